@@ -42,7 +42,7 @@
 #ifndef _LUFA_CONFIG_H_
 #define _LUFA_CONFIG_H_
 
-	#if (ARCH == ARCH_AVR8)
+	#if ((ARCH == ARCH_AVR8) || (ARCH == ARCH_SIM))
 
 		/* Non-USB Related Configuration Tokens: */
 //		#define DISABLE_TERMINAL_CODES
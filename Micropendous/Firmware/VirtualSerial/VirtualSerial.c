@@ -40,9 +40,12 @@
 #include "VirtualSerial.h"
 
 
-// Global buffer for use with STDIO functions
+// Global buffer holding one endpoint bank of echoed data
 volatile char buffer[CDC_TXRX_EPSIZE];
 
+// Set when the last echoed packet filled the IN bank, so the host is still waiting for the end of the transfer
+static bool EchoZLPPending;
+
 
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
@@ -74,10 +77,12 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 			},
 	};
 
+#if defined(FDEV_SETUP_STREAM)
 /** Standard file stream for the CDC interface when set up, so that the virtual CDC COM port can be
  *  used like any regular character stream in the C APIs
  */
 static FILE USBSerialStream;
+#endif
 
 
 /** Main program entry point. This routine contains the overall program flow, including initial
@@ -87,8 +92,10 @@ int main(void)
 {
 	SetupHardware();
 
+	#if defined(FDEV_SETUP_STREAM)
 	/* Create a regular character stream for the interface so that it can be used with the stdio.h functions */
 	CDC_Device_CreateStream(&VirtualSerial_CDC_Interface, &USBSerialStream);
+	#endif
 
 	GlobalInterruptEnable();
 
@@ -107,6 +114,7 @@ int main(void)
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
 void SetupHardware(void)
 {
+	#if (ARCH == ARCH_AVR8)
 	/* Disable watchdog if enabled by bootloader/fuses */
 	MCUSR &= ~(1 << WDRF);
 	wdt_disable();
@@ -121,6 +129,7 @@ void SetupHardware(void)
 			defined(__AVR_ATmega32U6__)	)
 		JTAG_DISABLE();
 	#endif
+	#endif
 
 	/* Hardware Initialization */
 	LEDs_Init();
@@ -163,20 +172,39 @@ void EVENT_USB_Device_ControlRequest(void)
 
 void MainTask(void)
 {
-	int count = 0;
-
-	// If the host has sent data then echo it back
-	// Throughput is maximized if the full EP buffer is read and sent each time
-	// Throughput approaches CDC_TXRX_EPSIZE kbytes/second and depends on transfer size from host 
-	if ((count = fread(&buffer, 1, CDC_TXRX_EPSIZE, &USBSerialStream)) > 0) {
-		fwrite(&buffer, 1, count, &USBSerialStream);
+	uint16_t count;
+	uint16_t space;
+
+	// If the host has sent data then echo it back a whole endpoint bank at a time
+	// The OUT bank is read in place with one block copy and handed straight back to the USB controller,
+	// then the packet is written into the IN bank and committed, so no data passes through stdio
+	// Throughput is then limited by the USB bus rather than by per-byte overhead
+	if ((space = CDC_Device_AcquireINBank(&VirtualSerial_CDC_Interface)) > 0) {
+		if ((count = CDC_Device_AcquireOUTBank(&VirtualSerial_CDC_Interface)) > 0) {
+			// If earlier data has left too little room in the IN bank, send that first and echo this packet next time
+			if (count <= space) {
+				Endpoint_Read_Stream_LE((void*)buffer, count, NULL);
+				CDC_Device_ReleaseOUTBank(&VirtualSerial_CDC_Interface);
+				CDC_Device_SendData(&VirtualSerial_CDC_Interface, (const void*)buffer, count);
+			}
+
+			// A packet which fills the IN bank does not end the host's transfer, a shorter one does
+			EchoZLPPending = (count == space);
+			CDC_Device_CommitINBank(&VirtualSerial_CDC_Interface);
+		} else if (EchoZLPPending) {
+			// Nothing more to echo after a full packet, so end the transfer with a zero length packet
+			CDC_Device_CommitINBank(&VirtualSerial_CDC_Interface);
+			EchoZLPPending = false;
+		}
 	}
 
 
+	#if (ARCH == ARCH_AVR8)
 	// If HWB Button is pressed then send formatted strings
 	if (Buttons_GetStatus()) {
 		fprintf_P(&USBSerialStream, PSTR("\r\nHWB has been pressed!\r\n")); // send a constant string stored in FLASH
 		fprintf(&USBSerialStream, "PORTD = %3x\r\n", PIND); // send a string that is dynamic and stored in SRAM
 	}
+	#endif
 
 }
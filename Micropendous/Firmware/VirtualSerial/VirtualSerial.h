@@ -37,19 +37,23 @@
 #define _VIRTUALSERIAL_H_
 
 	/* Includes: */
-		#include <avr/io.h>
-		#include <avr/wdt.h>
-		#include <avr/power.h>
-		#include <avr/interrupt.h>
 		#include <string.h>
 		#include <stdio.h>
 
 		#include "Descriptors.h"
 
 		#include <LUFA/Drivers/Board/LEDs.h>
-		#include <LUFA/Drivers/Board/Buttons.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
+		#if (ARCH == ARCH_AVR8)
+			#include <avr/io.h>
+			#include <avr/wdt.h>
+			#include <avr/power.h>
+			#include <avr/interrupt.h>
+
+			#include <LUFA/Drivers/Board/Buttons.h>
+		#endif
+
 	/* Macros: */
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
 		#define LEDMASK_USB_NOTREADY      LEDS_LED1
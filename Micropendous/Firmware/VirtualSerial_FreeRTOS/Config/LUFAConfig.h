@@ -42,7 +42,7 @@
 #ifndef _LUFA_CONFIG_H_
 #define _LUFA_CONFIG_H_
 
-	#if (ARCH == ARCH_AVR8)
+	#if ((ARCH == ARCH_AVR8) || (ARCH == ARCH_SIM))
 
 		/* Non-USB Related Configuration Tokens: */
 //		#define DISABLE_TERMINAL_CODES
@@ -74,7 +74,7 @@
 //		#define DEVICE_STATE_AS_GPIOR            {Insert Value Here}
 		#define FIXED_NUM_CONFIGURATIONS         1
 //		#define CONTROL_ONLY_DEVICE
-		#define INTERRUPT_CONTROL_ENDPOINT
+//		#define INTERRUPT_CONTROL_ENDPOINT
 //		#define NO_DEVICE_REMOTE_WAKEUP
 //		#define NO_DEVICE_SELF_POWER
 
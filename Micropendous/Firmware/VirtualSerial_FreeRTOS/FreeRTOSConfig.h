@@ -75,7 +75,9 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
-#include <avr/io.h>
+#if defined(__AVR__)
+	#include <avr/io.h>
+#endif
 
 /*-----------------------------------------------------------
  * Application specific definitions.
@@ -90,21 +92,37 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION		1
-#define configUSE_IDLE_HOOK		0
+#if defined(__AVR__)
+	#define configUSE_IDLE_HOOK		0
+#else
+	#define configUSE_IDLE_HOOK		1
+#endif
 #define configUSE_TICK_HOOK		0
 #define configCPU_CLOCK_HZ		( ( unsigned long ) F_CPU )
 #define configTICK_RATE_HZ		( ( portTickType ) 1000 )
 #define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 5 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 128 )
-#define configTOTAL_HEAP_SIZE		( (size_t ) ( 1500 ) )
+#if defined(__AVR__)
+	#define configTOTAL_HEAP_SIZE		( (size_t ) ( 1500 ) )
+#else
+	/* Task stacks are sized in words of the host, which are several times larger */
+	#define configTOTAL_HEAP_SIZE		( (size_t ) ( 16 * 1024 ) )
+#endif
 #define configMAX_TASK_NAME_LEN		( 8 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		1
 #define configIDLE_SHOULD_YIELD		1
 #define configQUEUE_REGISTRY_SIZE	0
 
+/* Sleep through idle periods rather than taking every tick, on the AVR port
+which supports it. */
+#if defined(__AVR__)
+	#define configUSE_TICKLESS_IDLE		1
+#endif
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
+#define configUSE_MUTEXES		1
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
 
 /* Set the following definitions to 1 to include the API function, or zero
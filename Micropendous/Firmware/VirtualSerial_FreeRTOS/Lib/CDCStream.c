@@ -0,0 +1,284 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Thread-safe CDC streams for FreeRTOS. Application tasks never touch the USB controller;
+ *  they write to and read from per-interface FreeRTOS stream buffers, and the USB task alone
+ *  moves the buffered data to and from the interface's endpoints, a full packet at a time
+ *  where it can.
+ *
+ *  Each stream buffer has a single writer and a single reader, so the buffers themselves
+ *  need no locking, and the USB task reads and writes them in place rather than through an
+ *  intermediate packet buffer. Tasks writing to the same stream are serialized by the
+ *  stream's mutex, which - unlike suspending the scheduler - leaves higher priority tasks
+ *  free to run while a slow fprintf() is formatting its output.
+ */
+
+#define  INCLUDE_FROM_CDCSTREAM_C
+#include "CDCStream.h"
+
+/** Initializes a CDC stream for the given CDC interface, including its standard stream where the C
+ *  library supports custom streams. This must be called before the scheduler is started.
+ *
+ *  \param[out] CDCStream        CDC stream to initialize
+ *  \param[in]  CDCInterfaceInfo CDC interface the stream is attached to
+ */
+void CDCStream_Init(CDCStream_t* const CDCStream,
+                    USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	memset(CDCStream, 0x00, sizeof(CDCStream_t));
+
+	CDCStream->CDCInterfaceInfo = CDCInterfaceInfo;
+
+	#if defined(FDEV_SETUP_STREAM)
+	CDCStream->Stream           = (FILE)FDEV_SETUP_STREAM(CDCStream_putchar, CDCStream_getchar, _FDEV_SETUP_RW);
+	fdev_set_udata(&CDCStream->Stream, CDCStream);
+	#endif
+
+	CDCStream->TxBuffer = xStreamBufferCreate(CDC_STREAM_TX_BUFFER_SIZE, 1);
+	CDCStream->TxLock   = xSemaphoreCreateMutex();
+	CDCStream->RxBuffer = xStreamBufferCreate(CDC_STREAM_RX_BUFFER_SIZE, 1);
+}
+
+/** Moves buffered data between a CDC stream and its interface's endpoints. This must only be
+ *  called from the USB task, each time it is woken.
+ *
+ *  \param[in,out] CDCStream  CDC stream to service
+ */
+void CDCStream_USBTask(CDCStream_t* const CDCStream)
+{
+	USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo = CDCStream->CDCInterfaceInfo;
+	uint8_t*                    Data;
+	uint16_t                    Length;
+
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return;
+
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	/* Move a received packet from the host into the buffer, leaving what does not fit in the endpoint */
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if (Endpoint_IsOUTReceived())
+	{
+		uint16_t BytesInEndpoint;
+
+		/* Flag the packet as stalled before committing any of it, as a reading task woken by the commit checks the flag
+		   to decide whether to wake the USB task again for the rest of the packet once it has made room in the buffer */
+		CDCStream->RxStalled = true;
+
+		/* The free space may be split across the end of the buffer's storage, so fill it a part at a time */
+		while ((BytesInEndpoint = Endpoint_BytesInEndpoint()) &&
+		       (Length = xStreamBufferWriteAcquire(CDCStream->RxBuffer, (void**)&Data, BytesInEndpoint, 0)))
+		{
+			Length = MIN(Length, BytesInEndpoint);
+
+			for (uint16_t i = 0; i < Length; i++)
+			  Data[i] = Endpoint_Read_8();
+
+			/* Committing the data wakes the reading task if it is waiting for it */
+			vStreamBufferWriteCommit(CDCStream->RxBuffer, Length);
+		}
+
+		if (!(Endpoint_BytesInEndpoint()))
+		{
+			/* Whole packet read, so a reading task need not wake the USB task again */
+			Endpoint_ClearOUT();
+			CDCStream->RxStalled = false;
+		}
+	}
+
+	if (!(CDCStream->RxStalled))
+	  LUFAFreeRTOS_ArmEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	/* Send the buffered data to the host, a full packet at a time while there is enough of it */
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	uint16_t PacketSize = CDCInterfaceInfo->Config.DataINEndpoint.Size;
+
+	if (xStreamBufferBytesAvailable(CDCStream->TxBuffer) || CDCStream->TxZLPPending)
+	{
+		if (Endpoint_IsINReady())
+		{
+			uint16_t PacketLength = 0;
+
+			/* The data may be split across the end of the buffer's storage, so send it a part at a time */
+			while ((PacketLength < PacketSize) &&
+			       (Length = xStreamBufferReadAcquire(CDCStream->TxBuffer, (void**)&Data, 0)))
+			{
+				Length = MIN(Length, (PacketSize - PacketLength));
+
+				for (uint16_t i = 0; i < Length; i++)
+				  Endpoint_Write_8(Data[i]);
+
+				/* Releasing the data wakes a writing task if it is waiting for room in the buffer */
+				vStreamBufferReadRelease(CDCStream->TxBuffer, Length);
+				PacketLength += Length;
+			}
+
+			/* A full packet which empties the buffer must be followed by a short packet to end the transfer */
+			CDCStream->TxZLPPending = ((PacketLength == PacketSize) &&
+			                           !(xStreamBufferBytesAvailable(CDCStream->TxBuffer)));
+
+			Endpoint_ClearIN();
+		}
+
+		/* Wake the USB task again once the bank is free for the rest of the data */
+		if (xStreamBufferBytesAvailable(CDCStream->TxBuffer) || CDCStream->TxZLPPending)
+		  LUFAFreeRTOS_ArmEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+	}
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+}
+
+/** Locks a CDC stream for writing by the calling task, so that its standard stream can be used with
+ *  the stdio.h output functions. Each lock must be released with \ref CDCStream_Unlock().
+ *
+ *  \param[in,out] CDCStream  CDC stream to lock
+ */
+void CDCStream_Lock(CDCStream_t* const CDCStream)
+{
+	xSemaphoreTake(CDCStream->TxLock, portMAX_DELAY);
+}
+
+/** Releases a CDC stream locked with \ref CDCStream_Lock(), and wakes the USB task to send the data
+ *  written while the stream was locked.
+ *
+ *  \param[in,out] CDCStream  CDC stream to unlock
+ */
+void CDCStream_Unlock(CDCStream_t* const CDCStream)
+{
+	xSemaphoreGive(CDCStream->TxLock);
+	LUFAFreeRTOS_WakeUSBTask();
+}
+
+/** Writes a block of data to a CDC stream, for the USB task to send to the host. This may be called
+ *  by any number of tasks, and blocks while the stream's buffer is full.
+ *
+ *  \param[in,out] CDCStream  CDC stream to write to
+ *  \param[in]     Buffer     Data to write
+ *  \param[in]     Length     Length of the data in bytes
+ *
+ *  \return Number of bytes written, less than Length if the host stopped reading or is not connected
+ */
+uint16_t CDCStream_Write(CDCStream_t* const CDCStream,
+                         const void* Buffer,
+                         uint16_t Length)
+{
+	uint16_t Written;
+
+	CDCStream_Lock(CDCStream);
+	Written = CDCStream_Send(CDCStream, (const uint8_t*)Buffer, Length);
+	CDCStream_Unlock(CDCStream);
+
+	return Written;
+}
+
+/** Reads data received from the host from a CDC stream. Only one task may read from a given stream.
+ *
+ *  \param[in,out] CDCStream    CDC stream to read from
+ *  \param[out]    Buffer       Buffer to read the data into
+ *  \param[in]     Length       Size of the buffer in bytes
+ *  \param[in]     TicksToWait  Longest time to wait for data if there is none buffered
+ *
+ *  \return Number of bytes read, zero if no data arrived before the timeout
+ */
+uint16_t CDCStream_Read(CDCStream_t* const CDCStream,
+                        void* Buffer,
+                        uint16_t Length,
+                        const portTickType TicksToWait)
+{
+	uint16_t Read = xStreamBufferReceive(CDCStream->RxBuffer, Buffer, Length, TicksToWait);
+
+	/* Have the USB task fetch the rest of a packet which did not fit into the buffer */
+	if (Read && CDCStream->RxStalled)
+	  LUFAFreeRTOS_WakeUSBTask();
+
+	return Read;
+}
+
+/** Adds data to a CDC stream's device-to-host buffer, waiting for the USB task to make room while it
+ *  is full. The calling task must hold the stream's lock.
+ *
+ *  \param[in,out] CDCStream  CDC stream to write to
+ *  \param[in]     Data       Data to write
+ *  \param[in]     Length     Length of the data in bytes
+ *
+ *  \return Number of bytes written, less than Length if the host is not connected or did not read the
+ *          buffered data in time
+ */
+static uint16_t CDCStream_Send(CDCStream_t* const CDCStream,
+                               const uint8_t* Data,
+                               uint16_t Length)
+{
+	uint16_t Written = 0;
+
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCStream->CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return 0;
+
+	while (Written < Length)
+	{
+		uint16_t Sent = xStreamBufferSend(CDCStream->TxBuffer, &Data[Written], (Length - Written), 0);
+
+		if (!(Sent))
+		{
+			/* The buffer is full, have the USB task empty it while this task waits for room */
+			LUFAFreeRTOS_WakeUSBTask();
+
+			if (!(Sent = xStreamBufferSend(CDCStream->TxBuffer, &Data[Written], (Length - Written), CDC_STREAM_TX_TIMEOUT)))
+			  break;
+		}
+
+		Written += Sent;
+	}
+
+	return Written;
+}
+
+#if defined(FDEV_SETUP_STREAM)
+static int CDCStream_putchar(char c,
+                             FILE* Stream)
+{
+	uint8_t Data = c;
+
+	return CDCStream_Send((CDCStream_t*)fdev_get_udata(Stream), &Data, 1) ? 0 : _FDEV_ERR;
+}
+
+static int CDCStream_getchar(FILE* Stream)
+{
+	uint8_t ReceivedByte;
+
+	if (!(CDCStream_Read((CDCStream_t*)fdev_get_udata(Stream), &ReceivedByte, 1, 0)))
+	  return _FDEV_EOF;
+
+	return ReceivedByte;
+}
+#endif
@@ -0,0 +1,119 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for CDCStream.c.
+ */
+
+#ifndef _CDC_STREAM_H_
+#define _CDC_STREAM_H_
+
+	/* Includes: */
+		#include <stdio.h>
+		#include <string.h>
+		#include <stdint.h>
+		#include <stdbool.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+
+		#include "FreeRTOS.h"
+		#include "task.h"
+		#include "semphr.h"
+		#include "stream_buffer.h"
+
+		#include "LUFAFreeRTOS.h"
+
+	/* Preprocessor Checks: */
+		#if (configUSE_MUTEXES != 1)
+			#error configUSE_MUTEXES must be enabled in FreeRTOSConfig.h for the CDC stream locks.
+		#endif
+
+	/* Macros: */
+		/** Size in bytes of each CDC stream's device-to-host buffer, allocated from the FreeRTOS heap. */
+		#define CDC_STREAM_TX_BUFFER_SIZE      128
+
+		/** Size in bytes of each CDC stream's host-to-device buffer, allocated from the FreeRTOS heap. */
+		#define CDC_STREAM_RX_BUFFER_SIZE      64
+
+		/** Longest time a writer waits for the USB task to make room in a full device-to-host buffer before the
+		 *  remaining data is discarded.
+		 */
+		#define CDC_STREAM_TX_TIMEOUT          ( ( portTickType ) USB_STREAM_TIMEOUT_MS / portTICK_RATE_MS )
+
+	/* Type Defines: */
+		/** Type define for a thread-safe CDC stream, buffering data between application tasks and the USB task
+		 *  for one CDC interface.
+		 */
+		typedef struct
+		{
+			USB_ClassInfo_CDC_Device_t* CDCInterfaceInfo; /**< CDC interface the stream is attached to */
+			#if defined(FDEV_SETUP_STREAM)
+			FILE                        Stream; /**< Standard stream for use with the stdio.h functions, see
+			                                     *   \ref CDCStream_Lock()
+			                                     */
+			#endif
+
+			xStreamBufferHandle         TxBuffer; /**< Device-to-host buffer, read in place by the USB task */
+			bool                        TxZLPPending; /**< Indicates the last packet sent was full and must be terminated */
+			xSemaphoreHandle            TxLock; /**< Mutex serializing the tasks writing to the stream */
+
+			xStreamBufferHandle         RxBuffer; /**< Host-to-device buffer, written in place by the USB task */
+			volatile bool               RxStalled; /**< Indicates host data was, or is about to be, left in the endpoint for lack of room */
+		} CDCStream_t;
+
+	/* Function Prototypes: */
+		void     CDCStream_Init(CDCStream_t* const CDCStream,
+		                        USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     CDCStream_USBTask(CDCStream_t* const CDCStream);
+		void     CDCStream_Lock(CDCStream_t* const CDCStream);
+		void     CDCStream_Unlock(CDCStream_t* const CDCStream);
+		uint16_t CDCStream_Write(CDCStream_t* const CDCStream,
+		                         const void* Buffer,
+		                         uint16_t Length);
+		uint16_t CDCStream_Read(CDCStream_t* const CDCStream,
+		                        void* Buffer,
+		                        uint16_t Length,
+		                        const portTickType TicksToWait);
+
+		#if defined(INCLUDE_FROM_CDCSTREAM_C)
+			static uint16_t CDCStream_Send(CDCStream_t* const CDCStream,
+			                               const uint8_t* Data,
+			                               uint16_t Length);
+
+			#if defined(FDEV_SETUP_STREAM)
+			static int      CDCStream_putchar(char c,
+			                                  FILE* Stream);
+			static int      CDCStream_getchar(FILE* Stream);
+			#endif
+		#endif
+
+#endif
+
@@ -0,0 +1,168 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Interrupt driven USB servicing for LUFA under FreeRTOS. Rather than polling the USB
+ *  controller on a fixed tick period, the USB task blocks on a semaphore which is given
+ *  from the USB endpoint interrupt, so that it only runs when the host has done
+ *  something, and runs straight away when it has.
+ *
+ *  Each endpoint interrupt is disarmed when it fires, as the endpoint condition stays
+ *  set until a task has serviced the endpoint. The task re-arms the endpoint with
+ *  \ref LUFAFreeRTOS_ArmEndpoint() once the endpoint has been serviced.
+ */
+
+#include "LUFAFreeRTOS.h"
+
+/** Semaphore given by the USB endpoint interrupt to wake the USB task. */
+static xSemaphoreHandle USBEventSemaphore;
+
+/** Mask of endpoints which have interrupted since the USB task last woke, one bit per endpoint number. */
+static volatile uint8_t PendingEndpointEvents;
+
+
+/** Initializes the FreeRTOS USB integration. This must be called before the USB interface
+ *  is initialized with USB_Init().
+ */
+void LUFAFreeRTOS_Init(void)
+{
+	vSemaphoreCreateBinary(USBEventSemaphore);
+}
+
+/** Blocks the calling task until one or more armed USB endpoints have interrupted. The
+ *  interrupted endpoints are left disarmed, and must be re-armed with
+ *  \ref LUFAFreeRTOS_ArmEndpoint() once they have been serviced.
+ *
+ *  \return Mask of the endpoints which have interrupted, see \ref LUFA_FREERTOS_ENDPOINT_EVENT()
+ */
+uint8_t LUFAFreeRTOS_WaitForUSBEvents(void)
+{
+	uint8_t EndpointEvents;
+
+	xSemaphoreTake(USBEventSemaphore, portMAX_DELAY);
+
+	portENTER_CRITICAL();
+	EndpointEvents        = PendingEndpointEvents;
+	PendingEndpointEvents = 0;
+	portEXIT_CRITICAL();
+
+	return EndpointEvents;
+}
+
+/** Arms the interrupt of the given endpoint, so that the USB task is woken when the endpoint
+ *  needs servicing. The control endpoint is woken on the reception of a SETUP packet, OUT
+ *  endpoints on the reception of a packet from the host, and IN endpoints when a bank is
+ *  free for a new packet to the host. This may be called from a task or an interrupt.
+ *
+ *  \param[in] Address  Address of the endpoint to arm, including its direction
+ */
+void LUFAFreeRTOS_ArmEndpoint(const uint8_t Address)
+{
+	portENTER_CRITICAL();
+
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	Endpoint_SelectEndpoint(Address);
+
+	#if (ARCH == ARCH_AVR8)
+	if ((Address & ENDPOINT_EPNUM_MASK) == ENDPOINT_CONTROLEP)
+	  UEIENX |= (1 << RXSTPE);
+	else if ((Address & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
+	  UEIENX |= (1 << TXINE);
+	else
+	  UEIENX |= (1 << RXOUTE);
+	#else
+	Endpoint_EnableEndpointInterrupt();
+	#endif
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+
+	portEXIT_CRITICAL();
+}
+
+/** Wakes the USB task from another task without an endpoint event, so that it can service
+ *  data the calling task has produced for, or made room for from, the USB interface.
+ */
+void LUFAFreeRTOS_WakeUSBTask(void)
+{
+	xSemaphoreGive(USBEventSemaphore);
+}
+
+/** Event handler for the library USB Reset event. The bus reset reconfigures the control
+ *  endpoint, so it is re-armed here to wake the USB task for the host's SETUP packets.
+ */
+void EVENT_USB_Device_Reset(void)
+{
+	LUFAFreeRTOS_ArmEndpoint(ENDPOINT_CONTROLEP);
+}
+
+/** USB endpoint interrupt, disarming each interrupting endpoint and waking the USB task
+ *  to service it.
+ */
+ISR(USB_COM_vect, ISR_BLOCK)
+{
+	signed portBASE_TYPE HigherPriorityTaskWoken = pdFALSE;
+
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+	uint8_t EndpointInterrupts   = Endpoint_GetEndpointInterrupts();
+
+	for (uint8_t EndpointNum = 0; EndpointNum < ENDPOINT_TOTAL_ENDPOINTS; EndpointNum++)
+	{
+		if (EndpointInterrupts & (1 << EndpointNum))
+		{
+			Endpoint_SelectEndpoint(EndpointNum);
+
+			#if (ARCH == ARCH_AVR8)
+			UEIENX = 0;
+			#else
+			Endpoint_DisableEndpointInterrupt();
+			#endif
+		}
+	}
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+
+	PendingEndpointEvents |= EndpointInterrupts;
+	xSemaphoreGiveFromISR(USBEventSemaphore, &HigherPriorityTaskWoken);
+
+	/* Switch straight to the USB task if it has a higher priority than the interrupted task */
+	if (HigherPriorityTaskWoken != pdFALSE)
+	{
+		#if (ARCH == ARCH_SIM)
+		/* Each task has its own copy of the global interrupt flag on the AVR, restored with SREG when it is
+		 * switched back in, so the woken task must not inherit the flag cleared for this ISR */
+		GlobalInterruptEnable();
+		#endif
+
+		taskYIELD();
+	}
+}
+
@@ -0,0 +1,72 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for LUFAFreeRTOS.c.
+ */
+
+#ifndef _LUFA_FREERTOS_H_
+#define _LUFA_FREERTOS_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+
+		#if (ARCH == ARCH_AVR8)
+			#include <avr/io.h>
+			#include <avr/interrupt.h>
+		#endif
+
+		#include "FreeRTOS.h"
+		#include "task.h"
+		#include "semphr.h"
+
+	/* Preprocessor Checks: */
+		#if defined(INTERRUPT_CONTROL_ENDPOINT)
+			#error INTERRUPT_CONTROL_ENDPOINT must not be defined, as the USB_COM_vect interrupt is handled here.
+		#endif
+
+	/* Macros: */
+		/** Mask for \ref LUFAFreeRTOS_WaitForUSBEvents() indicating an event on the given endpoint.
+		 *
+		 *  \param[in] Address  Address of the endpoint, including its direction
+		 */
+		#define LUFA_FREERTOS_ENDPOINT_EVENT(Address)  (1 << ((Address) & ENDPOINT_EPNUM_MASK))
+
+	/* Function Prototypes: */
+		void    LUFAFreeRTOS_Init(void);
+		uint8_t LUFAFreeRTOS_WaitForUSBEvents(void);
+		void    LUFAFreeRTOS_ArmEndpoint(const uint8_t Address);
+		void    LUFAFreeRTOS_WakeUSBTask(void);
+
+#endif
+
@@ -0,0 +1,141 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/** \file
+ *
+ *  Simulated USB host script for the FreeRTOS VirtualSerial demo, used when the demo is built for the
+ *  host-side simulated USB controller and the Posix FreeRTOS port (make ARCH=SIM BOARD=NONE). The script
+ *  enumerates the device, opens the virtual serial port and then streams a test pattern through the
+ *  tasks' loopback, verifying the echoed data and reporting the achieved throughput and the host CPU
+ *  cycles spent per byte.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Descriptors.h"
+
+#if (ARCH == ARCH_SIM)
+
+#include <time.h>
+
+/** Total number of bytes streamed through the device's loopback by the benchmark. */
+#define SIMHOST_BENCHMARK_BYTES    (4UL * 1024UL * 1024UL)
+
+static uint8_t SimHost_OpenPort(void)
+{
+	uint8_t ErrorCode;
+
+	CDC_LineEncoding_t LineEncoding =
+		{
+			.BaudRateBPS = 115200,
+			.CharFormat  = CDC_LINEENCODING_OneStopBit,
+			.ParityType  = CDC_PARITY_None,
+			.DataBits    = 8,
+		};
+
+	USB_Request_Header_t SetLineEncoding =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = CDC_REQ_SetLineEncoding,
+			.wValue        = 0,
+			.wIndex        = 0, // CDC control interface
+			.wLength       = sizeof(CDC_LineEncoding_t),
+		};
+
+	if ((ErrorCode = USB_SimHost_ControlTransfer(&SetLineEncoding, &LineEncoding, NULL)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_Request_Header_t SetControlLineState =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = CDC_REQ_SetControlLineState,
+			.wValue        = (CDC_CONTROL_LINE_OUT_DTR | CDC_CONTROL_LINE_OUT_RTS),
+			.wIndex        = 0, // CDC control interface
+			.wLength       = 0,
+		};
+
+	return USB_SimHost_ControlTransfer(&SetControlLineState, NULL, NULL);
+}
+
+static void SimHost_Fail(const char* const Stage,
+                         const uint8_t ErrorCode)
+{
+	fprintf(stderr, "SimHost: %s failed (error %u)\n", Stage, ErrorCode);
+	exit(EXIT_FAILURE);
+}
+
+/** Simulated host script, overriding the library's default enumerate-and-idle host behaviour. */
+void CALLBACK_USB_SimHost_Task(void)
+{
+	uint8_t  TxPacket[CDC_TXRX_EPSIZE];
+	uint8_t  RxPacket[ENDPOINT_MAX_BANK_SIZE];
+	uint32_t BytesSent     = 0;
+	uint32_t BytesEchoed   = 0;
+	uint8_t  ErrorCode;
+
+	if ((ErrorCode = USB_SimHost_Enumerate(1)) != USB_SIMHOST_Successful)
+	  SimHost_Fail("Enumeration", ErrorCode);
+
+	if ((ErrorCode = SimHost_OpenPort()) != USB_SIMHOST_Successful)
+	  SimHost_Fail("Port open", ErrorCode);
+
+	memset(&USB_SimHost_Statistics, 0, sizeof(USB_SimHost_Statistics));
+
+	struct timespec StartTime;
+	struct timespec EndTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &StartTime);
+	uint64_t StartCycles = SIM_GetCycleCount();
+
+	while (BytesEchoed < SIMHOST_BENCHMARK_BYTES)
+	{
+		for (uint16_t i = 0; i < sizeof(TxPacket); i++)
+		  TxPacket[i] = (uint8_t)(BytesSent + i);
+
+		if ((ErrorCode = USB_SimHost_WriteOUT(CDC_RX_EPADDR, TxPacket, sizeof(TxPacket))) != USB_SIMHOST_Successful)
+		  SimHost_Fail("OUT transfer", ErrorCode);
+
+		BytesSent += sizeof(TxPacket);
+
+		while (BytesEchoed < BytesSent)
+		{
+			uint16_t PacketLength;
+
+			if ((ErrorCode = USB_SimHost_ReadIN(CDC_TX_EPADDR, RxPacket, &PacketLength)) != USB_SIMHOST_Successful)
+			  SimHost_Fail("IN transfer", ErrorCode);
+
+			for (uint16_t i = 0; i < PacketLength; i++)
+			{
+				if (RxPacket[i] != (uint8_t)(BytesEchoed + i))
+				{
+					fprintf(stderr, "SimHost: loopback data mismatch at byte %lu\n", (unsigned long)(BytesEchoed + i));
+					exit(EXIT_FAILURE);
+				}
+			}
+
+			BytesEchoed += PacketLength;
+		}
+	}
+
+	uint64_t TotalCycles = (SIM_GetCycleCount() - StartCycles);
+	clock_gettime(CLOCK_MONOTONIC, &EndTime);
+
+	double Seconds = (EndTime.tv_sec - StartTime.tv_sec) + ((EndTime.tv_nsec - StartTime.tv_nsec) / 1e9);
+	uint32_t TotalPackets = (USB_SimHost_Statistics.PacketsOUT + USB_SimHost_Statistics.PacketsIN);
+
+	printf("SimHost: %lu bytes looped back in %.3f s\n", (unsigned long)BytesEchoed, Seconds);
+	printf("SimHost: %.0f bytes/s, %.0f packets/s, %.1f cycles/byte\n",
+	       (BytesEchoed / Seconds), (TotalPackets / Seconds), ((double)TotalCycles / BytesEchoed));
+
+	exit(EXIT_SUCCESS);
+}
+
+#endif
+
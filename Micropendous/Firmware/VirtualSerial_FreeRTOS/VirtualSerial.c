@@ -40,8 +40,8 @@
 #include "VirtualSerial.h"
 
 
-// Global buffer for use with STDIO functions
-volatile char buffer[CDC_TXRX_EPSIZE];
+// Global buffer for the data echoed back to the host
+uint8_t buffer[CDC_TXRX_EPSIZE];
 
 
 /** LUFA CDC Class driver interface configuration and state information. This structure is
@@ -74,10 +74,11 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 			},
 	};
 
-/** Standard file stream for the CDC interface when set up, so that the virtual CDC COM port can be
- *  used like any regular character stream in the C APIs
+/** Thread-safe stream for the CDC interface, buffering data between the application tasks and the USB task.
+ *  Its standard file stream allows the virtual CDC COM port to be used like any regular character stream in
+ *  the C APIs while the stream is locked.
  */
-static FILE USBSerialStream;
+static CDCStream_t USBSerialStream;
 
 
 /** Main program entry point. This routine contains the overall program flow, including initial
@@ -87,9 +88,6 @@ int main(void)
 {
 	SetupHardware();
 
-	/* Create a regular character stream for the interface so that it can be used with the stdio.h functions */
-	CDC_Device_CreateStream(&VirtualSerial_CDC_Interface, &USBSerialStream);
-
 	GlobalInterruptEnable();
 
 	// Create Tasks for FreeRTOS
@@ -107,6 +105,7 @@ int main(void)
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
 void SetupHardware(void)
 {
+	#if (ARCH == ARCH_AVR8)
 	/* Disable watchdog if enabled by bootloader/fuses */
 	MCUSR &= ~(1 << WDRF);
 	wdt_disable();
@@ -121,6 +120,7 @@ void SetupHardware(void)
 			defined(__AVR_ATmega32U6__)	)
 		JTAG_DISABLE();
 	#endif
+	#endif
 
 	/* Hardware Initialization */
 	LEDs_Init();
@@ -128,6 +128,10 @@ void SetupHardware(void)
 	DISABLE_VOLTAGE_TXRX(); // used on Micropendous REV1/2 boards
 	DISABLE_EXT_SRAM(); // used on Micropendous REV1/2 boards
 	SELECT_USB_B(); // needed for Micropendous REV1/2 boards
+
+	// USB endpoint interrupts wake the tasks, so the semaphores must exist before USB is started
+	LUFAFreeRTOS_Init();
+	CDCStream_Init(&USBSerialStream, &VirtualSerial_CDC_Interface);
 	USB_Init();
 }
 
@@ -135,6 +139,11 @@ void SetupHardware(void)
 // CoRoutines are not enabled, but FreeRTOS complains during compile
 void vApplicationIdleHook(void)
 {
+	#if (ARCH == ARCH_SIM)
+	// The idle task would otherwise spin through the simulated host's time slices while the tasks wait on it
+	SIM_YieldToBus();
+	#endif
+
 	//vCoRoutineSchedule();
 }
 
@@ -158,6 +167,9 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 
 	ConfigSuccess &= CDC_Device_ConfigureEndpoints(&VirtualSerial_CDC_Interface);
 
+	// Wake the USB task when the host sends data
+	LUFAFreeRTOS_ArmEndpoint(CDC_RX_EPADDR);
+
 	LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
 }
 
@@ -174,20 +186,18 @@ static void VirtualSerialTask(void *pvParameters)
 
 	for (;;)
 	{
-		// Must throw away unused bytes from the host, or it will lock up while waiting for the device
-		// TODO: this causes loopback to fail
-		//CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
-
-		// want CDC and USB functions to run without interruption but
-		// with interrupts enabled so ENTER/EXIT_CRITICAL won't work
-		vTaskSuspendAll();
+		// Sleep until the USB controller interrupts, rather than polling it every few ticks
+		uint8_t EndpointEvents = LUFAFreeRTOS_WaitForUSBEvents();
 
-			CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
-			USB_USBTask();
+		// Only this task touches the USB controller, the other tasks go through USBSerialStream
+		USB_USBTask();
 
-		xTaskResumeAll();
+		// The SETUP packet has been processed, wait for the next one
+		if (EndpointEvents & LUFA_FREERTOS_ENDPOINT_EVENT(ENDPOINT_CONTROLEP))
+		  LUFAFreeRTOS_ArmEndpoint(ENDPOINT_CONTROLEP);
 
-		vTaskDelay((portTickType) taskDelayPeriod );
+		// Move data between the CDC endpoints and the stream buffers
+		CDCStream_USBTask(&USBSerialStream);
 	}
 
 }
@@ -197,7 +207,6 @@ static void MainTask(void *pvParameters)
 {
 	for(;;) {
 		MainTaskLoop();
-		portYIELD();
 	}
 }
 
@@ -206,31 +215,30 @@ void MainTaskLoop(void)
 {
 	int count = 0;
 
-	// If the host has sent data then echo it back
+	// If the host has sent data then echo it back, sleeping until it does
+	// or until it is time to check the HWB button again
 	// Throughput is maximized if the full EP buffer is read and sent each time
 	// Throughput approaches CDC_TXRX_EPSIZE kbytes/second and depends on transfer size from host 
-	// NOTE: AVRlibc stdio functions are not thread-safe and must therefore be in a Suspend-Resume section
-	vTaskSuspendAll();
-		count = fread(&buffer, 1, CDC_TXRX_EPSIZE, &USBSerialStream);
-	xTaskResumeAll();
+	// NOTE: the stream functions lock only USBSerialStream, so higher priority tasks keep running
+	count = CDCStream_Read(&USBSerialStream, buffer, CDC_TXRX_EPSIZE, BUTTON_POLL_PERIOD);
 
 	//TODO: you can process the received buffer data here
 
-	vTaskSuspendAll();
-		if (count > 0) {
-			fwrite(&buffer, 1, count, &USBSerialStream);
-		}
-	xTaskResumeAll();
+	if (count > 0) {
+		CDCStream_Write(&USBSerialStream, buffer, count);
+	}
 
 
+	#if (ARCH == ARCH_AVR8)
 	// If HWB Button is pressed then send formatted strings
 	if (Buttons_GetStatus()) {
-		// NOTE: AVRlibc stdio functions are not thread-safe and must therefore be in a Suspend-Resume section
-		vTaskSuspendAll();
-			fprintf_P(&USBSerialStream, PSTR("\r\nHWB has been pressed!\r\n")); // send a constant string stored in FLASH
-			fprintf(&USBSerialStream, "PORTD = %3x\r\n", PIND); // send a string that is dynamic and stored in SRAM
-		xTaskResumeAll();
+		// NOTE: AVRlibc stdio functions are not thread-safe and must therefore be in a Lock-Unlock section
+		CDCStream_Lock(&USBSerialStream);
+			fprintf_P(&USBSerialStream.Stream, PSTR("\r\nHWB has been pressed!\r\n")); // send a constant string stored in FLASH
+			fprintf(&USBSerialStream.Stream, "PORTD = %3x\r\n", PIND); // send a string that is dynamic and stored in SRAM
+		CDCStream_Unlock(&USBSerialStream);
 	}
+	#endif
 
 }
 
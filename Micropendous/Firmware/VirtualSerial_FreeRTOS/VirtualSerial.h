@@ -37,22 +37,29 @@
 #define _VIRTUALSERIAL_FREERTOS_H_
 
 	/* Includes: */
-		#include <avr/io.h>
-		#include <avr/wdt.h>
-		#include <avr/power.h>
-		#include <avr/interrupt.h>
 		#include <string.h>
 		#include <stdio.h>
 
 		#include "Descriptors.h"
+		#include "Lib/LUFAFreeRTOS.h"
+		#include "Lib/CDCStream.h"
 
 		#include <LUFA/Drivers/Board/LEDs.h>
-		#include <LUFA/Drivers/Board/Buttons.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
+		#if (ARCH == ARCH_AVR8)
+			#include <avr/io.h>
+			#include <avr/wdt.h>
+			#include <avr/power.h>
+			#include <avr/interrupt.h>
+
+			#include <LUFA/Drivers/Board/Buttons.h>
+		#endif
+
 		// FreeRTOS include files
 		#include "FreeRTOS.h"
 		#include "task.h"
+		#include "semphr.h"
 		#include "croutine.h"
 		#include "FreeRTOSConfig.h"
 
@@ -61,7 +68,8 @@
 		#define MAIN_TASK_PRIORITY		( configMAX_PRIORITIES - 3 )
 		#define ViSe_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )	// highest priority
 
-		#define taskDelayPeriod			3
+		// Longest time the MainTask sleeps waiting for host data before checking the HWB button
+		#define BUTTON_POLL_PERIOD		( ( portTickType ) 50 / portTICK_RATE_MS )
 
 	/* Macros: */
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
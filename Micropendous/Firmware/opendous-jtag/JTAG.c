@@ -29,10 +29,19 @@ TASK_LIST
 };
 
 /* Global Variables */
-uint8_t  dataFromHost[IN_EP_SIZE];
-uint8_t  dataToHost[OUT_EP_SIZE];
-uint16_t dataFromHostSize=0;
-uint16_t dataToHostSize=0;
+//commands recieved from the host, queued so the OUT endpoint is freed while the TAP is busy
+uint8_t  dataFromHost[JTAG_COMMAND_QUEUE_DEPTH][OUT_EP_SIZE];
+uint8_t  dataFromHostSize[JTAG_COMMAND_QUEUE_DEPTH];
+uint8_t  dataFromHostIn=0;
+uint8_t  dataFromHostOut=0;
+uint8_t  dataFromHostCount=0;
+
+//replies for the host, one can be filled by the TAP while the other waits for the IN endpoint
+uint8_t  dataToHost[2][IN_EP_SIZE];
+uint8_t  dataToHostSize[2];
+uint8_t  dataToHostIn=0;
+uint8_t  dataToHostOut=0;
+uint8_t  dataToHostCount=0;
 
 volatile uint8_t resetJtagTransfers=0;
 
@@ -77,17 +86,13 @@ int main(void)
   SerialStream_Init(9600,0);
 #endif //DEBUG
   
-	// initialize the send and receive buffers
-	uint8_t i = 0;
-	for (i = 0; i < IN_EP_SIZE; i++) {
-		dataFromHost[i] = 0;
-	}
-
-	for (i = 0; i < OUT_EP_SIZE; i++) {
-		dataToHost[i] = 0;
-	}
-  dataFromHostSize=0;
-  dataToHostSize=0;
+	// initialize the send and receive queues
+  dataFromHostIn=0;
+  dataFromHostOut=0;
+  dataFromHostCount=0;
+  dataToHostIn=0;
+  dataToHostOut=0;
+  dataToHostCount=0;
   resetJtagTransfers=0;
 
 
@@ -145,7 +150,7 @@ void EVENT_USB_ConfigurationChanged(void)
 	/* Setup Keyboard Keycode Report Endpoint */
 	Endpoint_ConfigureEndpoint(IN_EP, EP_TYPE_BULK,
 								ENDPOINT_DIR_IN, IN_EP_SIZE,
-								ENDPOINT_BANK_SINGLE);
+								JTAG_EP_BANKS);
 
 	/* Enable the endpoint IN interrupt ISR for data being sent TO the host */
 	//USB_INT_Enable(ENDPOINT_INT_IN);
@@ -153,7 +158,7 @@ void EVENT_USB_ConfigurationChanged(void)
 	/* Setup Keyboard LED Report Endpoint */
 	Endpoint_ConfigureEndpoint(OUT_EP, EP_TYPE_BULK,
 								ENDPOINT_DIR_OUT, OUT_EP_SIZE,
-								ENDPOINT_BANK_SINGLE);
+								JTAG_EP_BANKS);
 
 	/* Enable the endpoint OUT interrupt ISR for data recevied FROM the host */
 	//USB_INT_Enable(ENDPOINT_INT_OUT);
@@ -196,6 +201,164 @@ void EVENT_USB_UnhandledControlPacket(void)
 	}
 }
 
+/** Runs a single host command on the TAP.
+ *
+ *  \param command  command byte followed by its parameters
+ *  \param length   number of bytes in command, including the command byte
+ *  \param reply    buffer for the reply, a reply is never longer than its command
+ *
+ *  \return number of bytes written to reply, 0 if the command has no reply
+ */
+static uint8_t jtag_process_command(const uint8_t* command, uint8_t length, uint8_t* reply);
+
+/** Works out how many TDI/TMS pairs a JTAG_CMD_TAP_OUTPUT or JTAG_CMD_TAP_OUTPUT_EMU command carries.
+ *
+ *  \param command  command byte, the JTAG_DATA_MASK bits give the pairs used in a partly filled last byte
+ *  \param size     number of payload bytes after the command byte
+ *
+ *  \return number of pairs to output, 0 if the command is malformed
+ */
+static uint16_t jtag_tap_output_length(uint8_t command, uint16_t size)
+{
+  uint8_t lastPairs=(command&JTAG_DATA_MASK)>>4;
+
+  if(!lastPairs)
+    return size*4;
+
+  //a partly filled last byte holds 1 to 3 pairs, and has to be there
+  if(!size || lastPairs>3)
+    return 0;
+
+  return size*4-(4-lastPairs);
+}
+
+/** Runs the commands packed into a JTAG_CMD_BATCH packet and concatenates their replies.
+ *
+ *  \param batch    sequence of [length] [command, length bytes] records
+ *  \param length   number of bytes in batch
+ *  \param reply    buffer for the combined reply
+ *
+ *  \return number of bytes written to reply
+ */
+static uint8_t jtag_process_batch(const uint8_t* batch, uint8_t length, uint8_t* reply)
+{
+  uint8_t replySize=0;
+
+  while(length)
+  {
+    uint8_t size=batch[0];
+
+    //stop at a malformed record rather than run past the end of the packet
+    if(!size || size>=length)
+      break;
+
+    //a reply is never longer than its command, stop before one could run past the end of the reply buffer
+    if(replySize+size>IN_EP_SIZE)
+      break;
+
+    //batches do not nest
+    if( (batch[1]&JTAG_CMD_MASK)!=JTAG_CMD_BATCH )
+      replySize+=jtag_process_command(&batch[1], size, &reply[replySize]);
+
+    batch +=size+1;
+    length-=size+1;
+  }
+
+  return replySize;
+}
+
+static uint8_t jtag_process_command(const uint8_t* command, uint8_t length, uint8_t* reply)
+{
+  //first byte is always the command
+  uint16_t size=length-1;
+
+  switch( command[0] &JTAG_CMD_MASK ) 
+  {
+    
+  case JTAG_CMD_TAP_OUTPUT:
+    
+    if(!(size=jtag_tap_output_length(command[0], size)))
+      break;
+    
+    if(jtag_delay)
+      return jtag_tap_output_with_delay( &command[1] , size, reply);
+    else
+      return jtag_tap_output_max_speed( &command[1] , size, reply);
+    
+  case JTAG_CMD_TAP_OUTPUT_EMU:
+    if(!(size=jtag_tap_output_length(command[0], size)))
+      break;
+    
+    return jtag_tap_output_emu(&command[1], size, reply);
+
+  case JTAG_CMD_TAP_SHIFT:
+    if(size<2)
+      break;
+
+    //bit count is stored LSB first after the command, never shift more bits than were sent
+    size=(size-2)*8;
+    if( (command[1]|(command[2]<<8)) < size )
+      size=command[1]|(command[2]<<8);
+
+    return jtag_tap_shift(&command[3], size, command[0]&JTAG_DATA_MASK, reply);
+
+  case JTAG_CMD_TAP_SHIFT_TMS:
+    if(size<1)
+      break;
+
+    size=(size-1)*8;
+    if( command[1] < size )
+      size=command[1];
+
+    return jtag_tap_shift_tms(&command[2], size, command[0]&JTAG_DATA_MASK, reply);
+
+  case JTAG_CMD_BATCH:
+    return jtag_process_batch(&command[1], size, reply);
+    
+  case JTAG_CMD_READ_INPUT:
+    reply[0]=jtag_read_input();
+    return 1;
+  
+  case JTAG_CMD_SET_SRST:
+    if(size<1)
+      break;
+
+    jtag_set_srst(command[1]&1);
+    reply[0]=0;//TODO: what to output here?
+    return 1;
+  
+  case JTAG_CMD_SET_TRST:
+    if(size<1)
+      break;
+
+    jtag_set_trst(command[1]&1);
+    reply[0]=0;//TODO: what to output here?
+    return 1;
+  
+  case JTAG_CMD_SET_DELAY:
+    //delay is stored MSB first after the command
+    if(size<2)
+      break;
+
+    jtag_delay=command[1]*256+command[2];
+    reply[0]=0;//TODO: what to output here?
+    return 1;
+
+  case JTAG_CMD_SET_SRST_TRST:
+    if(size<1)
+      break;
+
+    jtag_set_trst_srst(command[1]&2?1:0,command[1]&1);
+    reply[0]=0;//TODO: what to output here?
+    return 1;
+  
+  default: //REPORT ERROR?
+    break;
+  }
+
+  return 0;
+}
+
 TASK(USB_MainTask)
 {
 	/* Check if the USB System is connected to a Host */
@@ -203,94 +366,60 @@ TASK(USB_MainTask)
 	{
 		/* process data or do something generally useful */
 		/* note that TASK(USB_MainTask) will be periodically executed when no other tasks or functions are running */
-     
+
+    //hand finished replies to the IN endpoint, with double banking the host reads one while the next is written
     Endpoint_SelectEndpoint(IN_EP);
 
-    if (dataToHostSize && Endpoint_IsReadWriteAllowed())
+    while (dataToHostCount && Endpoint_IsINReady())
     {
-      if(dataToHostSize)
-        Endpoint_Write_Stream_LE(dataToHost,dataToHostSize);
+      Endpoint_Write_Stream_LE(dataToHost[dataToHostOut],dataToHostSize[dataToHostOut]);
       
       /* Handshake the IN Endpoint - send the data to the host */
-      //Endpoint_ClearCurrentBank();
       Endpoint_ClearIN();
       
-      dataToHostSize=0;
+      dataToHostOut^=1;
+      dataToHostCount--;
     }
 
+    //queue every command the host has already sent, freeing the OUT banks so it can send more during the TAP run
     Endpoint_SelectEndpoint(OUT_EP);
 
-    if (Endpoint_IsReadWriteAllowed())
+    while (dataFromHostCount<JTAG_COMMAND_QUEUE_DEPTH && Endpoint_IsOUTReceived())
     {
-      if( (dataFromHostSize=Endpoint_BytesInEndpoint()) >0 )
+      uint8_t size=Endpoint_BytesInEndpoint();
+
+      Endpoint_Read_Stream_LE(dataFromHost[dataFromHostIn],size);
+      /* Clear the endpoint buffer */
+      Endpoint_ClearOUT();
+
+      if(size)
       {
-        Endpoint_Read_Stream_LE(dataFromHost,dataFromHostSize);
-        /* Clear the endpoint buffer */
-        //Endpoint_ClearCurrentBank();
-        Endpoint_ClearOUT();
-        
-        //first byte is always the command
-        dataFromHostSize--;
-        
-        dataToHostSize=0;
-        
-        switch( dataFromHost[0] &JTAG_CMD_MASK ) 
-        {
-          
-        case JTAG_CMD_TAP_OUTPUT:
-          
-          dataFromHostSize*=4;
-
-          if( dataFromHost[0] & JTAG_DATA_MASK )
-            dataFromHostSize-= (4- ((dataFromHost[0] & JTAG_DATA_MASK)>>4));
-          
-					if(jtag_delay)
-						dataToHostSize= jtag_tap_output_with_delay( &dataFromHost[1] , dataFromHostSize, dataToHost);
-					else
-						dataToHostSize= jtag_tap_output_max_speed( &dataFromHost[1] , dataFromHostSize, dataToHost);
-          
-          break;
-          
-        case JTAG_CMD_TAP_OUTPUT_EMU:
-          dataFromHostSize*=4;
-          if(dataFromHost[0]&JTAG_DATA_MASK)
-            dataFromHostSize-=(4- ((dataFromHost[0]&JTAG_DATA_MASK)>>4));
-          
-          dataToHostSize=jtag_tap_output_emu(&dataFromHost[1], dataFromHostSize, dataToHost);
-          
-          break;
-          
-        case JTAG_CMD_READ_INPUT:
-          dataToHost[0]=jtag_read_input();
-          dataToHostSize=1;
-          break;
-        
-        case JTAG_CMD_SET_SRST:
-          jtag_set_srst(dataFromHost[1]&1);
-          dataToHost[0]=0;//TODO: what to output here?
-          dataToHostSize=1;
-          break;
-        
-        case JTAG_CMD_SET_TRST:
-          jtag_set_trst(dataFromHost[1]&1);
-          dataToHost[0]=0;//TODO: what to output here?
-          dataToHostSize=1;
-          break;
-        
-        case JTAG_CMD_SET_DELAY:
-          jtag_delay=dataFromHost[1]*256+dataFromHost[2];
-          dataToHost[0]=0;//TODO: what to output here?
-          dataToHostSize=1;
-
-        case JTAG_CMD_SET_SRST_TRST:
-          jtag_set_trst_srst(dataFromHost[1]&2?1:0,dataFromHost[1]&1);
-          dataToHost[0]=0;//TODO: what to output here?
-          dataToHostSize=1;
-        
-        default: //REPORT ERROR?
-          break;
-        }
+        dataFromHostSize[dataFromHostIn]=size;
+
+        if(++dataFromHostIn==JTAG_COMMAND_QUEUE_DEPTH)
+          dataFromHostIn=0;
+
+        dataFromHostCount++;
+      }
+    }
+
+    //run the oldest command once there is room for its reply, replies leave in command order
+    if (dataFromHostCount && dataToHostCount<2)
+    {
+      uint8_t size=jtag_process_command(dataFromHost[dataFromHostOut],dataFromHostSize[dataFromHostOut],
+                                        dataToHost[dataToHostIn]);
+
+      if(size)
+      {
+        dataToHostSize[dataToHostIn]=size;
+        dataToHostIn^=1;
+        dataToHostCount++;
       }
+
+      if(++dataFromHostOut==JTAG_COMMAND_QUEUE_DEPTH)
+        dataFromHostOut=0;
+
+      dataFromHostCount--;
     }
 	}
 }
@@ -27,6 +27,14 @@
 	#include <LUFA/Scheduler/Scheduler.h>		// Simple scheduler for task management
 
 	/* Macros: */
+		//the 176 byte USB DPRAM of the AT90USBxx2 cannot double bank both 64 byte endpoints, nor hold a deep queue in 512 bytes of RAM
+		#if (defined(__AVR_AT90USB82__) || defined(__AVR_AT90USB162__))
+			#define JTAG_EP_BANKS             ENDPOINT_BANK_SINGLE
+			#define JTAG_COMMAND_QUEUE_DEPTH  2
+		#else
+			#define JTAG_EP_BANKS             ENDPOINT_BANK_DOUBLE
+			#define JTAG_COMMAND_QUEUE_DEPTH  4
+		#endif
 
 	/* Type Defines: */
 
@@ -27,6 +27,21 @@
 	#define JTAG_CMD_TAP_OUTPUT_EMU 0x4
 	#define JTAG_CMD_SET_DELAY      0x5
 	#define JTAG_CMD_SET_SRST_TRST  0x6
+	#define JTAG_CMD_TAP_SHIFT      0x7
+	#define JTAG_CMD_TAP_SHIFT_TMS  0x8
+	#define JTAG_CMD_BATCH          0x9
+
+	//JTAG_CMD_TAP_SHIFT:     [cmd|flags] [bits lo] [bits hi] [TDI bytes, LSB first] -> TDO bytes, LSB first
+	//                        TMS is held at one level for the whole run, a DR/IR scan with no per bit TMS data
+	//JTAG_CMD_TAP_SHIFT_TMS: [cmd|flags] [bits] [TMS bytes, LSB first]              -> TDO bytes, LSB first
+	//                        TDI is held at one level, used for TAP state transitions
+	//TDO is sampled after the falling TCK edge, the same as for JTAG_CMD_TAP_OUTPUT
+	//JTAG_CMD_BATCH:         [cmd] ([length] [command, length bytes])...            -> replies of all commands back to back
+	//                        many scans in one packet, commands without a reply add nothing and batches do not nest
+
+	//JTAG_CMD_TAP_SHIFT/JTAG_CMD_TAP_SHIFT_TMS flags, stored in the JTAG_DATA_MASK bits of the command byte
+	#define JTAG_SHIFT_LEVEL    0x10 //level of the held signal - TMS for TAP_SHIFT, TDI for TAP_SHIFT_TMS
+	#define JTAG_SHIFT_EXIT     0x20 //TAP_SHIFT only: raise TMS on the last bit to leave Shift-DR/Shift-IR
 
 	//JTAG usb command mask
 	#define JTAG_CMD_MASK       0x0f
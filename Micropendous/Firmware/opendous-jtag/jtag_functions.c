@@ -23,38 +23,40 @@ void jtag_init(void)
 uint8_t jtag_tap_output_max_speed(const uint8_t *out_buffer, uint16_t out_length, uint8_t *in_buffer)
 {
   uint16_t i;
+  uint8_t  taps=0;
+  uint8_t  tdo=0;
   
 #ifdef      DEBUG
-  printf("Sending %d bits \r\n", dataFromHostSize);
+  printf("Sending %d bits \r\n", out_length);
 #endif
   
   for(i=0 ; i<out_length ; i++ )
   {
-    uint8_t index=i/4;
-    uint8_t bit=  (i%4)*2;
-
-    uint8_t index2=i/8;
-    uint8_t bit2=  i%8;
-
-    uint8_t tdi=(out_buffer[index]>>bit    )&1;
-    uint8_t tms=(out_buffer[index]>>(bit+1))&1;
+    //four TDI/TMS pairs per byte, consumed from the lowest bits up
+    if(!(i&3))
+      taps=*out_buffer++;
 
     JTAG_OUT = ( JTAG_OUT & ( ~JTAG_SIGNAL_MASK ) )
-               | (tdi<<JTAG_PIN_TDI)
-               | (tms<<JTAG_PIN_TMS);
+               | ((taps&1)<<JTAG_PIN_TDI)
+               | (((taps>>1)&1)<<JTAG_PIN_TMS);
 
     JTAG_OUT|=JTAG_CLK_HI;//CLK hi
 
-    asm("nop");
+    taps>>=2;
 
     JTAG_OUT&=JTAG_CLK_LO;//CLK lo
-    uint8_t data=JTAG_IN;
-    
-    if(!bit2)
-      in_buffer[index2]=0;
-    
-    in_buffer[index2] |= ((data>>JTAG_PIN_TDO)&1)<<bit2;
+
+    tdo>>=1;
+    if(JTAG_IN&(1<<JTAG_PIN_TDO))
+      tdo|=0x80;
+
+    if((i&7)==7)
+      *in_buffer++=tdo;
   }
+
+  //align the last partial byte to bit 0
+  if(out_length&7)
+    *in_buffer=tdo>>(8-(out_length&7));
   
   return (out_length+7)/8;
 }
@@ -67,39 +69,40 @@ uint8_t jtag_tap_output_max_speed(const uint8_t *out_buffer, uint16_t out_length
 uint8_t jtag_tap_output_with_delay(const uint8_t *out_buffer, uint16_t out_length, uint8_t *in_buffer)
 {
   uint16_t i;
+  uint8_t  taps=0;
+  uint8_t  tdo=0;
   
 #ifdef      DEBUG
-  printf("Sending %d bits \r\n", dataFromHostSize);
+  printf("Sending %d bits \r\n", out_length);
 #endif
   
   for(i=0 ; i<out_length ; i++ )
   {
-    uint8_t index=i/4;
-    uint8_t bit=  (i%4)*2;
-
-    uint8_t index2=i/8;
-    uint8_t bit2=  i%8;
-
-    uint8_t tdi=(out_buffer[index]>>bit    )&1;
-    uint8_t tms=(out_buffer[index]>>(bit+1))&1;
+    if(!(i&3))
+      taps=*out_buffer++;
 
     JTAG_OUT = ( JTAG_OUT & ( ~JTAG_SIGNAL_MASK ) )
-               | (tdi<<JTAG_PIN_TDI)
-               | (tms<<JTAG_PIN_TMS);
+               | ((taps&1)<<JTAG_PIN_TDI)
+               | (((taps>>1)&1)<<JTAG_PIN_TMS);
+    taps>>=2;
 
     JTAG_OUT|=JTAG_CLK_HI;//CLK hi
     _delay_loop_2(jtag_delay);
 
     JTAG_OUT&=JTAG_CLK_LO;//CLK lo
 
-		_delay_loop_2(jtag_delay);
-    uint8_t data=JTAG_IN;
-    
-    if(!bit2)
-      in_buffer[index2]=0;
-    
-    in_buffer[index2] |= ((data>>JTAG_PIN_TDO)&1)<<bit2;
+    _delay_loop_2(jtag_delay);
+
+    tdo>>=1;
+    if(JTAG_IN&(1<<JTAG_PIN_TDO))
+      tdo|=0x80;
+
+    if((i&7)==7)
+      *in_buffer++=tdo;
   }
+
+  if(out_length&7)
+    *in_buffer=tdo>>(8-(out_length&7));
   
   return (out_length+7)/8;
 }
@@ -113,18 +116,18 @@ uint8_t jtag_tap_output_with_delay(const uint8_t *out_buffer, uint16_t out_lengt
 uint8_t jtag_tap_output_emu(const uint8_t *out_buffer,uint16_t out_length,uint8_t *in_buffer)
 {
   uint16_t i;
+  uint8_t  taps=0;
+  uint8_t  input=0;
   
   for(i=0 ; i<out_length ; i++ )
   {
-    uint8_t index=i/4;
-    uint8_t bit=(i%4)*2;
-
-    uint8_t tdi=(out_buffer[index]>>bit)&1;
-    uint8_t tms=(out_buffer[index]>>(bit+1))&1;
+    if(!(i&3))
+      taps=*out_buffer++;
 
     JTAG_OUT = ( JTAG_OUT & ( ~JTAG_SIGNAL_MASK ) )
-        | (tdi<<JTAG_PIN_TDI)
-        | (tms<<JTAG_PIN_TMS);
+        | ((taps&1)<<JTAG_PIN_TDI)
+        | (((taps>>1)&1)<<JTAG_PIN_TMS);
+    taps>>=2;
 
     if(jtag_delay>0) _delay_loop_2(jtag_delay);
 
@@ -134,16 +137,161 @@ uint8_t jtag_tap_output_emu(const uint8_t *out_buffer,uint16_t out_length,uint8_
 
     JTAG_OUT&=JTAG_CLK_LO;//CLK lo
     uint8_t data=JTAG_IN;
-    
-    if(!bit)
-      in_buffer[index]=0;
-    
-    in_buffer[index] |= ((data>>JTAG_PIN_TDO)&1)<<(bit) |
-       ((data>>JTAG_PIN_EMU)&1)<<(bit+1);
+
+    //TDO/EMU pairs are packed the same way as the TDI/TMS pairs
+    input>>=2;
+    input|= (((data>>JTAG_PIN_TDO)&1)<<6) |
+            (((data>>JTAG_PIN_EMU)&1)<<7);
+
+    if((i&3)==3)
+      *in_buffer++=input;
   }
+
+  if(out_length&3)
+    *in_buffer=input>>((4-(out_length&3))*2);
+
   return (out_length+3)/4;
 }
 
+//! clock a single TCK cycle, honouring jtag_delay
+//! \parameter out - value for JTAG_OUT with TCK low and TDI/TMS already set
+//! \return    level of TDO after the falling TCK edge
+static uint8_t jtag_clock(uint8_t out)
+{
+  JTAG_OUT=out;
+  if(jtag_delay>0) _delay_loop_2(jtag_delay);
+
+  JTAG_OUT|=JTAG_CLK_HI;//CLK hi
+  if(jtag_delay>0) _delay_loop_2(jtag_delay);
+
+  JTAG_OUT&=JTAG_CLK_LO;//CLK lo
+  return (JTAG_IN>>JTAG_PIN_TDO)&1;
+}
+
+//! clock up to 8 bits of one signal LSB first through the TAP, one bit per jtag_clock()
+//! \parameter out   - value for JTAG_OUT with TCK and the shifted signal low
+//! \parameter mask  - JTAG_OUT bit of the shifted signal (TDI or TMS)
+//! \parameter bits  - bits to shift out
+//! \parameter count - number of bits to shift
+//! \return    TDO bits, LSB first
+static uint8_t jtag_clock_bits(uint8_t out, uint8_t mask, uint8_t bits, uint8_t count)
+{
+  uint8_t tdo=0;
+  uint8_t bit;
+
+  for(bit=0 ; bit<count ; bit++ )
+  {
+    tdo|=jtag_clock((bits&1)?(out|mask):out)<<bit;
+    bits>>=1;
+  }
+
+  return tdo;
+}
+
+//! shift one whole byte LSB first through TDI at full speed, the 8 TCK cycles are unrolled
+//! \parameter out - value for JTAG_OUT with TCK and TDI low and TMS at the level for the run
+//! \parameter tdi - byte to shift out
+//! \return    TDO byte, LSB first
+static inline uint8_t jtag_shift_byte(uint8_t out, uint8_t tdi)
+{
+  uint8_t tdo=0;
+
+#define JTAG_SHIFT_BIT()                      \
+  JTAG_OUT = out | ((tdi&1)<<JTAG_PIN_TDI);   \
+  JTAG_OUT|=JTAG_CLK_HI;                      \
+  tdi>>=1;                                    \
+  JTAG_OUT&=JTAG_CLK_LO;                      \
+  tdo>>=1;                                    \
+  if(JTAG_IN&(1<<JTAG_PIN_TDO))               \
+    tdo|=0x80;
+
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+  JTAG_SHIFT_BIT();
+
+#undef JTAG_SHIFT_BIT
+
+  return tdo;
+}
+
+//! shift a run of bits through TDI with TMS held at one level, TDO is recieved the same way
+//! \parameter tdi_buffer - bits for TDI, LSB of the first byte goes out first
+//! \parameter bit_length - number of TCK cycles
+//! \parameter flags      - JTAG_SHIFT_LEVEL for TMS high during the run, JTAG_SHIFT_EXIT to raise TMS on the last bit
+//! \parameter tdo_buffer - buffer which will hold the TDO bits, packed like tdi_buffer
+//! \return    number of bytes used in the tdo_buffer
+uint8_t jtag_tap_shift(const uint8_t *tdi_buffer, uint16_t bit_length, uint8_t flags, uint8_t *tdo_buffer)
+{
+  uint8_t  out=(JTAG_OUT&~(JTAG_SIGNAL_MASK|JTAG_CLK_HI)) |
+               ((flags&JTAG_SHIFT_LEVEL)?(1<<JTAG_PIN_TMS):0);
+  uint16_t run=bit_length;
+  uint8_t  bytes;
+  uint8_t  i;
+
+  if(!bit_length)
+    return 0;
+
+  //the exit bit has its own TMS level, so it is always clocked on its own
+  if(flags&JTAG_SHIFT_EXIT)
+    run--;
+
+  bytes=run/8;
+
+  if(jtag_delay)
+  {
+    for(i=0 ; i<bytes ; i++ )
+      tdo_buffer[i]=jtag_clock_bits(out,(1<<JTAG_PIN_TDI),tdi_buffer[i],8);
+  }
+  else
+  {
+    for(i=0 ; i<bytes ; i++ )
+      tdo_buffer[i]=jtag_shift_byte(out,tdi_buffer[i]);
+  }
+
+  if(bit_length>bytes*8)
+  {
+    uint8_t tdi=tdi_buffer[bytes];
+    uint8_t tail=run&7;
+    uint8_t tdo=jtag_clock_bits(out,(1<<JTAG_PIN_TDI),tdi,tail);
+
+    if(flags&JTAG_SHIFT_EXIT)
+      tdo|=jtag_clock(out|(1<<JTAG_PIN_TMS)|(((tdi>>tail)&1)<<JTAG_PIN_TDI))<<tail;
+
+    tdo_buffer[bytes]=tdo;
+  }
+
+  return (bit_length+7)/8;
+}
+
+//! clock a TMS sequence through the TAP with TDI held at one level, used for state transitions
+//! \parameter tms_buffer - bits for TMS, LSB of the first byte goes out first
+//! \parameter bit_length - number of TCK cycles
+//! \parameter flags      - JTAG_SHIFT_LEVEL for TDI high during the sequence
+//! \parameter tdo_buffer - buffer which will hold the TDO bits, packed like tms_buffer
+//! \return    number of bytes used in the tdo_buffer
+uint8_t jtag_tap_shift_tms(const uint8_t *tms_buffer, uint8_t bit_length, uint8_t flags, uint8_t *tdo_buffer)
+{
+  uint8_t out=(JTAG_OUT&~(JTAG_SIGNAL_MASK|JTAG_CLK_HI)) |
+              ((flags&JTAG_SHIFT_LEVEL)?(1<<JTAG_PIN_TDI):0);
+  uint8_t bits=bit_length;
+  uint8_t i;
+
+  for(i=0 ; bits ; i++ )
+  {
+    uint8_t count=(bits>8)?8:bits;
+
+    tdo_buffer[i]=jtag_clock_bits(out,(1<<JTAG_PIN_TMS),tms_buffer[i],count);
+    bits-=count;
+  }
+
+  return (bit_length+7)/8;
+}
+
 //! return current status of TDO & EMU pins
 //! \return packed result TDO - bit 0 , EMU bit 1
 uint8_t jtag_read_input(void)
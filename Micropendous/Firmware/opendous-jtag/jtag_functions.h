@@ -26,6 +26,22 @@
 	//! \return    number of bytes used in the in_buffer (equal to the input (length+3)/4
 	uint8_t jtag_tap_output_emu(const uint8_t *out_buffer,uint16_t out_length,uint8_t *in_buffer);
 
+	//! shift a run of bits through TDI with TMS held at one level, TDO is recieved the same way
+	//! \parameter tdi_buffer - bits for TDI, LSB of the first byte goes out first
+	//! \parameter bit_length - number of TCK cycles (maximum length is 8*255 bits)
+	//! \parameter flags      - JTAG_SHIFT_LEVEL for TMS high during the run, JTAG_SHIFT_EXIT to raise TMS on the last bit
+	//! \parameter tdo_buffer - buffer which will hold the TDO bits, packed like tdi_buffer
+	//! \return    number of bytes used in the tdo_buffer
+	uint8_t jtag_tap_shift(const uint8_t *tdi_buffer, uint16_t bit_length, uint8_t flags, uint8_t *tdo_buffer);
+
+	//! clock a TMS sequence through the TAP with TDI held at one level, used for state transitions
+	//! \parameter tms_buffer - bits for TMS, LSB of the first byte goes out first
+	//! \parameter bit_length - number of TCK cycles
+	//! \parameter flags      - JTAG_SHIFT_LEVEL for TDI high during the sequence
+	//! \parameter tdo_buffer - buffer which will hold the TDO bits, packed like tms_buffer
+	//! \return    number of bytes used in the tdo_buffer
+	uint8_t jtag_tap_shift_tms(const uint8_t *tms_buffer, uint8_t bit_length, uint8_t flags, uint8_t *tdo_buffer);
+
 
 	//! return current status of TDO & EMU pins
 	//! \return packed result TDO - bit 0 , EMU bit 1
@@ -282,7 +282,7 @@ unsigned portBASE_TYPE uxPriority = queuesetMEDIUM_PRIORITY, ulLoops = 0;
 	/* Remove compiler warning about the unused parameter. */
 	( void ) pvParameters;
 
-	srand( ( unsigned int ) &ulTaskTxValue );
+	srand( ( unsigned int ) ( portPOINTER_SIZE_TYPE ) &ulTaskTxValue );
 
 	for( ;; )
 	{
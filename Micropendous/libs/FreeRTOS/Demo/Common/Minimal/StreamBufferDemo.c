@@ -0,0 +1,477 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+
+/*
+ * Tests the stream and message buffers.
+ *
+ * Two tasks pass a sequence of bytes through a stream buffer.  The sending
+ * task has the higher priority, so it fills the buffer and then blocks waiting
+ * for space.  The receiving task reads blocks of a different length to the
+ * blocks being written, so the data keeps wrapping around the end of the
+ * buffer's storage.  Both tasks alternate between the copying functions and
+ * the functions that work on the buffer in place.
+ *
+ * Two more tasks pass messages through a message buffer.  Here the receiving
+ * task has the higher priority, so it blocks waiting for each message.  The
+ * messages cycle through every length from one byte up to the longest message
+ * the buffer accepts.  The sending task also checks that a message one byte
+ * longer than that is rejected at once, even though a block time is given.
+ * The receiving task checks that a message is left in the buffer when the
+ * buffer it is read into is too short for it.
+ *
+ * An error is latched if any data arrives out of sequence, if a message has
+ * the wrong length or contents, or if a call that should have been unblocked
+ * times out instead.
+ */
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "message_buffer.h"
+
+/* Demo program include files. */
+#include "StreamBufferDemo.h"
+
+/* Priorities of the tasks.  The stream buffer sender and the message buffer
+receiver have the higher priority, so that both a writer and a reader get to
+block. */
+#define sbLOWER_PRIORITY			( tskIDLE_PRIORITY )
+#define sbHIGHER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+
+/* Capacity of the buffers.  Neither is a multiple of the block lengths used,
+so the data wraps at a different point on each pass. */
+#define sbSTREAM_BUFFER_SIZE		( ( size_t ) 29 )
+#define sbMESSAGE_BUFFER_SIZE		( ( size_t ) 70 )
+
+/* A message is stored after a length field, and can be at most half the size
+of the buffer less the length field - see message_buffer.h. */
+#define sbMAX_MESSAGE_LENGTH		( ( sbMESSAGE_BUFFER_SIZE / ( size_t ) 2 ) - sizeof( size_t ) )
+
+/* The longest blocks written to and read from the stream buffer. */
+#define sbMAX_WRITE_LENGTH			( ( size_t ) 23 )
+#define sbMAX_READ_LENGTH			( ( size_t ) 17 )
+
+/* Time after which a task blocked on a buffer is assumed to have missed being
+unblocked. */
+#define sbBLOCK_TIME				( ( portTickType ) 1000 / portTICK_RATE_MS )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks that write to and read from the stream buffer.
+ */
+static void prvStreamSenderTask( void *pvParameters );
+static void prvStreamReceiverTask( void *pvParameters );
+
+/*
+ * The tasks that write to and read from the message buffer.
+ */
+static void prvMessageSenderTask( void *pvParameters );
+static void prvMessageReceiverTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The buffers used by the tasks. */
+static xStreamBufferHandle xStreamBuffer = NULL;
+static xMessageBufferHandle xMessageBuffer = NULL;
+
+/* Flag that will be latched to pdTRUE should any unexpected behaviour be
+detected in any of the tasks. */
+static volatile portBASE_TYPE xErrorDetected = pdFALSE;
+
+/* Incremented by the receiving tasks each time they have checked a block of
+data or a message.  Used to detect a stalled task. */
+static volatile unsigned portBASE_TYPE uxStreamCycles = 0, uxMessageCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartStreamBufferTasks( void )
+{
+	xStreamBuffer = xStreamBufferCreate( sbSTREAM_BUFFER_SIZE, 1 );
+	xMessageBuffer = xMessageBufferCreate( sbMESSAGE_BUFFER_SIZE );
+
+	if( ( xStreamBuffer != NULL ) && ( xMessageBuffer != NULL ) )
+	{
+		xTaskCreate( prvStreamSenderTask, ( signed char * ) "StrTx", configMINIMAL_STACK_SIZE, NULL, sbHIGHER_PRIORITY, NULL );
+		xTaskCreate( prvStreamReceiverTask, ( signed char * ) "StrRx", configMINIMAL_STACK_SIZE, NULL, sbLOWER_PRIORITY, NULL );
+		xTaskCreate( prvMessageSenderTask, ( signed char * ) "MsgTx", configMINIMAL_STACK_SIZE, NULL, sbLOWER_PRIORITY, NULL );
+		xTaskCreate( prvMessageReceiverTask, ( signed char * ) "MsgRx", configMINIMAL_STACK_SIZE, NULL, sbHIGHER_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamSenderTask( void *pvParameters )
+{
+static unsigned char ucTxData[ sbMAX_WRITE_LENGTH ];
+unsigned char *pucData, ucNextByte = 0;
+size_t xLength = 0, xRemaining, xSpace, x;
+portBASE_TYPE xInPlace = pdFALSE;
+
+	/* The parameters are not used. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Write blocks of every length from one byte up to sbMAX_WRITE_LENGTH,
+		which is most of the buffer, so the buffer is often too full to take
+		the next block and this task has to block. */
+		xLength = ( xLength % sbMAX_WRITE_LENGTH ) + ( size_t ) 1;
+
+		if( xInPlace == pdFALSE )
+		{
+			for( x = 0; x < xLength; x++ )
+			{
+				ucTxData[ x ] = ucNextByte++;
+			}
+
+			/* The whole block should be written once the receiving task has
+			made room for it. */
+			if( xStreamBufferSend( xStreamBuffer, ucTxData, xLength, sbBLOCK_TIME ) != xLength )
+			{
+				xErrorDetected = pdTRUE;
+			}
+		}
+		else
+		{
+			/* The free space can be split across the end of the storage, so
+			write the block a contiguous part at a time. */
+			for( xRemaining = xLength; xRemaining > ( size_t ) 0; xRemaining -= xSpace )
+			{
+				xSpace = xStreamBufferWriteAcquire( xStreamBuffer, ( void ** ) &pucData, xRemaining, sbBLOCK_TIME );
+
+				if( xSpace == ( size_t ) 0 )
+				{
+					xErrorDetected = pdTRUE;
+					break;
+				}
+
+				if( xSpace > xRemaining )
+				{
+					xSpace = xRemaining;
+				}
+
+				for( x = 0; x < xSpace; x++ )
+				{
+					pucData[ x ] = ucNextByte++;
+				}
+
+				vStreamBufferWriteCommit( xStreamBuffer, xSpace );
+			}
+		}
+
+		xInPlace = !xInPlace;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamReceiverTask( void *pvParameters )
+{
+static unsigned char ucRxData[ sbMAX_READ_LENGTH ];
+unsigned char *pucData, ucExpectedByte = 0;
+size_t xLength = 0, xReceived, x;
+portBASE_TYPE xInPlace = pdFALSE;
+
+	/* The parameters are not used. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xLength = ( xLength % sbMAX_READ_LENGTH ) + ( size_t ) 1;
+
+		if( xInPlace == pdFALSE )
+		{
+			xReceived = xStreamBufferReceive( xStreamBuffer, ucRxData, xLength, sbBLOCK_TIME );
+			pucData = ucRxData;
+		}
+		else
+		{
+			/* Only the data before the end of the storage is returned, the
+			rest is read on a later pass. */
+			xReceived = xStreamBufferReadAcquire( xStreamBuffer, ( void ** ) &pucData, sbBLOCK_TIME );
+
+			if( xReceived > xLength )
+			{
+				xReceived = xLength;
+			}
+		}
+
+		/* The sending task keeps the buffer supplied, so there should always
+		be data - though not necessarily as much as was asked for. */
+		if( ( xReceived == ( size_t ) 0 ) || ( xReceived > xLength ) )
+		{
+			xErrorDetected = pdTRUE;
+		}
+
+		for( x = 0; x < xReceived; x++ )
+		{
+			if( pucData[ x ] != ucExpectedByte )
+			{
+				xErrorDetected = pdTRUE;
+
+				/* Resynchronise with the sending task. */
+				ucExpectedByte = pucData[ x ];
+			}
+
+			ucExpectedByte++;
+		}
+
+		if( xInPlace != pdFALSE )
+		{
+			vStreamBufferReadRelease( xStreamBuffer, xReceived );
+		}
+
+		xInPlace = !xInPlace;
+
+		if( xErrorDetected == pdFALSE )
+		{
+			uxStreamCycles++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessageSenderTask( void *pvParameters )
+{
+static unsigned char ucTxData[ sbMAX_MESSAGE_LENGTH + 1 ];
+unsigned char *pucData, ucSequence = 0;
+size_t xLength = 0, x;
+portBASE_TYPE xInPlace = pdFALSE;
+portTickType xTimeBefore;
+
+	/* The parameters are not used. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Send messages of every length from one byte up to the longest the
+		buffer accepts.  Each byte of a message is derived from its sequence
+		number, so the receiving task can tell if a message was lost. */
+		xLength = ( xLength % sbMAX_MESSAGE_LENGTH ) + ( size_t ) 1;
+
+		if( xInPlace == pdFALSE )
+		{
+			for( x = 0; x < xLength; x++ )
+			{
+				ucTxData[ x ] = ( unsigned char ) ( ucSequence + x );
+			}
+
+			if( xMessageBufferSend( xMessageBuffer, ucTxData, xLength, sbBLOCK_TIME ) != xLength )
+			{
+				xErrorDetected = pdTRUE;
+			}
+		}
+		else
+		{
+			/* A message is always given contiguous space. */
+			if( xMessageBufferWriteAcquire( xMessageBuffer, ( void ** ) &pucData, xLength, sbBLOCK_TIME ) != xLength )
+			{
+				xErrorDetected = pdTRUE;
+			}
+			else
+			{
+				for( x = 0; x < xLength; x++ )
+				{
+					pucData[ x ] = ( unsigned char ) ( ucSequence + x );
+				}
+
+				vMessageBufferWriteCommit( xMessageBuffer, xLength );
+			}
+		}
+
+		ucSequence++;
+		xInPlace = !xInPlace;
+
+		/* Once per cycle of lengths, check that a message too long for the
+		buffer is rejected without waiting for space that can never be
+		found. */
+		if( xLength == sbMAX_MESSAGE_LENGTH )
+		{
+			xTimeBefore = xTaskGetTickCount();
+
+			if( xMessageBufferSend( xMessageBuffer, ucTxData, sbMAX_MESSAGE_LENGTH + 1, sbBLOCK_TIME ) != ( size_t ) 0 )
+			{
+				xErrorDetected = pdTRUE;
+			}
+
+			if( xMessageBufferWriteAcquire( xMessageBuffer, ( void ** ) &pucData, sbMAX_MESSAGE_LENGTH + 1, sbBLOCK_TIME ) != ( size_t ) 0 )
+			{
+				xErrorDetected = pdTRUE;
+			}
+
+			if( ( xTaskGetTickCount() - xTimeBefore ) >= sbBLOCK_TIME )
+			{
+				xErrorDetected = pdTRUE;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessageReceiverTask( void *pvParameters )
+{
+static unsigned char ucRxData[ sbMAX_MESSAGE_LENGTH ];
+unsigned char *pucData, ucSequence = 0;
+size_t xLength = 0, xReceived, x;
+portBASE_TYPE xInPlace = pdFALSE;
+
+	/* The parameters are not used. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xLength = ( xLength % sbMAX_MESSAGE_LENGTH ) + ( size_t ) 1;
+
+		if( xInPlace == pdFALSE )
+		{
+			/* Wait for the message with a buffer one byte too short for it,
+			which should leave the message where it is... */
+			if( xMessageBufferReceive( xMessageBuffer, ucRxData, xLength - ( size_t ) 1, sbBLOCK_TIME ) != ( size_t ) 0 )
+			{
+				xErrorDetected = pdTRUE;
+			}
+
+			/* ...to be read whole with a buffer that is long enough. */
+			xReceived = xMessageBufferReceive( xMessageBuffer, ucRxData, sizeof( ucRxData ), 0 );
+			pucData = ucRxData;
+		}
+		else
+		{
+			xReceived = xMessageBufferReadAcquire( xMessageBuffer, ( void ** ) &pucData, sbBLOCK_TIME );
+		}
+
+		if( xReceived != xLength )
+		{
+			xErrorDetected = pdTRUE;
+		}
+		else
+		{
+			for( x = 0; x < xReceived; x++ )
+			{
+				if( pucData[ x ] != ( unsigned char ) ( ucSequence + x ) )
+				{
+					xErrorDetected = pdTRUE;
+				}
+			}
+		}
+
+		if( ( xInPlace != pdFALSE ) && ( xReceived != ( size_t ) 0 ) )
+		{
+			vMessageBufferReadRelease( xMessageBuffer );
+		}
+
+		ucSequence++;
+		xInPlace = !xInPlace;
+
+		if( xErrorDetected == pdFALSE )
+		{
+			uxMessageCycles++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xAreStreamBufferTasksStillRunning( void )
+{
+static unsigned portBASE_TYPE uxLastStreamCycles = 0, uxLastMessageCycles = 0;
+portBASE_TYPE xReturn = pdPASS;
+
+	/* Return fail if any data or message was not as expected. */
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	/* Return fail if either receiving task has stopped receiving. */
+	if( uxLastStreamCycles == uxStreamCycles )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		uxLastStreamCycles = uxStreamCycles;
+	}
+
+	if( uxLastMessageCycles == uxMessageCycles )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		uxLastMessageCycles = uxMessageCycles;
+	}
+
+	return xReturn;
+}
+
@@ -1019,8 +1019,12 @@ portTickType xMargin;
 static void prvAutoReloadTimerCallback( xTimerHandle pxExpiredTimer )
 {
 unsigned long ulTimerID;
+void *pvTimerID;
 
-	ulTimerID = ( unsigned long ) pvTimerGetTimerID( pxExpiredTimer );
+	/* The ID holds an index rather than a pointer, so convert it through an
+	integer type as wide as a pointer. */
+	pvTimerID = pvTimerGetTimerID( pxExpiredTimer );
+	ulTimerID = ( unsigned long ) ( portPOINTER_SIZE_TYPE ) pvTimerID;
 	if( ulTimerID <= ( configTIMER_QUEUE_LENGTH + 1 ) )
 	{
 		( ucAutoReloadTimerCounters[ ulTimerID ] )++;
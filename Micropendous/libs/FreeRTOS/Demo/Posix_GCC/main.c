@@ -0,0 +1,335 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+/*
+ * Creates the standard demo application tasks, then starts the scheduler on
+ * the host.  This demo exercises the Posix port, and gives a repeatable
+ * kernel workload to profile on a PC with perf or valgrind.
+ *
+ * Main.c also creates a task called "Check".  This only executes every three
+ * seconds but has the highest priority so is guaranteed to get processor time.
+ * Its main function is to check that all the other tasks are still
+ * operational.  Each standard demo task maintains a unique count that is
+ * incremented each time the task successfully completes its function.  Should
+ * any error occur within such a task the count is permanently halted.  The
+ * check task inspects the count of each task to ensure it has changed since
+ * the last time the check task executed, and prints the result.
+ *
+ * The check task stops the scheduler once it has run the number of times given
+ * on the command line - mainDEFAULT_CHECK_CYCLES times if none is given, or
+ * for ever if the number is zero - and the demo then exits with a status of
+ * zero if no error was ever found, or one if an error was found.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo file headers. */
+#include "BlockQ.h"
+#include "PollQ.h"
+#include "semtest.h"
+#include "death.h"
+#include "dynamic.h"
+#include "integer.h"
+#include "flop.h"
+#include "recmutex.h"
+#include "countsem.h"
+#include "GenQTest.h"
+#include "QPeek.h"
+#include "blocktim.h"
+#include "QueueSet.h"
+#include "TimerDemo.h"
+#include "StreamBufferDemo.h"
+
+/* Priority definitions for most of the tasks in the demo application.  Some
+tasks just use the idle priority. */
+#define mainQUEUE_POLL_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define mainBLOCK_Q_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define mainSEM_TEST_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define mainGEN_QUEUE_TASK_PRIORITY		( tskIDLE_PRIORITY )
+#define mainCREATOR_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
+#define mainCHECK_TASK_PRIORITY			( configMAX_PRIORITIES - 1 )
+
+/* The period between executions of the check task. */
+#define mainCHECK_PERIOD				( ( portTickType ) 3000 / portTICK_RATE_MS )
+
+/* Base period of the software timer demo. */
+#define mainTIMER_TEST_PERIOD			( ( portTickType ) 50 / portTICK_RATE_MS )
+
+/* Number of times the check task runs before the scheduler is stopped, if no
+number is given on the command line. */
+#define mainDEFAULT_CHECK_CYCLES		( 5UL )
+
+/*
+ * The task function for the "Check" task.
+ */
+static void vErrorChecks( void *pvParameters );
+
+/*
+ * Checks the unique counts of other tasks to ensure they are still operational.
+ * Returns pdTRUE if everything is okay.
+ */
+static portBASE_TYPE prvCheckOtherTasksAreStillRunning( void );
+
+/*
+ * The tick hook drives the ISR parts of the timer and queue set demos.
+ */
+void vApplicationTickHook( void );
+
+/*-----------------------------------------------------------*/
+
+/* Number of times the check task runs before stopping the scheduler. */
+static unsigned long ulCheckCycles = mainDEFAULT_CHECK_CYCLES;
+
+/* Set by the check task if an error was ever found. */
+static portBASE_TYPE xErrorHasOccurred = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+	if( argc > 1 )
+	{
+		ulCheckCycles = strtoul( argv[ 1 ], NULL, 0 );
+	}
+
+	/* Create the standard demo tasks. */
+	vStartIntegerMathTasks( tskIDLE_PRIORITY );
+	vStartMathTasks( tskIDLE_PRIORITY );
+	vStartPolledQueueTasks( mainQUEUE_POLL_PRIORITY );
+	vStartBlockingQueueTasks( mainBLOCK_Q_PRIORITY );
+	vStartSemaphoreTasks( mainSEM_TEST_PRIORITY );
+	vStartDynamicPriorityTasks();
+	vStartRecursiveMutexTasks();
+	vStartCountingSemaphoreTasks();
+	vStartGenericQueueTasks( mainGEN_QUEUE_TASK_PRIORITY );
+	vStartQueuePeekTasks();
+	vCreateBlockTimeTasks();
+	vStartQueueSetTasks();
+	vStartTimerDemoTask( mainTIMER_TEST_PERIOD );
+	vStartStreamBufferTasks();
+
+	/* Create the tasks defined within this file. */
+	xTaskCreate( vErrorChecks, ( signed char * ) "Check", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
+
+	/* The suicide tasks must be created last as they need to know how many
+	tasks were running prior to their creation in order to ascertain whether
+	or not the correct/expected number of tasks are running at any given time. */
+	vCreateSuicidalTasks( mainCREATOR_TASK_PRIORITY );
+
+	vTaskStartScheduler();
+
+	/* Only get here once the check task has stopped the scheduler. */
+	return ( xErrorHasOccurred == pdFALSE ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+/*-----------------------------------------------------------*/
+
+static void vErrorChecks( void *pvParameters )
+{
+portTickType xLastWakeTime = xTaskGetTickCount();
+unsigned long ulCycle = 0;
+
+	/* The parameters are not used. */
+	( void ) pvParameters;
+
+	/* Cycle for ever, delaying then checking all the other tasks are still
+	operating without error. */
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, mainCHECK_PERIOD );
+
+		if( prvCheckOtherTasksAreStillRunning() != pdTRUE )
+		{
+			xErrorHasOccurred = pdTRUE;
+		}
+
+		ulCycle++;
+
+		/* The other tasks share the host thread and its stdio state, so
+		print from inside a critical section. */
+		taskENTER_CRITICAL();
+		{
+			printf( "Check %lu at tick %lu: %s\n", ulCycle, ( unsigned long ) xTaskGetTickCount(), ( xErrorHasOccurred == pdFALSE ) ? "PASS" : "FAIL" );
+			fflush( stdout );
+		}
+		taskEXIT_CRITICAL();
+
+		if( ulCycle == ulCheckCycles )
+		{
+			vTaskEndScheduler();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvCheckOtherTasksAreStillRunning( void )
+{
+portBASE_TYPE xReturn = pdTRUE;
+
+	if( xAreIntegerMathsTaskStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreMathsTaskStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xArePollingQueuesStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreBlockingQueuesStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreSemaphoreTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreDynamicPriorityTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreRecursiveMutexTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreCountingSemaphoreTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreGenericQueueTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreQueuePeekTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreBlockTimeTestTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreQueueSetTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreTimerDemoTasksStillRunning( mainCHECK_PERIOD ) != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xAreStreamBufferTasksStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	if( xIsCreateTaskStillRunning() != pdTRUE )
+	{
+		xReturn = pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook( void )
+{
+	vTimerPeriodicISRTests();
+	vQueueSetAccessQueueSetFromISR();
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char *pcFile, unsigned long ulLine )
+{
+	taskDISABLE_INTERRUPTS();
+	fprintf( stderr, "Assertion failed: %s line %lu\n", pcFile, ulLine );
+	exit( EXIT_FAILURE );
+}
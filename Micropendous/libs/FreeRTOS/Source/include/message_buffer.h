@@ -0,0 +1,150 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+
+#ifndef MESSAGE_BUFFER_H
+#define MESSAGE_BUFFER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include message_buffer.h"
+#endif
+
+#include "stream_buffer.h"
+
+/*
+ * Message buffers pass variable length messages from a single writer to a
+ * single reader.  They are stream buffers that store a size_t length in
+ * front of each message, and that always store a message contiguously -
+ * space left at the end of the storage that is too small for the next
+ * message is skipped - so that a message can always be read in place.
+ *
+ * Each message therefore takes sizeof( size_t ) bytes more than its own
+ * length.  A message is always written and read as a whole, and can be at
+ * most half the size of the buffer less the length field - for example a
+ * buffer for 64 byte USB packets on an AVR (where size_t is two bytes) must
+ * be at least 132 bytes.
+ */
+
+typedef xStreamBufferHandle xMessageBufferHandle;
+
+/*
+ * Creates a message buffer with xBufferSizeBytes bytes of storage, which
+ * includes the length field stored with each message.  Returns NULL if there
+ * was not enough heap left to create it, or if xBufferSizeBytes is too small
+ * to hold even a one byte message.
+ */
+#define xMessageBufferCreate( xBufferSizeBytes ) ( xMessageBufferHandle ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, pdTRUE )
+
+/*
+ * Copies a whole message into the buffer, blocking for up to xTicksToWait
+ * ticks for there to be room for it.  Returns xDataLengthBytes if the message
+ * was written, or 0 if it was not.  A message that is too long for the buffer
+ * is rejected at once, without blocking.
+ */
+#define xMessageBufferSend( xMessageBuffer, pvTxData, xDataLengthBytes, xTicksToWait ) xStreamBufferSend( xMessageBuffer, pvTxData, xDataLengthBytes, xTicksToWait )
+#define xMessageBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken )
+
+/*
+ * Copies the next message out of the buffer, blocking for up to xTicksToWait
+ * ticks for one to arrive.  Returns the length of the message, or 0 if there
+ * was no message or if it was longer than xBufferLengthBytes - in which case
+ * it is left in the buffer.
+ */
+#define xMessageBufferReceive( xMessageBuffer, pvRxData, xBufferLengthBytes, xTicksToWait ) xStreamBufferReceive( xMessageBuffer, pvRxData, xBufferLengthBytes, xTicksToWait )
+#define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken )
+
+/*
+ * Reserves contiguous space for a message of up to xBytesWanted bytes, which
+ * is then written in place and sent with vMessageBufferWriteCommit().  As
+ * with xMessageBufferSend(), a message that is too long for the buffer is
+ * rejected at once.
+ */
+#define xMessageBufferWriteAcquire( xMessageBuffer, ppvData, xBytesWanted, xTicksToWait ) xStreamBufferWriteAcquire( xMessageBuffer, ppvData, xBytesWanted, xTicksToWait )
+#define vMessageBufferWriteCommit( xMessageBuffer, xBytesWritten ) vStreamBufferWriteCommit( xMessageBuffer, xBytesWritten )
+#define xMessageBufferWriteCommitFromISR( xMessageBuffer, xBytesWritten, pxHigherPriorityTaskWoken ) xStreamBufferWriteCommitFromISR( xMessageBuffer, xBytesWritten, pxHigherPriorityTaskWoken )
+
+/*
+ * Obtains a pointer to the next message and its length, so the message can
+ * be used in place.  The message stays in the buffer until it is freed with
+ * vMessageBufferReadRelease().
+ */
+#define xMessageBufferReadAcquire( xMessageBuffer, ppvData, xTicksToWait ) xStreamBufferReadAcquire( xMessageBuffer, ppvData, xTicksToWait )
+#define vMessageBufferReadRelease( xMessageBuffer ) vStreamBufferReadRelease( xMessageBuffer, ( size_t ) 0 )
+#define xMessageBufferReadReleaseFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) xStreamBufferReadReleaseFromISR( xMessageBuffer, ( size_t ) 0, pxHigherPriorityTaskWoken )
+
+#define xMessageBufferReset( xMessageBuffer ) xStreamBufferReset( xMessageBuffer )
+#define vMessageBufferDelete( xMessageBuffer ) vStreamBufferDelete( xMessageBuffer )
+
+#endif /* MESSAGE_BUFFER_H */
+
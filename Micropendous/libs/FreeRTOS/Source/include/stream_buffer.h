@@ -0,0 +1,390 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include stream_buffer.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "mpu_wrappers.h"
+
+/*
+ * Stream buffers pass a stream of bytes from a single writer to a single
+ * reader, either of which can be a task or an interrupt.  Unlike a queue the
+ * data is not copied an item at a time under a critical section - the writer
+ * only ever updates the head index and the reader only ever updates the tail
+ * index, so the data itself is moved with interrupts enabled.  Interrupts are
+ * only masked for the few instructions needed to block or unblock a task.
+ *
+ * As well as the usual copying send and receive functions, the buffer can be
+ * written and read in place.  xStreamBufferWriteAcquire() returns a pointer
+ * to free space within the buffer and vStreamBufferWriteCommit() then makes
+ * the data written there visible to the reader, while
+ * xStreamBufferReadAcquire() returns a pointer to the data at the front of
+ * the buffer and vStreamBufferReadRelease() frees it again.  A USB or UART
+ * driver can therefore move data straight between its hardware and the
+ * buffer without an intermediate copy.
+ *
+ * Message buffers (see message_buffer.h) are built on stream buffers, and
+ * keep the boundaries between the blocks that were written to them.
+ *
+ * If more than one task or interrupt can write to (or read from) the same
+ * buffer then the application must serialise the writers (or readers)
+ * itself, for example with a mutex.
+ */
+
+/**
+ * Type by which stream buffers are referenced.  For example, a call to
+ * xStreamBufferCreate() returns an xStreamBufferHandle variable that can then
+ * be used as a parameter to xStreamBufferSend(), xStreamBufferReceive(), etc.
+ */
+typedef void * xStreamBufferHandle;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ xStreamBufferHandle xStreamBufferCreate(
+											size_t xBufferSizeBytes,
+											size_t xTriggerLevelBytes
+										);
+ * </pre>
+ *
+ * Creates a new stream buffer.  The buffer's control structure and its
+ * storage are allocated as a single block from the FreeRTOS heap.
+ *
+ * @param xBufferSizeBytes The total number of bytes the buffer can hold.
+ *
+ * @param xTriggerLevelBytes The number of bytes that must be in the buffer
+ * before a task that is blocked waiting for data is unblocked.  A value of 0
+ * is treated as 1.  A task that times out is still given whatever data did
+ * arrive.
+ *
+ * @return A handle to the new stream buffer, or NULL if there was not enough
+ * heap left to create it.
+ */
+#define xStreamBufferCreate( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE )
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferSend(
+							xStreamBufferHandle xStreamBuffer,
+							const void *pvTxData,
+							size_t xDataLengthBytes,
+							portTickType xTicksToWait
+						);
+ * </pre>
+ *
+ * Copies data into a stream buffer.  If there is not enough space for all of
+ * the data the calling task blocks until there is, or until xTicksToWait
+ * expires, and then writes as much of the data as will fit.
+ *
+ * Must not be called from an interrupt - use xStreamBufferSendFromISR().
+ *
+ * @param xStreamBuffer The handle of the buffer to write to.
+ *
+ * @param pvTxData A pointer to the data to copy into the buffer.
+ *
+ * @param xDataLengthBytes The number of bytes to write.
+ *
+ * @param xTicksToWait The maximum time the task should remain blocked
+ * waiting for space, in ticks.
+ *
+ * @return The number of bytes written to the buffer.
+ */
+size_t xStreamBufferSend( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, portTickType xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferSendFromISR(
+									xStreamBufferHandle xStreamBuffer,
+									const void *pvTxData,
+									size_t xDataLengthBytes,
+									signed portBASE_TYPE *pxHigherPriorityTaskWoken
+								);
+ * </pre>
+ *
+ * Interrupt safe version of xStreamBufferSend().  Writes as much of the data
+ * as will fit without blocking.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if writing the data
+ * unblocked a task with a priority higher than that of the interrupted task,
+ * in which case a context switch should be requested before the interrupt
+ * exits.
+ *
+ * @return The number of bytes written to the buffer.
+ */
+size_t xStreamBufferSendFromISR( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferReceive(
+								xStreamBufferHandle xStreamBuffer,
+								void *pvRxData,
+								size_t xBufferLengthBytes,
+								portTickType xTicksToWait
+							);
+ * </pre>
+ *
+ * Copies data out of a stream buffer.  If the buffer is empty the calling
+ * task blocks until the trigger level is reached, or until xTicksToWait
+ * expires.
+ *
+ * Must not be called from an interrupt - use xStreamBufferReceiveFromISR().
+ *
+ * @param xStreamBuffer The handle of the buffer to read from.
+ *
+ * @param pvRxData A pointer to the buffer into which the data is copied.
+ *
+ * @param xBufferLengthBytes The size of pvRxData, and so the most bytes that
+ * will be read.
+ *
+ * @param xTicksToWait The maximum time the task should remain blocked
+ * waiting for data, in ticks.
+ *
+ * @return The number of bytes read from the buffer.
+ */
+size_t xStreamBufferReceive( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, portTickType xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferReceiveFromISR(
+										xStreamBufferHandle xStreamBuffer,
+										void *pvRxData,
+										size_t xBufferLengthBytes,
+										signed portBASE_TYPE *pxHigherPriorityTaskWoken
+									);
+ * </pre>
+ *
+ * Interrupt safe version of xStreamBufferReceive().  Reads whatever data is
+ * available without blocking.
+ *
+ * @return The number of bytes read from the buffer.
+ */
+size_t xStreamBufferReceiveFromISR( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferWriteAcquire(
+									xStreamBufferHandle xStreamBuffer,
+									void **ppvData,
+									size_t xBytesWanted,
+									portTickType xTicksToWait
+								);
+ * </pre>
+ *
+ * Obtains a pointer to contiguous free space at the head of the buffer, so
+ * the writer can fill the buffer in place.  Nothing becomes visible to the
+ * reader until vStreamBufferWriteCommit() is called.
+ *
+ * If less than xBytesWanted contiguous bytes are free the calling task
+ * blocks until they are, or until xTicksToWait expires.  Pass an
+ * xTicksToWait of 0 when calling from an interrupt.
+ *
+ * @param ppvData Set to point to the free space.
+ *
+ * @param xBytesWanted The number of contiguous bytes the writer would like.
+ *
+ * @return The number of contiguous bytes available at *ppvData.  For a
+ * stream buffer this can be more or, once the block time has expired, less
+ * than xBytesWanted.  For a message buffer it is either xBytesWanted or 0.
+ */
+size_t xStreamBufferWriteAcquire( xStreamBufferHandle xStreamBuffer, void **ppvData, size_t xBytesWanted, portTickType xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ void vStreamBufferWriteCommit( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten );
+ signed portBASE_TYPE xStreamBufferWriteCommitFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+ * </pre>
+ *
+ * Makes xBytesWritten bytes written at the pointer returned by
+ * xStreamBufferWriteAcquire() available to the reader, unblocking the reader
+ * if it was waiting for them.  xBytesWritten must not exceed the length
+ * returned by xStreamBufferWriteAcquire().  For a message buffer it is the
+ * length of the message.
+ *
+ * The FromISR version returns pdTRUE if a context switch should be requested
+ * before the interrupt exits, and also sets *pxHigherPriorityTaskWoken if it
+ * is not NULL.
+ */
+void vStreamBufferWriteCommit( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+signed portBASE_TYPE xStreamBufferWriteCommitFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten, signed portBASE_TYPE *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferReadAcquire(
+									xStreamBufferHandle xStreamBuffer,
+									void **ppvData,
+									portTickType xTicksToWait
+								);
+ * </pre>
+ *
+ * Obtains a pointer to the data at the front of the buffer, so the reader
+ * can use it in place.  The data stays in the buffer until
+ * vStreamBufferReadRelease() is called.  If the buffer is empty the calling
+ * task blocks in the same way as xStreamBufferReceive().  Pass an
+ * xTicksToWait of 0 when calling from an interrupt.
+ *
+ * @param ppvData Set to point to the data.
+ *
+ * @return For a stream buffer, the number of contiguous bytes at *ppvData,
+ * which can be less than the number of bytes in the buffer when the data
+ * wraps around the end of the storage.  For a message buffer, the length of
+ * the message at *ppvData.  0 if there was no data.
+ */
+size_t xStreamBufferReadAcquire( xStreamBufferHandle xStreamBuffer, void **ppvData, portTickType xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ void vStreamBufferReadRelease( xStreamBufferHandle xStreamBuffer, size_t xBytesRead );
+ signed portBASE_TYPE xStreamBufferReadReleaseFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesRead, signed portBASE_TYPE *pxHigherPriorityTaskWoken );
+ * </pre>
+ *
+ * Frees xBytesRead bytes of the data returned by xStreamBufferReadAcquire(),
+ * unblocking the writer if it was waiting for space.  For a message buffer
+ * the whole message is freed and xBytesRead is ignored.
+ *
+ * The FromISR version returns pdTRUE if a context switch should be requested
+ * before the interrupt exits, and also sets *pxHigherPriorityTaskWoken if it
+ * is not NULL.
+ */
+void vStreamBufferReadRelease( xStreamBufferHandle xStreamBuffer, size_t xBytesRead ) PRIVILEGED_FUNCTION;
+signed portBASE_TYPE xStreamBufferReadReleaseFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesRead, signed portBASE_TYPE *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer );
+ size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer );
+ * </pre>
+ *
+ * Return the number of bytes held in the buffer, and the number of bytes
+ * that could still be written to it.  For a message buffer both figures
+ * include the length field stored with each message.
+ */
+size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer ) PRIVILEGED_FUNCTION;
+size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ portBASE_TYPE xStreamBufferReset( xStreamBufferHandle xStreamBuffer );
+ * </pre>
+ *
+ * Empties the buffer.  A buffer can only be reset while no task is blocked
+ * on it, and while neither side holds an acquired region.
+ *
+ * @return pdPASS if the buffer was reset, otherwise pdFAIL.
+ */
+portBASE_TYPE xStreamBufferReset( xStreamBufferHandle xStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer. h
+ * <pre>
+ void vStreamBufferDelete( xStreamBufferHandle xStreamBuffer );
+ * </pre>
+ *
+ * Frees the memory used by a stream buffer.  No task may be blocked on the
+ * buffer when it is deleted.
+ */
+void vStreamBufferDelete( xStreamBufferHandle xStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Use xStreamBufferCreate() or xMessageBufferCreate()
+ * instead of calling this directly.
+ */
+xStreamBufferHandle xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, portBASE_TYPE xIsMessageBuffer ) PRIVILEGED_FUNCTION;
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_BUFFER_H */
+
@@ -83,11 +83,16 @@ Changes from V2.6.0
 Changes from FreeRTOS V7.4.0
 
 	+ AVR port - Adapted ATmega323 port to the AT90USB USB AVRs
+	+ AVR port - vPortYield() only saves the call-saved registers, as the
+	  compiler has already saved any others it needs across the call.
+	+ AVR port - Added tickless idle, which moves the timer 1 compare match
+	  to the next task unblock time while the idle task sleeps.
 
 */
 
 #include <stdlib.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -106,6 +111,17 @@ Changes from FreeRTOS V7.4.0
 #define portCLOCK_PRESCALER				( (unsigned portLONG) 64 )
 #define portCOMPARE_MATCH_A_INTERRUPT_ENABLE		( (unsigned portCHAR)(1 << OCIE1A) )
 
+/* Timer 1 counts in one tick period, and the longest tickless idle period.
+An idle period ended early may run into the period after it, which must
+still fit in the 16 bit compare register. */
+#define portTIMER_COUNTS_PER_TICK			( ( unsigned long ) configCPU_CLOCK_HZ / configTICK_RATE_HZ / portCLOCK_PRESCALER )
+#define portMAX_SUPPRESSED_TICKS			( ( portTickType ) ( ( 0xffffUL / portTIMER_COUNTS_PER_TICK ) - 1UL ) )
+
+/* The byte on top of a saved context, telling portRESTORE_CONTEXT() whether
+all the registers were saved, or only those vPortYield() has to preserve. */
+#define portFULL_CONTEXT					( ( portSTACK_TYPE ) 0x00 )
+#define portCALL_SAVED_CONTEXT				( ( portSTACK_TYPE ) 0x01 )
+
 /*-----------------------------------------------------------*/
 
 /* We require the address of the pxCurrentTCB variable, but don't want to know
@@ -168,6 +184,51 @@ extern volatile tskTCB * volatile pxCurrentTCB;
 					"push	r29						\n\t"	\
 					"push	r30						\n\t"	\
 					"push	r31						\n\t"	\
+					"push	__zero_reg__			\n\t"	\
+					"lds	r26, pxCurrentTCB		\n\t"	\
+					"lds	r27, pxCurrentTCB + 1	\n\t"	\
+					"in		r0, 0x3d				\n\t"	\
+					"st		x+, r0					\n\t"	\
+					"in		r0, 0x3e				\n\t"	\
+					"st		x+, r0					\n\t"	\
+				);
+
+/*
+ * Lighter version of portSAVE_CONTEXT() for vPortYield().  A task calling
+ * vPortYield() expects the call to clobber r0, r18 to r27, r30 and r31, as any
+ * function call may, and r1 is always zero on entry to a function, so only the
+ * call-saved registers r2 to r17, r28 and r29 need to be saved along with the
+ * flags - 19 bytes rather than 34 each way.  The context is marked so that
+ * portRESTORE_CONTEXT() knows to restore the same registers.
+ *
+ * vPortYield() is naked, so the macro must be plain asm without operands -
+ * the 0x01 marker loaded into r24 is portCALL_SAVED_CONTEXT written out.
+ */
+
+#define portSAVE_CALL_SAVED_CONTEXT()						\
+	asm volatile (	"in		r0, __SREG__			\n\t"	\
+					"cli							\n\t"	\
+					"push	r0						\n\t"	\
+					"push	r2						\n\t"	\
+					"push	r3						\n\t"	\
+					"push	r4						\n\t"	\
+					"push	r5						\n\t"	\
+					"push	r6						\n\t"	\
+					"push	r7						\n\t"	\
+					"push	r8						\n\t"	\
+					"push	r9						\n\t"	\
+					"push	r10						\n\t"	\
+					"push	r11						\n\t"	\
+					"push	r12						\n\t"	\
+					"push	r13						\n\t"	\
+					"push	r14						\n\t"	\
+					"push	r15						\n\t"	\
+					"push	r16						\n\t"	\
+					"push	r17						\n\t"	\
+					"push	r28						\n\t"	\
+					"push	r29						\n\t"	\
+					"ldi	r24, 0x01				\n\t"	\
+					"push	r24						\n\t"	\
 					"lds	r26, pxCurrentTCB		\n\t"	\
 					"lds	r27, pxCurrentTCB + 1	\n\t"	\
 					"in		r0, 0x3d				\n\t"	\
@@ -177,8 +238,9 @@ extern volatile tskTCB * volatile pxCurrentTCB;
 				);
 
 /* 
- * Opposite to portSAVE_CONTEXT().  Interrupts will have been disabled during
- * the context save so we can write to the stack pointer. 
+ * Opposite to portSAVE_CONTEXT() and portSAVE_CALL_SAVED_CONTEXT(), depending
+ * on which of them saved the context being restored.  Interrupts will have
+ * been disabled during the context save so we can write to the stack pointer. 
  */
 
 #define portRESTORE_CONTEXT()								\
@@ -188,6 +250,31 @@ extern volatile tskTCB * volatile pxCurrentTCB;
 					"out	__SP_L__, r28			\n\t"	\
 					"ld		r29, x+					\n\t"	\
 					"out	__SP_H__, r29			\n\t"	\
+					"pop	r0						\n\t"	\
+					"tst	r0						\n\t"	\
+					"breq	1f						\n\t"	\
+					"pop	r29						\n\t"	\
+					"pop	r28						\n\t"	\
+					"pop	r17						\n\t"	\
+					"pop	r16						\n\t"	\
+					"pop	r15						\n\t"	\
+					"pop	r14						\n\t"	\
+					"pop	r13						\n\t"	\
+					"pop	r12						\n\t"	\
+					"pop	r11						\n\t"	\
+					"pop	r10						\n\t"	\
+					"pop	r9						\n\t"	\
+					"pop	r8						\n\t"	\
+					"pop	r7						\n\t"	\
+					"pop	r6						\n\t"	\
+					"pop	r5						\n\t"	\
+					"pop	r4						\n\t"	\
+					"pop	r3						\n\t"	\
+					"pop	r2						\n\t"	\
+					"pop	r0						\n\t"	\
+					"out	__SREG__, r0			\n\t"	\
+					"rjmp	2f						\n\t"	\
+					"1:								\n\t"	\
 					"pop	r31						\n\t"	\
 					"pop	r30						\n\t"	\
 					"pop	r29						\n\t"	\
@@ -222,6 +309,7 @@ extern volatile tskTCB * volatile pxCurrentTCB;
 					"pop	r0						\n\t"	\
 					"out	__SREG__, r0			\n\t"	\
 					"pop	r0						\n\t"	\
+					"2:								\n\t"	\
 				);
 
 /*-----------------------------------------------------------*/
@@ -344,6 +432,10 @@ unsigned short usAddress;
 	*pxTopOfStack = ( portSTACK_TYPE ) 0x031;	/* R31 */
 	pxTopOfStack--;
 
+	/* The task starts from a full context. */
+	*pxTopOfStack = portFULL_CONTEXT;
+	pxTopOfStack--;
+
 	/*lint +e950 +e611 +e923 */
 
 	return pxTopOfStack;
@@ -376,12 +468,13 @@ void vPortEndScheduler( void )
 
 /*
  * Manual context switch.  The first thing we do is save the registers so we
- * can use a naked attribute.
+ * can use a naked attribute.  Only the call-saved registers are saved, see
+ * portSAVE_CALL_SAVED_CONTEXT().
  */
 void vPortYield( void ) __attribute__ ( ( naked ) );
 void vPortYield( void )
 {
-	portSAVE_CONTEXT();
+	portSAVE_CALL_SAVED_CONTEXT();
 	vTaskSwitchContext();
 	portRESTORE_CONTEXT();
 
@@ -399,6 +492,15 @@ void vPortYieldFromTick( void ) __attribute__ ( ( naked ) );
 void vPortYieldFromTick( void )
 {
 	portSAVE_CONTEXT();
+
+	#if configUSE_TICKLESS_IDLE == 1
+	{
+		/* Go back to one tick period, should this tick have ended a
+		tickless idle period. */
+		OCR1A = portTIMER_COUNTS_PER_TICK - 1;
+	}
+	#endif
+
 	vTaskIncrementTick();
 	vTaskSwitchContext();
 	portRESTORE_CONTEXT();
@@ -463,7 +565,109 @@ static void prvSetupTimerInterrupt( void )
 	void TIMER1_COMPA_vect( void ) __attribute__ ( ( signal ) );
 	void TIMER1_COMPA_vect( void )
 	{
+		#if configUSE_TICKLESS_IDLE == 1
+		{
+			OCR1A = portTIMER_COUNTS_PER_TICK - 1;
+		}
+		#endif
+
 		vTaskIncrementTick();
 	}
 #endif
+/*-----------------------------------------------------------*/
+
+#if configUSE_TICKLESS_IDLE == 1
+
+	/*
+	 * Sleeps through the expected idle time without taking the ticks in
+	 * between.  Timer 1 keeps counting from the start of the current tick
+	 * period, so moving its compare match further out loses no time while
+	 * the processor sleeps - the tick interrupt ends the idle period
+	 * xExpectedIdleTime ticks after the start of the current period, unless
+	 * another interrupt wakes the processor first.  Timer 1 runs in the idle
+	 * sleep mode only.
+	 */
+	void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime )
+	{
+	unsigned short usCount, usCompleteTickPeriods;
+	portTickType xModifiableIdleTime;
+
+		if( xExpectedIdleTime > portMAX_SUPPRESSED_TICKS )
+		{
+			xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
+		}
+
+		portDISABLE_INTERRUPTS();
+
+		/* Abandon the sleep if a task was readied, or if the tick interrupt
+		is already pending, while interrupts were still enabled. */
+		if( ( eTaskConfirmSleepModeStatus() == eAbortSleep ) || ( TIFR1 & ( 1 << OCF1A ) ) )
+		{
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		OCR1A = ( unsigned short ) ( ( portTIMER_COUNTS_PER_TICK * xExpectedIdleTime ) - 1UL );
+
+		/* The application can clear xModifiableIdleTime to do its own
+		sleeping in configPRE_SLEEP_PROCESSING(). */
+		xModifiableIdleTime = xExpectedIdleTime;
+		configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+		if( xModifiableIdleTime > 0 )
+		{
+			set_sleep_mode( SLEEP_MODE_IDLE );
+			sleep_enable();
+
+			/* The instruction after sei is always executed, so an interrupt
+			cannot slip in between the two and leave the processor asleep. */
+			sei();
+			sleep_cpu();
+			sleep_disable();
+		}
+		else
+		{
+			portENABLE_INTERRUPTS();
+		}
+
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		/* Stop the timer, so that it cannot reach a compare match while it
+		is being looked at. */
+		portDISABLE_INTERRUPTS();
+		TCCR1B = portCLEAR_COUNTER_ON_MATCH;
+
+		if( ( OCR1A == ( portTIMER_COUNTS_PER_TICK - 1 ) ) || ( TIFR1 & ( 1 << OCF1A ) ) )
+		{
+			/* The idle period ran to the end.  The tick interrupt has
+			counted, or is about to count, the last tick of the period and
+			puts the compare match back to one tick period. */
+			vTaskStepTick( xExpectedIdleTime - 1 );
+		}
+		else
+		{
+			/* Another interrupt ended the idle period early.  Count the tick
+			periods which have passed, and end the current one with the next
+			tick interrupt - unless the counter is already on its last count,
+			in which case that period is counted here too, rather than set a
+			compare match the counter may be past by the time it restarts. */
+			usCount = TCNT1;
+			usCompleteTickPeriods = usCount / ( unsigned short ) portTIMER_COUNTS_PER_TICK;
+
+			if( ( usCount % ( unsigned short ) portTIMER_COUNTS_PER_TICK ) == ( unsigned short ) ( portTIMER_COUNTS_PER_TICK - 1 ) )
+			{
+				usCompleteTickPeriods++;
+			}
+
+			OCR1A = ( unsigned short ) ( ( portTIMER_COUNTS_PER_TICK * ( usCompleteTickPeriods + 1 ) ) - 1UL );
+			vTaskStepTick( ( portTickType ) usCompleteTickPeriods );
+		}
+
+		/* Restarting the timer can lose up to one prescaled count. */
+		TCCR1B = portCLEAR_COUNTER_ON_MATCH | portPRESCALE_64;
+
+		portENABLE_INTERRUPTS();
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
 
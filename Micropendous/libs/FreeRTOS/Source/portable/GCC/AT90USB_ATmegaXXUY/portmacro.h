@@ -131,6 +131,7 @@ extern "C" {
 #define portTICK_RATE_MS			( ( portTickType ) 1000 / configTICK_RATE_HZ )		
 #define portBYTE_ALIGNMENT			1
 #define portNOP()					asm volatile ( "nop" );
+#define portMEMORY_BARRIER()		asm volatile ( "" ::: "memory" )
 /*-----------------------------------------------------------*/
 
 /* Kernel utilities. */
@@ -138,6 +139,13 @@ extern void vPortYield( void ) __attribute__ ( ( naked ) );
 #define portYIELD()					vPortYield()
 /*-----------------------------------------------------------*/
 
+/* Tickless idle support. */
+#if configUSE_TICKLESS_IDLE == 1
+	extern void vPortSuppressTicksAndSleep( portTickType xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
 /* Task function macros as described on the FreeRTOS.org WEB site. */
 #define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
@@ -0,0 +1,476 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+/*
+Changes from FreeRTOS V7.4.0
+
+	+ Posix port - Runs the kernel as a single process on a POSIX host, for
+	  the testing and profiling of the AVR applications on a PC.
+
+*/
+
+/*
+ * All of the tasks run on the one host thread that starts the scheduler, each
+ * on a host stack of its own, and are switched with swapcontext().  Running
+ * a single thread rather than a thread per task keeps the scheduling exactly
+ * that of the target - only one task can ever run at a time, and a task only
+ * stops running when the kernel switches away from it - so that the scheduler
+ * overhead, queue throughput and task latencies measured on the host with
+ * perf or valgrind are those of the kernel and not of the host scheduler.
+ *
+ * Interrupts are modelled with host signals delivered to the scheduler thread.
+ * The tick is raised by a timer thread, and the signal handler is the tick ISR
+ * - incrementing the tick count and, with the preemptive scheduler, switching
+ * context from inside the handler as the AVR port does from TIMER1_COMPA_vect.
+ * The other signals in xInterruptSignals are free for simulated peripherals,
+ * whose handlers may use the FromISR API functions and yield in the same way.
+ *
+ * Host library functions are not reentrant between tasks, as they all share
+ * the one host thread.  The port allocates the task contexts with interrupts
+ * disabled, and tasks which share host library state - a stdio stream, for
+ * instance - must likewise do so from within a critical section.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the Posix port.
+ *----------------------------------------------------------*/
+
+/* Signal used to deliver the tick to the scheduler thread. */
+#define portTICK_SIGNAL						SIGALRM
+
+/* Tick period of the timer thread. */
+#define portNANOSECONDS_PER_SECOND			( 1000000000L )
+#define portTICK_PERIOD_NS					( portNANOSECONDS_PER_SECOND / configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/* We require the address of the pxCurrentTCB variable, but don't want to know
+any details of its type. */
+typedef void tskTCB;
+extern volatile tskTCB * volatile pxCurrentTCB;
+
+/* Host context of a task.  The context is allocated along with the host stack
+of the task, and is referenced from the top of the task's FreeRTOS stack - the
+location the first member of the TCB, pxTopOfStack, points to. */
+typedef struct xTASK_CONTEXT
+{
+	ucontext_t xContext;
+	pdTASK_CODE pxCode;
+	void *pvParameters;
+} xTaskContext;
+
+#define portTASK_CONTEXT( pxTCB )			( *( xTaskContext ** ) ( *( portSTACK_TYPE ** ) ( pxTCB ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* The signals which model interrupts, blocked while interrupts are disabled. */
+static sigset_t xInterruptSignals;
+
+/* Nesting depth of the critical sections of the running task, and the signal
+mask of the task on entry to the outermost one.  Both are saved and restored
+with the context of the task, so a task can yield from inside a critical
+section. */
+static unsigned portBASE_TYPE uxCriticalNesting = 0;
+static sigset_t xCriticalSignalMask;
+
+/* The thread running the scheduler, to which the tick is delivered. */
+static pthread_t xSchedulerThread;
+
+/* The thread generating the tick, and whether it should keep doing so. */
+static pthread_t xTickThread;
+static volatile portBASE_TYPE xTickThreadRunning = pdFALSE;
+
+/* Context of xPortStartScheduler(), restored by vPortEndScheduler() so that
+vTaskStartScheduler() returns once the scheduler has been stopped. */
+static ucontext_t xSchedulerContext;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Builds xInterruptSignals before anything - the creation of the first
+ * task or queue included - can enter a critical section.
+ */
+static void prvInitialiseInterruptSignals( void ) __attribute__ ( ( constructor ) );
+
+/*
+ * Entry point of the host context of each task, calling the task function.
+ */
+static void prvTaskEntry( void );
+
+/*
+ * Selects the next task to run and switches to its context.  Must be called
+ * with interrupts disabled.
+ */
+static void prvSwitchContext( void );
+
+/*
+ * The tick ISR.
+ */
+static void prvTickSignalHandler( int iSignal );
+
+/*
+ * Body of the thread which generates the tick.
+ */
+static void *prvTickThread( void *pvParameters );
+
+/*
+ * Start the thread which generates the tick.
+ */
+static void prvSetupTimerInterrupt( void );
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseInterruptSignals( void )
+{
+	sigemptyset( &xInterruptSignals );
+	sigaddset( &xInterruptSignals, portTICK_SIGNAL );
+	sigaddset( &xInterruptSignals, SIGUSR1 );
+	sigaddset( &xInterruptSignals, SIGUSR2 );
+}
+/*-----------------------------------------------------------*/
+
+/* 
+ * See header file for description. 
+ */
+portSTACK_TYPE *pxPortInitialiseStack( portSTACK_TYPE *pxTopOfStack, pdTASK_CODE pxCode, void *pvParameters )
+{
+xTaskContext *pxContext;
+unsigned char *pucStack;
+
+	/* The host allocator is not reentrant, and is used by the tasks too. */
+	vPortEnterCritical();
+	pxContext = ( xTaskContext * ) malloc( sizeof( xTaskContext ) + configPOSIX_TASK_STACK_SIZE );
+	vPortExitCritical();
+
+	if( pxContext == NULL )
+	{
+		abort();
+	}
+
+	pucStack = ( unsigned char * ) ( pxContext + 1 );
+
+	getcontext( &( pxContext->xContext ) );
+	pxContext->xContext.uc_stack.ss_sp = pucStack;
+	pxContext->xContext.uc_stack.ss_size = configPOSIX_TASK_STACK_SIZE;
+	pxContext->xContext.uc_link = NULL;
+
+	/* Start the task with interrupts enabled. */
+	sigemptyset( &( pxContext->xContext.uc_sigmask ) );
+
+	pxContext->pxCode = pxCode;
+	pxContext->pvParameters = pvParameters;
+	makecontext( &( pxContext->xContext ), prvTaskEntry, 0 );
+
+	/* The FreeRTOS stack of the task holds nothing but its host context. */
+	*pxTopOfStack = ( portSTACK_TYPE ) pxContext;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+	/* The task has been deleted, so is not running on the host stack. */
+	vPortEnterCritical();
+	free( portTASK_CONTEXT( pxTCB ) );
+	vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xPortStartScheduler( void )
+{
+struct sigaction xTickAction;
+
+	/* Interrupts were disabled by vTaskStartScheduler(), so the tick cannot
+	occur until the first task has started. */
+	xSchedulerThread = pthread_self();
+
+	xTickAction.sa_handler = prvTickSignalHandler;
+	xTickAction.sa_mask = xInterruptSignals;
+	xTickAction.sa_flags = SA_RESTART;
+	sigaction( portTICK_SIGNAL, &xTickAction, NULL );
+
+	/* Setup the host to generate the tick. */
+	prvSetupTimerInterrupt();
+
+	/* Switch to the context of the first task that is going to run. */
+	swapcontext( &xSchedulerContext, &( portTASK_CONTEXT( pxCurrentTCB )->xContext ) );
+
+	/* Should only get here if a task calls vTaskEndScheduler().  A tick may
+	still be pending, so ignore it rather than let it end the process. */
+	xTickAction.sa_handler = SIG_IGN;
+	sigaction( portTICK_SIGNAL, &xTickAction, NULL );
+
+	uxCriticalNesting = 0;
+	vPortEnableInterrupts();
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	/* Stop the tick, then resume xPortStartScheduler() in the context it was
+	called from.  The task contexts are not freed, as the memory of the tasks
+	is not freed by the kernel either. */
+	xTickThreadRunning = pdFALSE;
+	pthread_join( xTickThread, NULL );
+
+	setcontext( &xSchedulerContext );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+sigset_t xPreviousMask;
+
+	pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xPreviousMask );
+
+	/* Interrupts are left as they were found when the outermost critical
+	section is exited, as portEXIT_CRITICAL() does on the AVR, so that a
+	critical section inside an ISR does not enable interrupts. */
+	if( uxCriticalNesting == 0 )
+	{
+		xCriticalSignalMask = xPreviousMask;
+	}
+
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	uxCriticalNesting--;
+
+	if( uxCriticalNesting == 0 )
+	{
+		pthread_sigmask( SIG_SETMASK, &xCriticalSignalMask, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Manual context switch.  Interrupts are disabled while the next task is
+ * selected, and are restored to their previous state - from the context of
+ * this task - once this task is switched back in.
+ */
+void vPortYield( void )
+{
+sigset_t xPreviousMask;
+
+	pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xPreviousMask );
+	prvSwitchContext();
+	pthread_sigmask( SIG_SETMASK, &xPreviousMask, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+xTaskContext *pxPreviousContext, *pxNextContext;
+unsigned portBASE_TYPE uxSavedCriticalNesting = uxCriticalNesting;
+sigset_t xSavedCriticalSignalMask = xCriticalSignalMask;
+int iSavedErrno = errno;
+
+	pxPreviousContext = portTASK_CONTEXT( pxCurrentTCB );
+	vTaskSwitchContext();
+	pxNextContext = portTASK_CONTEXT( pxCurrentTCB );
+
+	if( pxNextContext != pxPreviousContext )
+	{
+		/* swapcontext() saves and restores the signal mask - the interrupt
+		state - of each task along with its registers.  The rest of the
+		state of this task is restored once it is switched back in. */
+		swapcontext( &( pxPreviousContext->xContext ), &( pxNextContext->xContext ) );
+
+		uxCriticalNesting = uxSavedCriticalNesting;
+		xCriticalSignalMask = xSavedCriticalSignalMask;
+		errno = iSavedErrno;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+xTaskContext *pxContext = portTASK_CONTEXT( pxCurrentTCB );
+
+	/* A task starts outside of any critical section, whatever the state of
+	the task that switched to it. */
+	uxCriticalNesting = 0;
+
+	pxContext->pxCode( pxContext->pvParameters );
+
+	/* Tasks must never return from their implementing function. */
+	abort();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Tick ISR.  Like the AVR timer interrupt, the tick is delivered only while
+ * interrupts are enabled, and ticks falling due while they are disabled are
+ * merged into one.
+ */
+static void prvTickSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	vTaskIncrementTick();
+
+	#if configUSE_PREEMPTION == 1
+	{
+		prvSwitchContext();
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTickThread( void *pvParameters )
+{
+struct timespec xNextTick, xNow;
+
+	( void ) pvParameters;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNextTick );
+
+	while( xTickThreadRunning != pdFALSE )
+	{
+		xNextTick.tv_nsec += portTICK_PERIOD_NS;
+
+		if( xNextTick.tv_nsec >= portNANOSECONDS_PER_SECOND )
+		{
+			xNextTick.tv_nsec -= portNANOSECONDS_PER_SECOND;
+			xNextTick.tv_sec++;
+		}
+
+		/* Do not try to catch up on ticks missed while the process was
+		stopped, as they would be merged anyway. */
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+		if( ( xNextTick.tv_sec < xNow.tv_sec ) || ( ( xNextTick.tv_sec == xNow.tv_sec ) && ( xNextTick.tv_nsec < xNow.tv_nsec ) ) )
+		{
+			xNextTick = xNow;
+		}
+
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL ) == EINTR );
+
+		pthread_kill( xSchedulerThread, portTICK_SIGNAL );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Start a thread sending the tick signal to the scheduler thread every tick
+ * period.  The thread blocks every signal, so that the interrupts are only
+ * ever handled on the scheduler thread.
+ */
+static void prvSetupTimerInterrupt( void )
+{
+sigset_t xAllSignals, xPreviousMask;
+
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xPreviousMask );
+
+	xTickThreadRunning = pdTRUE;
+
+	if( pthread_create( &xTickThread, NULL, prvTickThread, NULL ) != 0 )
+	{
+		abort();
+	}
+
+	pthread_sigmask( SIG_SETMASK, &xPreviousMask, NULL );
+}
+/*-----------------------------------------------------------*/
+
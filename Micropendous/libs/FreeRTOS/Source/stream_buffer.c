@@ -0,0 +1,942 @@
+/*
+    FreeRTOS V7.4.0 - Copyright (C) 2013 Real Time Engineers Ltd.
+
+    FEATURES AND PORTS ARE ADDED TO FREERTOS ALL THE TIME.  PLEASE VISIT
+    http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS tutorial books are available in pdf and paperback.        *
+     *    Complete, revised, and edited pdf reference manuals are also       *
+     *    available.                                                         *
+     *                                                                       *
+     *    Purchasing FreeRTOS documentation will not only help you, by       *
+     *    ensuring you get running as quickly as possible and with an        *
+     *    in-depth knowledge of how to use FreeRTOS, it will also help       *
+     *    the FreeRTOS project to continue with its mission of providing     *
+     *    professional grade, cross platform, de facto standard solutions    *
+     *    for microcontrollers - completely free of charge!                  *
+     *                                                                       *
+     *    >>> See http://www.FreeRTOS.org/Documentation for details. <<<     *
+     *                                                                       *
+     *    Thank you for using FreeRTOS, and thank you for your support!      *
+     *                                                                       *
+    ***************************************************************************
+
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation AND MODIFIED BY the FreeRTOS exception.
+
+    >>>>>>NOTE<<<<<< The modification to the GPL is included to allow you to
+    distribute a combined work that includes FreeRTOS without being obliged to
+    provide the source code for proprietary components outside of the FreeRTOS
+    kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+    details. You should have received a copy of the GNU General Public License
+    and the FreeRTOS license exception along with FreeRTOS; if not itcan be
+    viewed here: http://www.freertos.org/a00114.html and also obtained by
+    writing to Real Time Engineers Ltd., contact details for whom are available
+    on the FreeRTOS WEB site.
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions, 
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, and our new
+    fully thread aware and reentrant UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High 
+    Integrity Systems, who sell the code with commercial support, 
+    indemnification and middleware, under the OpenRTOS brand.
+    
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety 
+    engineered and independently SIL3 certified version for use in safety and 
+    mission critical applications that require provable dependability.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Set in ucFlags when the buffer holds messages rather than a byte stream. */
+#define sbFLAGS_IS_MESSAGE_BUFFER		( ( unsigned char ) 0x01U )
+
+/* Each message is stored after a length field of this many bytes. */
+#define sbMESSAGE_HEADER_LENGTH			( sizeof( size_t ) )
+
+/* Length field written where a message did not fit before the end of the
+storage, telling the reader to carry on from the start of the storage. */
+#define sbMESSAGE_WRAP					( ~( ( size_t ) 0U ) )
+
+/* Passed to prvIsReady() and prvWaitForBuffer() by the reader, which waits
+for data rather than for space. */
+#define sbWAIT_FOR_DATA					( ( size_t ) 0U )
+
+/* Messages are never split, so once the reader has emptied the buffer the
+writer's position can leave as little as half of the storage contiguous -
+either before or after it.  Longer messages are always rejected rather than
+only sometimes fitting. */
+#define sbMAX_MESSAGE_LENGTH( pxStreamBuffer )	( ( ( ( pxStreamBuffer )->xLength - ( size_t ) 1U ) / ( size_t ) 2U ) - sbMESSAGE_HEADER_LENGTH )
+
+/* The storage follows the control structure within the same allocation. */
+#define sbSTORAGE( pxStreamBuffer )		( ( unsigned char * ) ( ( pxStreamBuffer ) + 1 ) )
+
+/*
+ * Definition of a stream buffer.  The head is only ever written by the
+ * writer and the tail only ever by the reader.  The storage is one byte
+ * longer than the capacity requested, so the head only equals the tail when
+ * the buffer is empty.
+ */
+typedef struct StreamBufferDefinition
+{
+	volatile size_t xHead;					/*< Index of the next byte to be written. */
+	volatile size_t xTail;					/*< Index of the next byte to be read. */
+	size_t xLength;							/*< Length of the storage in bytes. */
+	size_t xTriggerLevelBytes;				/*< Number of bytes that must be in a stream buffer before a blocked reader is unblocked. */
+	size_t xWriteOffset;					/*< Index at which the message being written by a message buffer writer starts. */
+
+	xList xTasksWaitingToSend;				/*< List of tasks that are blocked waiting for space.  Stored in priority order. */
+	xList xTasksWaitingToReceive;			/*< List of tasks that are blocked waiting for data.  Stored in priority order. */
+
+	unsigned char ucFlags;
+} xSTREAM_BUFFER;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Reads an index owned by the other side of the buffer.  Indexes can be
+ * wider than the processor's data bus, so instead of masking interrupts the
+ * index is read until two reads agree.
+ */
+static size_t prvReadIndex( const volatile size_t * const pxIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of bytes in the buffer.
+ */
+static size_t prvBytesInBuffer( const xSTREAM_BUFFER * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Works out where the writer can write next.  For a stream buffer returns the
+ * number of contiguous free bytes from the head.  For a message buffer
+ * returns xBytesWanted if a message of that length fits contiguously, or 0 if
+ * it does not.  In both cases *pxOffset is set to the index at which the
+ * data (or, for a message, its length field) is to be written.
+ */
+static size_t prvWriteRegion( const xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesWanted, size_t *pxOffset ) PRIVILEGED_FUNCTION;
+
+/*
+ * Works out what the reader can read next.  For a stream buffer returns the
+ * number of contiguous bytes from the tail.  For a message buffer returns the
+ * length of the next message.  In both cases *pxOffset is set to the index of
+ * the data.  Returns 0 if the buffer is empty.
+ */
+static size_t prvReadRegion( const xSTREAM_BUFFER * const pxStreamBuffer, size_t *pxOffset ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if the buffer holds data (xBytesNeeded is sbWAIT_FOR_DATA),
+ * or has room for xBytesNeeded bytes - contiguous bytes if xContiguous is
+ * pdTRUE.
+ */
+static portBASE_TYPE prvIsReady( const xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesNeeded, portBASE_TYPE xContiguous ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task until prvIsReady() would return pdTRUE, or until
+ * xTicksToWait expires.
+ */
+static void prvWaitForBuffer( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesNeeded, portBASE_TYPE xContiguous, portTickType xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the highest priority task waiting on pxEventList, if there is one.
+ */
+static void prvUnblockTask( xList * const pxEventList ) PRIVILEGED_FUNCTION;
+static signed portBASE_TYPE prvUnblockTaskFromISR( xList * const pxEventList, signed portBASE_TYPE *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy data into (out of) the buffer without making it visible to the reader
+ * (freeing it for the writer).  Return the number of bytes copied.
+ */
+static size_t prvCopyToBuffer( xSTREAM_BUFFER * const pxStreamBuffer, const void *pvTxData, size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+static size_t prvCopyFromBuffer( const xSTREAM_BUFFER * const pxStreamBuffer, void *pvRxData, size_t xBufferLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the head (tail) past data that has been written (read).  prvCommitWrite()
+ * returns pdTRUE if a blocked reader should now be unblocked.
+ */
+static portBASE_TYPE prvCommitWrite( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+static void prvReleaseRead( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+xStreamBufferHandle xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, portBASE_TYPE xIsMessageBuffer )
+{
+xSTREAM_BUFFER *pxNewStreamBuffer = NULL;
+size_t xMinimumSize;
+
+	/* A message buffer must have room for at least a one byte message, see
+	sbMAX_MESSAGE_LENGTH(). */
+	xMinimumSize = ( xIsMessageBuffer != pdFALSE ) ? ( size_t ) ( ( sbMESSAGE_HEADER_LENGTH + 1U ) * 2U ) : ( size_t ) 1U;
+
+	if( xBufferSizeBytes >= xMinimumSize )
+	{
+		pxNewStreamBuffer = ( xSTREAM_BUFFER * ) pvPortMalloc( sizeof( xSTREAM_BUFFER ) + xBufferSizeBytes + ( size_t ) 1U );
+
+		if( pxNewStreamBuffer != NULL )
+		{
+			pxNewStreamBuffer->xHead = ( size_t ) 0U;
+			pxNewStreamBuffer->xTail = ( size_t ) 0U;
+			pxNewStreamBuffer->xLength = xBufferSizeBytes + ( size_t ) 1U;
+			pxNewStreamBuffer->xWriteOffset = ( size_t ) 0U;
+
+			if( xTriggerLevelBytes == ( size_t ) 0U )
+			{
+				xTriggerLevelBytes = ( size_t ) 1U;
+			}
+			else if( xTriggerLevelBytes > xBufferSizeBytes )
+			{
+				xTriggerLevelBytes = xBufferSizeBytes;
+			}
+
+			pxNewStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
+			pxNewStreamBuffer->ucFlags = ( xIsMessageBuffer != pdFALSE ) ? sbFLAGS_IS_MESSAGE_BUFFER : ( unsigned char ) 0U;
+
+			vListInitialise( &( pxNewStreamBuffer->xTasksWaitingToSend ) );
+			vListInitialise( &( pxNewStreamBuffer->xTasksWaitingToReceive ) );
+		}
+	}
+
+	configASSERT( pxNewStreamBuffer );
+	return ( xStreamBufferHandle ) pxNewStreamBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferDelete( xStreamBufferHandle xStreamBuffer )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) != pdFALSE );
+	configASSERT( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToReceive ) ) != pdFALSE );
+
+	vPortFree( pxStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+portBASE_TYPE xStreamBufferReset( xStreamBufferHandle xStreamBuffer )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+portBASE_TYPE xReturn = pdFAIL;
+
+	configASSERT( pxStreamBuffer );
+
+	taskENTER_CRITICAL();
+	{
+		if( ( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToSend ) ) != pdFALSE ) &&
+			( listLIST_IS_EMPTY( &( pxStreamBuffer->xTasksWaitingToReceive ) ) != pdFALSE ) )
+		{
+			pxStreamBuffer->xHead = ( size_t ) 0U;
+			pxStreamBuffer->xTail = ( size_t ) 0U;
+			pxStreamBuffer->xWriteOffset = ( size_t ) 0U;
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSend( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesNeeded, xBytesWritten;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( !( ( pvTxData == NULL ) && ( xDataLengthBytes != ( size_t ) 0U ) ) );
+
+	if( xDataLengthBytes == ( size_t ) 0U )
+	{
+		return ( size_t ) 0U;
+	}
+
+	xBytesNeeded = xDataLengthBytes;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* A message that is too long for the buffer would never fit, however
+		long the task waited for space. */
+		if( xDataLengthBytes > sbMAX_MESSAGE_LENGTH( pxStreamBuffer ) )
+		{
+			return ( size_t ) 0U;
+		}
+	}
+	else if( xBytesNeeded > ( pxStreamBuffer->xLength - ( size_t ) 1U ) )
+	{
+		/* A stream buffer writes what it can once the block time expires, so
+		there is no point waiting for more space than the buffer has. */
+		xBytesNeeded = pxStreamBuffer->xLength - ( size_t ) 1U;
+	}
+
+	if( ( xTicksToWait != ( portTickType ) 0U ) && ( prvIsReady( pxStreamBuffer, xBytesNeeded, pdFALSE ) == pdFALSE ) )
+	{
+		prvWaitForBuffer( pxStreamBuffer, xBytesNeeded, pdFALSE, xTicksToWait );
+	}
+
+	xBytesWritten = prvCopyToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes );
+
+	if( xBytesWritten != ( size_t ) 0U )
+	{
+		if( prvCommitWrite( pxStreamBuffer, xBytesWritten ) != pdFALSE )
+		{
+			prvUnblockTask( &( pxStreamBuffer->xTasksWaitingToReceive ) );
+		}
+	}
+
+	return xBytesWritten;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendFromISR( xStreamBufferHandle xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesWritten;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( !( ( pvTxData == NULL ) && ( xDataLengthBytes != ( size_t ) 0U ) ) );
+
+	xBytesWritten = prvCopyToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes );
+
+	if( xBytesWritten != ( size_t ) 0U )
+	{
+		if( prvCommitWrite( pxStreamBuffer, xBytesWritten ) != pdFALSE )
+		{
+			( void ) prvUnblockTaskFromISR( &( pxStreamBuffer->xTasksWaitingToReceive ), pxHigherPriorityTaskWoken );
+		}
+	}
+
+	return xBytesWritten;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceive( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesRead;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( !( ( pvRxData == NULL ) && ( xBufferLengthBytes != ( size_t ) 0U ) ) );
+
+	if( ( xTicksToWait != ( portTickType ) 0U ) && ( prvBytesInBuffer( pxStreamBuffer ) == ( size_t ) 0U ) )
+	{
+		prvWaitForBuffer( pxStreamBuffer, sbWAIT_FOR_DATA, pdFALSE, xTicksToWait );
+	}
+
+	xBytesRead = prvCopyFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+
+	if( xBytesRead != ( size_t ) 0U )
+	{
+		prvReleaseRead( pxStreamBuffer, xBytesRead );
+		prvUnblockTask( &( pxStreamBuffer->xTasksWaitingToSend ) );
+	}
+
+	return xBytesRead;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveFromISR( xStreamBufferHandle xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesRead;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( !( ( pvRxData == NULL ) && ( xBufferLengthBytes != ( size_t ) 0U ) ) );
+
+	xBytesRead = prvCopyFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes );
+
+	if( xBytesRead != ( size_t ) 0U )
+	{
+		prvReleaseRead( pxStreamBuffer, xBytesRead );
+		( void ) prvUnblockTaskFromISR( &( pxStreamBuffer->xTasksWaitingToSend ), pxHigherPriorityTaskWoken );
+	}
+
+	return xBytesRead;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferWriteAcquire( xStreamBufferHandle xStreamBuffer, void **ppvData, size_t xBytesWanted, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesNeeded, xBytesAvailable, xOffset;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( ppvData );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* As in xStreamBufferSend(), do not wait for space for a message that
+		is too long to ever fit. */
+		if( ( xBytesWanted == ( size_t ) 0U ) || ( xBytesWanted > sbMAX_MESSAGE_LENGTH( pxStreamBuffer ) ) )
+		{
+			return ( size_t ) 0U;
+		}
+
+		xBytesNeeded = xBytesWanted;
+	}
+	else
+	{
+		/* The writer can never be given more contiguous space than is left
+		before the end of the storage, so only wait for that much. */
+		xBytesNeeded = pxStreamBuffer->xLength - ( size_t ) 1U - pxStreamBuffer->xHead;
+
+		if( xBytesNeeded > xBytesWanted )
+		{
+			xBytesNeeded = xBytesWanted;
+		}
+
+		if( xBytesNeeded == ( size_t ) 0U )
+		{
+			xBytesNeeded = ( size_t ) 1U;
+		}
+	}
+
+	xBytesAvailable = prvWriteRegion( pxStreamBuffer, xBytesNeeded, &xOffset );
+
+	if( ( xBytesAvailable < xBytesNeeded ) && ( xTicksToWait != ( portTickType ) 0U ) )
+	{
+		prvWaitForBuffer( pxStreamBuffer, xBytesNeeded, pdTRUE, xTicksToWait );
+		xBytesAvailable = prvWriteRegion( pxStreamBuffer, xBytesNeeded, &xOffset );
+	}
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* Remember where the message goes, the reader could move the tail
+		before it is committed. */
+		pxStreamBuffer->xWriteOffset = xOffset;
+		xOffset += sbMESSAGE_HEADER_LENGTH;
+	}
+
+	*ppvData = ( void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset );
+	return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferWriteCommit( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesWritten != ( size_t ) 0U )
+	{
+		if( prvCommitWrite( pxStreamBuffer, xBytesWritten ) != pdFALSE )
+		{
+			prvUnblockTask( &( pxStreamBuffer->xTasksWaitingToReceive ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE xStreamBufferWriteCommitFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesWritten, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+signed portBASE_TYPE xReturn = pdFALSE;
+
+	configASSERT( pxStreamBuffer );
+
+	if( xBytesWritten != ( size_t ) 0U )
+	{
+		if( prvCommitWrite( pxStreamBuffer, xBytesWritten ) != pdFALSE )
+		{
+			xReturn = prvUnblockTaskFromISR( &( pxStreamBuffer->xTasksWaitingToReceive ), pxHigherPriorityTaskWoken );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReadAcquire( xStreamBufferHandle xStreamBuffer, void **ppvData, portTickType xTicksToWait )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+size_t xBytesAvailable, xOffset;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( ppvData );
+
+	if( ( xTicksToWait != ( portTickType ) 0U ) && ( prvBytesInBuffer( pxStreamBuffer ) == ( size_t ) 0U ) )
+	{
+		prvWaitForBuffer( pxStreamBuffer, sbWAIT_FOR_DATA, pdFALSE, xTicksToWait );
+	}
+
+	xBytesAvailable = prvReadRegion( pxStreamBuffer, &xOffset );
+
+	*ppvData = ( void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset );
+	return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReadRelease( xStreamBufferHandle xStreamBuffer, size_t xBytesRead )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	prvReleaseRead( pxStreamBuffer, xBytesRead );
+	prvUnblockTask( &( pxStreamBuffer->xTasksWaitingToSend ) );
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE xStreamBufferReadReleaseFromISR( xStreamBufferHandle xStreamBuffer, size_t xBytesRead, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	prvReleaseRead( pxStreamBuffer, xBytesRead );
+	return prvUnblockTaskFromISR( &( pxStreamBuffer->xTasksWaitingToSend ), pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferBytesAvailable( xStreamBufferHandle xStreamBuffer )
+{
+	configASSERT( xStreamBuffer );
+	return prvBytesInBuffer( ( xSTREAM_BUFFER * ) xStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSpacesAvailable( xStreamBufferHandle xStreamBuffer )
+{
+xSTREAM_BUFFER * const pxStreamBuffer = ( xSTREAM_BUFFER * ) xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+	return ( pxStreamBuffer->xLength - ( size_t ) 1U ) - prvBytesInBuffer( pxStreamBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadIndex( const volatile size_t * const pxIndex )
+{
+size_t xIndex;
+
+	do
+	{
+		xIndex = *pxIndex;
+	} while( xIndex != *pxIndex );
+
+	return xIndex;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBytesInBuffer( const xSTREAM_BUFFER * const pxStreamBuffer )
+{
+size_t xHead, xTail;
+
+	xHead = prvReadIndex( &( pxStreamBuffer->xHead ) );
+	xTail = prvReadIndex( &( pxStreamBuffer->xTail ) );
+
+	if( xHead >= xTail )
+	{
+		return xHead - xTail;
+	}
+	else
+	{
+		return ( pxStreamBuffer->xLength - xTail ) + xHead;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteRegion( const xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesWanted, size_t *pxOffset )
+{
+size_t xHead, xTail, xSpace, xRecordLength;
+
+	xHead = pxStreamBuffer->xHead;
+	xTail = prvReadIndex( &( pxStreamBuffer->xTail ) );
+
+	/* The free space from the head runs either up to the byte before the
+	tail, or to the end of the storage - less one byte if the tail is at the
+	start of the storage, as the head must not catch up with it. */
+	if( xTail > xHead )
+	{
+		xSpace = ( xTail - xHead ) - ( size_t ) 1U;
+	}
+	else if( xTail == ( size_t ) 0U )
+	{
+		xSpace = ( pxStreamBuffer->xLength - xHead ) - ( size_t ) 1U;
+	}
+	else
+	{
+		xSpace = pxStreamBuffer->xLength - xHead;
+	}
+
+	*pxOffset = xHead;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == 0U )
+	{
+		return xSpace;
+	}
+
+	if( xBytesWanted > sbMAX_MESSAGE_LENGTH( pxStreamBuffer ) )
+	{
+		return ( size_t ) 0U;
+	}
+
+	xRecordLength = xBytesWanted + sbMESSAGE_HEADER_LENGTH;
+
+	if( xSpace >= xRecordLength )
+	{
+		return xBytesWanted;
+	}
+
+	/* If the space before the end of the storage is too small, the message
+	can go at the start of the storage instead, provided it then stays short
+	of the tail. */
+	if( ( xTail <= xHead ) && ( xTail > xRecordLength ) )
+	{
+		*pxOffset = ( size_t ) 0U;
+		return xBytesWanted;
+	}
+
+	return ( size_t ) 0U;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadRegion( const xSTREAM_BUFFER * const pxStreamBuffer, size_t *pxOffset )
+{
+size_t xHead, xTail, xMessageLength;
+
+	xTail = pxStreamBuffer->xTail;
+	xHead = prvReadIndex( &( pxStreamBuffer->xHead ) );
+
+	*pxOffset = xTail;
+
+	if( xHead == xTail )
+	{
+		return ( size_t ) 0U;
+	}
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == 0U )
+	{
+		return ( xHead > xTail ) ? ( xHead - xTail ) : ( pxStreamBuffer->xLength - xTail );
+	}
+
+	/* The next message is at the tail, unless the writer skipped the end of
+	the storage - either because there was no room left for even a length
+	field, or by writing a wrap marker in place of one. */
+	if( ( pxStreamBuffer->xLength - xTail ) >= sbMESSAGE_HEADER_LENGTH )
+	{
+		memcpy( ( void * ) &xMessageLength, ( void * ) ( sbSTORAGE( pxStreamBuffer ) + xTail ), sbMESSAGE_HEADER_LENGTH );
+
+		if( xMessageLength != sbMESSAGE_WRAP )
+		{
+			*pxOffset = xTail + sbMESSAGE_HEADER_LENGTH;
+			return xMessageLength;
+		}
+	}
+
+	memcpy( ( void * ) &xMessageLength, ( void * ) sbSTORAGE( pxStreamBuffer ), sbMESSAGE_HEADER_LENGTH );
+	*pxOffset = sbMESSAGE_HEADER_LENGTH;
+
+	return xMessageLength;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvIsReady( const xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesNeeded, portBASE_TYPE xContiguous )
+{
+size_t xOffset;
+
+	if( xBytesNeeded == sbWAIT_FOR_DATA )
+	{
+		return ( prvBytesInBuffer( pxStreamBuffer ) != ( size_t ) 0U ) ? pdTRUE : pdFALSE;
+	}
+	else if( ( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U ) || ( xContiguous != pdFALSE ) )
+	{
+		return ( prvWriteRegion( pxStreamBuffer, xBytesNeeded, &xOffset ) >= xBytesNeeded ) ? pdTRUE : pdFALSE;
+	}
+	else
+	{
+		return ( ( ( pxStreamBuffer->xLength - ( size_t ) 1U ) - prvBytesInBuffer( pxStreamBuffer ) ) >= xBytesNeeded ) ? pdTRUE : pdFALSE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForBuffer( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesNeeded, portBASE_TYPE xContiguous, portTickType xTicksToWait )
+{
+xTimeOutType xTimeOut;
+xList *pxEventList;
+portBASE_TYPE xBlocked;
+
+	if( xBytesNeeded == sbWAIT_FOR_DATA )
+	{
+		pxEventList = &( pxStreamBuffer->xTasksWaitingToReceive );
+	}
+	else
+	{
+		pxEventList = &( pxStreamBuffer->xTasksWaitingToSend );
+	}
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	do
+	{
+		xBlocked = pdFALSE;
+
+		/* The other side only looks at the event list after it has moved its
+		index, so testing the buffer and joining the event list within the
+		same critical section cannot miss a wake up.  Unlike a queue nothing
+		else needs protecting, so there is no need to suspend the scheduler
+		and lock the buffer as queue.c does. */
+		taskENTER_CRITICAL();
+		{
+			if( prvIsReady( pxStreamBuffer, xBytesNeeded, xContiguous ) == pdFALSE )
+			{
+				if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+				{
+					vTaskPlaceOnEventList( pxEventList, xTicksToWait );
+
+					/* Yes it is ok to yield from within the critical
+					section - the kernel takes care of that. */
+					portYIELD_WITHIN_API();
+					xBlocked = pdTRUE;
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+	} while( xBlocked != pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockTask( xList * const pxEventList )
+{
+	if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* Check again as the task might have timed out in the meantime. */
+			if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static signed portBASE_TYPE prvUnblockTaskFromISR( xList * const pxEventList, signed portBASE_TYPE *pxHigherPriorityTaskWoken )
+{
+signed portBASE_TYPE xReturn = pdFALSE;
+unsigned portBASE_TYPE uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+		{
+			if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+			{
+				xReturn = pdTRUE;
+
+				if( pxHigherPriorityTaskWoken != NULL )
+				{
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+			}
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyToBuffer( xSTREAM_BUFFER * const pxStreamBuffer, const void *pvTxData, size_t xDataLengthBytes )
+{
+size_t xOffset, xSpace, xFirstLength;
+
+	if( xDataLengthBytes == ( size_t ) 0U )
+	{
+		return ( size_t ) 0U;
+	}
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		if( prvWriteRegion( pxStreamBuffer, xDataLengthBytes, &xOffset ) == ( size_t ) 0U )
+		{
+			return ( size_t ) 0U;
+		}
+
+		pxStreamBuffer->xWriteOffset = xOffset;
+		memcpy( ( void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset + sbMESSAGE_HEADER_LENGTH ), pvTxData, xDataLengthBytes );
+
+		return xDataLengthBytes;
+	}
+
+	xSpace = ( pxStreamBuffer->xLength - ( size_t ) 1U ) - prvBytesInBuffer( pxStreamBuffer );
+
+	if( xDataLengthBytes > xSpace )
+	{
+		xDataLengthBytes = xSpace;
+	}
+
+	/* The data may wrap around the end of the storage. */
+	xOffset = pxStreamBuffer->xHead;
+	xFirstLength = pxStreamBuffer->xLength - xOffset;
+
+	if( xFirstLength > xDataLengthBytes )
+	{
+		xFirstLength = xDataLengthBytes;
+	}
+
+	memcpy( ( void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset ), pvTxData, xFirstLength );
+	memcpy( ( void * ) sbSTORAGE( pxStreamBuffer ), ( const void * ) ( ( const unsigned char * ) pvTxData + xFirstLength ), xDataLengthBytes - xFirstLength );
+
+	return xDataLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyFromBuffer( const xSTREAM_BUFFER * const pxStreamBuffer, void *pvRxData, size_t xBufferLengthBytes )
+{
+size_t xOffset, xBytesAvailable, xFirstLength;
+
+	xBytesAvailable = prvReadRegion( pxStreamBuffer, &xOffset );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* A message that does not fit is left in the buffer. */
+		if( xBytesAvailable > xBufferLengthBytes )
+		{
+			return ( size_t ) 0U;
+		}
+
+		memcpy( pvRxData, ( const void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset ), xBytesAvailable );
+		return xBytesAvailable;
+	}
+
+	/* prvReadRegion() only returned the bytes up to the end of the storage,
+	the rest of the data is at the start. */
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+	if( xBufferLengthBytes > xBytesAvailable )
+	{
+		xBufferLengthBytes = xBytesAvailable;
+	}
+
+	xFirstLength = pxStreamBuffer->xLength - xOffset;
+
+	if( xFirstLength > xBufferLengthBytes )
+	{
+		xFirstLength = xBufferLengthBytes;
+	}
+
+	memcpy( pvRxData, ( const void * ) ( sbSTORAGE( pxStreamBuffer ) + xOffset ), xFirstLength );
+	memcpy( ( void * ) ( ( unsigned char * ) pvRxData + xFirstLength ), ( const void * ) sbSTORAGE( pxStreamBuffer ), xBufferLengthBytes - xFirstLength );
+
+	return xBufferLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+static portBASE_TYPE prvCommitWrite( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesWritten )
+{
+size_t xHead, xMessageLength;
+unsigned char *pucStorage = sbSTORAGE( pxStreamBuffer );
+
+	xHead = pxStreamBuffer->xHead;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* If the message went to the start of the storage, tell the reader
+		to skip the end - unless there is not even room for a length field
+		there, which the reader skips anyway. */
+		if( ( pxStreamBuffer->xWriteOffset != xHead ) && ( ( pxStreamBuffer->xLength - xHead ) >= sbMESSAGE_HEADER_LENGTH ) )
+		{
+			xMessageLength = sbMESSAGE_WRAP;
+			memcpy( ( void * ) ( pucStorage + xHead ), ( void * ) &xMessageLength, sbMESSAGE_HEADER_LENGTH );
+		}
+
+		xHead = pxStreamBuffer->xWriteOffset;
+		memcpy( ( void * ) ( pucStorage + xHead ), ( void * ) &xBytesWritten, sbMESSAGE_HEADER_LENGTH );
+		xHead += sbMESSAGE_HEADER_LENGTH;
+	}
+
+	xHead += xBytesWritten;
+
+	if( xHead >= pxStreamBuffer->xLength )
+	{
+		xHead -= pxStreamBuffer->xLength;
+	}
+
+	/* The data must be in place before the reader can see the new head. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xHead = xHead;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		return pdTRUE;
+	}
+
+	return ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseRead( xSTREAM_BUFFER * const pxStreamBuffer, size_t xBytesRead )
+{
+size_t xTail, xOffset, xMessageLength;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != 0U )
+	{
+		/* The whole of the message at the front of the buffer is freed. */
+		xMessageLength = prvReadRegion( pxStreamBuffer, &xOffset );
+
+		if( xMessageLength == ( size_t ) 0U )
+		{
+			return;
+		}
+
+		xTail = xOffset + xMessageLength;
+	}
+	else
+	{
+		configASSERT( xBytesRead <= prvBytesInBuffer( pxStreamBuffer ) );
+		xTail = pxStreamBuffer->xTail + xBytesRead;
+	}
+
+	if( xTail >= pxStreamBuffer->xLength )
+	{
+		xTail -= pxStreamBuffer->xLength;
+	}
+
+	/* The data must have been read before the writer can reuse the space. */
+	portMEMORY_BARRIER();
+	pxStreamBuffer->xTail = xTail;
+}
+
@@ -55,6 +55,9 @@ int main(void)
 	Dataflash_SendByte(0);
 	// cppcheck-suppress redundantAssignment
 	Dummy = Dataflash_ReceiveByte();
+	Dataflash_StartTransfer(0);
+	// cppcheck-suppress redundantAssignment
+	Dummy = Dataflash_FinishTransfer();
 	// cppcheck-suppress redundantAssignment
 	Dummy = Dataflash_GetSelectedChip();
 	Dataflash_SelectChip(0);
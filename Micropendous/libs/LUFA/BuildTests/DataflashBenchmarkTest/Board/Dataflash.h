@@ -0,0 +1,188 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Simulated board Dataflash driver for the Dataflash benchmark build test.
+ *
+ *  Board Dataflash driver for the host-side simulated architecture, laid out like the Atmel USBKEY with two
+ *  AT45DB642D ICs interleaved by page. Every byte sent over the simulated SPI bus is handled by the Dataflash
+ *  model in the build test's Test.c, which also keeps the simulated time of the bus and of the ICs.
+ */
+
+#ifndef __DATAFLASH_USER_H__
+#define __DATAFLASH_USER_H__
+
+	/* Includes: */
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/Misc/AT45DB642D.h>
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_DATAFLASH_H)
+			#error Do not include this file directly. Include LUFA/Drivers/Board/Dataflash.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Constant indicating the total number of dataflash ICs mounted on the selected board. */
+			#define DATAFLASH_TOTALCHIPS                 2
+
+			/** Mask for no dataflash chip selected. */
+			#define DATAFLASH_NO_CHIP                    0
+
+			/** Mask for the first dataflash chip selected. */
+			#define DATAFLASH_CHIP1                      (1 << 0)
+
+			/** Mask for the second dataflash chip selected. */
+			#define DATAFLASH_CHIP2                      (1 << 1)
+
+			/** Internal main memory page size for the board's dataflash ICs. */
+			#define DATAFLASH_PAGE_SIZE                  1024
+
+			/** Total number of pages inside each of the board's dataflash ICs. */
+			#define DATAFLASH_PAGES                      8192
+
+		/* Function Prototypes: */
+			/** Clocks a byte through the simulated SPI bus to the selected simulated dataflash IC.
+			 *
+			 *  \param[in] Byte  Byte of data to send to the dataflash
+			 *
+			 *  \return Response byte from the dataflash
+			 */
+			uint8_t SimDataflash_TransferByte(const uint8_t Byte);
+
+			/** Changes the simulated /CS lines, completing the command of any IC that is deselected.
+			 *
+			 *  \param[in] ChipMask  Mask of the Dataflash IC to select, or \ref DATAFLASH_NO_CHIP
+			 */
+			void SimDataflash_SelectChip(const uint8_t ChipMask);
+
+			/** Retrieves the mask of the currently selected simulated dataflash IC.
+			 *
+			 *  \return Mask of the selected IC, or \ref DATAFLASH_NO_CHIP
+			 */
+			uint8_t SimDataflash_GetSelectedChip(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Response of the transfer started by the last \ref Dataflash_StartTransfer() call. */
+			extern uint8_t SimDataflash_PendingResponse;
+
+		/* Inline Functions: */
+			static inline void Dataflash_Init(void)
+			{
+
+			}
+
+			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte)
+			{
+				return SimDataflash_TransferByte(Byte);
+			}
+
+			static inline void Dataflash_SendByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_SendByte(const uint8_t Byte)
+			{
+				SimDataflash_TransferByte(Byte);
+			}
+
+			static inline uint8_t Dataflash_ReceiveByte(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline uint8_t Dataflash_ReceiveByte(void)
+			{
+				return SimDataflash_TransferByte(0x00);
+			}
+
+			static inline void Dataflash_StartTransfer(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_StartTransfer(const uint8_t Byte)
+			{
+				SimDataflash_PendingResponse = SimDataflash_TransferByte(Byte);
+			}
+
+			static inline uint8_t Dataflash_FinishTransfer(void) ATTR_ALWAYS_INLINE;
+			static inline uint8_t Dataflash_FinishTransfer(void)
+			{
+				return SimDataflash_PendingResponse;
+			}
+
+			static inline uint8_t Dataflash_GetSelectedChip(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline uint8_t Dataflash_GetSelectedChip(void)
+			{
+				return SimDataflash_GetSelectedChip();
+			}
+
+			static inline void Dataflash_SelectChip(const uint8_t ChipMask) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_SelectChip(const uint8_t ChipMask)
+			{
+				SimDataflash_SelectChip(ChipMask);
+			}
+
+			static inline void Dataflash_DeselectChip(void) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_DeselectChip(void)
+			{
+				Dataflash_SelectChip(DATAFLASH_NO_CHIP);
+			}
+
+			static inline void Dataflash_SelectChipFromPage(const uint16_t PageAddress)
+			{
+				Dataflash_DeselectChip();
+
+				if (PageAddress >= (DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS))
+				  return;
+
+				if (PageAddress & 0x01)
+				  Dataflash_SelectChip(DATAFLASH_CHIP2);
+				else
+				  Dataflash_SelectChip(DATAFLASH_CHIP1);
+			}
+
+			static inline void Dataflash_ToggleSelectedChipCS(void)
+			{
+				uint8_t SelectedChipMask = Dataflash_GetSelectedChip();
+
+				Dataflash_DeselectChip();
+				Dataflash_SelectChip(SelectedChipMask);
+			}
+
+			static inline void Dataflash_WaitWhileBusy(void)
+			{
+				Dataflash_ToggleSelectedChipCS();
+				Dataflash_SendByte(DF_CMD_GETSTATUS);
+				while (!(Dataflash_ReceiveByte() & DF_STATUS_READY));
+				Dataflash_ToggleSelectedChipCS();
+			}
+
+			static inline void Dataflash_SendAddressBytes(uint16_t PageAddress,
+			                                              const uint16_t BufferByte)
+			{
+				PageAddress >>= 1;
+
+				Dataflash_SendByte(PageAddress >> 5);
+				Dataflash_SendByte((PageAddress << 3) | (BufferByte >> 8));
+				Dataflash_SendByte(BufferByte);
+			}
+
+#endif
@@ -0,0 +1,390 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../Projects/Webserver/Lib/DataflashManager.h"
+
+#if (ARCH != ARCH_SIM)
+	#error The Dataflash benchmark requires the host-side simulated USB controller (ARCH=SIM).
+#endif
+
+/** Endpoint address of the benchmark's device-to-host Mass Storage data endpoint. */
+#define BENCHMARK_IN_EPADDR      (ENDPOINT_DIR_IN  | 1)
+
+/** Endpoint address of the benchmark's host-to-device Mass Storage data endpoint. */
+#define BENCHMARK_OUT_EPADDR     (ENDPOINT_DIR_OUT | 2)
+
+/** Number of bytes from the start of the media checked after the benchmark, covering every benchmarked block. */
+#define BENCHMARK_VERIFY_BYTES   (16384UL * VIRTUAL_MEMORY_BLOCK_SIZE)
+
+/** Size in bytes of each benchmark endpoint bank. */
+#define BENCHMARK_EPSIZE         64
+
+/** Time taken to clock one byte over the SPI bus at F_CPU / 2 on an 8MHz board, in nanoseconds. */
+#define SIM_SPI_BYTE_NS          2000
+
+/** Maximum AT45DB642D main memory page to buffer transfer time (tXFR), in nanoseconds. */
+#define SIM_DATAFLASH_TXFR_NS    400000
+
+/** Typical AT45DB642D page erase and program time (tEP), in nanoseconds. */
+#define SIM_DATAFLASH_TEP_NS     17000000
+
+/** Value of an erased Dataflash byte. */
+#define SIM_DATAFLASH_ERASED     0xFF
+
+/** State of one simulated AT45DB642D Dataflash IC. */
+typedef struct
+{
+	uint8_t  Memory[DATAFLASH_PAGES][DATAFLASH_PAGE_SIZE]; /**< Main memory pages of the IC. */
+	uint8_t  Buffer[2][DATAFLASH_PAGE_SIZE]; /**< SRAM buffers of the IC. */
+	uint64_t BusyUntil; /**< Simulated time at which the running internal operation completes. */
+	int8_t   BusyBuffer; /**< SRAM buffer used by the running internal operation, or -1. */
+	uint8_t  Command[4]; /**< Opcode and address bytes of the command in progress. */
+	uint32_t CommandBytes; /**< Number of bytes clocked since the IC was selected. */
+	uint16_t DataAddress; /**< Current byte address within the buffer or page of a data transfer. */
+} SimDataflash_t;
+
+/** One timed benchmark phase, a run of Mass Storage commands over a contiguous range of blocks. */
+typedef struct
+{
+	const char* Name;
+	bool        Write;
+	uint32_t    StartBlock;
+	uint16_t    TotalBlocks;
+	uint16_t    BlocksPerCommand;
+} BenchmarkPhase_t;
+
+static const BenchmarkPhase_t Phases[] =
+	{
+		{"Sequential write, 64KB commands",   true,  0,    2048, 128},
+		{"Sequential read, 64KB commands",    false, 0,    2048, 128},
+		{"Single block writes",               true,  4096, 256,  1  },
+		{"Single block reads",                false, 4096, 256,  1  },
+		{"Unaligned 4KB writes",              true,  8193, 512,  8  },
+		{"Unaligned 4KB reads",               false, 8193, 512,  8  },
+	};
+
+uint8_t SimDataflash_PendingResponse;
+
+static SimDataflash_t* SimDataflash[DATAFLASH_TOTALCHIPS];
+static uint8_t         SimDataflash_Selected;
+static uint64_t        SimDataflash_TimeNS;
+static uint32_t        SimDataflash_PageLoads;
+static uint32_t        SimDataflash_PagePrograms;
+static uint32_t        SimDataflash_BusyViolations;
+
+/** Direction of the running benchmark phase, \c true for host-to-device. */
+static volatile bool     BenchmarkWrite;
+
+/** Byte address on the media of the next packet the simulated host sends or checks. */
+static volatile uint32_t BenchmarkAddress;
+
+/** Number of packets the simulated host has still to move in the running benchmark phase. */
+static volatile uint32_t BenchmarkPacketsRemaining;
+
+/** Number of bytes read back by the simulated host which did not match the written pattern. */
+static volatile uint32_t BenchmarkMismatches;
+
+static USB_ClassInfo_MS_Device_t Disk_MS_Interface;
+
+static uint8_t Pattern(const uint32_t Address)
+{
+	return (uint8_t)(Address ^ (Address >> 8) ^ (Address >> 16) ^ 0x5A);
+}
+
+static SimDataflash_t* SelectedDataflash(void)
+{
+	if (SimDataflash_Selected == DATAFLASH_CHIP1)
+	  return SimDataflash[0];
+	else if (SimDataflash_Selected == DATAFLASH_CHIP2)
+	  return SimDataflash[1];
+
+	return NULL;
+}
+
+uint8_t SimDataflash_GetSelectedChip(void)
+{
+	return SimDataflash_Selected;
+}
+
+void SimDataflash_SelectChip(const uint8_t ChipMask)
+{
+	SimDataflash_t* Dataflash = SelectedDataflash();
+
+	if (ChipMask == SimDataflash_Selected)
+	  return;
+
+	/* Internal operations of the deselected IC start on the rising edge of its /CS line */
+	if (Dataflash && (Dataflash->CommandBytes >= 4))
+	{
+		uint16_t Page = ((Dataflash->Command[1] << 5) | (Dataflash->Command[2] >> 3));
+
+		switch (Dataflash->Command[0])
+		{
+			case DF_CMD_MAINMEMTOBUFF1:
+			case DF_CMD_MAINMEMTOBUFF2:
+				Dataflash->BusyBuffer = (Dataflash->Command[0] == DF_CMD_MAINMEMTOBUFF2);
+				memcpy(Dataflash->Buffer[Dataflash->BusyBuffer], Dataflash->Memory[Page], DATAFLASH_PAGE_SIZE);
+				Dataflash->BusyUntil  = (SimDataflash_TimeNS + SIM_DATAFLASH_TXFR_NS);
+				SimDataflash_PageLoads++;
+				break;
+			case DF_CMD_BUFF1TOMAINMEMWITHERASE:
+			case DF_CMD_BUFF2TOMAINMEMWITHERASE:
+				Dataflash->BusyBuffer = (Dataflash->Command[0] == DF_CMD_BUFF2TOMAINMEMWITHERASE);
+				memcpy(Dataflash->Memory[Page], Dataflash->Buffer[Dataflash->BusyBuffer], DATAFLASH_PAGE_SIZE);
+				Dataflash->BusyUntil  = (SimDataflash_TimeNS + SIM_DATAFLASH_TEP_NS);
+				SimDataflash_PagePrograms++;
+				break;
+		}
+	}
+
+	SimDataflash_Selected = ChipMask;
+
+	if ((Dataflash = SelectedDataflash()) != NULL)
+	  Dataflash->CommandBytes = 0;
+}
+
+uint8_t SimDataflash_TransferByte(const uint8_t Byte)
+{
+	SimDataflash_t* Dataflash = SelectedDataflash();
+
+	SimDataflash_TimeNS += SIM_SPI_BYTE_NS;
+
+	if (!(Dataflash))
+	  return 0xFF;
+
+	uint32_t ByteIndex = Dataflash->CommandBytes++;
+	bool     Busy      = (SimDataflash_TimeNS < Dataflash->BusyUntil);
+
+	if (ByteIndex < 4)
+	  Dataflash->Command[ByteIndex] = Byte;
+
+	if (ByteIndex == 0)
+	{
+		/* A busy IC only accepts status reads, and writes to the SRAM buffer its running operation is not using */
+		if (Busy && !((Byte == DF_CMD_GETSTATUS) ||
+		              ((Byte == DF_CMD_BUFF1WRITE) && (Dataflash->BusyBuffer != 0)) ||
+		              ((Byte == DF_CMD_BUFF2WRITE) && (Dataflash->BusyBuffer != 1))))
+		{
+			SimDataflash_BusyViolations++;
+		}
+
+		return 0;
+	}
+
+	if (ByteIndex == 3)
+	  Dataflash->DataAddress = (((Dataflash->Command[2] & 0x07) << 8) | Dataflash->Command[3]);
+
+	switch (Dataflash->Command[0])
+	{
+		case DF_CMD_GETSTATUS:
+			return (Busy ? 0 : DF_STATUS_READY);
+		case DF_CMD_READMANUFACTURERDEVICEINFO:
+			return ((ByteIndex == 1) ? DF_MANUFACTURER_ATMEL : 0);
+		case DF_CMD_BUFF1WRITE:
+		case DF_CMD_BUFF2WRITE:
+			if (ByteIndex >= 4)
+			{
+				Dataflash->Buffer[Dataflash->Command[0] == DF_CMD_BUFF2WRITE][Dataflash->DataAddress] = Byte;
+				Dataflash->DataAddress = ((Dataflash->DataAddress + 1) % DATAFLASH_PAGE_SIZE);
+			}
+
+			return 0;
+		case DF_CMD_MAINMEMPAGEREAD:
+			/* Opcode and address are followed by four don't care bytes before the page data */
+			if (ByteIndex >= 8)
+			{
+				uint16_t Page = ((Dataflash->Command[1] << 5) | (Dataflash->Command[2] >> 3));
+				uint8_t  Data = Dataflash->Memory[Page][Dataflash->DataAddress];
+
+				Dataflash->DataAddress = ((Dataflash->DataAddress + 1) % DATAFLASH_PAGE_SIZE);
+				return Data;
+			}
+
+			return 0;
+	}
+
+	return 0;
+}
+
+uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
+                                    const uint8_t wIndex,
+                                    const void** const DescriptorAddress)
+{
+	return NO_DESCRIPTOR;
+}
+
+void CALLBACK_USB_SimHost_Task(void)
+{
+	uint8_t Packet[ENDPOINT_MAX_BANK_SIZE];
+
+	if (USB_SimHost_Attach() != USB_SIMHOST_Successful)
+	{
+		fprintf(stderr, "Simulated host could not attach the device.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (;;)
+	{
+		uint16_t Length    = BENCHMARK_EPSIZE;
+		uint8_t  ErrorCode;
+
+		if (!(BenchmarkPacketsRemaining))
+		{
+			SIM_Delay_MS(1);
+			USB_SimHost_StartOfFrame();
+			continue;
+		}
+
+		if (BenchmarkWrite)
+		{
+			for (uint8_t i = 0; i < BENCHMARK_EPSIZE; i++)
+			  Packet[i] = Pattern(BenchmarkAddress + i);
+
+			ErrorCode = USB_SimHost_WriteOUT(BENCHMARK_OUT_EPADDR, Packet, BENCHMARK_EPSIZE);
+		}
+		else
+		{
+			ErrorCode = USB_SimHost_ReadIN(BENCHMARK_IN_EPADDR, Packet, &Length);
+
+			for (uint8_t i = 0; i < Length; i++)
+			{
+				if (Packet[i] != Pattern(BenchmarkAddress + i))
+				  BenchmarkMismatches++;
+			}
+		}
+
+		if ((ErrorCode != USB_SIMHOST_Successful) || (Length != BENCHMARK_EPSIZE))
+		{
+			fprintf(stderr, "Simulated host transfer failed (error %u).\n", ErrorCode);
+			exit(EXIT_FAILURE);
+		}
+
+		BenchmarkAddress += BENCHMARK_EPSIZE;
+		BenchmarkPacketsRemaining--;
+	}
+}
+
+static void RunPhase(const BenchmarkPhase_t* const Phase)
+{
+	uint32_t Bytes          = ((uint32_t)Phase->TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	uint64_t StartTime      = SimDataflash_TimeNS;
+	uint32_t StartLoads     = SimDataflash_PageLoads;
+	uint32_t StartPrograms  = SimDataflash_PagePrograms;
+
+	BenchmarkWrite            = Phase->Write;
+	BenchmarkAddress          = (Phase->StartBlock * VIRTUAL_MEMORY_BLOCK_SIZE);
+	BenchmarkPacketsRemaining = (Bytes / BENCHMARK_EPSIZE);
+
+	Endpoint_SelectEndpoint(Phase->Write ? BENCHMARK_OUT_EPADDR : BENCHMARK_IN_EPADDR);
+
+	for (uint16_t Block = 0; Block < Phase->TotalBlocks; Block += Phase->BlocksPerCommand)
+	{
+		if (Phase->Write)
+		  DataflashManager_WriteBlocks(&Disk_MS_Interface, (Phase->StartBlock + Block), Phase->BlocksPerCommand);
+		else
+		  DataflashManager_ReadBlocks(&Disk_MS_Interface, (Phase->StartBlock + Block), Phase->BlocksPerCommand);
+	}
+
+	while (BenchmarkPacketsRemaining)
+	  SIM_YieldToBus();
+
+	double Seconds = ((double)(SimDataflash_TimeNS - StartTime) / 1e9);
+
+	printf("  %-34s %7.3f MB/s  %6u page loads  %6u page programs\n", Phase->Name, ((double)Bytes / Seconds / 1e6),
+	       (unsigned)(SimDataflash_PageLoads - StartLoads), (unsigned)(SimDataflash_PagePrograms - StartPrograms));
+}
+
+/** Checks every byte of the simulated media, blocks written by the benchmark must hold the pattern and all others
+ *  must still be erased, so that data around unaligned writes is known to be preserved.
+ *
+ *  \return Number of bytes holding the wrong value
+ */
+static uint32_t VerifyMedia(void)
+{
+	uint32_t Errors = 0;
+
+	for (uint32_t Address = 0; Address < BENCHMARK_VERIFY_BYTES; Address++)
+	{
+		uint32_t Block    = (Address / VIRTUAL_MEMORY_BLOCK_SIZE);
+		uint16_t Page     = (Address / DATAFLASH_PAGE_SIZE);
+		uint8_t  Expected = SIM_DATAFLASH_ERASED;
+
+		for (uint8_t i = 0; i < (sizeof(Phases) / sizeof(Phases[0])); i++)
+		{
+			if (Phases[i].Write && (Block >= Phases[i].StartBlock) &&
+			    (Block < (Phases[i].StartBlock + Phases[i].TotalBlocks)))
+			{
+				Expected = Pattern(Address);
+			}
+		}
+
+		if (SimDataflash[Page & 0x01]->Memory[Page >> 1][Address % DATAFLASH_PAGE_SIZE] != Expected)
+		  Errors++;
+	}
+
+	return Errors;
+}
+
+int main(void)
+{
+	for (uint8_t Chip = 0; Chip < DATAFLASH_TOTALCHIPS; Chip++)
+	{
+		if ((SimDataflash[Chip] = calloc(1, sizeof(SimDataflash_t))) == NULL)
+		  return EXIT_FAILURE;
+
+		memset(SimDataflash[Chip]->Memory, SIM_DATAFLASH_ERASED, sizeof(SimDataflash[Chip]->Memory));
+		SimDataflash[Chip]->BusyBuffer = -1;
+	}
+
+	GlobalInterruptEnable();
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+
+	while (USB_DeviceState != DEVICE_STATE_Default)
+	  SIM_YieldToBus();
+
+	Endpoint_ConfigureEndpoint(BENCHMARK_IN_EPADDR,  EP_TYPE_BULK, BENCHMARK_EPSIZE, 2);
+	Endpoint_ConfigureEndpoint(BENCHMARK_OUT_EPADDR, EP_TYPE_BULK, BENCHMARK_EPSIZE, 2);
+
+	printf("Dataflash Mass Storage benchmark (simulated %u x AT45DB642D, SPI %u ns/byte, tEP %u us):\n",
+	       DATAFLASH_TOTALCHIPS, SIM_SPI_BYTE_NS, (SIM_DATAFLASH_TEP_NS / 1000));
+
+	for (uint8_t i = 0; i < (sizeof(Phases) / sizeof(Phases[0])); i++)
+	  RunPhase(&Phases[i]);
+
+	uint32_t MediaErrors = VerifyMedia();
+
+	printf("  %u mismatched bytes read back, %u bytes wrong on the media, %u commands sent to a busy IC\n",
+	       (unsigned)BenchmarkMismatches, (unsigned)MediaErrors, (unsigned)SimDataflash_BusyViolations);
+
+	return (BenchmarkMismatches || MediaErrors || SimDataflash_BusyViolations) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include <LUFA/Common/Common.h>
+#include <LUFA/Drivers/Misc/InternetChecksum.h>
+
+#if (ARCH != ARCH_SIM)
+	#error The Internet checksum test requires the host-side simulated architecture (ARCH=SIM).
+#endif
+
+/** Longest buffer summed, long enough for the AVR loop's outer counter to run more than once. */
+#define CHECKSUM_MAX_LENGTH     1500
+
+/** Number of random word changes checked against a full checksum recalculation. */
+#define ADJUST_ITERATIONS       100000
+
+/** Buffer summed by each test, with room for every start alignment within a 32-bit word. */
+static uint8_t Buffer[CHECKSUM_MAX_LENGTH + 3];
+
+/** Running one's complement sums each buffer is summed from. */
+static const uint16_t StartSums[] = {0x0000, 0x0001, 0x8000, 0xFFFE, 0xFFFF, 0x3C5A};
+
+/** Number of sums compared against the reference, for the test report. */
+static uint32_t SumsChecked;
+
+/** Advances a simple xorshift pseudo-random generator, used to fill the test buffers. */
+static uint32_t NextRandom(uint32_t* const State)
+{
+	uint32_t x = *State;
+
+	x ^= (x << 13);
+	x ^= (x >> 17);
+	x ^= (x << 5);
+
+	return (*State = x);
+}
+
+/** Reference one's complement sum, adding the buffer a 16-bit memory-order word at a time into a 32-bit
+ *  accumulator as described in RFC 1071, with a trailing odd byte padded with zero.
+ */
+static uint16_t ReferenceSum(const uint16_t Sum,
+                             const uint8_t* const Data,
+                             const uint16_t Length)
+{
+	uint32_t WideSum = Sum;
+
+	for (uint16_t i = 0; (i + 1) < Length; i += 2)
+	  WideSum += (uint16_t)(Data[i] | (Data[i + 1] << 8));
+
+	if (Length & 1)
+	  WideSum += Data[Length - 1];
+
+	while (WideSum >> 16)
+	  WideSum = ((WideSum & 0xFFFF) + (WideSum >> 16));
+
+	return WideSum;
+}
+
+/** Model of the AVR8 and XMEGA assembly loop of \ref InetChecksum_Add(), instruction for instruction: the two
+ *  bytes of the sum are added to with a single carry flag that is never cleared between blocks, the block count
+ *  is split into an inner counter where zero means 256 passes and an outer counter, and the carry left over at
+ *  the end is folded back in with three ADC instructions. The trailing bytes are then added by the same C code
+ *  as on the other architectures.
+ */
+static uint16_t ModelAVRSum(uint16_t Sum,
+                            const uint8_t* Data,
+                            uint16_t Length)
+{
+	uint16_t Blocks = (Length >> 2);
+
+	if (Blocks)
+	{
+		uint8_t SumLow     = (Sum & 0xFF);
+		uint8_t SumHigh    = (Sum >> 8);
+		uint8_t InnerCount = (Blocks & 0xFF);
+		uint8_t OuterCount = ((Blocks >> 8) + (InnerCount ? 1 : 0));
+		uint8_t Carry      = 0;
+
+		#define MODEL_ADC(Register, Value)  do { uint16_t Result = (Register + (Value) + Carry); \
+		                                         Register = (uint8_t)Result; Carry = (Result >> 8); } while (0)
+
+		do
+		{
+			do
+			{
+				MODEL_ADC(SumLow,  *Data++);
+				MODEL_ADC(SumHigh, *Data++);
+				MODEL_ADC(SumLow,  *Data++);
+				MODEL_ADC(SumHigh, *Data++);
+			}
+			while (--InnerCount);
+		}
+		while (--OuterCount);
+
+		MODEL_ADC(SumLow,  0);
+		MODEL_ADC(SumHigh, 0);
+		MODEL_ADC(SumLow,  0);
+
+		#undef MODEL_ADC
+
+		Sum     = (SumLow | (SumHigh << 8));
+		Length &= 0x03;
+	}
+
+	while (Length >= 2)
+	{
+		Sum = InetChecksum_AddWord(Sum, (Data[0] | (Data[1] << 8)));
+
+		Data   += 2;
+		Length -= 2;
+	}
+
+	if (Length)
+	  Sum = InetChecksum_AddWord(Sum, Data[0]);
+
+	return Sum;
+}
+
+/** Checks one sum against the reference, exiting with a failure report if it differs. */
+static void CheckSum(const char* const Routine,
+                     const uint16_t Result,
+                     const uint16_t Expected,
+                     const uint16_t StartSum,
+                     const uint16_t Offset,
+                     const uint16_t Length)
+{
+	SumsChecked++;
+
+	if (Result == Expected)
+	  return;
+
+	fprintf(stderr, "%s of %u bytes at offset %u from 0x%04X returned 0x%04X, expected 0x%04X\n",
+	        Routine, Length, Offset, StartSum, Result, Expected);
+	exit(EXIT_FAILURE);
+}
+
+/** Sums every length and start alignment of the current buffer contents from each start sum. */
+static void CheckAllLengths(void)
+{
+	for (uint16_t Length = 0; Length <= CHECKSUM_MAX_LENGTH; Length++)
+	{
+		for (uint8_t Offset = 0; Offset < 4; Offset++)
+		{
+			const uint8_t* Data = &Buffer[Offset];
+
+			for (uint8_t i = 0; i < (sizeof(StartSums) / sizeof(StartSums[0])); i++)
+			{
+				uint16_t Expected = ReferenceSum(StartSums[i], Data, Length);
+
+				CheckSum("InetChecksum_Add()", InetChecksum_Add(StartSums[i], Data, Length), Expected, StartSums[i], Offset, Length);
+				CheckSum("AVR loop model",     ModelAVRSum(StartSums[i], Data, Length),      Expected, StartSums[i], Offset, Length);
+			}
+		}
+	}
+}
+
+/** Checks that sums of even-length pieces of a buffer chain to the sum of the whole buffer. */
+static void CheckChaining(void)
+{
+	for (uint16_t Length = 0; Length <= CHECKSUM_MAX_LENGTH; Length += 7)
+	{
+		uint16_t Expected = ReferenceSum(0, Buffer, Length);
+
+		for (uint16_t Split = 0; Split <= Length; Split += 2)
+		{
+			uint16_t Sum = InetChecksum_Add(InetChecksum_Add(0, Buffer, Split), &Buffer[Split], (Length - Split));
+
+			CheckSum("Chained InetChecksum_Add()", Sum, Expected, 0, Split, Length);
+		}
+	}
+}
+
+/** Checks that patching a checksum with \ref InetChecksum_Adjust() after a word changes gives the same result as
+ *  summing the changed buffer again.
+ */
+static void CheckAdjust(uint32_t* const RandomState)
+{
+	uint16_t Length   = 40;
+	uint16_t Checksum = ~InetChecksum_Add(0, Buffer, Length);
+
+	for (uint32_t i = 0; i < ADJUST_ITERATIONS; i++)
+	{
+		uint32_t Random   = NextRandom(RandomState);
+		uint16_t Offset   = (((Random >> 16) % (Length / 2)) * 2);
+		uint16_t OldValue = (Buffer[Offset] | (Buffer[Offset + 1] << 8));
+		uint16_t NewValue = ((i & 0x0F) ? (uint16_t)Random : (uint16_t)~OldValue);
+
+		Buffer[Offset]     = (NewValue & 0xFF);
+		Buffer[Offset + 1] = (NewValue >> 8);
+
+		Checksum = InetChecksum_Adjust(Checksum, OldValue, NewValue);
+		CheckSum("InetChecksum_Adjust()", Checksum, (uint16_t)~ReferenceSum(0, Buffer, Length), OldValue, Offset, Length);
+	}
+}
+
+int main(void)
+{
+	uint32_t RandomState = 0x2545F491;
+
+	/* Random data, then all ones so that every addition carries, then all zeros */
+	for (uint16_t i = 0; i < sizeof(Buffer); i++)
+	  Buffer[i] = NextRandom(&RandomState);
+
+	CheckAllLengths();
+	CheckChaining();
+	CheckAdjust(&RandomState);
+
+	memset(Buffer, 0xFF, sizeof(Buffer));
+	CheckAllLengths();
+
+	memset(Buffer, 0x00, sizeof(Buffer));
+	CheckAllLengths();
+
+	printf("Internet checksum: %lu sums matched the RFC 1071 reference\n", (unsigned long)SumsChecked);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Network stack benchmark adapter for the AVRlib network stack (ARP, IP and ICMP, with the default UDP and TCP
+ *  handlers). The adapter takes the place of the stack's network interface driver: each replayed frame is
+ *  returned by the next poll of the interface, and the stack's service routine is then run once to process it.
+ *  The stack's ARP cache timer is run once for every second of simulated time.
+ */
+
+#include <string.h>
+
+#include "netstack.h"
+
+#include "StackInterface.h"
+
+const char     Stack_Name[]         = "AVRlib netstack";
+const uint8_t  Stack_MACAddress[6]  = {0x00, 0x01, 0x00, 0x01, 0x00, 0x01};
+const uint16_t Stack_MaxFrameLength = NETSTACK_BUFFERSIZE;
+
+/** Replayed frame waiting to be polled by the stack, and its length. */
+static const uint8_t* PendingFrame;
+static uint16_t       PendingFrameLength;
+
+/** Simulated time in seconds at which the ARP cache timer was last run. */
+static uint32_t       LastARPTimerSecond;
+
+void nicInit(void)
+{
+
+}
+
+void nicSend(unsigned int len,
+             unsigned char* packet)
+{
+	Benchmark_TransmitFrame(packet, len);
+}
+
+unsigned int nicPoll(unsigned int maxlen,
+                     unsigned char* packet)
+{
+	if (!(PendingFrame) || (PendingFrameLength > maxlen))
+	  return 0;
+
+	memcpy(packet, PendingFrame, PendingFrameLength);
+	PendingFrame = NULL;
+
+	return PendingFrameLength;
+}
+
+void nicGetMacAddress(uint8_t* macaddr)
+{
+	memcpy(macaddr, Stack_MACAddress, sizeof(Stack_MACAddress));
+}
+
+void nicSetMacAddress(uint8_t* macaddr)
+{
+
+}
+
+void Stack_Init(void)
+{
+	netstackInit(IPDOT(10, 0, 0, 2), IPDOT(255, 255, 255, 0), IPDOT(10, 0, 0, 1));
+}
+
+void Stack_ProcessFrame(const uint8_t* const Frame,
+                        const uint16_t Length)
+{
+	while (LastARPTimerSecond < (Benchmark_TimeMS / 1000))
+	{
+		arpTimer();
+		LastARPTimerSecond++;
+	}
+
+	PendingFrame       = Frame;
+	PendingFrameLength = Length;
+
+	netstackService();
+}
+
@@ -0,0 +1,88 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Simulated board Dataflash driver for the network stack benchmark build test.
+ *
+ *  Board Dataflash definitions for the host-side simulated architecture, laid out like the Atmel USBKEY, so
+ *  that the Webserver project's headers build unchanged. The Webserver's HTTP application is replaced by a
+ *  stub in the benchmark, so no Dataflash access is ever made, and all Dataflash operations have no effect.
+ */
+
+#ifndef __DATAFLASH_USER_H__
+#define __DATAFLASH_USER_H__
+
+	/* Includes: */
+		#include <LUFA/Common/Common.h>
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_DATAFLASH_H)
+			#error Do not include this file directly. Include LUFA/Drivers/Board/Dataflash.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Constant indicating the total number of dataflash ICs mounted on the selected board. */
+			#define DATAFLASH_TOTALCHIPS                 2
+
+			/** Mask for no dataflash chip selected. */
+			#define DATAFLASH_NO_CHIP                    0
+
+			/** Mask for the first dataflash chip selected. */
+			#define DATAFLASH_CHIP1                      (1 << 0)
+
+			/** Mask for the second dataflash chip selected. */
+			#define DATAFLASH_CHIP2                      (1 << 1)
+
+			/** Internal main memory page size for the board's dataflash ICs. */
+			#define DATAFLASH_PAGE_SIZE                  1024
+
+			/** Total number of pages inside each of the board's dataflash ICs. */
+			#define DATAFLASH_PAGES                      8192
+
+		/* Inline Functions: */
+		#if !defined(__DOXYGEN__)
+			static inline void Dataflash_Init(void) {}
+			static inline uint8_t Dataflash_TransferByte(const uint8_t Byte) { return 0; }
+			static inline void Dataflash_SendByte(const uint8_t Byte) {}
+			static inline uint8_t Dataflash_ReceiveByte(void) { return 0; }
+			static inline void Dataflash_StartTransfer(const uint8_t Byte) {}
+			static inline uint8_t Dataflash_FinishTransfer(void) { return 0; }
+			static inline uint8_t Dataflash_GetSelectedChip(void) { return DATAFLASH_NO_CHIP; }
+			static inline void Dataflash_SelectChip(const uint8_t ChipMask) {}
+			static inline void Dataflash_DeselectChip(void) {}
+			static inline void Dataflash_SelectChipFromPage(const uint16_t PageAddress) {}
+			static inline void Dataflash_ToggleSelectedChipCS(void) {}
+			static inline void Dataflash_WaitWhileBusy(void) {}
+			static inline void Dataflash_SendAddressBytes(uint16_t PageAddress, const uint16_t BufferByte) {}
+		#endif
+
+#endif
+
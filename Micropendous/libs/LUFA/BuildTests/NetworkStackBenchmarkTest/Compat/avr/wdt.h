@@ -0,0 +1,13 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc header <avr/wdt.h>, for network stack sources which include it directly. The
+ *  host-side simulated architecture provides the definitions these sources use through the LUFA common header.
+ */
+
+#ifndef _COMPAT_AVR_WDT_H_
+#define _COMPAT_AVR_WDT_H_
+
+	/* Includes: */
+		#include <LUFA/Common/Common.h>
+
+#endif
@@ -0,0 +1,11 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc header <util/atomic.h>, for network stack sources which include it directly. The
+ *  atomic block macros are only used by the Webserver's hardware timer driven uIP clock, which the benchmark's
+ *  adapter replaces, so no definitions are needed.
+ */
+
+#ifndef _COMPAT_UTIL_ATOMIC_H_
+#define _COMPAT_UTIL_ATOMIC_H_
+
+#endif
@@ -0,0 +1,85 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Network stack benchmark adapter for the TCP/IP stack of the LowLevel RNDISEthernet device demo. Replayed
+ *  frames are placed into the demo's incoming frame buffer as its RNDIS task would, and the demo's Ethernet
+ *  and TCP tasks are then run until the frame has been processed and all outgoing frames have been sent.
+ */
+
+#include <Lib/Ethernet.h>
+#include <Lib/TCP.h>
+#include <Lib/Webserver.h>
+
+#include "StackInterface.h"
+
+/** Maximum number of passes through the demo's tasks for a single replayed frame. */
+#define LOWLEVEL_MAX_PASSES    16
+
+const char     Stack_Name[]         = "LowLevel RNDISEthernet demo";
+const uint8_t  Stack_MACAddress[6]  = SERVER_MAC_ADDRESS;
+const uint16_t Stack_MaxFrameLength = ETHERNET_FRAME_SIZE_MAX;
+
+void Stack_Init(void)
+{
+	TCP_Init();
+	Webserver_Init();
+}
+
+void Stack_ProcessFrame(const uint8_t* const Frame,
+                        const uint16_t Length)
+{
+	memcpy(FrameIN.FrameData, Frame, Length);
+	FrameIN.FrameLength = Length;
+
+	for (uint8_t Pass = 0; Pass < LOWLEVEL_MAX_PASSES; Pass++)
+	{
+		if (FrameIN.FrameLength && !(FrameOUT.FrameLength))
+		  Ethernet_ProcessPacket();
+
+		TCP_Task();
+
+		if (!(FrameOUT.FrameLength))
+		{
+			if (!(FrameIN.FrameLength))
+			  break;
+
+			continue;
+		}
+
+		Benchmark_TransmitFrame(FrameOUT.FrameData, FrameOUT.FrameLength);
+		FrameOUT.FrameLength = 0;
+	}
+
+	/* Discard a frame the demo could not process, as its RNDIS task would otherwise stall on it */
+	FrameIN.FrameLength = 0;
+}
+
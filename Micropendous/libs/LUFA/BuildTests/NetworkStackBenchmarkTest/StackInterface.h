@@ -0,0 +1,96 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Interface between the network stack benchmark harness in Test.c and the adapter for the network stack
+ *  under test. Exactly one adapter is built into each benchmark binary, selected by the makefile's STACK
+ *  option; the adapter feeds each replayed Ethernet frame into its stack's normal receive entry point, and
+ *  hands every frame the stack transmits back to the harness.
+ */
+
+#ifndef _STACK_INTERFACE_H_
+#define _STACK_INTERFACE_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+
+	/* Macros: */
+		/** IP address of the network stack under test, which all three stacks are configured with. */
+		#define BENCHMARK_STACK_IP_ADDRESS             {10, 0, 0, 2}
+
+		/** IP address of the simulated client which sends the replayed frames. */
+		#define BENCHMARK_CLIENT_IP_ADDRESS            {10, 0, 0, 1}
+
+		/** MAC address of the simulated client which sends the replayed frames. */
+		#define BENCHMARK_CLIENT_MAC_ADDRESS           {0x02, 0x00, 0x02, 0x00, 0x02, 0x00}
+
+	/* External Variables: */
+		/** Human readable name of the network stack under test. */
+		extern const char    Stack_Name[];
+
+		/** MAC address of the network stack under test. Unicast frames of the replayed capture are readdressed
+		 *  to this address before they are delivered to the stack.
+		 */
+		extern const uint8_t Stack_MACAddress[6];
+
+		/** Length in bytes of the largest Ethernet frame the network stack under test can receive. */
+		extern const uint16_t Stack_MaxFrameLength;
+
+		/** Simulated time in milliseconds, advanced by the harness to the timestamp of each replayed frame. */
+		extern uint32_t Benchmark_TimeMS;
+
+	/* Function Prototypes: */
+		/** Initializes the network stack under test, and its applications. This is called once before the
+		 *  first frame is replayed.
+		 */
+		void Stack_Init(void);
+
+		/** Delivers a received Ethernet frame to the network stack under test, through the stack's normal
+		 *  receive entry point, and runs the stack until it has finished processing the frame and sending
+		 *  any replies.
+		 *
+		 *  \param[in] Frame   Pointer to the received Ethernet frame, without its FCS
+		 *  \param[in] Length  Length of the frame in bytes, no more than \ref Stack_MaxFrameLength
+		 */
+		void Stack_ProcessFrame(const uint8_t* const Frame,
+		                        const uint16_t Length);
+
+		/** Called by the network stack adapter for each Ethernet frame transmitted by the stack under test.
+		 *
+		 *  \param[in] Frame   Pointer to the transmitted Ethernet frame
+		 *  \param[in] Length  Length of the frame in bytes
+		 */
+		void Benchmark_TransmitFrame(const void* const Frame,
+		                             const uint16_t Length);
+
+#endif
+
@@ -0,0 +1,552 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Packet replay benchmark harness for the network stacks in the tree. Ethernet frames are loaded from a
+ *  pcap capture file (or, if none is given, generated as a fixed workload of ARP, ICMP echo, TCP and UDP
+ *  traffic from a simulated client), and fed one at a time into the stack selected at build time through
+ *  its adapter (see StackInterface.h).
+ *
+ *  The capture is first replayed once with each frame processed on a freshly painted stack, to record the
+ *  stack high-water mark and to write the frames the stack transmits to a reply capture file. The capture
+ *  is then replayed repeatedly while the host cycles spent processing each frame are counted.
+ *
+ *  Usage: Test.elf ReplyCapture.pcap [InputCapture.pcap]
+ */
+
+#include <LUFA/Common/Common.h>
+#include <LUFA/Drivers/Misc/InternetChecksum.h>
+
+#include <ucontext.h>
+
+#include "StackInterface.h"
+
+#if (ARCH != ARCH_SIM)
+	#error The network stack benchmark requires the host-side simulated architecture (ARCH=SIM).
+#endif
+
+/** Minimum number of frames replayed in the timed passes over the capture. */
+#define BENCHMARK_TIMED_FRAMES      200000UL
+
+/** Number of sessions of the simulated client in the generated workload, when no input capture is given. */
+#define BENCHMARK_SESSIONS          64
+
+/** Size of the painted stack each frame is processed on in the measurement pass. */
+#define BENCHMARK_STACK_SIZE        (64UL * 1024UL)
+
+/** Value the measurement pass stack is painted with, to find the deepest location written by the stack. */
+#define BENCHMARK_STACK_PATTERN     0xA5
+
+/** Maximum number of frames captured from the stack in reply to a single replayed frame. */
+#define BENCHMARK_MAX_REPLIES       16
+
+/** Maximum length of a captured frame, including the FCS. */
+#define BENCHMARK_MAX_FRAME_LENGTH  1518
+
+/** \name pcap File Format Constants */
+//@{
+#define PCAP_MAGIC_USEC             0xA1B2C3D4UL
+#define PCAP_MAGIC_NSEC             0xA1B23C4DUL
+#define PCAP_LINKTYPE_ETHERNET      1
+#define PCAP_SNAPLEN                65535UL
+//@}
+
+/** Type define for a frame of the replayed capture. */
+typedef struct
+{
+	uint32_t TimeMS; /**< Time of the frame, relative to the start of the capture */
+	uint16_t Length; /**< Length of the frame in bytes */
+	uint8_t* Data; /**< Frame contents */
+} Benchmark_Frame_t;
+
+/** Type define for the set of replies captured from the stack for a single replayed frame. */
+typedef struct
+{
+	uint8_t  TotalReplies; /**< Number of frames held in the reply set */
+	uint16_t Length[BENCHMARK_MAX_REPLIES]; /**< Length of each frame */
+	uint8_t  Data[BENCHMARK_MAX_REPLIES][BENCHMARK_MAX_FRAME_LENGTH]; /**< Contents of each frame */
+} Benchmark_Replies_t;
+
+static const uint8_t ClientMACAddress[6]    = BENCHMARK_CLIENT_MAC_ADDRESS;
+static const uint8_t ClientIPAddress[4]     = BENCHMARK_CLIENT_IP_ADDRESS;
+static const uint8_t StackIPAddress[4]      = BENCHMARK_STACK_IP_ADDRESS;
+static const uint8_t BroadcastMACAddress[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+uint32_t Benchmark_TimeMS;
+
+/** Frames of the replayed capture, and the number of frames it holds. The harness keeps its buffers on the
+ *  heap, so that the static RAM of the benchmark image is almost entirely that of the stack under test.
+ */
+static Benchmark_Frame_t*   Frames;
+static uint32_t             TotalFrames;
+
+/** Replies captured from the stack in the measurement pass, or \c NULL if replies are only counted. */
+static Benchmark_Replies_t* Replies;
+static uint32_t             TotalReplies;
+
+/** Memory of the painted stack used to measure the stack high-water mark, and the frame to process on it. */
+static uint8_t*             StackMemory;
+static const Benchmark_Frame_t* StackContextFrame;
+
+/** Linker defined bounds of the benchmark image's initialized and zeroed data. */
+extern char __data_start[], _edata[], __bss_start[], _end[];
+
+void Benchmark_TransmitFrame(const void* const Frame,
+                             const uint16_t Length)
+{
+	TotalReplies++;
+
+	/* Only copy the frame in the measurement pass, and never call the C library's I/O functions, whose
+	   stack usage would otherwise be counted against the stack under test */
+	if (!(Replies) || (Replies->TotalReplies == BENCHMARK_MAX_REPLIES))
+	  return;
+
+	uint16_t CaptureLength = MIN(Length, BENCHMARK_MAX_FRAME_LENGTH);
+
+	memcpy(Replies->Data[Replies->TotalReplies], Frame, CaptureLength);
+	Replies->Length[Replies->TotalReplies++] = CaptureLength;
+}
+
+static void Fail(const char* const Message,
+                 const char* const Detail)
+{
+	fprintf(stderr, "%s: %s\n", Message, Detail);
+	exit(EXIT_FAILURE);
+}
+
+static uint32_t SwapIf(const bool Swap,
+                       const uint32_t Value)
+{
+	return (Swap ? SwapEndian_32(Value) : Value);
+}
+
+static void AddFrame(const uint32_t TimeMS,
+                     const uint8_t* const Data,
+                     const uint16_t Length)
+{
+	if (!(TotalFrames % 256))
+	{
+		if (!(Frames = realloc(Frames, (TotalFrames + 256) * sizeof(Benchmark_Frame_t))))
+		  Fail("Out of memory", "capture frames");
+	}
+
+	Benchmark_Frame_t* Frame = &Frames[TotalFrames++];
+
+	Frame->TimeMS = TimeMS;
+	Frame->Length = Length;
+
+	if (!(Frame->Data = malloc(Length)))
+	  Fail("Out of memory", "capture frame data");
+
+	memcpy(Frame->Data, Data, Length);
+
+	/* Readdress unicast frames to the stack under test, so that one capture may be replayed into each stack */
+	if ((Length >= 6) && !(Frame->Data[0] & 0x01))
+	  memcpy(Frame->Data, Stack_MACAddress, sizeof(Stack_MACAddress));
+}
+
+static void LoadCapture(const char* const FileName)
+{
+	FILE*    CaptureFile = fopen(FileName, "rb");
+	uint32_t Header[6];
+	uint8_t  FrameData[PCAP_SNAPLEN];
+
+	if (!(CaptureFile))
+	  Fail("Cannot open input capture", FileName);
+
+	if (fread(Header, sizeof(Header), 1, CaptureFile) != 1)
+	  Fail("Truncated input capture", FileName);
+
+	bool     Swapped    = ((Header[0] == SwapEndian_32(PCAP_MAGIC_USEC)) || (Header[0] == SwapEndian_32(PCAP_MAGIC_NSEC)));
+	uint32_t Magic      = SwapIf(Swapped, Header[0]);
+	uint32_t FirstTime  = 0;
+
+	if ((Magic != PCAP_MAGIC_USEC) && (Magic != PCAP_MAGIC_NSEC))
+	  Fail("Not a pcap capture file", FileName);
+
+	if (SwapIf(Swapped, Header[5]) != PCAP_LINKTYPE_ETHERNET)
+	  Fail("Capture is not of Ethernet frames", FileName);
+
+	uint32_t RecordHeader[4];
+
+	while (fread(RecordHeader, sizeof(RecordHeader), 1, CaptureFile) == 1)
+	{
+		uint32_t Seconds        = SwapIf(Swapped, RecordHeader[0]);
+		uint32_t Fraction       = SwapIf(Swapped, RecordHeader[1]);
+		uint32_t CapturedLength = SwapIf(Swapped, RecordHeader[2]);
+
+		if ((CapturedLength > sizeof(FrameData)) || (fread(FrameData, CapturedLength, 1, CaptureFile) != 1))
+		  Fail("Truncated input capture", FileName);
+
+		uint32_t TimeMS = ((Seconds * 1000UL) + ((Magic == PCAP_MAGIC_NSEC) ? (Fraction / 1000000UL) : (Fraction / 1000UL)));
+
+		if (!(TotalFrames))
+		  FirstTime = TimeMS;
+
+		AddFrame(TimeMS - FirstTime, FrameData, CapturedLength);
+	}
+
+	fclose(CaptureFile);
+
+	if (!(TotalFrames))
+	  Fail("No frames in input capture", FileName);
+}
+
+static void PutBE16(uint8_t* const Data,
+                    const uint16_t Value)
+{
+	Data[0] = (Value >> 8);
+	Data[1] = (Value & 0xFF);
+}
+
+static void PutBE32(uint8_t* const Data,
+                    const uint32_t Value)
+{
+	PutBE16(&Data[0], (Value >> 16));
+	PutBE16(&Data[2], (Value & 0xFFFF));
+}
+
+/** Fills in the Ethernet and IPv4 headers of a generated frame sent from the client to the stack, and the
+ *  checksum of its TCP or UDP payload if the checksum offset within the transport header is non-zero.
+ *
+ *  \return Total length of the frame in bytes
+ */
+static uint16_t PutIPFrame(uint8_t* const Frame,
+                           const uint8_t Protocol,
+                           const uint16_t TransportLength,
+                           const uint16_t ChecksumOffset)
+{
+	static uint16_t Identification;
+
+	uint8_t* IPHeader  = &Frame[14];
+	uint8_t* Transport = &Frame[14 + 20];
+
+	memcpy(&Frame[0], Stack_MACAddress, 6);
+	memcpy(&Frame[6], ClientMACAddress, 6);
+	PutBE16(&Frame[12], 0x0800);
+
+	IPHeader[0] = 0x45;
+	IPHeader[1] = 0;
+	PutBE16(&IPHeader[2], (20 + TransportLength));
+	PutBE16(&IPHeader[4], Identification++);
+	PutBE16(&IPHeader[6], 0);
+	IPHeader[8] = 64;
+	IPHeader[9] = Protocol;
+	PutBE16(&IPHeader[10], 0);
+	memcpy(&IPHeader[12], ClientIPAddress, 4);
+	memcpy(&IPHeader[16], StackIPAddress, 4);
+
+	uint16_t HeaderChecksum = ~InetChecksum_Add(0, IPHeader, 20);
+	memcpy(&IPHeader[10], &HeaderChecksum, sizeof(uint16_t));
+
+	if (ChecksumOffset)
+	{
+		uint8_t PseudoHeader[12];
+
+		memcpy(&PseudoHeader[0], ClientIPAddress, 4);
+		memcpy(&PseudoHeader[4], StackIPAddress, 4);
+		PseudoHeader[8] = 0;
+		PseudoHeader[9] = Protocol;
+		PutBE16(&PseudoHeader[10], TransportLength);
+
+		PutBE16(&Transport[ChecksumOffset], 0);
+
+		uint16_t Checksum = ~InetChecksum_Add(InetChecksum_Add(0, PseudoHeader, sizeof(PseudoHeader)),
+		                                      Transport, TransportLength);
+		memcpy(&Transport[ChecksumOffset], &Checksum, sizeof(uint16_t));
+	}
+
+	return (14 + 20 + TransportLength);
+}
+
+static uint16_t PutTCPFrame(uint8_t* const Frame,
+                            const uint16_t SourcePort,
+                            const uint32_t SequenceNumber,
+                            const uint8_t Flags)
+{
+	uint8_t* TCPHeader    = &Frame[14 + 20];
+	bool     HasMSSOption = (Flags & 0x02);
+	uint8_t  HeaderLength = (HasMSSOption ? 24 : 20);
+
+	memset(TCPHeader, 0, HeaderLength);
+	PutBE16(&TCPHeader[0], SourcePort);
+	PutBE16(&TCPHeader[2], 80);
+	PutBE32(&TCPHeader[4], SequenceNumber);
+	TCPHeader[12] = ((HeaderLength / 4) << 4);
+	TCPHeader[13] = Flags;
+	PutBE16(&TCPHeader[14], 8192);
+
+	if (HasMSSOption)
+	{
+		TCPHeader[20] = 2;
+		TCPHeader[21] = 4;
+		PutBE16(&TCPHeader[22], 1460);
+	}
+
+	return PutIPFrame(Frame, 6, HeaderLength, 16);
+}
+
+/** Generates the default workload when no input capture is given. Each session of the simulated client
+ *  resolves the stack's address with ARP, pings it, opens and resets a TCP connection to port 80, and sends
+ *  a UDP datagram to the discard port.
+ */
+static void GenerateCapture(void)
+{
+	uint8_t  Frame[BENCHMARK_MAX_FRAME_LENGTH];
+	uint32_t TimeMS = 0;
+
+	for (uint16_t Session = 0; Session < BENCHMARK_SESSIONS; Session++)
+	{
+		uint16_t ClientPort     = (49152 + Session);
+		uint32_t SequenceNumber = (0x10000000UL + ((uint32_t)Session << 16));
+		uint16_t Length;
+
+		/* ARP request for the stack's address, padded to the minimum Ethernet frame length */
+		memset(Frame, 0, 60);
+		memcpy(&Frame[0], BroadcastMACAddress, 6);
+		memcpy(&Frame[6], ClientMACAddress, 6);
+		PutBE16(&Frame[12], 0x0806);
+		PutBE16(&Frame[14], 1);
+		PutBE16(&Frame[16], 0x0800);
+		Frame[18] = 6;
+		Frame[19] = 4;
+		PutBE16(&Frame[20], 1);
+		memcpy(&Frame[22], ClientMACAddress, 6);
+		memcpy(&Frame[28], ClientIPAddress, 4);
+		memcpy(&Frame[38], StackIPAddress, 4);
+		AddFrame(TimeMS++, Frame, 60);
+
+		/* ICMP echo request with a 56 byte payload */
+		uint8_t* ICMPHeader = &Frame[14 + 20];
+		ICMPHeader[0] = 8;
+		ICMPHeader[1] = 0;
+		PutBE16(&ICMPHeader[2], 0);
+		PutBE16(&ICMPHeader[4], 0x4C55);
+		PutBE16(&ICMPHeader[6], Session);
+		for (uint8_t i = 0; i < 56; i++)
+		  ICMPHeader[8 + i] = i;
+
+		uint16_t ICMPChecksum = ~InetChecksum_Add(0, ICMPHeader, (8 + 56));
+		memcpy(&ICMPHeader[2], &ICMPChecksum, sizeof(uint16_t));
+
+		Length = PutIPFrame(Frame, 1, (8 + 56), 0);
+		AddFrame(TimeMS++, Frame, Length);
+
+		/* TCP connection request to the HTTP port, then a reset of the half-open connection */
+		Length = PutTCPFrame(Frame, ClientPort, SequenceNumber, 0x02);
+		AddFrame(TimeMS++, Frame, Length);
+
+		Length = PutTCPFrame(Frame, ClientPort, (SequenceNumber + 1), 0x04);
+		AddFrame(TimeMS++, Frame, Length);
+
+		/* UDP datagram with a 32 byte payload to the discard port */
+		uint8_t* UDPHeader = &Frame[14 + 20];
+		PutBE16(&UDPHeader[0], ClientPort);
+		PutBE16(&UDPHeader[2], 9);
+		PutBE16(&UDPHeader[4], (8 + 32));
+		memset(&UDPHeader[8], 'U', 32);
+
+		Length = PutIPFrame(Frame, 17, (8 + 32), 6);
+		AddFrame(TimeMS++, Frame, Length);
+	}
+}
+
+static void WriteCaptureRecord(FILE* const CaptureFile,
+                               const uint32_t TimeMS,
+                               const void* const Data,
+                               const uint16_t Length)
+{
+	uint32_t RecordHeader[4] = {(TimeMS / 1000), ((TimeMS % 1000) * 1000), Length, Length};
+
+	fwrite(RecordHeader, sizeof(RecordHeader), 1, CaptureFile);
+	fwrite(Data, Length, 1, CaptureFile);
+}
+
+static void StackContextEntry(void)
+{
+	Stack_ProcessFrame(StackContextFrame->Data, StackContextFrame->Length);
+}
+
+/** Processes a frame on a freshly painted stack, returning the number of bytes of the stack it used. */
+static uint32_t ProcessFrameOnPaintedStack(const Benchmark_Frame_t* const Frame)
+{
+	ucontext_t HarnessContext;
+	ucontext_t StackContext;
+
+	memset(StackMemory, BENCHMARK_STACK_PATTERN, BENCHMARK_STACK_SIZE);
+
+	getcontext(&StackContext);
+	StackContext.uc_stack.ss_sp   = StackMemory;
+	StackContext.uc_stack.ss_size = BENCHMARK_STACK_SIZE;
+	StackContext.uc_link          = &HarnessContext;
+	makecontext(&StackContext, StackContextEntry, 0);
+
+	StackContextFrame = Frame;
+	swapcontext(&HarnessContext, &StackContext);
+
+	uint32_t UnusedBytes = 0;
+
+	while ((UnusedBytes < BENCHMARK_STACK_SIZE) && (StackMemory[UnusedBytes] == BENCHMARK_STACK_PATTERN))
+	  UnusedBytes++;
+
+	return (BENCHMARK_STACK_SIZE - UnusedBytes);
+}
+
+static int CompareCycles(const void* A,
+                         const void* B)
+{
+	uint64_t CyclesA = *(const uint64_t*)A;
+	uint64_t CyclesB = *(const uint64_t*)B;
+
+	return (CyclesA > CyclesB) - (CyclesA < CyclesB);
+}
+
+int main(int argc,
+         char* argv[])
+{
+	if ((argc < 2) || (argc > 3))
+	{
+		fprintf(stderr, "Usage: %s ReplyCapture.pcap [InputCapture.pcap]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (argc == 3)
+	  LoadCapture(argv[2]);
+	else
+	  GenerateCapture();
+
+	FILE* ReplyFile = fopen(argv[1], "wb");
+
+	if (!(ReplyFile))
+	  Fail("Cannot create reply capture", argv[1]);
+
+	uint32_t ReplyFileHeader[6] = {PCAP_MAGIC_USEC, 0x00040002UL, 0, 0, PCAP_SNAPLEN, PCAP_LINKTYPE_ETHERNET};
+	fwrite(ReplyFileHeader, sizeof(ReplyFileHeader), 1, ReplyFile);
+
+	Replies     = malloc(sizeof(Benchmark_Replies_t));
+	StackMemory = malloc(BENCHMARK_STACK_SIZE);
+
+	if (!(Replies) || !(StackMemory))
+	  Fail("Out of memory", "measurement pass");
+
+	Stack_Init();
+
+	/* Measurement pass - process each frame on a painted stack, and capture the stack's replies */
+	uint32_t StackHighWater = 0;
+	uint32_t DroppedFrames  = 0;
+
+	for (uint32_t i = 0; i < TotalFrames; i++)
+	{
+		Benchmark_TimeMS = Frames[i].TimeMS;
+
+		if (Frames[i].Length > Stack_MaxFrameLength)
+		{
+			DroppedFrames++;
+			continue;
+		}
+
+		Replies->TotalReplies = 0;
+
+		uint32_t StackUsed = ProcessFrameOnPaintedStack(&Frames[i]);
+		StackHighWater = MAX(StackHighWater, StackUsed);
+
+		for (uint8_t j = 0; j < Replies->TotalReplies; j++)
+		  WriteCaptureRecord(ReplyFile, Benchmark_TimeMS, Replies->Data[j], Replies->Length[j]);
+	}
+
+	fclose(ReplyFile);
+	free(Replies);
+	Replies = NULL;
+
+	uint32_t ReplayedFrames  = (TotalFrames - DroppedFrames);
+	uint32_t CapturedReplies = TotalReplies;
+
+	if (!(ReplayedFrames))
+	  Fail("No frames could be delivered to", Stack_Name);
+
+	/* Timed passes - replay the capture until enough frames have been processed, timing each frame */
+	uint32_t  TimedPasses   = ((BENCHMARK_TIMED_FRAMES + ReplayedFrames - 1) / ReplayedFrames);
+	uint32_t  TimedFrames   = (TimedPasses * ReplayedFrames);
+	uint64_t* FrameCycles   = malloc(TimedFrames * sizeof(uint64_t));
+	uint32_t  PassStartTime = (Frames[TotalFrames - 1].TimeMS + 1);
+	uint32_t  FrameIndex    = 0;
+
+	if (!(FrameCycles))
+	  Fail("Out of memory", "timed passes");
+
+	struct timespec StartTime;
+	struct timespec EndTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &StartTime);
+
+	for (uint32_t Pass = 0; Pass < TimedPasses; Pass++)
+	{
+		for (uint32_t i = 0; i < TotalFrames; i++)
+		{
+			if (Frames[i].Length > Stack_MaxFrameLength)
+			  continue;
+
+			Benchmark_TimeMS = (PassStartTime + Frames[i].TimeMS);
+
+			uint64_t StartCycles = SIM_GetCycleCount();
+			Stack_ProcessFrame(Frames[i].Data, Frames[i].Length);
+			FrameCycles[FrameIndex++] = (SIM_GetCycleCount() - StartCycles);
+		}
+
+		PassStartTime = (Benchmark_TimeMS + 1);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &EndTime);
+
+	double   Seconds     = (EndTime.tv_sec - StartTime.tv_sec) + ((EndTime.tv_nsec - StartTime.tv_nsec) / 1e9);
+	uint64_t TotalCycles = 0;
+
+	for (uint32_t i = 0; i < TimedFrames; i++)
+	  TotalCycles += FrameCycles[i];
+
+	qsort(FrameCycles, TimedFrames, sizeof(FrameCycles[0]), CompareCycles);
+
+	uint32_t DataBytes = (_edata - __data_start);
+	uint32_t BSSBytes  = (_end - __bss_start);
+
+	printf("Network stack benchmark - %s:\n", Stack_Name);
+	printf("  Frames replayed             %10lu (%lu too long for the stack)\n", (unsigned long)ReplayedFrames, (unsigned long)DroppedFrames);
+	printf("  Frames transmitted          %10lu\n", (unsigned long)CapturedReplies);
+	printf("  Frames per second           %10.0f\n", (TimedFrames / Seconds));
+	printf("  Cycles per frame (median)   %10llu\n", (unsigned long long)FrameCycles[TimedFrames / 2]);
+	printf("  Cycles per frame (mean)     %10.0f\n", ((double)TotalCycles / TimedFrames));
+	printf("  Stack high-water (bytes)    %10lu\n", (unsigned long)StackHighWater);
+	printf("  Static RAM (bytes)          %10lu (.data %lu, .bss %lu)\n", (unsigned long)(DataBytes + BSSBytes),
+	       (unsigned long)DataBytes, (unsigned long)BSSBytes);
+	printf("  RAM high-water (bytes)      %10lu\n", (unsigned long)(DataBytes + BSSBytes + StackHighWater));
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+//*****************************************************************************
+//
+// File Name	: 'global.h'
+// Title		: AVRlib project global include for the network stack benchmark
+// Target MCU	: Host-side simulated architecture (ARCH=SIM)
+// Editor Tabs	: 4
+//
+//	Description : Project global include file required by the AVRlib network
+//					stack sources, which the AVRlib network stack benchmark
+//					adapter is built with.
+//
+//*****************************************************************************
+
+#ifndef GLOBAL_H
+#define GLOBAL_H
+
+// global AVRLIB defines
+#include "avrlibdefs.h"
+// global AVRLIB types definitions
+#include "avrlibtypes.h"
+
+// project/system dependent defines
+
+// CPU clock speed, normally supplied by the LUFA build scripts
+#ifndef F_CPU
+#define F_CPU        48000000
+#endif
+
+// CYCLES_PER_US is used by some short delay loops
+#define CYCLES_PER_US ((F_CPU+500000)/1000000) 	// cpu cycles per microsecond
+
+#endif
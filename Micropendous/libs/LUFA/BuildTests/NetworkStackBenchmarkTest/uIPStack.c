@@ -0,0 +1,143 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Network stack benchmark adapter for the uIP TCP/IP stack of the Webserver project, with its DHCP and TELNET
+ *  applications. Replayed frames are handed to the Webserver's uIP manager through stand-ins for the RNDIS
+ *  device class driver functions it calls, and the manager is then run until it has nothing more to send.
+ *
+ *  The Webserver's HTTP application serves files from its FAT filesystem on the board Dataflash, which has no
+ *  counterpart here; it is replaced by a minimal application which answers each request on the HTTP port with
+ *  a fixed page, so that TCP connections to the HTTP port are still accepted and exercised.
+ */
+
+#include <Lib/uIPManagement.h>
+#include <USBDeviceMode.h>
+
+#include "StackInterface.h"
+
+/** Maximum number of passes through the uIP manager for a single replayed frame. */
+#define UIP_MAX_PASSES    16
+
+const char     Stack_Name[]         = "Webserver uIP";
+const uint8_t  Stack_MACAddress[6]  = {1, 0, 1, 0, 1, 0};
+const uint16_t Stack_MaxFrameLength = UIP_CONF_BUFFER_SIZE;
+
+/** Fixed response of the stand-in HTTP application. */
+static const char HTTPResponse[] = "HTTP/1.1 200 OK\r\n"
+                                   "Content-Type: text/plain\r\n"
+                                   "Content-Length: 2\r\n\r\nOK";
+
+/** Replayed frame waiting to be read by the uIP manager, and its length. */
+static const uint8_t* PendingFrame;
+static uint16_t       PendingFrameLength;
+
+/** Number of frames sent by the uIP manager since the counter was last cleared. */
+static uint8_t        FramesSent;
+
+volatile uint8_t USB_DeviceState = DEVICE_STATE_Configured;
+
+USB_ClassInfo_RNDIS_Device_t Ethernet_RNDIS_Interface_Device;
+
+bool RNDIS_Device_IsPacketReceived(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	return (PendingFrame != NULL);
+}
+
+uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                uint16_t* const PacketLength)
+{
+	memcpy(Buffer, PendingFrame, PendingFrameLength);
+	*PacketLength = PendingFrameLength;
+
+	PendingFrame = NULL;
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                const uint16_t PacketLength)
+{
+	FramesSent++;
+	Benchmark_TransmitFrame(Buffer, PacketLength);
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+void clock_init(void)
+{
+
+}
+
+clock_time_t clock_time(void)
+{
+	return (Benchmark_TimeMS / (1000 / CLOCK_SECOND));
+}
+
+void HTTPServerApp_Init(void)
+{
+	uip_listen(HTONS(HTTP_SERVER_PORT));
+}
+
+void HTTPServerApp_Callback(void)
+{
+	if (uip_aborted() || uip_timedout() || uip_closed())
+	  return;
+
+	if (uip_newdata() || uip_rexmit())
+	  uip_send(HTTPResponse, (sizeof(HTTPResponse) - 1));
+	else if (uip_acked())
+	  uip_close();
+}
+
+void Stack_Init(void)
+{
+	uIPManagement_Init();
+}
+
+void Stack_ProcessFrame(const uint8_t* const Frame,
+                        const uint16_t Length)
+{
+	PendingFrame       = Frame;
+	PendingFrameLength = Length;
+
+	for (uint8_t Pass = 0; Pass < UIP_MAX_PASSES; Pass++)
+	{
+		FramesSent = 0;
+
+		uIPManagement_ManageNetwork();
+
+		if (!(PendingFrame) && !(FramesSent))
+		  break;
+	}
+}
+
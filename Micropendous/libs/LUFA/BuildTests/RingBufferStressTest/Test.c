@@ -0,0 +1,235 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include <LUFA/Common/Common.h>
+#include <LUFA/Drivers/Misc/RingBufferSPSC.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#if (ARCH != ARCH_SIM)
+	#error The ring buffer stress test requires the host-side simulated architecture (ARCH=SIM).
+#endif
+
+/** Size of the ring buffer under test, which must be a power of two. */
+#define STRESS_BUFFER_SIZE      128
+
+/** Total number of bytes passed from the producer thread to the consumer thread. */
+#define STRESS_TOTAL_BYTES      (16UL * 1024UL * 1024UL)
+
+/** Largest block inserted or removed in a single block or span operation. */
+#define STRESS_MAX_BLOCK        (STRESS_BUFFER_SIZE + 37)
+
+/** Ring buffer shared between the producer and consumer threads. */
+static RingBufferSPSC_t StressBuffer;
+
+/** Underlying data buffer for \ref StressBuffer. */
+static uint8_t          StressBuffer_Data[STRESS_BUFFER_SIZE];
+
+/** Advances a simple xorshift pseudo-random generator, used both to choose each thread's next operation
+ *  and size, and to generate the expected byte stream.
+ */
+static uint32_t NextRandom(uint32_t* const State)
+{
+	uint32_t x = *State;
+
+	x ^= (x << 13);
+	x ^= (x >> 17);
+	x ^= (x << 5);
+
+	return (*State = x);
+}
+
+/** Returns the expected value of the given byte of the stream. */
+static uint8_t StreamByte(const uint32_t Index)
+{
+	return (uint8_t)((Index * 2654435761UL) >> 24);
+}
+
+static void* ProducerThread(void* Param)
+{
+	uint32_t RandomState = 0x12345678;
+	uint32_t BytesSent   = 0;
+	uint8_t  Block[STRESS_MAX_BLOCK];
+
+	while (BytesSent < STRESS_TOTAL_BYTES)
+	{
+		uint32_t Random = NextRandom(&RandomState);
+		uint16_t Length = (1 + ((Random >> 8) % STRESS_MAX_BLOCK));
+
+		if (Length > (STRESS_TOTAL_BYTES - BytesSent))
+		  Length = (STRESS_TOTAL_BYTES - BytesSent);
+
+		switch (Random & 0x03)
+		{
+			case 0:
+				if (RingBufferSPSC_IsFull(&StressBuffer))
+				{
+					sched_yield();
+					break;
+				}
+
+				RingBufferSPSC_Insert(&StressBuffer, StreamByte(BytesSent++));
+				break;
+			case 1:
+			{
+				uint8_t*   Span;
+				uint_reg_t SpanLength = RingBufferSPSC_ReserveSpan(&StressBuffer, &Span);
+
+				if (SpanLength > Length)
+				  SpanLength = Length;
+
+				for (uint_reg_t i = 0; i < SpanLength; i++)
+				  Span[i] = StreamByte(BytesSent + i);
+
+				RingBufferSPSC_AdvanceIn(&StressBuffer, SpanLength);
+				BytesSent += SpanLength;
+
+				if (!(SpanLength))
+				  sched_yield();
+
+				break;
+			}
+			default:
+			{
+				for (uint16_t i = 0; i < Length; i++)
+				  Block[i] = StreamByte(BytesSent + i);
+
+				uint16_t BytesInserted = RingBufferSPSC_InsertBlock(&StressBuffer, Block, Length);
+				BytesSent += BytesInserted;
+
+				if (!(BytesInserted))
+				  sched_yield();
+
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void* ConsumerThread(void* Param)
+{
+	uint32_t RandomState = 0x87654321;
+	uint32_t BytesReceived = 0;
+	uint8_t  Block[STRESS_MAX_BLOCK];
+
+	while (BytesReceived < STRESS_TOTAL_BYTES)
+	{
+		uint32_t Random    = NextRandom(&RandomState);
+		uint16_t Length    = (1 + ((Random >> 8) % STRESS_MAX_BLOCK));
+		uint8_t* Received  = Block;
+		uint16_t BytesRead = 0;
+
+		switch (Random & 0x03)
+		{
+			case 0:
+				if (RingBufferSPSC_IsEmpty(&StressBuffer))
+				  break;
+
+				if (RingBufferSPSC_Peek(&StressBuffer) != StreamByte(BytesReceived))
+				{
+					fprintf(stderr, "RingBufferSPSC_Peek() returned the wrong byte at offset %lu\n", (unsigned long)BytesReceived);
+					exit(EXIT_FAILURE);
+				}
+
+				Block[0]  = RingBufferSPSC_Remove(&StressBuffer);
+				BytesRead = 1;
+				break;
+			case 1:
+				BytesRead = RingBufferSPSC_PeekSpan(&StressBuffer, &Received);
+
+				if (BytesRead > Length)
+				  BytesRead = Length;
+
+				break;
+			default:
+				BytesRead = RingBufferSPSC_RemoveBlock(&StressBuffer, Block, Length);
+				break;
+		}
+
+		for (uint16_t i = 0; i < BytesRead; i++)
+		{
+			if (Received[i] != StreamByte(BytesReceived + i))
+			{
+				fprintf(stderr, "Stream corrupted at offset %lu: expected 0x%02X, got 0x%02X\n",
+				        (unsigned long)(BytesReceived + i), StreamByte(BytesReceived + i), Received[i]);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		if (Received != Block)
+		  RingBufferSPSC_AdvanceOut(&StressBuffer, BytesRead);
+
+		if (RingBufferSPSC_GetCount(&StressBuffer) > STRESS_BUFFER_SIZE)
+		{
+			fprintf(stderr, "Buffer count out of range at offset %lu\n", (unsigned long)BytesReceived);
+			exit(EXIT_FAILURE);
+		}
+
+		BytesReceived += BytesRead;
+
+		if (!(BytesRead))
+		  sched_yield();
+	}
+
+	return NULL;
+}
+
+int main(void)
+{
+	pthread_t Producer;
+	pthread_t Consumer;
+
+	RingBufferSPSC_InitBuffer(&StressBuffer, StressBuffer_Data, sizeof(StressBuffer_Data));
+
+	printf("Ring buffer stress test: passing %lu bytes through a %u byte SPSC buffer...\n",
+	       (unsigned long)STRESS_TOTAL_BYTES, STRESS_BUFFER_SIZE);
+
+	uint64_t StartCycles = SIM_GetCycleCount();
+
+	pthread_create(&Consumer, NULL, ConsumerThread, NULL);
+	pthread_create(&Producer, NULL, ProducerThread, NULL);
+
+	pthread_join(Producer, NULL);
+	pthread_join(Consumer, NULL);
+
+	if (!(RingBufferSPSC_IsEmpty(&StressBuffer)))
+	{
+		fprintf(stderr, "Buffer not empty after all data was consumed\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Ring buffer stress test passed, %.1f host cycles per byte.\n",
+	       (double)(SIM_GetCycleCount() - StartCycles) / STRESS_TOTAL_BYTES);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,436 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include <LUFA/Common/Common.h>
+#include <LUFA/Drivers/USB/USB.h>
+
+#if (ARCH != ARCH_SIM)
+	#error The stream benchmark requires the host-side simulated USB controller (ARCH=SIM).
+#endif
+
+/** Endpoint address of the benchmark's device-to-host endpoint. */
+#define BENCHMARK_IN_EPADDR     (ENDPOINT_DIR_IN  | 1)
+
+/** Endpoint address of the benchmark's host-to-device endpoint. */
+#define BENCHMARK_OUT_EPADDR    (ENDPOINT_DIR_OUT | 2)
+
+/** Size in bytes of each benchmark endpoint bank, and of each timed stream transfer. */
+#define BENCHMARK_EPSIZE        64
+
+/** Number of packets timed for each stream function. */
+#define BENCHMARK_PACKETS       4096
+
+/** Size in bytes of the patterned stream buffers, several endpoint banks long. */
+#define PATTERN_LENGTH          256
+
+/** Value of byte \c i of the test pattern, which reads differently backwards so that byte order errors are caught. */
+#define PATTERN_BYTE(i)         ((uint8_t)(((i) * 37) + 11))
+
+#define PATTERN_4(i)            PATTERN_BYTE(i), PATTERN_BYTE(i + 1), PATTERN_BYTE(i + 2), PATTERN_BYTE(i + 3)
+#define PATTERN_16(i)           PATTERN_4(i),  PATTERN_4(i + 4),   PATTERN_4(i + 8),   PATTERN_4(i + 12)
+#define PATTERN_64(i)           PATTERN_16(i), PATTERN_16(i + 16), PATTERN_16(i + 32), PATTERN_16(i + 48)
+#define PATTERN_256(i)          PATTERN_64(i), PATTERN_64(i + 64), PATTERN_64(i + 128), PATTERN_64(i + 192)
+
+typedef uint8_t (*WriteStreamFunc_t)(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed);
+typedef uint8_t (*ReadStreamFunc_t)(void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed);
+
+/** Type define for an endpoint stream function under test, and the buffer it transfers. */
+typedef struct
+{
+	const char*       FunctionName; /**< Name of the stream function, for the test report. */
+	WriteStreamFunc_t WriteFunc; /**< Stream function if it writes to the IN endpoint, otherwise \c NULL. */
+	ReadStreamFunc_t  ReadFunc; /**< Stream function if it reads from the OUT endpoint, otherwise \c NULL. */
+	void*             Buffer; /**< Buffer holding the test pattern, in the function's memory space. */
+	bool              InEEPROM; /**< Whether \c Buffer is located in EEPROM rather than RAM or FLASH. */
+	bool              BigEndian; /**< Whether the function transfers the buffer last byte first. */
+} StreamFunction_t;
+
+/** Direction of the running benchmark or verification phase, as a \c ENDPOINT_DIR_* mask. */
+static volatile uint8_t  BenchmarkDirection;
+
+/** Number of packets the simulated host has still to move in the running benchmark phase. */
+static volatile uint16_t BenchmarkPacketsRemaining;
+
+/** Per-packet cycle counts of the running benchmark phase. */
+static uint64_t PacketCycles[BENCHMARK_PACKETS];
+
+/** Bus data of the running verification phase, which the simulated host sends or expects to receive. */
+static uint8_t           VerifyData[PATTERN_LENGTH];
+
+/** Total length of the running verification phase's transfer. */
+static volatile uint16_t VerifyLength;
+
+/** Number of bytes the simulated host has still to move in the running verification phase. */
+static volatile uint16_t VerifyBytesRemaining;
+
+/** Set by the simulated host when it receives a packet other than the one expected. */
+static volatile bool     VerifyFailed;
+
+static uint8_t       Pattern[PATTERN_LENGTH];
+static uint8_t       RAMBuffer[PATTERN_LENGTH];
+static const uint8_t FlashBuffer[PATTERN_LENGTH] PROGMEM = {PATTERN_256(0)};
+static uint8_t       EEPROMBuffer[PATTERN_LENGTH] EEMEM;
+
+static const StreamFunction_t StreamFunctions[] =
+	{
+		{"Endpoint_Write_Stream_LE",  Endpoint_Write_Stream_LE,  NULL,                     RAMBuffer,           false, false},
+		{"Endpoint_Write_Stream_BE",  Endpoint_Write_Stream_BE,  NULL,                     RAMBuffer,           false, true },
+		{"Endpoint_Read_Stream_LE",   NULL,                      Endpoint_Read_Stream_LE,  RAMBuffer,           false, false},
+		{"Endpoint_Read_Stream_BE",   NULL,                      Endpoint_Read_Stream_BE,  RAMBuffer,           false, true },
+		{"Endpoint_Write_PStream_LE", Endpoint_Write_PStream_LE, NULL,                     (void*)FlashBuffer,  false, false},
+		{"Endpoint_Write_PStream_BE", Endpoint_Write_PStream_BE, NULL,                     (void*)FlashBuffer,  false, true },
+		{"Endpoint_Write_EStream_LE", Endpoint_Write_EStream_LE, NULL,                     EEPROMBuffer,        true,  false},
+		{"Endpoint_Write_EStream_BE", Endpoint_Write_EStream_BE, NULL,                     EEPROMBuffer,        true,  true },
+		{"Endpoint_Read_EStream_LE",  NULL,                      Endpoint_Read_EStream_LE, EEPROMBuffer,        true,  false},
+		{"Endpoint_Read_EStream_BE",  NULL,                      Endpoint_Read_EStream_BE, EEPROMBuffer,        true,  true },
+	};
+
+/** Transfer lengths verified for each stream function: single bytes, partial, exact and multiple banks. */
+static const uint16_t VerifyLengths[] = {1, 63, 64, 65, 128, 200, PATTERN_LENGTH};
+
+uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
+                                    const uint8_t wIndex,
+                                    const void** const DescriptorAddress)
+{
+	return NO_DESCRIPTOR;
+}
+
+/** Moves the next packet of the running verification phase, checking the packets received from the device
+ *  against the expected bus data.
+ *
+ *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+ */
+static uint8_t SimHost_VerifyPacket(void)
+{
+	uint8_t  Packet[ENDPOINT_MAX_BANK_SIZE];
+	uint16_t Offset       = (VerifyLength - VerifyBytesRemaining);
+	uint16_t PacketLength = MIN(VerifyBytesRemaining, BENCHMARK_EPSIZE);
+	uint16_t Length;
+	uint8_t  ErrorCode;
+
+	if (BenchmarkDirection == ENDPOINT_DIR_IN)
+	{
+		if ((ErrorCode = USB_SimHost_ReadIN(BENCHMARK_IN_EPADDR, Packet, &Length)) != USB_SIMHOST_Successful)
+		  return ErrorCode;
+
+		/* Every packet but the last must fill a whole bank, and the data must arrive in the function's byte order */
+		if ((Length != PacketLength) || memcmp(Packet, &VerifyData[Offset], Length))
+		{
+			fprintf(stderr, "Simulated host received a bad %u byte IN packet at offset %u.\n", Length, Offset);
+			VerifyFailed = true;
+		}
+	}
+	else
+	{
+		if ((ErrorCode = USB_SimHost_WriteOUT(BENCHMARK_OUT_EPADDR, &VerifyData[Offset], PacketLength)) != USB_SIMHOST_Successful)
+		  return ErrorCode;
+	}
+
+	VerifyBytesRemaining = (VerifyFailed ? 0 : (VerifyBytesRemaining - PacketLength));
+	return USB_SIMHOST_Successful;
+}
+
+void CALLBACK_USB_SimHost_Task(void)
+{
+	uint8_t Packet[ENDPOINT_MAX_BANK_SIZE];
+
+	memcpy_P(Packet, FlashBuffer, BENCHMARK_EPSIZE);
+
+	if (USB_SimHost_Attach() != USB_SIMHOST_Successful)
+	{
+		fprintf(stderr, "Simulated host could not attach the device.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (;;)
+	{
+		uint16_t Length;
+		uint8_t  ErrorCode;
+
+		if (VerifyBytesRemaining)
+		{
+			ErrorCode = SimHost_VerifyPacket();
+		}
+		else if (BenchmarkPacketsRemaining)
+		{
+			if (BenchmarkDirection == ENDPOINT_DIR_IN)
+			  ErrorCode = USB_SimHost_ReadIN(BENCHMARK_IN_EPADDR, Packet, &Length);
+			else
+			  ErrorCode = USB_SimHost_WriteOUT(BENCHMARK_OUT_EPADDR, Packet, BENCHMARK_EPSIZE);
+
+			BenchmarkPacketsRemaining--;
+		}
+		else
+		{
+			SIM_Delay_MS(1);
+			USB_SimHost_StartOfFrame();
+			continue;
+		}
+
+		if (ErrorCode != USB_SIMHOST_Successful)
+		{
+			fprintf(stderr, "Simulated host transfer failed (error %u).\n", ErrorCode);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+static int CompareCycles(const void* A,
+                         const void* B)
+{
+	uint64_t CyclesA = *(const uint64_t*)A;
+	uint64_t CyclesB = *(const uint64_t*)B;
+
+	return (CyclesA > CyclesB) - (CyclesA < CyclesB);
+}
+
+/** Copies a whole pattern buffer into a stream function's buffer, in the buffer's memory space. */
+static void StoreBuffer(const StreamFunction_t* const Function,
+                        const uint8_t* const Data)
+{
+	if (Function->InEEPROM)
+	  eeprom_update_block(Data, Function->Buffer, PATTERN_LENGTH);
+	else
+	  memcpy(Function->Buffer, Data, PATTERN_LENGTH);
+}
+
+/** Copies a stream function's whole buffer out of the buffer's memory space. */
+static void LoadBuffer(const StreamFunction_t* const Function,
+                       uint8_t* const Data)
+{
+	if (Function->InEEPROM)
+	  eeprom_read_block(Data, Function->Buffer, PATTERN_LENGTH);
+	else
+	  memcpy(Data, Function->Buffer, PATTERN_LENGTH);
+}
+
+/** Transfers the start of the test pattern through a stream function and checks that it arrives intact.
+ *
+ *  \param[in] Function  Stream function to verify
+ *  \param[in] Length    Number of bytes to transfer
+ *  \param[in] Resume    Whether to pass a \c BytesProcessed counter, resuming the transfer after each full bank
+ *
+ *  \return Boolean \c true if the transfer was correct, \c false otherwise
+ */
+static bool VerifyTransfer(const StreamFunction_t* const Function,
+                           const uint16_t Length,
+                           const bool Resume)
+{
+	uint8_t  Received[PATTERN_LENGTH];
+	uint16_t BytesProcessed      = 0;
+	uint16_t IncompleteTransfers = 0;
+	uint8_t  ErrorCode;
+
+	/* A big endian function sends the buffer's last byte first, and fills the buffer from the end when reading */
+	for (uint16_t i = 0; i < Length; i++)
+	  VerifyData[i] = Pattern[Function->BigEndian ? (Length - 1 - i) : i];
+
+	if (Function->ReadFunc)
+	{
+		memset(Received, 0x00, sizeof(Received));
+		StoreBuffer(Function, Received);
+	}
+
+	Endpoint_SelectEndpoint(Function->WriteFunc ? BENCHMARK_IN_EPADDR : BENCHMARK_OUT_EPADDR);
+
+	VerifyFailed         = false;
+	BenchmarkDirection   = (Function->WriteFunc ? ENDPOINT_DIR_IN : ENDPOINT_DIR_OUT);
+	VerifyLength         = Length;
+	VerifyBytesRemaining = Length;
+
+	for (;;)
+	{
+		if (Function->WriteFunc)
+		  ErrorCode = Function->WriteFunc(Function->Buffer, Length, (Resume ? &BytesProcessed : NULL));
+		else
+		  ErrorCode = Function->ReadFunc(Function->Buffer, Length, (Resume ? &BytesProcessed : NULL));
+
+		if (ErrorCode != ENDPOINT_RWSTREAM_IncompleteTransfer)
+		  break;
+
+		IncompleteTransfers++;
+	}
+
+	/* The stream functions leave the last bank of the transfer for the application to clear */
+	if (Function->WriteFunc)
+	  Endpoint_ClearIN();
+	else
+	  Endpoint_ClearOUT();
+
+	while (VerifyBytesRemaining)
+	  SIM_YieldToBus();
+
+	if ((ErrorCode != ENDPOINT_RWSTREAM_NoError) || VerifyFailed)
+	{
+		printf("  %s failed to transfer %u bytes (error %u)\n", Function->FunctionName, Length, ErrorCode);
+		return false;
+	}
+
+	/* A resumed transfer returns once each time it fills or empties a bank with more of the transfer to go,
+	 * counting the bytes of the whole banks it has processed */
+	if (Resume && ((IncompleteTransfers != ((Length - 1) / BENCHMARK_EPSIZE)) ||
+	               (BytesProcessed != (IncompleteTransfers * BENCHMARK_EPSIZE))))
+	{
+		printf("  %s resumed a %u byte transfer %u times, processing %u bytes\n", Function->FunctionName,
+		       Length, IncompleteTransfers, BytesProcessed);
+		return false;
+	}
+
+	if (Function->ReadFunc)
+	{
+		LoadBuffer(Function, Received);
+		StoreBuffer(Function, Pattern);
+
+		/* The data must land at the start of the buffer, in order, without touching the rest of it */
+		for (uint16_t i = 0; i < PATTERN_LENGTH; i++)
+		{
+			if (Received[i] != ((i < Length) ? Pattern[i] : 0x00))
+			{
+				printf("  %s read a %u byte transfer wrongly at offset %u\n", Function->FunctionName, Length, i);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/** Verifies every stream function with each of the test lengths, with and without resuming.
+ *
+ *  \return Boolean \c true if every transfer was correct, \c false otherwise
+ */
+static bool VerifyStreams(void)
+{
+	uint16_t Transfers = 0;
+	bool     Passed    = true;
+
+	for (uint8_t i = 0; i < (sizeof(StreamFunctions) / sizeof(StreamFunctions[0])); i++)
+	{
+		for (uint8_t j = 0; j < (sizeof(VerifyLengths) / sizeof(VerifyLengths[0])); j++)
+		{
+			Passed &= VerifyTransfer(&StreamFunctions[i], VerifyLengths[j], false);
+			Passed &= VerifyTransfer(&StreamFunctions[i], VerifyLengths[j], true);
+			Transfers += 2;
+		}
+	}
+
+	printf("Endpoint stream verification: %u transfers %s\n", Transfers, (Passed ? "passed" : "FAILED"));
+	return Passed;
+}
+
+static void StartPhase(const uint8_t Direction)
+{
+	BenchmarkDirection        = Direction;
+	BenchmarkPacketsRemaining = BENCHMARK_PACKETS;
+}
+
+static void ReportPhase(const char* const FunctionName)
+{
+	while (BenchmarkPacketsRemaining)
+	  SIM_YieldToBus();
+
+	/* Median per-packet cost, so that the occasional preemption of the application thread is discarded */
+	qsort(PacketCycles, BENCHMARK_PACKETS, sizeof(PacketCycles[0]), CompareCycles);
+
+	printf("  %-28s %8.2f\n", FunctionName, ((double)PacketCycles[BENCHMARK_PACKETS / 2] / BENCHMARK_EPSIZE));
+}
+
+static void BenchmarkWrite(const StreamFunction_t* const Function)
+{
+	Endpoint_SelectEndpoint(BENCHMARK_IN_EPADDR);
+	StartPhase(ENDPOINT_DIR_IN);
+
+	for (uint16_t i = 0; i < BENCHMARK_PACKETS; i++)
+	{
+		while (!(Endpoint_IsINReady()));
+
+		uint64_t StartCycles = SIM_GetCycleCount();
+		Function->WriteFunc(Function->Buffer, BENCHMARK_EPSIZE, NULL);
+		PacketCycles[i] = (SIM_GetCycleCount() - StartCycles);
+
+		Endpoint_ClearIN();
+	}
+
+	ReportPhase(Function->FunctionName);
+}
+
+static void BenchmarkRead(const StreamFunction_t* const Function)
+{
+	Endpoint_SelectEndpoint(BENCHMARK_OUT_EPADDR);
+	StartPhase(ENDPOINT_DIR_OUT);
+
+	for (uint16_t i = 0; i < BENCHMARK_PACKETS; i++)
+	{
+		while (!(Endpoint_IsOUTReceived()));
+
+		uint64_t StartCycles = SIM_GetCycleCount();
+		Function->ReadFunc(Function->Buffer, BENCHMARK_EPSIZE, NULL);
+		PacketCycles[i] = (SIM_GetCycleCount() - StartCycles);
+
+		Endpoint_ClearOUT();
+	}
+
+	ReportPhase(Function->FunctionName);
+}
+
+int main(void)
+{
+	memcpy_P(Pattern, FlashBuffer, PATTERN_LENGTH);
+	memcpy(RAMBuffer, Pattern, PATTERN_LENGTH);
+	eeprom_update_block(Pattern, EEPROMBuffer, PATTERN_LENGTH);
+
+	GlobalInterruptEnable();
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+
+	while (USB_DeviceState != DEVICE_STATE_Default)
+	  SIM_YieldToBus();
+
+	Endpoint_ConfigureEndpoint(BENCHMARK_IN_EPADDR,  EP_TYPE_BULK, BENCHMARK_EPSIZE, 2);
+	Endpoint_ConfigureEndpoint(BENCHMARK_OUT_EPADDR, EP_TYPE_BULK, BENCHMARK_EPSIZE, 2);
+
+	if (!(VerifyStreams()))
+	  return EXIT_FAILURE;
+
+	#if defined(NO_STREAM_BLOCK_TRANSFERS)
+	printf("Endpoint stream benchmark, byte transfers (host cycles per byte, median of %u packets):\n", BENCHMARK_PACKETS);
+	#else
+	printf("Endpoint stream benchmark, block transfers (host cycles per byte, median of %u packets):\n", BENCHMARK_PACKETS);
+	#endif
+
+	for (uint8_t i = 0; i < (sizeof(StreamFunctions) / sizeof(StreamFunctions[0])); i++)
+	{
+		if (StreamFunctions[i].WriteFunc)
+		  BenchmarkWrite(&StreamFunctions[i]);
+		else
+		  BenchmarkRead(&StreamFunctions[i]);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -66,6 +66,9 @@
 		 */
 		#define VIRTUAL_MEMORY_BLOCKS               (VIRTUAL_MEMORY_BYTES / VIRTUAL_MEMORY_BLOCK_SIZE)
 
+		/** Value of the buffered Dataflash page index when no page image is held in a Dataflash buffer. */
+		#define DATAFLASH_NO_BUFFERED_PAGE          0xFFFF
+
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
 		#define LUN_MEDIA_BLOCKS                    (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
 
@@ -39,6 +39,15 @@
 #define  INCLUDE_FROM_DATAFLASHMANAGER_C
 #include "DataflashManager.h"
 
+/** Dataflash page whose programmed image is still held in one of its chip's SRAM buffers after the last write, or
+ *  \ref DATAFLASH_NO_BUFFERED_PAGE if none is. A following write into the same page, such as the second half of a page
+ *  written by the host one block at a time, can then modify the buffer in place instead of reloading the page.
+ */
+static uint16_t BufferedDFPage = DATAFLASH_NO_BUFFERED_PAGE;
+
+/** Indicates if \ref BufferedDFPage is held in its chip's second SRAM buffer rather than the first. */
+static bool     BufferedDFPageInSecondBuffer;
+
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
  *  the pre-selected data OUT endpoint. This routine reads in OS sized blocks from the endpoint and writes
  *  them to the Dataflash in Dataflash page sized blocks.
@@ -58,14 +67,25 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
+	if (CurrDFPage == BufferedDFPage)
+	{
+		/* Continue from the page image left in the Dataflash buffer by the previous write */
+		UsingSecondBuffer = BufferedDFPageInSecondBuffer;
+	}
+	else if (CurrDFPageByte || (((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE) < DATAFLASH_PAGE_SIZE))
+	{
+		/* Copy selected dataflash's current page contents to the Dataflash buffer, unless all of it is overwritten */
+		Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(CurrDFPage, 0);
+		Dataflash_WaitWhileBusy();
+	}
 #endif
 
+	/* Buffer contents no longer match main memory until the page is written back */
+	BufferedDFPage = DATAFLASH_NO_BUFFERED_PAGE;
+
 	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
 	Dataflash_SendAddressBytes(0, CurrDFPageByte);
 
 	/* Wait until endpoint is ready before continuing */
@@ -126,23 +146,16 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 				Dataflash_SendAddressBytes(0, 0);
 			}
 
-			/* Write one 16-byte chunk of data to the Dataflash */
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
-			Dataflash_SendByte(Endpoint_Read_8());
+			/* Write one 16-byte chunk of data to the Dataflash, reading each byte from the endpoint while the last is sent */
+			Dataflash_StartTransfer(Endpoint_Read_8());
+			for (uint8_t ByteNum = 1; ByteNum < 16; ByteNum++)
+			{
+				uint8_t NextByte = Endpoint_Read_8();
+
+				Dataflash_FinishTransfer();
+				Dataflash_StartTransfer(NextByte);
+			}
+			Dataflash_FinishTransfer();
 
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -165,6 +178,10 @@ void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
 	Dataflash_WaitWhileBusy();
 
+	/* The written page image remains in the Dataflash buffer for a following write to the same page */
+	BufferedDFPage               = CurrDFPage;
+	BufferedDFPageInSecondBuffer = UsingSecondBuffer;
+
 	/* If the endpoint is empty, clear it ready for the next packet from the host */
 	if (!(Endpoint_IsReadWriteAllowed()))
 	  Endpoint_ClearOUT();
@@ -239,23 +256,16 @@ void DataflashManager_ReadBlocks(const uint32_t BlockAddress,
 				Dataflash_SendByte(0x00);
 			}
 
-			/* Read one 16-byte chunk of data from the Dataflash */
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
-			Endpoint_Write_8(Dataflash_ReceiveByte());
+			/* Read one 16-byte chunk of data from the Dataflash, writing each byte to the endpoint while the next is received */
+			Dataflash_StartTransfer(0x00);
+			for (uint8_t ByteNum = 1; ByteNum < 16; ByteNum++)
+			{
+				uint8_t ReceivedByte = Dataflash_FinishTransfer();
+
+				Dataflash_StartTransfer(0x00);
+				Endpoint_Write_8(ReceivedByte);
+			}
+			Endpoint_Write_8(Dataflash_FinishTransfer());
 
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -302,14 +312,25 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_SelectChipFromPage(CurrDFPage);
 
 #if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
+	if (CurrDFPage == BufferedDFPage)
+	{
+		/* Continue from the page image left in the Dataflash buffer by the previous write */
+		UsingSecondBuffer = BufferedDFPageInSecondBuffer;
+	}
+	else if (CurrDFPageByte || (((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE) < DATAFLASH_PAGE_SIZE))
+	{
+		/* Copy selected dataflash's current page contents to the Dataflash buffer, unless all of it is overwritten */
+		Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(CurrDFPage, 0);
+		Dataflash_WaitWhileBusy();
+	}
 #endif
 
+	/* Buffer contents no longer match main memory until the page is written back */
+	BufferedDFPage = DATAFLASH_NO_BUFFERED_PAGE;
+
 	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
 	Dataflash_SendAddressBytes(0, CurrDFPageByte);
 
 	while (TotalBlocks)
@@ -356,9 +377,16 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 				Dataflash_SendAddressBytes(0, 0);
 			}
 
-			/* Write one 16-byte chunk of data to the Dataflash */
-			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
-			  Dataflash_SendByte(*(BufferPtr++));
+			/* Write one 16-byte chunk of data to the Dataflash, fetching each byte while the last is sent */
+			Dataflash_StartTransfer(*(BufferPtr++));
+			for (uint8_t ByteNum = 1; ByteNum < 16; ByteNum++)
+			{
+				uint8_t NextByte = *(BufferPtr++);
+
+				Dataflash_FinishTransfer();
+				Dataflash_StartTransfer(NextByte);
+			}
+			Dataflash_FinishTransfer();
 
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -377,6 +405,10 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
 	Dataflash_WaitWhileBusy();
 
+	/* The written page image remains in the Dataflash buffer for a following write to the same page */
+	BufferedDFPage               = CurrDFPage;
+	BufferedDFPageInSecondBuffer = UsingSecondBuffer;
+
 	/* Deselect all Dataflash chips */
 	Dataflash_DeselectChip();
 }
@@ -435,9 +467,16 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 				Dataflash_SendByte(0x00);
 			}
 
-			/* Read one 16-byte chunk of data from the Dataflash */
-			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
-			  *(BufferPtr++) = Dataflash_ReceiveByte();
+			/* Read one 16-byte chunk of data from the Dataflash, storing each byte while the next is received */
+			Dataflash_StartTransfer(0x00);
+			for (uint8_t ByteNum = 1; ByteNum < 16; ByteNum++)
+			{
+				uint8_t ReceivedByte = Dataflash_FinishTransfer();
+
+				Dataflash_StartTransfer(0x00);
+				*(BufferPtr++) = ReceivedByte;
+			}
+			*(BufferPtr++) = Dataflash_FinishTransfer();
 
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -40,6 +40,8 @@
 		#include <avr/io.h>
 		#include <string.h>
 
+		#include <LUFA/Drivers/Misc/InternetChecksum.h>
+
 		#include "Config/AppConfig.h"
 
 		#include "EthernetProtocols.h"
@@ -41,7 +41,11 @@
 		#include <avr/pgmspace.h>
 		#include <stdio.h>
 
-		#include <LUFA/Drivers/Peripheral/Serial.h>
+		#include <LUFA/Common/Common.h>
+
+		#if (ARCH != ARCH_SIM)
+			#include <LUFA/Drivers/Peripheral/Serial.h>
+		#endif
 
 		#include "EthernetProtocols.h"
 		#include "Ethernet.h"
@@ -50,6 +50,16 @@ TCP_PortState_t        PortStateTable[MAX_OPEN_TCP_PORTS];
  */
 TCP_ConnectionState_t  ConnectionStateTable[MAX_TCP_CONNECTIONS];
 
+/** Connection index, giving the first connection state table entry of each chain of active connections sharing the same hash
+ *  of their local port and remote address and port, so that a connection can be located without searching the whole table.
+ */
+static uint8_t         ConnectionIndex[TCP_CONNECTION_BUCKETS];
+
+/** Connection state table entry to be given the first chance to transmit on the next run of \ref TCP_Task(), so that a
+ *  connection streaming a large amount of data cannot starve the others.
+ */
+static uint8_t         NextTransmitConnection;
+
 
 /** Task to handle the calling of each registered application's callback function, to process and generate TCP packets at the application
  *  level. If an application produces a response, this task constructs the appropriate Ethernet frame and places it into the Ethernet OUT
@@ -60,93 +70,87 @@ void TCP_Task(void)
 	/* Run each application in sequence, to process incoming and generate outgoing packets */
 	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
 	{
-		/* Find the corresponding port entry in the port table */
-		for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_TCP_PORTS; PTableEntry++)
-		{
-			/* Run the application handler for the port */
-			if ((PortStateTable[PTableEntry].Port  == ConnectionStateTable[CSTableEntry].Port) &&
-			    (PortStateTable[PTableEntry].State == TCP_Port_Open))
-			{
-				PortStateTable[PTableEntry].ApplicationHandler(&ConnectionStateTable[CSTableEntry],
-				                                               &ConnectionStateTable[CSTableEntry].Info.Buffer);
-			}
-		}
+		TCP_ConnectionState_t* Connection = &ConnectionStateTable[CSTableEntry];
+
+		if (Connection->State == TCP_Connection_Closed)
+		  continue;
+
+		/* Run the application handler for the connection's port */
+		TCP_PortState_t* PortState = &PortStateTable[Connection->PortTableEntry];
+
+		if ((PortState->Port == Connection->Port) && (PortState->State == TCP_Port_Open))
+		  PortState->ApplicationHandler(Connection, &Connection->Info.Buffer);
 	}
 
 	/* Bail out early if there is already a frame waiting to be sent in the Ethernet OUT buffer */
 	if (FrameOUT.FrameLength)
 	  return;
 
-	/* Send response packets from each application as the TCP packet buffers are filled by the applications */
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
-	{
-		/* For each completely received packet, pass it along to the listening application */
-		if ((ConnectionStateTable[CSTableEntry].Info.Buffer.Direction == TCP_PACKETDIR_OUT) &&
-		    (ConnectionStateTable[CSTableEntry].Info.Buffer.Ready))
-		{
-			Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT.FrameData;
-			IP_Header_t*             IPHeaderOUT    = (IP_Header_t*)&FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t)];
-			TCP_Header_t*            TCPHeaderOUT   = (TCP_Header_t*)&FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t) +
-			                                                                             sizeof(IP_Header_t)];
-			void*                    TCPDataOUT     = &FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t) +
-			                                                              sizeof(IP_Header_t) +
-			                                                              sizeof(TCP_Header_t)];
+	uint8_t* TCPDataOUT = &FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t) + sizeof(IP_Header_t) + sizeof(TCP_Header_t)];
 
-			uint16_t PacketSize = ConnectionStateTable[CSTableEntry].Info.Buffer.Length;
+	/* Send the next packet of pending data from one connection, taking turns between the connections */
+	for (uint8_t CSTableCount = 0; CSTableCount < MAX_TCP_CONNECTIONS; CSTableCount++)
+	{
+		TCP_ConnectionState_t* Connection = &ConnectionStateTable[NextTransmitConnection];
+		TCP_ConnectionInfo_t*  Info       = &Connection->Info;
 
-			/* Fill out the TCP data */
-			TCPHeaderOUT->SourcePort           = ConnectionStateTable[CSTableEntry].Port;
-			TCPHeaderOUT->DestinationPort      = ConnectionStateTable[CSTableEntry].RemotePort;
-			TCPHeaderOUT->SequenceNumber       = SwapEndian_32(ConnectionStateTable[CSTableEntry].Info.SequenceNumberOut);
-			TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(ConnectionStateTable[CSTableEntry].Info.SequenceNumberIn);
-			TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
-			TCPHeaderOUT->WindowSize           = SwapEndian_16(TCP_WINDOW_SIZE);
+		if (++NextTransmitConnection == MAX_TCP_CONNECTIONS)
+		  NextTransmitConnection = 0;
 
-			TCPHeaderOUT->Flags                = TCP_FLAG_ACK;
-			TCPHeaderOUT->UrgentPointer        = 0;
-			TCPHeaderOUT->Checksum             = 0;
-			TCPHeaderOUT->Reserved             = 0;
+		if ((Connection->State != TCP_Connection_Established) && (Connection->State != TCP_Connection_Closing) &&
+		    (Connection->State != TCP_Connection_CloseWait))
+		{
+			continue;
+		}
 
-			memcpy(TCPDataOUT, ConnectionStateTable[CSTableEntry].Info.Buffer.Data, PacketSize);
+		/* Determine how much of the host's receive window is not yet taken up by unacknowledged data */
+		uint32_t InFlight   = (Info->SequenceNumberOut - Info->SequenceNumberAcked);
+		uint16_t WindowLeft = (InFlight < Info->RemoteWindowSize) ? (Info->RemoteWindowSize - InFlight) : 0;
 
-			ConnectionStateTable[CSTableEntry].Info.SequenceNumberOut += PacketSize;
+		if ((Info->Buffer.Direction == TCP_PACKETDIR_OUT) && Info->Buffer.Ready)
+		{
+			/* Hold the application's buffered packet back until the host has room to receive it whole */
+			if (Info->Buffer.Length > WindowLeft)
+			  continue;
 
-			TCPHeaderOUT->Checksum             = TCP_Checksum16(TCPHeaderOUT, &ServerIPAddress,
-			                                                    &ConnectionStateTable[CSTableEntry].RemoteAddress,
-			                                                    (sizeof(TCP_Header_t) + PacketSize));
+			memcpy(TCPDataOUT, Info->Buffer.Data, Info->Buffer.Length);
+			TCP_SendSegment(Connection, TCP_FLAG_ACK, Info->Buffer.Length);
 
-			PacketSize += sizeof(TCP_Header_t);
+			Info->Buffer.Ready = false;
+			break;
+		}
 
-			/* Fill out the response IP header */
-			IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + PacketSize);
-			IPHeaderOUT->TypeOfService      = 0;
-			IPHeaderOUT->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
-			IPHeaderOUT->Version            = 4;
-			IPHeaderOUT->Flags              = 0;
-			IPHeaderOUT->FragmentOffset     = 0;
-			IPHeaderOUT->Identification     = 0;
-			IPHeaderOUT->HeaderChecksum     = 0;
-			IPHeaderOUT->Protocol           = PROTOCOL_TCP;
-			IPHeaderOUT->TTL                = DEFAULT_TTL;
-			IPHeaderOUT->SourceAddress      = ServerIPAddress;
-			IPHeaderOUT->DestinationAddress = ConnectionStateTable[CSTableEntry].RemoteAddress;
+		int32_t StreamLeft = (Info->StreamEnd - Info->SequenceNumberOut);
 
-			IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
+		if (StreamLeft > 0)
+		{
+			if (!(WindowLeft))
+			  continue;
 
-			PacketSize += sizeof(IP_Header_t);
+			/* Read the next block of the stream straight into the packet, as much as the frame and host will take */
+			uint16_t Length = MIN(MIN((uint32_t)StreamLeft, TCP_MAX_SEGMENT_SIZE), WindowLeft);
 
-			/* Fill out the response Ethernet frame header */
-			FrameOUTHeader->Source          = ServerMACAddress;
-			FrameOUTHeader->Destination     = (MAC_Address_t){{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}};
-			FrameOUTHeader->EtherType       = SwapEndian_16(ETHERTYPE_IPV4);
+			Info->StreamReader((Info->SequenceNumberOut - Info->StreamStart), TCPDataOUT, Length);
+			TCP_SendSegment(Connection, (Length == StreamLeft) ? (TCP_FLAG_ACK | TCP_FLAG_PSH) : TCP_FLAG_ACK, Length);
+			break;
+		}
 
-			PacketSize += sizeof(Ethernet_Frame_Header_t);
+		/* Finalize a connection closed by the application once the host has acknowledged everything sent to it */
+		if ((Connection->State == TCP_Connection_Closing) && !(InFlight))
+		{
+			TCP_SendSegment(Connection, (TCP_FLAG_FIN | TCP_FLAG_ACK), 0);
 
-			/* Set the response length in the buffer and indicate that a response is ready to be sent */
-			FrameOUT.FrameLength            = PacketSize;
+			Info->Buffer.InUse = false;
+			Connection->State  = TCP_Connection_FINWait1;
+			break;
+		}
 
-			ConnectionStateTable[CSTableEntry].Info.Buffer.Ready = false;
+		/* Finalize a connection closed by the host once the application's reply has been sent and acknowledged */
+		if ((Connection->State == TCP_Connection_CloseWait) && !(InFlight) && !(Info->Buffer.Ready) && !(Info->Buffer.InUse))
+		{
+			TCP_SendSegment(Connection, (TCP_FLAG_FIN | TCP_FLAG_ACK), 0);
 
+			Connection->State = TCP_Connection_LastACK;
 			break;
 		}
 	}
@@ -164,6 +168,12 @@ void TCP_Init(void)
 	/* Initialize the connection table with all CLOSED entries */
 	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
 	  ConnectionStateTable[CSTableEntry].State = TCP_Connection_Closed;
+
+	/* Initialize the connection index with all chains empty */
+	for (uint8_t Bucket = 0; Bucket < TCP_CONNECTION_BUCKETS; Bucket++)
+	  ConnectionIndex[Bucket] = TCP_NO_CONNECTION;
+
+	NextTransmitConnection = 0;
 }
 
 /** Sets the state and callback handler of the given port, specified in big endian to the given state.
@@ -238,6 +248,111 @@ uint8_t TCP_GetPortState(const uint16_t Port)
 	return TCP_Port_Closed;
 }
 
+/** Locates an active connection in the connection index.
+ *
+ *  \param[in] Port           TCP port of the connection on the device, specified in big endian
+ *  \param[in] RemoteAddress  Remote protocol IP address of the connected device
+ *  \param[in] RemotePort     TCP port of the remote device in the connection, specified in big endian
+ *
+ *  \return Pointer to the connection's state table entry if found, NULL otherwise
+ */
+static TCP_ConnectionState_t* TCP_FindConnection(const uint16_t Port,
+                                                 const IP_Address_t* RemoteAddress,
+                                                 const uint16_t RemotePort)
+{
+	uint8_t CSTableEntry = ConnectionIndex[TCP_CONNECTION_BUCKET(Port, RemoteAddress, RemotePort)];
+
+	/* Walk the chain of connections sharing the same hash to find the matching connection */
+	while (CSTableEntry != TCP_NO_CONNECTION)
+	{
+		TCP_ConnectionState_t* Connection = &ConnectionStateTable[CSTableEntry];
+
+		if ((Connection->Port == Port) && (Connection->RemotePort == RemotePort) &&
+		    IP_COMPARE(&Connection->RemoteAddress, RemoteAddress))
+		{
+			return Connection;
+		}
+
+		CSTableEntry = Connection->NextConnection;
+	}
+
+	return NULL;
+}
+
+/** Locates an active connection in the connection index, or creates it in a free connection state table entry if it does not
+ *  yet exist. Newly created connections are placed in the \ref TCP_Connection_Listen state.
+ *
+ *  \param[in] Port           TCP port of the connection on the device, specified in big endian
+ *  \param[in] RemoteAddress  Remote protocol IP address of the connected device
+ *  \param[in] RemotePort     TCP port of the remote device in the connection, specified in big endian
+ *
+ *  \return Pointer to the connection's state table entry, or NULL if there is no more space in the connection state table
+ */
+static TCP_ConnectionState_t* TCP_OpenConnection(const uint16_t Port,
+                                                 const IP_Address_t* RemoteAddress,
+                                                 const uint16_t RemotePort)
+{
+	TCP_ConnectionState_t* Connection = TCP_FindConnection(Port, RemoteAddress, RemotePort);
+
+	if (Connection != NULL)
+	  return Connection;
+
+	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	{
+		Connection = &ConnectionStateTable[CSTableEntry];
+
+		/* Find empty entry in the table */
+		if (Connection->State == TCP_Connection_Closed)
+		{
+			uint8_t Bucket = TCP_CONNECTION_BUCKET(Port, RemoteAddress, RemotePort);
+
+			Connection->Port           = Port;
+			Connection->RemoteAddress  = *RemoteAddress;
+			Connection->RemotePort     = RemotePort;
+			Connection->State          = TCP_Connection_Listen;
+			Connection->PortTableEntry = 0;
+
+			/* Remember which port table entry the connection belongs to, so the port need not be searched for again */
+			for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_TCP_PORTS; PTableEntry++)
+			{
+				if (PortStateTable[PTableEntry].Port == Port)
+				  Connection->PortTableEntry = PTableEntry;
+			}
+
+			/* Link the connection into the head of its connection index chain */
+			Connection->NextConnection = ConnectionIndex[Bucket];
+			ConnectionIndex[Bucket]    = CSTableEntry;
+
+			return Connection;
+		}
+	}
+
+	return NULL;
+}
+
+/** Closes an active connection, removing it from the connection index so that its state table entry may be reused.
+ *
+ *  \param[in,out] Connection  Active connection to close
+ */
+static void TCP_CloseConnection(TCP_ConnectionState_t* const Connection)
+{
+	uint8_t* Link = &ConnectionIndex[TCP_CONNECTION_BUCKET(Connection->Port, &Connection->RemoteAddress, Connection->RemotePort)];
+
+	/* Find the link in the connection's index chain which refers to it, and unlink it */
+	while (*Link != TCP_NO_CONNECTION)
+	{
+		if (&ConnectionStateTable[*Link] == Connection)
+		{
+			*Link = Connection->NextConnection;
+			break;
+		}
+
+		Link = &ConnectionStateTable[*Link].NextConnection;
+	}
+
+	Connection->State = TCP_Connection_Closed;
+}
+
 /** Sets the connection state of the given port, remote address and remote port to the given TCP connection state. If the
  *  connection exists in the connection state table it is updated, otherwise it is created if possible.
  *
@@ -255,32 +370,22 @@ bool TCP_SetConnectionState(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
-	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
-		{
-			ConnectionStateTable[CSTableEntry].State = State;
-			return true;
-		}
-	}
+	TCP_ConnectionState_t* Connection;
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	if (State == TCP_Connection_Closed)
 	{
-		/* Find empty entry in the table */
-		if (ConnectionStateTable[CSTableEntry].State == TCP_Connection_Closed)
-		{
-			ConnectionStateTable[CSTableEntry].Port          = Port;
-			ConnectionStateTable[CSTableEntry].RemoteAddress = *RemoteAddress;
-			ConnectionStateTable[CSTableEntry].RemotePort    = RemotePort;
-			ConnectionStateTable[CSTableEntry].State         = State;
-			return true;
-		}
+		/* Closed connections are not kept in the table, so closing an unknown connection is always successful */
+		if ((Connection = TCP_FindConnection(Port, RemoteAddress, RemotePort)) != NULL)
+		  TCP_CloseConnection(Connection);
+
+		return true;
 	}
 
-	return false;
+	if ((Connection = TCP_OpenConnection(Port, RemoteAddress, RemotePort)) == NULL)
+	  return false;
+
+	Connection->State = State;
+	return true;
 }
 
 /** Retrieves the current state of a given TCP connection to a host.
@@ -297,19 +402,9 @@ uint8_t TCP_GetConnectionState(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
-	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
+	TCP_ConnectionState_t* Connection = TCP_FindConnection(Port, RemoteAddress, RemotePort);
 
-		{
-			return ConnectionStateTable[CSTableEntry].State;
-		}
-	}
-
-	return TCP_Connection_Closed;
+	return (Connection != NULL) ? Connection->State : TCP_Connection_Closed;
 }
 
 /** Retrieves the connection info structure of a given connection to a host.
@@ -326,18 +421,140 @@ TCP_ConnectionInfo_t* TCP_GetConnectionInfo(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	TCP_ConnectionState_t* Connection = TCP_FindConnection(Port, RemoteAddress, RemotePort);
+
+	return (Connection != NULL) ? &Connection->Info : NULL;
+}
+
+/** Processes the acknowledgement and window information of an incoming TCP packet on an active connection. Acknowledged data
+ *  is retired from the connection, and if the host repeatedly acknowledges the same data the unacknowledged part of the
+ *  connection's stream is queued to be sent again.
+ *
+ *  \param[in,out] Connection  Active connection the packet was received on
+ *  \param[in] TCPHeaderIN     Pointer to the start of the incoming packet's TCP header
+ *  \param[in] DataLength      Length of the data carried in the incoming packet
+ */
+static void TCP_ProcessACK(TCP_ConnectionState_t* const Connection,
+                           const TCP_Header_t* TCPHeaderIN,
+                           const uint16_t DataLength)
+{
+	TCP_ConnectionInfo_t* Info             = &Connection->Info;
+	uint32_t              AckNumber        = SwapEndian_32(TCPHeaderIN->AcknowledgmentNumber);
+	uint16_t              RemoteWindowSize = SwapEndian_16(TCPHeaderIN->WindowSize);
+
+	if (((int32_t)(AckNumber - Info->SequenceNumberAcked) > 0) && ((int32_t)(Info->SequenceNumberOut - AckNumber) >= 0))
+	{
+		/* Host has acknowledged new data */
+		Info->SequenceNumberAcked = AckNumber;
+		Info->DuplicateACKs       = 0;
+	}
+	else if (((int32_t)(AckNumber - Info->SequenceNumberOut) > 0) && ((int32_t)(Info->StreamEnd - AckNumber) >= 0))
+	{
+		/* Host has acknowledged stream data sent before the stream was rewound, skip over it */
+		Info->SequenceNumberAcked = AckNumber;
+		Info->SequenceNumberOut   = AckNumber;
+		Info->DuplicateACKs       = 0;
+	}
+	else if ((AckNumber == Info->SequenceNumberAcked) && (AckNumber != Info->SequenceNumberOut) && !(DataLength) &&
+	         (RemoteWindowSize == Info->RemoteWindowSize))
 	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
+		/* Host keeps acknowledging the same data, so a packet was lost - rewind the stream to the lost data */
+		if ((++Info->DuplicateACKs == TCP_DUPLICATE_ACK_LIMIT) &&
+		    ((int32_t)(AckNumber - Info->StreamStart) >= 0) && ((int32_t)(Info->StreamEnd - AckNumber) > 0))
 		{
-			return &ConnectionStateTable[CSTableEntry].Info;
+			Info->SequenceNumberOut = AckNumber;
+			Info->DuplicateACKs     = 0;
 		}
 	}
 
-	return NULL;
+	Info->RemoteWindowSize = RemoteWindowSize;
+}
+
+/** Determines the receive window size to advertise to the host on a connection, from the space left in the connection's
+ *  application buffer.
+ *
+ *  \param[in] Connection  Connection to advertise the window of
+ *
+ *  \return Receive window size in bytes
+ */
+static uint16_t TCP_ReceiveWindowSize(const TCP_ConnectionState_t* Connection)
+{
+	if (!(Connection->Info.Buffer.InUse))
+	  return TCP_WINDOW_SIZE;
+	else
+	  return (TCP_WINDOW_SIZE - Connection->Info.Buffer.Length);
+}
+
+/** Constructs a TCP packet to the host on a given connection, and places it into the Ethernet OUT buffer for transmission. The
+ *  packet's data must already be in place in the Ethernet OUT buffer.
+ *
+ *  \param[in,out] Connection  Connection to send the packet on
+ *  \param[in] Flags           TCP flags of the packet, a mask of TCP_FLAG_* constants
+ *  \param[in] DataLength      Length of the data in the packet
+ */
+static void TCP_SendSegment(TCP_ConnectionState_t* const Connection,
+                            const uint8_t Flags,
+                            const uint16_t DataLength)
+{
+	Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT.FrameData;
+	IP_Header_t*             IPHeaderOUT    = (IP_Header_t*)&FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t)];
+	TCP_Header_t*            TCPHeaderOUT   = (TCP_Header_t*)&FrameOUT.FrameData[sizeof(Ethernet_Frame_Header_t) +
+	                                                                             sizeof(IP_Header_t)];
+
+	uint16_t PacketSize = DataLength;
+
+	/* Fill out the TCP data */
+	TCPHeaderOUT->SourcePort           = Connection->Port;
+	TCPHeaderOUT->DestinationPort      = Connection->RemotePort;
+	TCPHeaderOUT->SequenceNumber       = SwapEndian_32(Connection->Info.SequenceNumberOut);
+	TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(Connection->Info.SequenceNumberIn);
+	TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
+	TCPHeaderOUT->WindowSize           = SwapEndian_16(TCP_ReceiveWindowSize(Connection));
+
+	TCPHeaderOUT->Flags                = Flags;
+	TCPHeaderOUT->UrgentPointer        = 0;
+	TCPHeaderOUT->Checksum             = 0;
+	TCPHeaderOUT->Reserved             = 0;
+
+	Connection->Info.SequenceNumberOut += PacketSize;
+
+	/* FIN takes up a sequence number of its own after the packet data */
+	if (Flags & TCP_FLAG_FIN)
+	  Connection->Info.SequenceNumberOut++;
+
+	TCPHeaderOUT->Checksum             = TCP_Checksum16(TCPHeaderOUT, &ServerIPAddress,
+	                                                    &Connection->RemoteAddress,
+	                                                    (sizeof(TCP_Header_t) + PacketSize));
+
+	PacketSize += sizeof(TCP_Header_t);
+
+	/* Fill out the response IP header */
+	IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + PacketSize);
+	IPHeaderOUT->TypeOfService      = 0;
+	IPHeaderOUT->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
+	IPHeaderOUT->Version            = 4;
+	IPHeaderOUT->Flags              = 0;
+	IPHeaderOUT->FragmentOffset     = 0;
+	IPHeaderOUT->Identification     = 0;
+	IPHeaderOUT->HeaderChecksum     = 0;
+	IPHeaderOUT->Protocol           = PROTOCOL_TCP;
+	IPHeaderOUT->TTL                = DEFAULT_TTL;
+	IPHeaderOUT->SourceAddress      = ServerIPAddress;
+	IPHeaderOUT->DestinationAddress = Connection->RemoteAddress;
+
+	IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
+
+	PacketSize += sizeof(IP_Header_t);
+
+	/* Fill out the response Ethernet frame header */
+	FrameOUTHeader->Source          = ServerMACAddress;
+	FrameOUTHeader->Destination     = (MAC_Address_t){{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}};
+	FrameOUTHeader->EtherType       = SwapEndian_16(ETHERTYPE_IPV4);
+
+	PacketSize += sizeof(Ethernet_Frame_Header_t);
+
+	/* Set the response length in the buffer and indicate that a response is ready to be sent */
+	FrameOUT.FrameLength            = PacketSize;
 }
 
 /** Processes a TCP packet inside an Ethernet frame, and writes the appropriate response
@@ -359,95 +576,115 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 	TCP_Header_t* TCPHeaderIN  = (TCP_Header_t*)TCPHeaderInStart;
 	TCP_Header_t* TCPHeaderOUT = (TCP_Header_t*)TCPHeaderOutStart;
 
-	TCP_ConnectionInfo_t* ConnectionInfo;
-
 	DecodeTCPHeader(TCPHeaderInStart);
 
-	bool PacketResponse = false;
+	uint16_t IPOffset   = (IPHeaderIN->HeaderLength * sizeof(uint32_t));
+	uint16_t TCPOffset  = (TCPHeaderIN->DataOffset * sizeof(uint32_t));
+	uint16_t DataLength = (SwapEndian_16(IPHeaderIN->TotalLength) - IPOffset - TCPOffset);
+
+	/* Look the connection up once, the state table entry is then used directly for the rest of the packet processing */
+	TCP_ConnectionState_t* Connection = TCP_FindConnection(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
+	                                                       TCPHeaderIN->SourcePort);
+	TCP_ConnectionInfo_t*  ConnectionInfo;
+
+	uint8_t ResponseFlags = 0;
+	bool    PortOpen;
 
 	/* Check if the destination port is open and allows incoming connections */
-	if (TCP_GetPortState(TCPHeaderIN->DestinationPort) == TCP_Port_Open)
+	if (Connection != NULL)
+	{
+		PortOpen = ((PortStateTable[Connection->PortTableEntry].Port  == Connection->Port) &&
+		            (PortStateTable[Connection->PortTableEntry].State == TCP_Port_Open));
+	}
+	else
+	{
+		PortOpen = (TCP_GetPortState(TCPHeaderIN->DestinationPort) == TCP_Port_Open);
+	}
+
+	if (PortOpen)
 	{
 		/* Detect SYN from host to start a connection */
 		if (TCPHeaderIN->Flags & TCP_FLAG_SYN)
-		  TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress, TCPHeaderIN->SourcePort, TCP_Connection_Listen);
+		{
+			if ((Connection = TCP_OpenConnection(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
+			                                     TCPHeaderIN->SourcePort)) != NULL)
+			{
+				Connection->State = TCP_Connection_Listen;
+			}
+		}
 
 		/* Detect RST from host to abort existing connection */
 		if (TCPHeaderIN->Flags & TCP_FLAG_RST)
 		{
-			if (TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-			                           TCPHeaderIN->SourcePort, TCP_Connection_Closed))
-			{
-				TCPHeaderOUT->Flags = (TCP_FLAG_RST | TCP_FLAG_ACK);
-				PacketResponse = true;
-			}
+			if (Connection != NULL)
+			  TCP_CloseConnection(Connection);
+
+			return NO_RESPONSE;
+		}
+		else if (Connection == NULL)
+		{
+			/* Segment for a connection which does not exist (or cannot be created), reject it */
+			ResponseFlags = (TCP_FLAG_RST | TCP_FLAG_ACK);
 		}
 		else
 		{
+			ConnectionInfo = &Connection->Info;
+
 			/* Process the incoming TCP packet based on the current connection state for the sender and port */
-			switch (TCP_GetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress, TCPHeaderIN->SourcePort))
+			switch (Connection->State)
 			{
 				case TCP_Connection_Listen:
 					if (TCPHeaderIN->Flags == TCP_FLAG_SYN)
 					{
 						/* SYN connection starts a connection with a peer */
-						if (TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-						                           TCPHeaderIN->SourcePort, TCP_Connection_SYNReceived))
-						{
-							TCPHeaderOUT->Flags = (TCP_FLAG_SYN | TCP_FLAG_ACK);
+						Connection->State = TCP_Connection_SYNReceived;
 
-							ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress, TCPHeaderIN->SourcePort);
+						ResponseFlags = (TCP_FLAG_SYN | TCP_FLAG_ACK);
 
-							ConnectionInfo->SequenceNumberIn  = (SwapEndian_32(TCPHeaderIN->SequenceNumber) + 1);
-							ConnectionInfo->SequenceNumberOut = 0;
-							ConnectionInfo->Buffer.InUse      = false;
-						}
-						else
-						{
-							TCPHeaderOUT->Flags = TCP_FLAG_RST;
-						}
-
-						PacketResponse      = true;
+						ConnectionInfo->SequenceNumberIn    = (SwapEndian_32(TCPHeaderIN->SequenceNumber) + 1);
+						ConnectionInfo->SequenceNumberOut   = 0;
+						ConnectionInfo->SequenceNumberAcked = 0;
+						ConnectionInfo->RemoteWindowSize    = SwapEndian_16(TCPHeaderIN->WindowSize);
+						ConnectionInfo->DuplicateACKs       = 0;
+						ConnectionInfo->Buffer.InUse        = false;
+						ConnectionInfo->Buffer.Ready        = false;
 					}
 
 					break;
 				case TCP_Connection_SYNReceived:
-					if (TCPHeaderIN->Flags == TCP_FLAG_ACK)
+					if (!(TCPHeaderIN->Flags & TCP_FLAG_ACK) ||
+					    (SwapEndian_32(TCPHeaderIN->AcknowledgmentNumber) != ConnectionInfo->SequenceNumberOut))
 					{
-						/* ACK during the connection process completes the connection to a peer */
+						break;
+					}
 
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_Established);
+					/* ACK during the connection process completes the connection to a peer */
+					Connection->State = TCP_Connection_Established;
 
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
+					ConnectionInfo->SequenceNumberAcked = ConnectionInfo->SequenceNumberOut;
+					ConnectionInfo->StreamStart         = ConnectionInfo->SequenceNumberOut;
+					ConnectionInfo->StreamEnd           = ConnectionInfo->SequenceNumberOut;
 
-						ConnectionInfo->SequenceNumberOut++;
-					}
+					/* Any data sent along with the ACK is processed as on an established connection */
+					if (!(DataLength) && !(TCPHeaderIN->Flags & TCP_FLAG_FIN))
+					  break;
 
-					break;
+					/* Fall through */
 				case TCP_Connection_Established:
-					if (TCPHeaderIN->Flags == (TCP_FLAG_FIN | TCP_FLAG_ACK))
-					{
-						/* FIN ACK when connected to a peer starts the finalization process */
+					if (TCPHeaderIN->Flags & TCP_FLAG_ACK)
+					  TCP_ProcessACK(Connection, TCPHeaderIN, DataLength);
 
-						TCPHeaderOUT->Flags = (TCP_FLAG_FIN | TCP_FLAG_ACK);
-						PacketResponse      = true;
-
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_CloseWait);
-
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
+					if (SwapEndian_32(TCPHeaderIN->SequenceNumber) != ConnectionInfo->SequenceNumberIn)
+					{
+						/* Out of order or repeated data from the peer, re-acknowledge what has been received so far */
+						if (DataLength)
+						  ResponseFlags = TCP_FLAG_ACK;
 
-						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
+						break;
 					}
-					else if ((TCPHeaderIN->Flags == TCP_FLAG_ACK) || (TCPHeaderIN->Flags == (TCP_FLAG_ACK | TCP_FLAG_PSH)))
-					{
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
 
+					if (DataLength)
+					{
 						/* Check if the buffer is currently in use either by a buffered data to send, or receive */
 						if ((ConnectionInfo->Buffer.InUse == false) && (ConnectionInfo->Buffer.Ready == false))
 						{
@@ -460,27 +697,25 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						if ((ConnectionInfo->Buffer.Direction == TCP_PACKETDIR_IN) &&
 							(ConnectionInfo->Buffer.Length != TCP_WINDOW_SIZE))
 						{
-							uint16_t IPOffset   = (IPHeaderIN->HeaderLength * sizeof(uint32_t));
-							uint16_t TCPOffset  = (TCPHeaderIN->DataOffset * sizeof(uint32_t));
-							uint16_t DataLength = (SwapEndian_16(IPHeaderIN->TotalLength) - IPOffset - TCPOffset);
+							/* Accept only as much of the packet data as will fit into the buffer */
+							uint16_t AcceptedLength = MIN(DataLength, (TCP_WINDOW_SIZE - ConnectionInfo->Buffer.Length));
 
 							/* Copy the packet data into the buffer */
 							memcpy(&ConnectionInfo->Buffer.Data[ConnectionInfo->Buffer.Length],
 								   &((uint8_t*)TCPHeaderInStart)[TCPOffset],
-								   DataLength);
+								   AcceptedLength);
 
-							ConnectionInfo->SequenceNumberIn += DataLength;
-							ConnectionInfo->Buffer.Length    += DataLength;
+							ConnectionInfo->SequenceNumberIn += AcceptedLength;
+							ConnectionInfo->Buffer.Length    += AcceptedLength;
 
 							/* Check if the buffer is full or if the PSH flag is set, if so indicate buffer ready */
 							if ((!(TCP_WINDOW_SIZE - ConnectionInfo->Buffer.Length)) || (TCPHeaderIN->Flags & TCP_FLAG_PSH))
 							{
 								ConnectionInfo->Buffer.InUse = false;
 								ConnectionInfo->Buffer.Ready = true;
-
-								TCPHeaderOUT->Flags = TCP_FLAG_ACK;
-								PacketResponse      = true;
 							}
+
+							ResponseFlags = TCP_FLAG_ACK;
 						}
 						else
 						{
@@ -489,64 +724,86 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						}
 					}
 
+					/* FIN when connected to a peer ends its half of the connection, once all of its data has been accepted */
+					if ((TCPHeaderIN->Flags & TCP_FLAG_FIN) &&
+					    ((ConnectionInfo->SequenceNumberIn - SwapEndian_32(TCPHeaderIN->SequenceNumber)) == DataLength))
+					{
+						/* The device's own FIN is sent by TCP_Task() after the application's reply has been acknowledged */
+						ResponseFlags = TCP_FLAG_ACK;
+
+						Connection->State = TCP_Connection_CloseWait;
+
+						ConnectionInfo->SequenceNumberIn++;
+
+						/* No more data can follow, so hand any partially received data over to the application */
+						if ((ConnectionInfo->Buffer.Direction == TCP_PACKETDIR_IN) && ConnectionInfo->Buffer.InUse)
+						{
+							ConnectionInfo->Buffer.InUse = false;
+							ConnectionInfo->Buffer.Ready = true;
+						}
+					}
+
 					break;
 				case TCP_Connection_Closing:
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
+					/* Application is closing the connection, the FIN is sent by TCP_Task() once all sent data is acknowledged */
+					if (TCPHeaderIN->Flags & TCP_FLAG_ACK)
+					  TCP_ProcessACK(Connection, TCPHeaderIN, DataLength);
 
-						TCPHeaderOUT->Flags = (TCP_FLAG_ACK | TCP_FLAG_FIN);
-						PacketResponse      = true;
+					/* Host may finish first, in which case the device's FIN is sent as for a connection closed by the host */
+					if ((TCPHeaderIN->Flags & TCP_FLAG_FIN) && !(DataLength) &&
+					    (SwapEndian_32(TCPHeaderIN->SequenceNumber) == ConnectionInfo->SequenceNumberIn))
+					{
+						ResponseFlags = TCP_FLAG_ACK;
 
-						ConnectionInfo->Buffer.InUse = false;
+						Connection->State = TCP_Connection_CloseWait;
 
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_FINWait1);
+						ConnectionInfo->SequenceNumberIn++;
+					}
 
 					break;
 				case TCP_Connection_FINWait1:
-					if (TCPHeaderIN->Flags == (TCP_FLAG_FIN | TCP_FLAG_ACK))
-					{
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
+					if (TCPHeaderIN->Flags & TCP_FLAG_ACK)
+					  TCP_ProcessACK(Connection, TCPHeaderIN, DataLength);
 
-						TCPHeaderOUT->Flags = TCP_FLAG_ACK;
-						PacketResponse      = true;
+					if (TCPHeaderIN->Flags & TCP_FLAG_FIN)
+					{
+						ResponseFlags = TCP_FLAG_ACK;
 
 						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
 
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_Closed);
+						TCP_CloseConnection(Connection);
 					}
-					else if (TCPHeaderIN->Flags == TCP_FLAG_ACK)
+					else if (ConnectionInfo->SequenceNumberAcked == ConnectionInfo->SequenceNumberOut)
 					{
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_FINWait2);
+						Connection->State = TCP_Connection_FINWait2;
 					}
 
 					break;
 				case TCP_Connection_FINWait2:
-					if (TCPHeaderIN->Flags == (TCP_FLAG_FIN | TCP_FLAG_ACK))
+					if (TCPHeaderIN->Flags & TCP_FLAG_FIN)
 					{
-						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-															   TCPHeaderIN->SourcePort);
-
-						TCPHeaderOUT->Flags = TCP_FLAG_ACK;
-						PacketResponse      = true;
+						ResponseFlags = TCP_FLAG_ACK;
 
 						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
 
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_Closed);
+						TCP_CloseConnection(Connection);
 					}
 
 					break;
 				case TCP_Connection_CloseWait:
-					if (TCPHeaderIN->Flags == TCP_FLAG_ACK)
+				case TCP_Connection_LastACK:
+					/* Host has finished sending, but still acknowledges the remainder of the reply and the device's FIN */
+					if (TCPHeaderIN->Flags & TCP_FLAG_ACK)
+					  TCP_ProcessACK(Connection, TCPHeaderIN, DataLength);
+
+					/* Acknowledge the host's FIN again if it is repeated, as the first acknowledgement was lost */
+					if (TCPHeaderIN->Flags & TCP_FLAG_FIN)
+					  ResponseFlags = TCP_FLAG_ACK;
+
+					if ((Connection->State == TCP_Connection_LastACK) &&
+					    (ConnectionInfo->SequenceNumberAcked == ConnectionInfo->SequenceNumberOut))
 					{
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_Closed);
+						TCP_CloseConnection(Connection);
 					}
 
 					break;
@@ -556,26 +813,40 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 	else
 	{
 		/* Port is not open, indicate via a RST/ACK response to the sender */
-		TCPHeaderOUT->Flags = (TCP_FLAG_RST | TCP_FLAG_ACK);
-		PacketResponse      = true;
+		if (!(TCPHeaderIN->Flags & TCP_FLAG_RST))
+		  ResponseFlags = (TCP_FLAG_RST | TCP_FLAG_ACK);
 	}
 
 	/* Check if we need to respond to the sent packet */
-	if (PacketResponse)
+	if (ResponseFlags)
 	{
-		ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, &IPHeaderIN->SourceAddress,
-		                                       TCPHeaderIN->SourcePort);
-
 		TCPHeaderOUT->SourcePort           = TCPHeaderIN->DestinationPort;
 		TCPHeaderOUT->DestinationPort      = TCPHeaderIN->SourcePort;
-		TCPHeaderOUT->SequenceNumber       = SwapEndian_32(ConnectionInfo->SequenceNumberOut);
-		TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(ConnectionInfo->SequenceNumberIn);
 		TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
+		TCPHeaderOUT->Flags                = ResponseFlags;
+
+		if (ResponseFlags & TCP_FLAG_RST)
+		{
+			/* Reset of a connection not in the table, sequence numbers are taken from the offending packet */
+			uint32_t SequenceNumberIn = (SwapEndian_32(TCPHeaderIN->SequenceNumber) + DataLength);
+
+			if (TCPHeaderIN->Flags & (TCP_FLAG_SYN | TCP_FLAG_FIN))
+			  SequenceNumberIn++;
 
-		if (!(ConnectionInfo->Buffer.InUse))
-		  TCPHeaderOUT->WindowSize         = SwapEndian_16(TCP_WINDOW_SIZE);
+			TCPHeaderOUT->SequenceNumber       = (TCPHeaderIN->Flags & TCP_FLAG_ACK) ? TCPHeaderIN->AcknowledgmentNumber : 0;
+			TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(SequenceNumberIn);
+			TCPHeaderOUT->WindowSize           = 0;
+		}
 		else
-		  TCPHeaderOUT->WindowSize         = SwapEndian_16(TCP_WINDOW_SIZE - ConnectionInfo->Buffer.Length);
+		{
+			TCPHeaderOUT->SequenceNumber       = SwapEndian_32(Connection->Info.SequenceNumberOut);
+			TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(Connection->Info.SequenceNumberIn);
+			TCPHeaderOUT->WindowSize           = SwapEndian_16(TCP_ReceiveWindowSize(Connection));
+
+			/* SYN and FIN each take up a sequence number of their own */
+			if (ResponseFlags & (TCP_FLAG_SYN | TCP_FLAG_FIN))
+			  Connection->Info.SequenceNumberOut++;
+		}
 
 		TCPHeaderOUT->UrgentPointer        = 0;
 		TCPHeaderOUT->Checksum             = 0;
@@ -605,27 +876,16 @@ static uint16_t TCP_Checksum16(void* TCPHeaderOutStart,
                                const IP_Address_t* DestinationAddress,
                                uint16_t TCPOutSize)
 {
-	uint32_t Checksum = 0;
+	uint16_t Checksum;
 
 	/* TCP/IP checksums are the addition of the one's compliment of each word including the IP pseudo-header,
 	   complimented */
 
-	Checksum += ((uint16_t*)SourceAddress)[0];
-	Checksum += ((uint16_t*)SourceAddress)[1];
-	Checksum += ((uint16_t*)DestinationAddress)[0];
-	Checksum += ((uint16_t*)DestinationAddress)[1];
-	Checksum += SwapEndian_16(PROTOCOL_TCP);
-	Checksum += SwapEndian_16(TCPOutSize);
-
-	for (uint16_t CurrWord = 0; CurrWord < (TCPOutSize >> 1); CurrWord++)
-	  Checksum += ((uint16_t*)TCPHeaderOutStart)[CurrWord];
-
-	if (TCPOutSize & 0x01)
-	  Checksum += (((uint16_t*)TCPHeaderOutStart)[TCPOutSize >> 1] & 0x00FF);
-
-	while (Checksum & 0xFFFF0000)
-	  Checksum = ((Checksum & 0xFFFF) + (Checksum >> 16));
+	Checksum = InetChecksum_Add(0, SourceAddress, sizeof(IP_Address_t));
+	Checksum = InetChecksum_Add(Checksum, DestinationAddress, sizeof(IP_Address_t));
+	Checksum = InetChecksum_AddWord(Checksum, SwapEndian_16(PROTOCOL_TCP));
+	Checksum = InetChecksum_AddWord(Checksum, SwapEndian_16(TCPOutSize));
 
-	return ~Checksum;
+	return ~InetChecksum_Add(Checksum, TCPHeaderOutStart, TCPOutSize);
 }
 
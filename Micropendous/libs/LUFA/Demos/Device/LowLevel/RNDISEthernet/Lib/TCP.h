@@ -54,6 +54,23 @@
 		/** TCP window size, giving the maximum number of bytes which can be buffered at the one time. */
 		#define TCP_WINDOW_SIZE                 512
 
+		/** Number of buckets in the connection index, which locates a connection from its local port and remote address and
+		 *  port. Must be a power of two.
+		 */
+		#define TCP_CONNECTION_BUCKETS          4
+
+		/** Marker for the end of a list of connections in the connection index. */
+		#define TCP_NO_CONNECTION               0xFF
+
+		/** Number of repeated acknowledgements of the same data from the host after which unacknowledged stream data is sent
+		 *  again.
+		 */
+		#define TCP_DUPLICATE_ACK_LIMIT         3
+
+		/** Largest amount of data sent to the host in a single TCP packet, limited by the size of the Ethernet frame buffer. */
+		#define TCP_MAX_SEGMENT_SIZE            (ETHERNET_FRAME_SIZE_MAX - sizeof(Ethernet_Frame_Header_t) - \
+		                                         sizeof(IP_Header_t) - sizeof(TCP_Header_t))
+
 		/** Port number for HTTP transmissions. */
 		#define TCP_PORT_HTTP                   SwapEndian_16(80)
 
@@ -134,17 +151,34 @@
 		 */
 		#define TCP_APP_SEND_BUFFER(Buffer, Len)     MACROS{ Buffer->Direction = TCP_PACKETDIR_OUT; Buffer->Length = Len; Buffer->Ready = true; }MACROE
 
+		/** Application macro: Streams data to the host on the given connection. Rather than being copied into the application
+		 *  buffer, the data is read by the given \ref TCP_StreamReader_t function straight into each outgoing packet as the host's
+		 *  receive window allows, spreading it over as many packets as needed. The reader may be called more than once for the
+		 *  same data, if the host asks for it to be sent again. The stream must not be combined with a reply sent through
+		 *  \ref TCP_APP_SEND_BUFFER() from the same application callback run.
+		 *
+		 *  \param[in] Connection  Open TCP connection to stream the data on
+		 *  \param[in] Len         Total length of the stream in bytes
+		 *  \param[in] Reader      Function to read the stream data
+		 */
+		#define TCP_APP_SEND_STREAM(Connection, Len, Reader) MACROS{ Connection->Info.StreamStart  = Connection->Info.SequenceNumberOut; \
+		                                                           Connection->Info.StreamEnd    = Connection->Info.SequenceNumberOut + (Len); \
+		                                                           Connection->Info.StreamReader = Reader; }MACROE
+
 		/** Application macro: Clears the application buffer, ready for a packet to be written to it.
 		 *
 		 *  \param[in] Buffer  Application buffer to clear
 		 */
 		#define TCP_APP_CLEAR_BUFFER(Buffer)         MACROS{ Buffer->Ready = false; Buffer->Length = 0; }MACROE
 
-		/** Application macro: Closes an open connection to a host.
+		/** Application macro: Closes an open connection to a host, once all data sent on it has been acknowledged. A connection
+		 *  the host has already closed is finalized in the same way once the application's reply has been sent, so this has no
+		 *  effect on it.
 		 *
 		 *  \param[in] Connection  Open TCP connection to close
 		 */
-		#define TCP_APP_CLOSECONNECTION(Connection)  MACROS{ Connection->State = TCP_Connection_Closing;  }MACROE
+		#define TCP_APP_CLOSECONNECTION(Connection)  MACROS{ if (Connection->State == TCP_Connection_Established) \
+		                                                       Connection->State = TCP_Connection_Closing; }MACROE
 
 	/* Enums: */
 		/** Enum for possible TCP port states. */
@@ -163,9 +197,9 @@
 			TCP_Connection_Established = 3, /**< Connection established in both directions */
 			TCP_Connection_FINWait1    = 4, /**< Closing, waiting for ACK */
 			TCP_Connection_FINWait2    = 5, /**< Closing, waiting for FIN ACK */
-			TCP_Connection_CloseWait   = 6, /**< Closing, waiting for ACK */
-			TCP_Connection_Closing     = 7, /**< Unused */
-			TCP_Connection_LastACK     = 8, /**< Unused */
+			TCP_Connection_CloseWait   = 6, /**< Closed by the host, sending the rest of the application's reply */
+			TCP_Connection_Closing     = 7, /**< Closed by the application, waiting for sent data to be acknowledged */
+			TCP_Connection_LastACK     = 8, /**< Closed by the host, waiting for ACK of the device's FIN */
 			TCP_Connection_TimeWait    = 9, /**< Unused */
 			TCP_Connection_Closed      = 10, /**< Connection closed in both directions */
 		};
@@ -183,11 +217,28 @@
 			bool                   InUse; /**< Indicates if the buffer is locked to to the current direction, and cannot be changed */
 		} TCP_ConnectionBuffer_t;
 
+		/** Type define for a TCP stream reader function, which copies a block of the data streamed to the host on a connection
+		 *  into an outgoing packet.
+		 *
+		 *  \param[in]  Offset  Offset of the block from the start of the stream
+		 *  \param[out] Data    Location in the outgoing packet to copy the block to
+		 *  \param[in]  Length  Length of the block in bytes
+		 */
+		typedef void (*TCP_StreamReader_t)(const uint32_t Offset,
+		                                   uint8_t* Data,
+		                                   const uint16_t Length);
+
 		/** Type define for a TCP connection information structure. */
 		typedef struct
 		{
 			uint32_t               SequenceNumberIn; /**< Current TCP sequence number for host-to-device */
 			uint32_t               SequenceNumberOut; /**< Current TCP sequence number for device-to-host */
+			uint32_t               SequenceNumberAcked; /**< Oldest device-to-host sequence number not yet acknowledged by the host */
+			uint16_t               RemoteWindowSize; /**< Receive window size last advertised by the host */
+			uint8_t                DuplicateACKs; /**< Number of repeated acknowledgements of \c SequenceNumberAcked received */
+			uint32_t               StreamStart; /**< Sequence number of the first byte streamed to the host */
+			uint32_t               StreamEnd; /**< Sequence number following the last byte streamed to the host */
+			TCP_StreamReader_t     StreamReader; /**< Stream reader function, see \ref TCP_APP_SEND_STREAM() */
 			TCP_ConnectionBuffer_t Buffer; /**< Connection application data buffer */
 		} TCP_ConnectionInfo_t;
 
@@ -199,6 +250,8 @@
 			IP_Address_t           RemoteAddress; /**< Connection protocol IP address of the host */
 			TCP_ConnectionInfo_t   Info; /**< Connection information, including application buffer */
 			uint8_t                State; /**< Current connection state, a value from the \ref TCP_ConnectionStates_t enum */
+			uint8_t                PortTableEntry; /**< Entry in the port state table for the connection's port */
+			uint8_t                NextConnection; /**< Next connection in the same connection index bucket, or \ref TCP_NO_CONNECTION */
 		} TCP_ConnectionState_t;
 
 		/** Type define for a TCP port state. */
@@ -250,6 +303,24 @@
 		                                           void* TCPHeaderOutStart);
 
 		#if defined(INCLUDE_FROM_TCP_C)
+			#define TCP_CONNECTION_BUCKET(Port, RemoteAddress, RemotePort) \
+			        (((uint8_t)(((Port) ^ (RemotePort)) >> 8) ^ (uint8_t)((Port) ^ (RemotePort)) ^ \
+			          (RemoteAddress)->Octets[3]) & (TCP_CONNECTION_BUCKETS - 1))
+
+			static TCP_ConnectionState_t* TCP_FindConnection(const uint16_t Port,
+			                                                 const IP_Address_t* RemoteAddress,
+			                                                 const uint16_t RemotePort);
+			static TCP_ConnectionState_t* TCP_OpenConnection(const uint16_t Port,
+			                                                 const IP_Address_t* RemoteAddress,
+			                                                 const uint16_t RemotePort);
+			static void TCP_CloseConnection(TCP_ConnectionState_t* const Connection);
+			static void TCP_ProcessACK(TCP_ConnectionState_t* const Connection,
+			                           const TCP_Header_t* TCPHeaderIN,
+			                           const uint16_t DataLength);
+			static uint16_t TCP_ReceiveWindowSize(const TCP_ConnectionState_t* Connection);
+			static void TCP_SendSegment(TCP_ConnectionState_t* const Connection,
+			                            const uint8_t Flags,
+			                            const uint16_t DataLength);
 			static uint16_t TCP_Checksum16(void* TCPHeaderOutStart,
 			                               const IP_Address_t* SourceAddress,
 			                               const IP_Address_t* DestinationAddress,
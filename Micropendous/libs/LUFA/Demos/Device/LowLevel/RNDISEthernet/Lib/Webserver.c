@@ -51,8 +51,8 @@ const char PROGMEM HTTP404Header[] = "HTTP/1.1 404 Not Found\r\n"
                                      "Server: LUFA RNDIS\r\n"
                                      "Connection: close\r\n\r\n";
 
-/** HTTP page to serve to the host when a HTTP request is made. This page is too long for a single response, thus it is automatically
- *  broken up into smaller blocks and sent as a series of packets each time the webserver application callback is run.
+/** HTTP page to serve to the host when a HTTP request is made. This page is too long for a single response, thus it is streamed
+ *  to the host straight from flash by the TCP stack, which breaks it up into as many packets as needed.
  */
 const char PROGMEM HTTPPage[]   =
 		"<html>"
@@ -83,6 +83,35 @@ void Webserver_Init(void)
 	TCP_SetPortState(TCP_PORT_HTTP, TCP_Port_Open, Webserver_ApplicationCallback);
 }
 
+/** TCP stream reader for the HTTP page response, reading the requested block of the HTTP 200 response header followed by the
+ *  HTTP page from flash into an outgoing packet.
+ *
+ *  \param[in]  Offset  Offset of the block from the start of the response
+ *  \param[out] Data    Location in the outgoing packet to copy the block to
+ *  \param[in]  Length  Length of the block in bytes
+ */
+static void Webserver_ReadPageResponse(const uint32_t Offset,
+                                       uint8_t* Data,
+                                       uint16_t Length)
+{
+	uint16_t Position = Offset;
+
+	/* Copy the part of the block which falls in the response header, less its null terminator */
+	if (Position < (sizeof(HTTP200Header) - 1))
+	{
+		uint16_t HeaderLength = MIN(Length, (sizeof(HTTP200Header) - 1) - Position);
+
+		memcpy_P(Data, &HTTP200Header[Position], HeaderLength);
+
+		Data     += HeaderLength;
+		Length   -= HeaderLength;
+		Position += HeaderLength;
+	}
+
+	/* Copy the remainder of the block from the page contents */
+	memcpy_P(Data, &HTTPPage[Position - (sizeof(HTTP200Header) - 1)], Length);
+}
+
 /** Indicates if a given request equals the given HTTP command.
  *
  *  \param[in] RequestHeader  HTTP request made by the host
@@ -106,8 +135,7 @@ static bool IsHTTPCommand(uint8_t* RequestHeader,
 void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
                                    TCP_ConnectionBuffer_t* const Buffer)
 {
-	char*          BufferDataStr = (char*)Buffer->Data;
-	static uint8_t PageBlock     = 0;
+	char* BufferDataStr = (char*)Buffer->Data;
 
 	/* Check to see if a packet has been received on the HTTP port from a remote host */
 	if (TCP_APP_HAS_RECEIVED_PACKET(Buffer))
@@ -116,16 +144,15 @@ void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
 		{
 			if (IsHTTPCommand(Buffer->Data, "GET / "))
 			{
-				PageBlock = 0;
-
-				/* Copy the HTTP 200 response header into the packet buffer */
-				strcpy_P(BufferDataStr, HTTP200Header);
+				/* Stream the HTTP 200 response header and the page contents to the host, less their null terminators */
+				TCP_APP_SEND_STREAM(ConnectionState, ((sizeof(HTTP200Header) - 1) + (sizeof(HTTPPage) - 1)),
+				                    Webserver_ReadPageResponse);
 
-				/* Send the buffer contents to the host */
-				TCP_APP_SEND_BUFFER(Buffer, strlen(BufferDataStr));
+				/* Request processed, free the buffer for future packets from the host */
+				TCP_APP_CLEAR_BUFFER(Buffer);
 
-				/* Lock the buffer to Device->Host transmissions only while we send the page contents */
-				TCP_APP_CAPTURE_BUFFER(Buffer);
+				/* Close the connection once the host has received the whole page */
+				TCP_APP_CLOSECONNECTION(ConnectionState);
 			}
 			else
 			{
@@ -175,29 +202,5 @@ void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
 			TCP_APP_CLEAR_BUFFER(Buffer);
 		}
 	}
-	else if (TCP_APP_HAVE_CAPTURED_BUFFER(Buffer))
-	{
-		uint16_t RemLength = strlen_P(&HTTPPage[PageBlock * HTTP_REPLY_BLOCK_SIZE]);
-		uint16_t Length;
-
-		/* Determine the length of the loaded block */
-		Length = MIN(RemLength, HTTP_REPLY_BLOCK_SIZE);
-
-		/* Copy the next buffer sized block of the page to the packet buffer */
-		strncpy_P(BufferDataStr, &HTTPPage[PageBlock * HTTP_REPLY_BLOCK_SIZE], Length);
-
-		/* Send the buffer contents to the host */
-		TCP_APP_SEND_BUFFER(Buffer, Length);
-
-		/* Check to see if the entire page has been sent */
-		if (PageBlock++ == (sizeof(HTTPPage) / HTTP_REPLY_BLOCK_SIZE))
-		{
-			/* Unlock the buffer so that the host can fill it with future packets */
-			TCP_APP_RELEASE_BUFFER(Buffer);
-
-			/* Close the connection to the host */
-			TCP_APP_CLOSECONNECTION(ConnectionState);
-		}
-	}
 }
 
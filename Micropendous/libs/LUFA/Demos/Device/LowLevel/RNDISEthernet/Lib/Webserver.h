@@ -44,10 +44,6 @@
 
 		#include "TCP.h"
 
-	/* Macros: */
-		/** Maximum size of a HTTP response per transmission */
-		#define  HTTP_REPLY_BLOCK_SIZE     128
-
 	/* Function Prototypes: */
 		void Webserver_Init(void);
 		void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
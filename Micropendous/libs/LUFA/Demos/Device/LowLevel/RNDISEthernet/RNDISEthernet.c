@@ -266,8 +266,9 @@ void Ethernet_Task(void)
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return;
 
-	/* Check if a frame has been written to the IN frame buffer */
-	if (FrameIN.FrameLength)
+	/* Check if a frame has been written to the IN frame buffer - leave it there while the OUT frame buffer still
+	   holds a frame waiting to be sent to the host, as any response would be written over the waiting frame */
+	if (FrameIN.FrameLength && !(FrameOUT.FrameLength))
 	{
 		/* Indicate packet processing started */
 		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
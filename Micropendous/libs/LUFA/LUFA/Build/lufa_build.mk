@@ -129,6 +129,8 @@ else ifeq ($(ARCH), XMEGA)
 else ifeq ($(ARCH), UC3)
    CROSS        := avr32
    $(warning The UC3 device support is currently EXPERIMENTAL (incomplete and/or non-functional), and is included for preview purposes only.)
+else ifeq ($(ARCH), SIM)
+   CROSS        := $(shell gcc -dumpmachine)
 else
    $(error Unsupported architecture "$(ARCH)")
 endif
@@ -185,6 +187,8 @@ else ifeq ($(ARCH), XMEGA)
    BASE_CC_FLAGS += -mmcu=$(MCU) -fshort-enums -fno-inline-small-functions -fpack-struct
 else ifeq ($(ARCH), UC3)
    BASE_CC_FLAGS += -mpart=$(MCU:at32%=%) -masm-addr-pseudos
+else ifeq ($(ARCH), SIM)
+   BASE_CC_FLAGS += -fshort-wchar -pthread -Wno-attribute-alias
 endif
 BASE_CC_FLAGS += -Wall -fno-strict-aliasing -funsigned-char -funsigned-bitfields -ffunction-sections
 BASE_CC_FLAGS += -I. -I$(patsubst %/,%,$(LUFA_PATH))/..
@@ -209,6 +213,8 @@ else ifeq ($(ARCH), XMEGA)
    BASE_LD_FLAGS += -mmcu=$(MCU)
 else ifeq ($(ARCH), UC3)
    BASE_LD_FLAGS += -mpart=$(MCU:at32%=%) --rodata-writable --direct-data
+else ifeq ($(ARCH), SIM)
+   BASE_LD_FLAGS += -pthread
 endif
 
 # Determine flags to pass to the size utility based on its reported features (only invoke if size target required)
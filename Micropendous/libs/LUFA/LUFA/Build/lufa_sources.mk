@@ -100,6 +100,10 @@ LUFA_SRC_USB_DEVICE      := $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/Device_$(
                             $(LUFA_ROOT_PATH)/Drivers/USB/Core/DeviceStandardReq.c               \
                             $(LUFA_SRC_USB_COMMON)
 
+ifeq ($(ARCH), SIM)
+   LUFA_SRC_USB_DEVICE   += $(LUFA_ROOT_PATH)/Drivers/USB/Core/SIM/HostModel_SIM.c
+endif
+
 LUFA_SRC_USBCLASS_DEVICE := $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/AudioClassDevice.c        \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/CDCClassDevice.c          \
                             $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/HIDClassDevice.c          \
@@ -130,6 +134,8 @@ LUFA_SRC_TWI             := $(LUFA_ROOT_PATH)/Drivers/Peripheral/$(ARCH)/TWI_$(A
 ifeq ($(ARCH), UC3)
    LUFA_SRC_PLATFORM     := $(LUFA_ROOT_PATH)/Platform/UC3/Exception.S   \
                             $(LUFA_ROOT_PATH)/Platform/UC3/InterruptManagement.c
+else ifeq ($(ARCH), SIM)
+   LUFA_SRC_PLATFORM     := $(LUFA_ROOT_PATH)/Platform/SIM/HostEmulation.c
 else
    LUFA_SRC_PLATFORM     :=
 endif
@@ -164,6 +164,14 @@
 				                                                     printf("%s: Function \"%s\", Line %d: "     \
 				                                                            "Assertion \"%s\" failed.\r\n"),     \
 				                                                            __FILE__, __func__, __LINE__, #Condition); } }MACROE
+			#elif (ARCH == ARCH_SIM)
+				#define JTAG_DEBUG_POINT()              __asm__ __volatile__ ("nop" ::)
+				#define JTAG_DEBUG_BREAK()              __builtin_trap()
+				#define JTAG_ASSERT(Condition)          MACROS{ if (!(Condition)) { JTAG_DEBUG_BREAK(); } }MACROE
+				#define STDOUT_ASSERT(Condition)        MACROS{ if (!(Condition)) {                              \
+				                                                     printf("%s: Function \"%s\", Line %d: "     \
+				                                                            "Assertion \"%s\" failed.\r\n",      \
+				                                                            __FILE__, __func__, __LINE__, #Condition); } }MACROE
 			#endif
 
 	/* Disable C linkage for C++ Compilers: */
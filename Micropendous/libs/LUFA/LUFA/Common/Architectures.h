@@ -70,6 +70,11 @@
 			/** Selects the Atmel XMEGA AVR (ATXMEGA*U chips) architecture. */
 			#define ARCH_XMEGA          2
 
+			/** Selects the host-side USB controller simulator architecture, which builds the library and its
+			 *  applications natively for the host machine against an in-memory model of the USB AVR controller.
+			 */
+			#define ARCH_SIM            3
+
 			#if !defined(__DOXYGEN__)
 				#define ARCH_           ARCH_AVR8
 
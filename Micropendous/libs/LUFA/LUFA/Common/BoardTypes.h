@@ -227,6 +227,9 @@
 
 			/** Selects the Stange-ISP specific board drivers, including the Button and LEDs drivers. */
 			#define BOARD_STANGE_ISP           54
+
+			/** Selects the Micropendous 32U4 specific board drivers, including the Button and LED drivers. */
+			#define BOARD_MICROPENDOUS_32U4    55
 			
 			#if !defined(__DOXYGEN__)
 				#define BOARD_                 BOARD_NONE
@@ -142,6 +142,16 @@
 			#define ARCH_HAS_MULTI_ADDRESS_SPACE
 			#define ARCH_LITTLE_ENDIAN
 
+			#include "Endianness.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "../Platform/SIM/HostEmulation.h"
+
+			typedef uint8_t uint_reg_t;
+
+			#define ARCH_HAS_EEPROM_ADDRESS_SPACE
+			#define ARCH_HAS_FLASH_ADDRESS_SPACE
+			#define ARCH_LITTLE_ENDIAN
+
 			#include "Endianness.h"
 		#else
 			#error Unknown device architecture specified.
@@ -282,6 +292,8 @@
 					while (Milliseconds--)
 					  _delay_ms(1);
 				}
+				#elif (ARCH == ARCH_SIM)
+				SIM_Delay_MS(Milliseconds);
 				#endif
 			}
 
@@ -304,6 +316,8 @@
 				return __builtin_mfsr(AVR32_SR);
 				#elif (ARCH == ARCH_XMEGA)
 				return SREG;
+				#elif (ARCH == ARCH_SIM)
+				return SIM_GlobalInterruptFlag;
 				#endif
 			}
 
@@ -329,6 +343,11 @@
 				  __builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				SREG = GlobalIntState;
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptFlag = GlobalIntState;
+
+				if (GlobalIntState && SIM_PendingInterrupts)
+				  SIM_INTC_DispatchPending();
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -349,6 +368,11 @@
 				__builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				sei();
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptFlag = 1;
+
+				if (SIM_PendingInterrupts)
+				  SIM_INTC_DispatchPending();
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -369,6 +393,8 @@
 				__builtin_ssrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				cli();
+				#elif (ARCH == ARCH_SIM)
+				SIM_GlobalInterruptFlag = 0;
 				#endif
 
 				GCC_MEMORY_BARRIER();
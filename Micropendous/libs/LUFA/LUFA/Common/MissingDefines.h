@@ -32,7 +32,9 @@
 #ifndef __MISSING_DEFINES__
 #define __MISSING_DEFINES__
 
-#include <avr/version.h>
+#if (ARCH != ARCH_SIM)
+	#include <avr/version.h>
+#endif
 
 
 #ifndef PINHIGH
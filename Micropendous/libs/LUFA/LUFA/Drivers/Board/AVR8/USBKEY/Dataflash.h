@@ -134,6 +134,28 @@
 				return SPI_ReceiveByte();
 			}
 
+			/** Starts sending a byte to the currently selected dataflash IC, without waiting for the transfer to complete,
+			 *  so that the next byte can be fetched while this one is being sent. Each call must be paired with a call to
+			 *  \ref Dataflash_FinishTransfer() before the dataflash is used again.
+			 *
+			 *  \param[in] Byte  Byte of data to send to the dataflash
+			 */
+			static inline void Dataflash_StartTransfer(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_StartTransfer(const uint8_t Byte)
+			{
+				SPI_StartTransfer(Byte);
+			}
+
+			/** Waits until a transfer started with \ref Dataflash_StartTransfer() is complete.
+			 *
+			 *  \return Response byte from the dataflash
+			 */
+			static inline uint8_t Dataflash_FinishTransfer(void) ATTR_ALWAYS_INLINE;
+			static inline uint8_t Dataflash_FinishTransfer(void)
+			{
+				return SPI_FinishTransfer();
+			}
+
 			/** Determines the currently selected dataflash chip.
 			 *
 			 *  \return Mask of the currently selected Dataflash chip, either \ref DATAFLASH_NO_CHIP if no chip is selected
@@ -0,0 +1,245 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Fast Internet (one's complement) checksum routines.
+ *
+ *  Optimized routines for calculating and incrementally updating the 16-bit one's complement checksum
+ *  used by the IP, ICMP, UDP and TCP protocols.
+ */
+
+/** \ingroup Group_MiscDrivers
+ *  \defgroup Group_InetChecksum Internet Checksum - LUFA/Drivers/Misc/InternetChecksum.h
+ *  \brief Fast Internet (one's complement) checksum routines.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - None
+ *
+ *  \section Sec_ModDescription Module Description
+ *  Checksum routines for the 16-bit one's complement sum defined by RFC 1071, shared by the network stacks
+ *  of the LUFA demos and projects. The sum is accumulated four bytes per loop iteration; on the 8-bit AVR
+ *  architectures this is done in assembly with the carry flag chained across the whole buffer, so that each
+ *  byte costs a single load and add-with-carry, rather than the 16-bit compare and branch needed to catch
+ *  each carry in C.
+ *
+ *  All sums are of 16-bit words in the order they are stored in memory, exactly as they appear in a packet
+ *  buffer; as the one's complement sum is independent of byte order, the complement of a finished sum may be
+ *  written straight into a packet's checksum field on any architecture. Sums of several separate buffers may
+ *  be chained by passing the previous result as the starting sum, as long as all but the last buffer are an
+ *  even number of bytes long.
+ *
+ *  Where only a few fields of an already checksummed packet change, \ref InetChecksum_Adjust() updates the
+ *  packet's checksum from the old and new field values as described in RFC 1624, without summing the packet
+ *  again.
+ *
+ *  \section Sec_ExampleUsage Example Usage
+ *  The following snippet is an example of how this module may be used within a typical
+ *  application.
+ *
+ *  \code
+ *      // Calculate the checksum of an IP header
+ *      IPHeader->HeaderChecksum = 0;
+ *      IPHeader->HeaderChecksum = ~InetChecksum_Add(0, IPHeader, sizeof(IP_Header_t));
+ *      
+ *      // Shorten the packet, patching the checksum rather than calculating it again
+ *      uint16_t NewLength = CPU_TO_BE16(sizeof(IP_Header_t) + 20);
+ *      IPHeader->HeaderChecksum = InetChecksum_Adjust(IPHeader->HeaderChecksum, IPHeader->TotalLength, NewLength);
+ *      IPHeader->TotalLength    = NewLength;
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __INTERNET_CHECKSUM_H__
+#define __INTERNET_CHECKSUM_H__
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Inline Functions: */
+		/** Adds two values together using one's complement arithmetic.
+		 *
+		 *  \param[in] SumA  First one's complement sum to add.
+		 *  \param[in] SumB  Second one's complement sum to add.
+		 *
+		 *  \return One's complement sum of the two values.
+		 */
+		static inline uint16_t InetChecksum_AddWord(const uint16_t SumA,
+		                                            const uint16_t SumB) ATTR_WARN_UNUSED_RESULT ATTR_CONST ATTR_ALWAYS_INLINE;
+		static inline uint16_t InetChecksum_AddWord(const uint16_t SumA,
+		                                            const uint16_t SumB)
+		{
+			uint16_t Sum = (SumA + SumB);
+
+			return (Sum + (Sum < SumB));
+		}
+
+		/** Adds the contents of a buffer to a running one's complement sum, treating the buffer as a sequence of
+		 *  16-bit words in memory order. If the buffer is an odd number of bytes long, its last byte is summed as
+		 *  though it were followed by a zero pad byte.
+		 *
+		 *  \param[in] Sum     Running sum to add to, or zero to start a new sum.
+		 *  \param[in] Data    Pointer to the start of the buffer to sum.
+		 *  \param[in] Length  Length of the buffer in bytes.
+		 *
+		 *  \return One's complement sum of the starting sum and the buffer contents, which must be complemented to
+		 *          give the final checksum.
+		 */
+		static inline uint16_t InetChecksum_Add(uint16_t Sum,
+		                                        const void* Data,
+		                                        uint16_t Length) ATTR_WARN_UNUSED_RESULT;
+		static inline uint16_t InetChecksum_Add(uint16_t Sum,
+		                                        const void* Data,
+		                                        uint16_t Length)
+		{
+			const uint8_t* DataPtr = (const uint8_t*)Data;
+
+			#if ((ARCH == ARCH_AVR8) || (ARCH == ARCH_XMEGA))
+			uint16_t Blocks = (Length >> 2);
+
+			if (Blocks)
+			{
+				/* Inner counter runs first, with zero standing for 256 iterations, then the outer counter repeats it */
+				uint8_t InnerCount = (Blocks & 0xFF);
+				uint8_t OuterCount = ((Blocks >> 8) + (InnerCount ? 1 : 0));
+
+				/* Only LD, DEC and BRNE appear between the additions, none of which affect the carry flag, so the
+				   carry out of each word is carried into the next one and the end-around carry is applied once */
+				__asm__ (
+					"clc"                                "\n\t"
+					"1:"                                 "\n\t"
+					"ld   __tmp_reg__, %a[DataPtr]+"     "\n\t"
+					"adc  %A[Sum], __tmp_reg__"          "\n\t"
+					"ld   __tmp_reg__, %a[DataPtr]+"     "\n\t"
+					"adc  %B[Sum], __tmp_reg__"          "\n\t"
+					"ld   __tmp_reg__, %a[DataPtr]+"     "\n\t"
+					"adc  %A[Sum], __tmp_reg__"          "\n\t"
+					"ld   __tmp_reg__, %a[DataPtr]+"     "\n\t"
+					"adc  %B[Sum], __tmp_reg__"          "\n\t"
+					"dec  %[InnerCount]"                 "\n\t"
+					"brne 1b"                            "\n\t"
+					"dec  %[OuterCount]"                 "\n\t"
+					"brne 1b"                            "\n\t"
+					"adc  %A[Sum], __zero_reg__"         "\n\t"
+					"adc  %B[Sum], __zero_reg__"         "\n\t"
+					"adc  %A[Sum], __zero_reg__"         "\n\t"
+					: [Sum]        "+r" (Sum),
+					  [DataPtr]    "+e" (DataPtr),
+					  [InnerCount] "+r" (InnerCount),
+					  [OuterCount] "+r" (OuterCount)
+					:
+					: "memory"
+				);
+
+				Length &= 0x03;
+			}
+			#else
+			uint32_t WideSum = Sum;
+
+			/* Sixteen bit words are added to a wider accumulator four at a time, and its carries folded back in at the end */
+			while (Length >= 8)
+			{
+				#if defined(ARCH_LITTLE_ENDIAN)
+				WideSum += (uint16_t)(DataPtr[0] | (DataPtr[1] << 8)) + (uint16_t)(DataPtr[2] | (DataPtr[3] << 8)) +
+				           (uint16_t)(DataPtr[4] | (DataPtr[5] << 8)) + (uint16_t)(DataPtr[6] | (DataPtr[7] << 8));
+				#else
+				WideSum += (uint16_t)((DataPtr[0] << 8) | DataPtr[1]) + (uint16_t)((DataPtr[2] << 8) | DataPtr[3]) +
+				           (uint16_t)((DataPtr[4] << 8) | DataPtr[5]) + (uint16_t)((DataPtr[6] << 8) | DataPtr[7]);
+				#endif
+
+				DataPtr += 8;
+				Length  -= 8;
+			}
+
+			WideSum = ((WideSum & 0xFFFF) + (WideSum >> 16));
+			Sum     = InetChecksum_AddWord((WideSum & 0xFFFF), (WideSum >> 16));
+			#endif
+
+			while (Length >= 2)
+			{
+				#if defined(ARCH_LITTLE_ENDIAN)
+				Sum = InetChecksum_AddWord(Sum, (DataPtr[0] | (DataPtr[1] << 8)));
+				#else
+				Sum = InetChecksum_AddWord(Sum, ((DataPtr[0] << 8) | DataPtr[1]));
+				#endif
+
+				DataPtr += 2;
+				Length  -= 2;
+			}
+
+			if (Length)
+			{
+				#if defined(ARCH_LITTLE_ENDIAN)
+				Sum = InetChecksum_AddWord(Sum, DataPtr[0]);
+				#else
+				Sum = InetChecksum_AddWord(Sum, (DataPtr[0] << 8));
+				#endif
+			}
+
+			return Sum;
+		}
+
+		/** Updates a checksum after a 16-bit word of the data it covers has changed, using equation 3 of RFC 1624.
+		 *  The checksum and both values must be in the same byte order, normally that in which they are stored in
+		 *  the packet. To account for a change to a field wider than 16 bits, such as an IP address, call this once
+		 *  for each word of the field; a one's complement sum of a whole block may also be passed as either value,
+		 *  to remove or add that block's contribution to the checksum.
+		 *
+		 *  \param[in] Checksum  Existing checksum, as stored in the packet.
+		 *  \param[in] OldValue  Previous value of the changed word.
+		 *  \param[in] NewValue  New value of the changed word.
+		 *
+		 *  \return Updated checksum, to be stored in the packet in place of the existing checksum.
+		 */
+		static inline uint16_t InetChecksum_Adjust(const uint16_t Checksum,
+		                                           const uint16_t OldValue,
+		                                           const uint16_t NewValue) ATTR_WARN_UNUSED_RESULT ATTR_CONST;
+		static inline uint16_t InetChecksum_Adjust(const uint16_t Checksum,
+		                                           const uint16_t OldValue,
+		                                           const uint16_t NewValue)
+		{
+			return ~InetChecksum_AddWord(InetChecksum_AddWord(~Checksum, ~OldValue), NewValue);
+		}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
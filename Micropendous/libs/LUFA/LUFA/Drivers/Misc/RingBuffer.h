@@ -57,6 +57,9 @@
  *  or deletions) must not overlap. If there is possibility of two or more of the same kind of
  *  operating occurring at the same point in time, atomic (mutex) locking should be used.
  *
+ *  Where each buffer has exactly one inserting and one removing thread and a power-of-two size is acceptable,
+ *  the \ref Group_RingBuffSPSC variant avoids disabling interrupts on every operation.
+ *
  *  \section Sec_ExampleUsage Example Usage
  *  The following snippet is an example of how this module may be used within a typical
  *  application.
@@ -96,6 +99,8 @@
 	/* Includes: */
 		#include "../../Common/Common.h"
 
+		#include <string.h>
+
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			extern "C" {
@@ -295,6 +300,176 @@
 			return *Buffer->Out;
 		}
 
+		/** Retrieves the number of bytes which may be inserted into the buffer as a single block starting at
+		 *  the current storage location \c Buffer->In, without wrapping around the end of the underlying
+		 *  storage array. Once data has been copied into this block, it should be committed to the buffer via
+		 *  a call to \ref RingBuffer_AdvanceIn().
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose contiguous free space is to be computed.
+		 *
+		 *  \return Number of contiguous free bytes at the buffer's current storage location.
+		 */
+		static inline uint16_t RingBuffer_GetContiguousFreeCount(RingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint16_t RingBuffer_GetContiguousFreeCount(RingBuffer_t* const Buffer)
+		{
+			uint16_t FreeCount   = RingBuffer_GetFreeCount(Buffer);
+			uint16_t BytesToWrap = (Buffer->End - Buffer->In);
+
+			return MIN(FreeCount, BytesToWrap);
+		}
+
+		/** Retrieves the number of bytes which may be removed from the buffer as a single block starting at
+		 *  the current retrieval location \c Buffer->Out, without wrapping around the end of the underlying
+		 *  storage array. Once data has been copied out of this block, it should be released from the buffer
+		 *  via a call to \ref RingBuffer_AdvanceOut().
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose contiguous stored data is to be computed.
+		 *
+		 *  \return Number of contiguous stored bytes at the buffer's current retrieval location.
+		 */
+		static inline uint16_t RingBuffer_GetContiguousCount(RingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint16_t RingBuffer_GetContiguousCount(RingBuffer_t* const Buffer)
+		{
+			uint16_t Count       = RingBuffer_GetCount(Buffer);
+			uint16_t BytesToWrap = (Buffer->End - Buffer->Out);
+
+			return MIN(Count, BytesToWrap);
+		}
+
+		/** Commits a block of data written directly to the buffer's current storage location, as if each byte
+		 *  had been inserted via \ref RingBuffer_Insert(), but with only a single atomic update of the count.
+		 *
+		 *  \warning The same restrictions on the execution thread apply as for \ref RingBuffer_Insert(), and the
+		 *           number of bytes must not exceed that returned by \ref RingBuffer_GetContiguousFreeCount().
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to commit to.
+		 *  \param[in]     Count   Number of bytes written to the buffer's current storage location.
+		 */
+		static inline void RingBuffer_AdvanceIn(RingBuffer_t* Buffer, const uint16_t Count) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBuffer_AdvanceIn(RingBuffer_t* Buffer, const uint16_t Count)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			Buffer->In += Count;
+
+			if (Buffer->In == Buffer->End)
+			  Buffer->In = Buffer->Start;
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Count += Count;
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Releases a block of data read directly from the buffer's current retrieval location, as if each byte
+		 *  had been removed via \ref RingBuffer_Remove(), but with only a single atomic update of the count.
+		 *
+		 *  \warning The same restrictions on the execution thread apply as for \ref RingBuffer_Remove(), and the
+		 *           number of bytes must not exceed that returned by \ref RingBuffer_GetContiguousCount().
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to release from.
+		 *  \param[in]     Count   Number of bytes read from the buffer's current retrieval location.
+		 */
+		static inline void RingBuffer_AdvanceOut(RingBuffer_t* Buffer, const uint16_t Count) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBuffer_AdvanceOut(RingBuffer_t* Buffer, const uint16_t Count)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			Buffer->Out += Count;
+
+			if (Buffer->Out == Buffer->End)
+			  Buffer->Out = Buffer->Start;
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Count -= Count;
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Inserts as much of a block of data into the ring buffer as will fit, copying it in at most two
+		 *  contiguous runs with a single atomic count update per run.
+		 *
+		 *  \warning The same restrictions on the execution thread apply as for \ref RingBuffer_Insert().
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Pointer to the data to insert.
+		 *  \param[in]     Length  Number of bytes to insert.
+		 *
+		 *  \return Number of bytes inserted into the buffer.
+		 */
+		static inline uint16_t RingBuffer_InsertBlock(RingBuffer_t* const Buffer,
+		                                              const void* const Data,
+		                                              const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_InsertBlock(RingBuffer_t* const Buffer,
+		                                              const void* const Data,
+		                                              const uint16_t Length)
+		{
+			const uint8_t* DataPtr       = (const uint8_t*)Data;
+			uint16_t       BytesInserted = 0;
+
+			for (uint8_t Run = 0; Run < 2; Run++)
+			{
+				uint16_t BytesInRun = RingBuffer_GetContiguousFreeCount(Buffer);
+
+				if ((Length - BytesInserted) < BytesInRun)
+				  BytesInRun = (Length - BytesInserted);
+
+				if (!(BytesInRun))
+				  break;
+
+				memcpy(Buffer->In, &DataPtr[BytesInserted], BytesInRun);
+				RingBuffer_AdvanceIn(Buffer, BytesInRun);
+
+				BytesInserted += BytesInRun;
+			}
+
+			return BytesInserted;
+		}
+
+		/** Removes as much of a block of data from the ring buffer as is available, copying it out in at most
+		 *  two contiguous runs with a single atomic count update per run.
+		 *
+		 *  \warning The same restrictions on the execution thread apply as for \ref RingBuffer_Remove().
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out]    Data    Pointer to the destination for the removed data.
+		 *  \param[in]     Length  Maximum number of bytes to remove.
+		 *
+		 *  \return Number of bytes removed from the buffer.
+		 */
+		static inline uint16_t RingBuffer_RemoveBlock(RingBuffer_t* const Buffer,
+		                                              void* const Data,
+		                                              const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBuffer_RemoveBlock(RingBuffer_t* const Buffer,
+		                                              void* const Data,
+		                                              const uint16_t Length)
+		{
+			uint8_t* DataPtr      = (uint8_t*)Data;
+			uint16_t BytesRemoved = 0;
+
+			for (uint8_t Run = 0; Run < 2; Run++)
+			{
+				uint16_t BytesInRun = RingBuffer_GetContiguousCount(Buffer);
+
+				if ((Length - BytesRemoved) < BytesInRun)
+				  BytesInRun = (Length - BytesRemoved);
+
+				if (!(BytesInRun))
+				  break;
+
+				memcpy(&DataPtr[BytesRemoved], Buffer->Out, BytesInRun);
+				RingBuffer_AdvanceOut(Buffer, BytesInRun);
+
+				BytesRemoved += BytesInRun;
+			}
+
+			return BytesRemoved;
+		}
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -0,0 +1,432 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Lock-free single producer, single consumer ring (circular) buffer.
+ *
+ *  Lock-free ring buffer for passing bytes between exactly one producer and one consumer, such as
+ *  an ISR and the main program loop, without disabling interrupts. Multiple buffers can be created
+ *  of different power-of-two sizes to suit different needs.
+ */
+
+/** \ingroup Group_MiscDrivers
+ *  \defgroup Group_RingBuffSPSC Lock-Free SPSC Byte Ring Buffer - LUFA/Drivers/Misc/RingBufferSPSC.h
+ *  \brief Lock-free single producer, single consumer ring buffer, with block insertion and removal.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - None
+ *
+ *  \section Sec_ModDescription Module Description
+ *  Variant of the \ref Group_RingBuff for the common case of a buffer with exactly one inserting and
+ *  one removing execution thread. Rather than a shared byte count, which must be updated under an atomic
+ *  lock, the buffer keeps free-running insertion and retrieval indexes of the architecture's native
+ *  register width, each of which is only ever written by one side. Reads and writes of a single index are
+ *  therefore atomic without disabling interrupts, and the number of stored bytes is simply the difference
+ *  between the two.
+ *
+ *  As a consequence the size of each buffer's underlying storage array must be a power of two, no larger
+ *  than half the range of a \c uint_reg_t (128 bytes on the 8-bit AVR architectures).
+ *
+ *  In addition to single byte insertion and removal, whole blocks may be copied in or out in one call,
+ *  or processed in place via the contiguous span functions, which expose the largest run of stored data
+ *  or free space that does not wrap around the end of the storage array.
+ *
+ *  \section Sec_ExampleUsage Example Usage
+ *  The following snippet is an example of how this module may be used within a typical
+ *  application.
+ *
+ *  \code
+ *      // Create the buffer structure and its underlying storage array
+ *      RingBufferSPSC_t Buffer;
+ *      uint8_t          BufferData[64];
+ *      
+ *      // Initialize the buffer with the created storage array
+ *      RingBufferSPSC_InitBuffer(&Buffer, BufferData, sizeof(BufferData));
+ *      
+ *      // Insert some data into the buffer (producer side)
+ *      RingBufferSPSC_InsertBlock(&Buffer, "HELLO", 5);
+ *      
+ *      // Print the contents of the buffer one contiguous span at a time (consumer side)
+ *      uint8_t*   Span;
+ *      uint_reg_t SpanLength;
+ *      
+ *      while ((SpanLength = RingBufferSPSC_PeekSpan(&Buffer, &Span)) > 0)
+ *      {
+ *          fwrite(Span, 1, SpanLength, stdout);
+ *          RingBufferSPSC_AdvanceOut(&Buffer, SpanLength);
+ *      }
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __RING_BUFFER_SPSC_H__
+#define __RING_BUFFER_SPSC_H__
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+		#include <string.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Type Defines: */
+		/** \brief Lock-Free SPSC Ring Buffer Management Structure.
+		 *
+		 *  Type define for a new lock-free ring buffer object. Buffers should be initialized via a call to
+		 *  \ref RingBufferSPSC_InitBuffer() before use.
+		 */
+		typedef struct
+		{
+			uint8_t*   Data; /**< Pointer to the start of the buffer's underlying storage array. */
+			uint_reg_t Mask; /**< Size of the buffer's underlying storage array, less one. */
+			uint_reg_t In; /**< Free-running insertion index, written only by the producer. */
+			uint_reg_t Out; /**< Free-running retrieval index, written only by the consumer. */
+		} RingBufferSPSC_t;
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Inline Functions: */
+			static inline uint_reg_t RingBufferSPSC_LoadIndex(const uint_reg_t* const Index) ATTR_ALWAYS_INLINE;
+			static inline uint_reg_t RingBufferSPSC_LoadIndex(const uint_reg_t* const Index)
+			{
+				return __atomic_load_n(Index, __ATOMIC_ACQUIRE);
+			}
+
+			static inline void RingBufferSPSC_StoreIndex(uint_reg_t* const Index,
+			                                             const uint_reg_t Value) ATTR_ALWAYS_INLINE;
+			static inline void RingBufferSPSC_StoreIndex(uint_reg_t* const Index,
+			                                             const uint_reg_t Value)
+			{
+				__atomic_store_n(Index, Value, __ATOMIC_RELEASE);
+			}
+	#endif
+
+	/* Inline Functions: */
+		/** Initializes a lock-free ring buffer ready for use. Buffers must be initialized via this function
+		 *  before any operations are called upon them. Already initialized buffers may be reset by re-initializing
+		 *  them using this function; this is the only operation which enters an atomic lock.
+		 *
+		 *  \param[out] Buffer   Pointer to a ring buffer structure to initialize.
+		 *  \param[out] DataPtr  Pointer to a global array that will hold the data stored into the ring buffer.
+		 *  \param[in]  Size     Size of the underlying data array, which must be a power of two no larger than
+		 *                       half the range of a \c uint_reg_t.
+		 */
+		static inline void RingBufferSPSC_InitBuffer(RingBufferSPSC_t* Buffer,
+		                                             uint8_t* const DataPtr,
+		                                             const uint16_t Size) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline void RingBufferSPSC_InitBuffer(RingBufferSPSC_t* Buffer,
+		                                             uint8_t* const DataPtr,
+		                                             const uint16_t Size)
+		{
+			GCC_FORCE_POINTER_ACCESS(Buffer);
+
+			uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+			GlobalInterruptDisable();
+
+			Buffer->Data = DataPtr;
+			Buffer->Mask = (Size - 1);
+			Buffer->In   = 0;
+			Buffer->Out  = 0;
+
+			SetGlobalInterruptMask(CurrentGlobalInt);
+		}
+
+		/** Retrieves the current number of bytes stored in a particular buffer. No atomic lock is required.
+		 *
+		 *  \note The value returned by this function is guaranteed to only be the minimum number of bytes
+		 *        stored in the given buffer when called by the consumer, as the producer may insert more
+		 *        data at any time.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose count is to be computed.
+		 *
+		 *  \return Number of bytes currently stored in the buffer.
+		 */
+		static inline uint_reg_t RingBufferSPSC_GetCount(RingBufferSPSC_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint_reg_t RingBufferSPSC_GetCount(RingBufferSPSC_t* const Buffer)
+		{
+			return (uint_reg_t)(RingBufferSPSC_LoadIndex(&Buffer->In) - RingBufferSPSC_LoadIndex(&Buffer->Out));
+		}
+
+		/** Retrieves the free space in a particular buffer. No atomic lock is required.
+		 *
+		 *  \note The value returned by this function is guaranteed to only be the minimum number of bytes
+		 *        free in the given buffer when called by the producer, as the consumer may remove data at
+		 *        any time.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose free count is to be computed.
+		 *
+		 *  \return Number of free bytes in the buffer.
+		 */
+		static inline uint_reg_t RingBufferSPSC_GetFreeCount(RingBufferSPSC_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint_reg_t RingBufferSPSC_GetFreeCount(RingBufferSPSC_t* const Buffer)
+		{
+			return ((Buffer->Mask + 1) - RingBufferSPSC_GetCount(Buffer));
+		}
+
+		/** Determines if the specified ring buffer contains any data. This should be tested by the consumer
+		 *  before removing data from the buffer, to ensure that the buffer does not underflow.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no data, \c false otherwise.
+		 */
+		static inline bool RingBufferSPSC_IsEmpty(RingBufferSPSC_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline bool RingBufferSPSC_IsEmpty(RingBufferSPSC_t* const Buffer)
+		{
+			return (RingBufferSPSC_LoadIndex(&Buffer->In) == RingBufferSPSC_LoadIndex(&Buffer->Out));
+		}
+
+		/** Determines if the specified ring buffer contains any free space. This should be tested by the
+		 *  producer before storing data to the buffer, to ensure that no data is lost due to a buffer overrun.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no free space, \c false otherwise.
+		 */
+		static inline bool RingBufferSPSC_IsFull(RingBufferSPSC_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline bool RingBufferSPSC_IsFull(RingBufferSPSC_t* const Buffer)
+		{
+			return (RingBufferSPSC_GetCount(Buffer) > Buffer->Mask);
+		}
+
+		/** Inserts an element into the ring buffer.
+		 *
+		 *  \warning Only the single producer execution thread may insert into a buffer, and only when the
+		 *           buffer is not full.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Data element to insert into the buffer.
+		 */
+		static inline void RingBufferSPSC_Insert(RingBufferSPSC_t* Buffer,
+		                                         const uint8_t Data) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBufferSPSC_Insert(RingBufferSPSC_t* Buffer,
+		                                         const uint8_t Data)
+		{
+			uint_reg_t In = Buffer->In;
+
+			Buffer->Data[In & Buffer->Mask] = Data;
+			RingBufferSPSC_StoreIndex(&Buffer->In, (uint_reg_t)(In + 1));
+		}
+
+		/** Removes an element from the ring buffer.
+		 *
+		 *  \warning Only the single consumer execution thread may remove from a buffer, and only when the
+		 *           buffer is not empty.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		static inline uint8_t RingBufferSPSC_Remove(RingBufferSPSC_t* Buffer) ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint8_t RingBufferSPSC_Remove(RingBufferSPSC_t* Buffer)
+		{
+			uint_reg_t Out  = Buffer->Out;
+			uint8_t    Data = Buffer->Data[Out & Buffer->Mask];
+
+			RingBufferSPSC_StoreIndex(&Buffer->Out, (uint_reg_t)(Out + 1));
+			return Data;
+		}
+
+		/** Returns the next element stored in the ring buffer, without removing it.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		static inline uint8_t RingBufferSPSC_Peek(RingBufferSPSC_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint8_t RingBufferSPSC_Peek(RingBufferSPSC_t* const Buffer)
+		{
+			return Buffer->Data[Buffer->Out & Buffer->Mask];
+		}
+
+		/** Retrieves the largest block of stored data that can be read in place from the buffer without wrapping
+		 *  around the end of the underlying storage array. Once processed, the data should be released via a
+		 *  call to \ref RingBufferSPSC_AdvanceOut(). This should only be called by the consumer.
+		 *
+		 *  \param[in]  Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out] Span    Location where a pointer to the start of the block is to be stored.
+		 *
+		 *  \return Number of contiguous stored bytes at the returned location.
+		 */
+		static inline uint_reg_t RingBufferSPSC_PeekSpan(RingBufferSPSC_t* const Buffer,
+		                                                 uint8_t** const Span) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint_reg_t RingBufferSPSC_PeekSpan(RingBufferSPSC_t* const Buffer,
+		                                                 uint8_t** const Span)
+		{
+			uint_reg_t Offset      = (Buffer->Out & Buffer->Mask);
+			uint_reg_t Count       = (uint_reg_t)(RingBufferSPSC_LoadIndex(&Buffer->In) - Buffer->Out);
+			uint_reg_t BytesToWrap = ((Buffer->Mask + 1) - Offset);
+
+			*Span = &Buffer->Data[Offset];
+			return MIN(Count, BytesToWrap);
+		}
+
+		/** Retrieves the largest block of free space that can be written in place in the buffer without wrapping
+		 *  around the end of the underlying storage array. Once filled, the data should be committed via a call
+		 *  to \ref RingBufferSPSC_AdvanceIn(). This should only be called by the producer.
+		 *
+		 *  \param[in]  Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[out] Span    Location where a pointer to the start of the block is to be stored.
+		 *
+		 *  \return Number of contiguous free bytes at the returned location.
+		 */
+		static inline uint_reg_t RingBufferSPSC_ReserveSpan(RingBufferSPSC_t* const Buffer,
+		                                                    uint8_t** const Span) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint_reg_t RingBufferSPSC_ReserveSpan(RingBufferSPSC_t* const Buffer,
+		                                                    uint8_t** const Span)
+		{
+			uint_reg_t Offset      = (Buffer->In & Buffer->Mask);
+			uint_reg_t FreeCount   = ((Buffer->Mask + 1) - (uint_reg_t)(Buffer->In - RingBufferSPSC_LoadIndex(&Buffer->Out)));
+			uint_reg_t BytesToWrap = ((Buffer->Mask + 1) - Offset);
+
+			*Span = &Buffer->Data[Offset];
+			return MIN(FreeCount, BytesToWrap);
+		}
+
+		/** Commits a block of data written in place to a span obtained from \ref RingBufferSPSC_ReserveSpan(),
+		 *  making it visible to the consumer. This should only be called by the producer.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to commit to.
+		 *  \param[in]     Count   Number of bytes written to the reserved span.
+		 */
+		static inline void RingBufferSPSC_AdvanceIn(RingBufferSPSC_t* const Buffer,
+		                                            const uint_reg_t Count) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBufferSPSC_AdvanceIn(RingBufferSPSC_t* const Buffer,
+		                                            const uint_reg_t Count)
+		{
+			RingBufferSPSC_StoreIndex(&Buffer->In, (uint_reg_t)(Buffer->In + Count));
+		}
+
+		/** Releases a block of data read in place from a span obtained from \ref RingBufferSPSC_PeekSpan(),
+		 *  freeing it for reuse by the producer. This should only be called by the consumer.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to release from.
+		 *  \param[in]     Count   Number of bytes read from the span.
+		 */
+		static inline void RingBufferSPSC_AdvanceOut(RingBufferSPSC_t* const Buffer,
+		                                             const uint_reg_t Count) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void RingBufferSPSC_AdvanceOut(RingBufferSPSC_t* const Buffer,
+		                                             const uint_reg_t Count)
+		{
+			RingBufferSPSC_StoreIndex(&Buffer->Out, (uint_reg_t)(Buffer->Out + Count));
+		}
+
+		/** Inserts as much of a block of data into the ring buffer as will fit, copying it in at most two
+		 *  contiguous runs. This should only be called by the producer.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Pointer to the data to insert.
+		 *  \param[in]     Length  Number of bytes to insert.
+		 *
+		 *  \return Number of bytes inserted into the buffer.
+		 */
+		static inline uint16_t RingBufferSPSC_InsertBlock(RingBufferSPSC_t* const Buffer,
+		                                                  const void* const Data,
+		                                                  const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBufferSPSC_InsertBlock(RingBufferSPSC_t* const Buffer,
+		                                                  const void* const Data,
+		                                                  const uint16_t Length)
+		{
+			const uint8_t* DataPtr       = (const uint8_t*)Data;
+			uint16_t       BytesInserted = 0;
+
+			for (uint8_t Run = 0; Run < 2; Run++)
+			{
+				uint8_t*   Span;
+				uint_reg_t SpanLength = RingBufferSPSC_ReserveSpan(Buffer, &Span);
+
+				if ((Length - BytesInserted) < SpanLength)
+				  SpanLength = (Length - BytesInserted);
+
+				if (!(SpanLength))
+				  break;
+
+				memcpy(Span, &DataPtr[BytesInserted], SpanLength);
+				RingBufferSPSC_AdvanceIn(Buffer, SpanLength);
+
+				BytesInserted += SpanLength;
+			}
+
+			return BytesInserted;
+		}
+
+		/** Removes as much of a block of data from the ring buffer as is available, copying it out in at most
+		 *  two contiguous runs. This should only be called by the consumer.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out]    Data    Pointer to the destination for the removed data.
+		 *  \param[in]     Length  Maximum number of bytes to remove.
+		 *
+		 *  \return Number of bytes removed from the buffer.
+		 */
+		static inline uint16_t RingBufferSPSC_RemoveBlock(RingBufferSPSC_t* const Buffer,
+		                                                  void* const Data,
+		                                                  const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t RingBufferSPSC_RemoveBlock(RingBufferSPSC_t* const Buffer,
+		                                                  void* const Data,
+		                                                  const uint16_t Length)
+		{
+			uint8_t* DataPtr      = (uint8_t*)Data;
+			uint16_t BytesRemoved = 0;
+
+			for (uint8_t Run = 0; Run < 2; Run++)
+			{
+				uint8_t*   Span;
+				uint_reg_t SpanLength = RingBufferSPSC_PeekSpan(Buffer, &Span);
+
+				if ((Length - BytesRemoved) < SpanLength)
+				  SpanLength = (Length - BytesRemoved);
+
+				if (!(SpanLength))
+				  break;
+
+				memcpy(&DataPtr[BytesRemoved], Span, SpanLength);
+				RingBufferSPSC_AdvanceOut(Buffer, SpanLength);
+
+				BytesRemoved += SpanLength;
+			}
+
+			return BytesRemoved;
+		}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -245,6 +245,29 @@
 				return SPDR;
 			}
 
+			/** Starts sending a byte through the SPI interface, without waiting for the transfer to complete. This
+			 *  allows the next byte to be fetched while the current one is shifted out; each call must be paired
+			 *  with a call to \ref SPI_FinishTransfer() before the interface is used again.
+			 *
+			 *  \param[in] Byte  Byte to send through the SPI interface.
+			 */
+			static inline void SPI_StartTransfer(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void SPI_StartTransfer(const uint8_t Byte)
+			{
+				SPDR = Byte;
+			}
+
+			/** Waits until a transfer started with \ref SPI_StartTransfer() is complete.
+			 *
+			 *  \return The response byte from the attached SPI device.
+			 */
+			static inline uint8_t SPI_FinishTransfer(void) ATTR_ALWAYS_INLINE;
+			static inline uint8_t SPI_FinishTransfer(void)
+			{
+				while (!(SPSR & (1 << SPIF)));
+				return SPDR;
+			}
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
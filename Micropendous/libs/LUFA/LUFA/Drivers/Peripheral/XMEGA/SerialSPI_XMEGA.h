@@ -191,6 +191,32 @@
 			{
 				return SerialSPI_TransferByte(USART, 0);
 			}
+
+			/** Starts sending a byte through the USART SPI interface, without waiting for the transfer to complete. This
+			 *  allows the next byte to be fetched while the current one is shifted out; each call must be paired with a
+			 *  call to \ref SerialSPI_FinishTransfer() before the interface is used again.
+			 *
+			 *  \param[in,out] USART     Pointer to the base of the USART peripheral within the device.
+			 *  \param[in]     DataByte  Byte to send through the USART SPI interface.
+			 */
+			static inline void SerialSPI_StartTransfer(USART_t* const USART,
+			                                           const uint8_t DataByte)
+			{
+				USART->DATA = DataByte;
+			}
+
+			/** Waits until a transfer started with \ref SerialSPI_StartTransfer() is complete.
+			 *
+			 *  \param[in,out] USART  Pointer to the base of the USART peripheral within the device.
+			 *
+			 *  \return The response byte from the attached SPI device.
+			 */
+			static inline uint8_t SerialSPI_FinishTransfer(USART_t* const USART)
+			{
+				while (!(USART->STATUS & USART_TXCIF_bm));
+				USART->STATUS = USART_TXCIF_bm;
+				return USART->DATA;
+			}
 			
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -137,6 +137,12 @@ void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return;
 
+	if (CDCInterfaceInfo->Config.CoalesceFrames)
+	{
+		CDC_Device_CoalesceIN(CDCInterfaceInfo);
+		return;
+	}
+
 	#if !defined(NO_CLASS_DRIVER_AUTOFLUSH)
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 
@@ -145,12 +151,51 @@ void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 	#endif
 }
 
+static void CDC_Device_MarkCoalescePending(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if (!(CDCInterfaceInfo->Config.CoalesceFrames) || CDCInterfaceInfo->State.CoalescePending)
+	  return;
+
+	CDCInterfaceInfo->State.CoalescePending    = true;
+	CDCInterfaceInfo->State.CoalesceStartFrame = USB_Device_GetFrameNumber();
+}
+
+static void CDC_Device_CoalesceIN(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if (!(CDCInterfaceInfo->State.CoalescePending))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	{
+		/* Full banks are sent straight away, holding back only the short packet or ZLP that ends the transfer */
+		Endpoint_ClearIN();
+		CDCInterfaceInfo->State.CoalesceStartFrame = USB_Device_GetFrameNumber();
+		return;
+	}
+
+	uint16_t FramesElapsed = ((USB_Device_GetFrameNumber() - CDCInterfaceInfo->State.CoalesceStartFrame) & CDC_FRAME_NUMBER_MASK);
+
+	if (FramesElapsed < CDCInterfaceInfo->Config.CoalesceFrames)
+	  return;
+
+	/* An empty bank here means the last packet was a full one sent by the stream functions, so this sends the ZLP */
+	Endpoint_ClearIN();
+	CDCInterfaceInfo->State.CoalescePending = false;
+}
+
 uint8_t CDC_Device_SendString(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
                               const char* const String)
 {
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	CDC_Device_MarkCoalescePending(CDCInterfaceInfo);
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 	return Endpoint_Write_Stream_LE(String, strlen(String), NULL);
 }
@@ -162,6 +207,8 @@ uint8_t CDC_Device_SendData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	CDC_Device_MarkCoalescePending(CDCInterfaceInfo);
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 	return Endpoint_Write_Stream_LE(Buffer, Length, NULL);
 }
@@ -172,6 +219,8 @@ uint8_t CDC_Device_SendByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	CDC_Device_MarkCoalescePending(CDCInterfaceInfo);
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 
 	if (!(Endpoint_IsReadWriteAllowed()))
@@ -195,10 +244,24 @@ uint8_t CDC_Device_Flush(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 
 	uint8_t ErrorCode;
 
+	bool CoalescePending = CDCInterfaceInfo->State.CoalescePending;
+	CDCInterfaceInfo->State.CoalescePending = false;
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 
 	if (!(Endpoint_BytesInEndpoint()))
-	  return ENDPOINT_READYWAIT_NoError;
+	{
+		/* A coalesced transfer that ended on a full packet still needs its terminating ZLP */
+		if (CoalescePending)
+		{
+			if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
+			  return ErrorCode;
+
+			Endpoint_ClearIN();
+		}
+
+		return ENDPOINT_READYWAIT_NoError;
+	}
 
 	bool BankFull = !(Endpoint_IsReadWriteAllowed());
 
@@ -261,6 +324,116 @@ int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInf
 	return ReceivedByte;
 }
 
+uint16_t CDC_Device_AcquireOUTBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return 0;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if (!(Endpoint_IsOUTReceived()))
+	  return 0;
+
+	uint16_t BytesInBank = Endpoint_BytesInEndpoint();
+
+	if (!(BytesInBank))
+	  Endpoint_ClearOUT();
+
+	return BytesInBank;
+}
+
+void CDC_Device_ReleaseOUTBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if (Endpoint_IsOUTReceived())
+	  Endpoint_ClearOUT();
+}
+
+uint16_t CDC_Device_AcquireINBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return 0;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (!(Endpoint_IsINReady()))
+	  return 0;
+
+	return (CDCInterfaceInfo->Config.DataINEndpoint.Size - Endpoint_BytesInEndpoint());
+}
+
+void CDC_Device_CommitINBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (Endpoint_IsINReady())
+	  Endpoint_ClearIN();
+}
+
+uint16_t CDC_Device_ReceiveToRingBuffer(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                        RingBufferSPSC_t* const Buffer)
+{
+	uint16_t BytesInBank = CDC_Device_AcquireOUTBank(CDCInterfaceInfo);
+	uint16_t BytesMoved  = 0;
+
+	while (BytesInBank)
+	{
+		uint8_t* Block;
+		uint16_t BytesInBlock = RingBufferSPSC_ReserveSpan(Buffer, &Block);
+
+		if (BytesInBlock > BytesInBank)
+		  BytesInBlock = BytesInBank;
+
+		if (!(BytesInBlock))
+		  return BytesMoved;
+
+		Endpoint_Read_Stream_LE(Block, BytesInBlock, NULL);
+		RingBufferSPSC_AdvanceIn(Buffer, BytesInBlock);
+
+		BytesInBank -= BytesInBlock;
+		BytesMoved  += BytesInBlock;
+	}
+
+	if (BytesMoved)
+	  CDC_Device_ReleaseOUTBank(CDCInterfaceInfo);
+
+	return BytesMoved;
+}
+
+uint16_t CDC_Device_SendFromRingBuffer(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                       RingBufferSPSC_t* const Buffer)
+{
+	uint16_t BytesFree  = CDC_Device_AcquireINBank(CDCInterfaceInfo);
+	uint16_t BytesMoved = 0;
+
+	while (BytesFree)
+	{
+		uint8_t* Block;
+		uint16_t BytesInBlock = RingBufferSPSC_PeekSpan(Buffer, &Block);
+
+		if (BytesInBlock > BytesFree)
+		  BytesInBlock = BytesFree;
+
+		if (!(BytesInBlock))
+		  break;
+
+		CDC_Device_SendData(CDCInterfaceInfo, Block, BytesInBlock);
+		RingBufferSPSC_AdvanceOut(Buffer, BytesInBlock);
+
+		BytesFree  -= BytesInBlock;
+		BytesMoved += BytesInBlock;
+	}
+
+	return BytesMoved;
+}
+
 void CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 {
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
@@ -74,6 +74,7 @@
 	/* Includes: */
 		#include "../../USB.h"
 		#include "../Common/CDCClassCommon.h"
+		#include "../../../Misc/RingBufferSPSC.h"
 
 		#include <stdio.h>
 
@@ -104,6 +105,13 @@
 					USB_Endpoint_Table_t DataINEndpoint; /**< Data IN endpoint configuration table. */
 					USB_Endpoint_Table_t DataOUTEndpoint; /**< Data OUT endpoint configuration table. */
 					USB_Endpoint_Table_t NotificationEndpoint; /**< Notification IN Endpoint configuration table. */
+
+					uint8_t CoalesceFrames; /**< Maximum number of USB frames that data written to the interface may be held back
+					                         *   for, so that many small writes are coalesced into full packets. Full packets are
+					                         *   sent as soon as the bank fills, and a zero length packet terminates the transfer
+					                         *   if the last packet was full. Set to zero (the default) to instead flush any data
+					                         *   each time \ref CDC_Device_USBTask() runs and the IN bank is ready.
+					                         */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -124,6 +132,13 @@
 					                                  *  This is generally only used if the virtual serial port data is to be
 					                                  *  reconstructed on a physical UART.
 					                                  */
+
+					bool     CoalescePending; /**< Indicates that data written to the interface has not yet been terminated by a
+					                           *   short packet, when \c Config.CoalesceFrames is non-zero.
+					                           */
+					uint16_t CoalesceStartFrame; /**< USB frame number at which the pending coalesced data was first written,
+					                              *   or the last full packet was sent.
+					                              */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -260,7 +275,104 @@
 			 */
 			int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** Lends the CDC interface's current OUT endpoint bank to the user application, so that a whole packet from the host
+			 *  can be processed in place rather than a byte at a time through \ref CDC_Device_ReceiveByte(). On return the data
+			 *  OUT endpoint is left selected, and the returned number of bytes may be read directly with the endpoint primitives
+			 *  (\ref Endpoint_Read_8(), \ref Endpoint_Read_Stream_LE(), etc.) until the bank is handed back to the controller via
+			 *  \ref CDC_Device_ReleaseOUTBank(). No other endpoint should be selected between the two calls.
+			 *
+			 *  \note Zero length packets from the host are consumed automatically, and reported as an empty bank.
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *
+			 *  \return Number of unread bytes in the acquired OUT bank, or zero if no packet is waiting.
+			 */
+			uint16_t CDC_Device_AcquireOUTBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Returns an OUT endpoint bank previously lent to the user application by \ref CDC_Device_AcquireOUTBank() back to the
+			 *  USB controller, so that the next packet from the host may be received into it. Any bytes not yet read from the bank
+			 *  are discarded.
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 */
+			void CDC_Device_ReleaseOUTBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Lends the CDC interface's current IN endpoint bank to the user application, so that a whole packet to the host
+			 *  can be built in place rather than through \ref CDC_Device_SendByte() or a blocking stream. This function does not
+			 *  wait for the bank to become free; if the host has not yet collected the previous packet, zero is returned. On
+			 *  success the data IN endpoint is left selected, and up to the returned number of bytes may be written directly with
+			 *  the endpoint primitives (\ref Endpoint_Write_8(), \ref Endpoint_Write_Stream_LE(), etc.) before the bank is sent
+			 *  with \ref CDC_Device_CommitINBank().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *
+			 *  \return Number of free bytes in the acquired IN bank, or zero if no bank is currently available.
+			 */
+			uint16_t CDC_Device_AcquireINBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Sends an IN endpoint bank previously lent to the user application by \ref CDC_Device_AcquireINBank() to the host.
+			 *
+			 *  \note Committing an empty bank sends a zero length packet, which may be used to terminate a transfer that ended
+			 *        on a full bank.
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 */
+			void CDC_Device_CommitINBank(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Moves as much of the data waiting in the CDC interface's OUT endpoint bank as will fit into the given ring
+			 *  buffer, as a block transfer rather than a byte at a time. The bank is released back to the USB controller once
+			 *  it has been completely emptied; any bytes which did not fit remain in the bank for the next call. This function
+			 *  never blocks, and is intended for bridging the virtual serial port to a physical interface whose transmit ISR
+			 *  drains the ring buffer.
+			 *
+			 *  \warning The calling thread is the ring buffer's single producer; see \ref RingBufferSPSC_Insert().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *  \param[in,out] Buffer            Pointer to a ring buffer structure to insert the received data into.
+			 *
+			 *  \return Number of bytes moved from the OUT endpoint bank into the ring buffer.
+			 */
+			uint16_t CDC_Device_ReceiveToRingBuffer(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+			                                        RingBufferSPSC_t* const Buffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Moves as much of the data stored in the given ring buffer as will fit into the CDC interface's IN endpoint bank,
+			 *  as a block transfer rather than a byte at a time. This function never blocks; if the IN bank is still waiting
+			 *  to be collected by the host, no data is moved. The filled bank is sent by \ref CDC_Device_USBTask(), so that
+			 *  the interface should be configured with a non-zero \c Config.CoalesceFrames flush deadline to ensure full packets
+			 *  are sent and short ones are delayed by no more than the given number of USB frames.
+			 *
+			 *  \warning The calling thread is the ring buffer's single consumer; see \ref RingBufferSPSC_Remove().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
+			 *       the call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 *  \param[in,out] Buffer            Pointer to a ring buffer structure to remove the data to send from.
+			 *
+			 *  \return Number of bytes moved from the ring buffer into the IN endpoint bank.
+			 */
+			uint16_t CDC_Device_SendFromRingBuffer(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+			                                       RingBufferSPSC_t* const Buffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** Flushes any data waiting to be sent, ensuring that the send buffer is cleared.
+			 *
+			 *  \note When coalescing is enabled via \c Config.CoalesceFrames, this immediately ends the pending transfer without
+			 *        waiting for the frame deadline, sending a zero length packet if required.
 			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
@@ -319,8 +431,14 @@
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define CDC_FRAME_NUMBER_MASK  0x07FF
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_CDC_DEVICE_C)
+				static void CDC_Device_MarkCoalescePending(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void CDC_Device_CoalesceIN(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 				#if defined(FDEV_SETUP_STREAM)
 				static int CDC_Device_putchar(char c,
 				                              FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
@@ -328,7 +446,7 @@
 				static int CDC_Device_getchar_Blocking(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
 				#endif
 
-				void CDC_Device_Event_Stub(void) ATTR_CONST;
+				void CDC_Device_Event_Stub(void);
 
 				void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 				                                          ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
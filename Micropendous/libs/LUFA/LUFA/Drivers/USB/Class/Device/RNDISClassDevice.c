@@ -155,6 +155,26 @@ void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo
 
 		RNDISInterfaceInfo->State.ResponseReady = false;
 	}
+
+	if (RNDISInterfaceInfo->State.CurrRNDISState != RNDIS_Data_Initialized)
+	  return;
+
+	if (RNDISInterfaceInfo->State.TxPackets)
+	{
+		Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpoint.Address);
+
+		/* End the IN transfer holding packet messages from this pass, sending a ZLP if the last packet was full */
+		if (Endpoint_IsINReady())
+		{
+			Endpoint_ClearIN();
+
+			RNDISInterfaceInfo->State.TxPackets = 0;
+			RNDISInterfaceInfo->State.TxLength  = 0;
+		}
+	}
+
+	if (RNDISInterfaceInfo->Config.FrameQueueBuffer)
+	  RNDIS_Device_FillFrameQueue(RNDISInterfaceInfo);
 }
 
 void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
@@ -174,6 +194,10 @@ void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const
 			RNDIS_Initialize_Complete_t* INITIALIZE_Response =
 			               (RNDIS_Initialize_Complete_t*)&RNDISInterfaceInfo->State.RNDISMessageBuffer;
 
+			/* The host's transfer size limit shares its location in the buffer with the response, so must be saved first */
+			uint32_t HostMaxTransferSize = le32_to_cpu(INITIALIZE_Message->MaxTransferSize);
+			uint8_t  MaxPacketsPerTransfer = MAX(RNDISInterfaceInfo->Config.MaxPacketsPerTransfer, 1);
+
 			INITIALIZE_Response->MessageType            = CPU_TO_LE32(REMOTE_NDIS_INITIALIZE_CMPLT);
 			INITIALIZE_Response->MessageLength          = CPU_TO_LE32(sizeof(RNDIS_Initialize_Complete_t));
 			INITIALIZE_Response->RequestId              = INITIALIZE_Message->RequestId;
@@ -183,12 +207,14 @@ void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const
 			INITIALIZE_Response->MinorVersion           = CPU_TO_LE32(REMOTE_NDIS_VERSION_MINOR);
 			INITIALIZE_Response->DeviceFlags            = CPU_TO_LE32(REMOTE_NDIS_DF_CONNECTIONLESS);
 			INITIALIZE_Response->Medium                 = CPU_TO_LE32(REMOTE_NDIS_MEDIUM_802_3);
-			INITIALIZE_Response->MaxPacketsPerTransfer  = CPU_TO_LE32(1);
-			INITIALIZE_Response->MaxTransferSize        = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX);
+			INITIALIZE_Response->MaxPacketsPerTransfer  = cpu_to_le32(MaxPacketsPerTransfer);
+			INITIALIZE_Response->MaxTransferSize        = cpu_to_le32(MaxPacketsPerTransfer *
+			                                                          (sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX));
 			INITIALIZE_Response->PacketAlignmentFactor  = CPU_TO_LE32(0);
 			INITIALIZE_Response->AFListOffset           = CPU_TO_LE32(0);
 			INITIALIZE_Response->AFListSize             = CPU_TO_LE32(0);
 
+			RNDISInterfaceInfo->State.HostMaxTransferSize = HostMaxTransferSize;
 			RNDISInterfaceInfo->State.CurrRNDISState    = RNDIS_Initialized;
 			break;
 		case REMOTE_NDIS_HALT_MSG:
@@ -426,45 +452,231 @@ bool RNDIS_Device_IsPacketReceived(USB_ClassInfo_RNDIS_Device_t* const RNDISInte
 		return false;
 	}
 
+	if (RNDISInterfaceInfo->State.QueueCount || RNDISInterfaceInfo->State.RxFramePending)
+	  return true;
+
 	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
 	return Endpoint_IsOUTReceived();
 }
 
-uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
-                                void* Buffer,
-                                uint16_t* const PacketLength)
+static void RNDIS_Device_DiscardPadding(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
 {
-	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
-	    (RNDISInterfaceInfo->State.CurrRNDISState != RNDIS_Data_Initialized))
+	uint16_t BankSize = RNDISInterfaceInfo->Config.DataOUTEndpoint.Size;
+
+	/* Release banks that cannot hold another packet message - empty banks, zero length packets ending a transfer that
+	   was a multiple of the endpoint size, and short banks ending a transfer with too few bytes left to make up a packet
+	   message header, which are padding added by the host in place of a zero length packet */
+	while (Endpoint_IsOUTReceived())
 	{
-		return ENDPOINT_RWSTREAM_DeviceDisconnected;
+		uint16_t BankRemaining = Endpoint_BytesInEndpoint();
+
+		if (BankRemaining && (((RNDISInterfaceInfo->State.RxBankOffset + BankRemaining) >= BankSize) ||
+		                      (BankRemaining >= sizeof(RNDIS_Packet_Message_t))))
+		{
+			break;
+		}
+
+		Endpoint_ClearOUT();
+		RNDISInterfaceInfo->State.RxBankOffset = 0;
 	}
+}
 
+static uint8_t RNDIS_Device_ReadPacketHeader(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
 	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
 
-	*PacketLength = 0;
+	RNDIS_Device_DiscardPadding(RNDISInterfaceInfo);
 
 	if (!(Endpoint_IsOUTReceived()))
-		return ENDPOINT_RWSTREAM_NoError;
+	  return ENDPOINT_RWSTREAM_NoError;
 
 	RNDIS_Packet_Message_t RNDISPacketHeader;
 	Endpoint_Read_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
 
-	if (le32_to_cpu(RNDISPacketHeader.DataLength) > ETHERNET_FRAME_SIZE_MAX)
+	uint32_t MessageLength = le32_to_cpu(RNDISPacketHeader.MessageLength);
+	uint32_t DataStart     = (sizeof(RNDIS_Message_Header_t) + le32_to_cpu(RNDISPacketHeader.DataOffset));
+	uint32_t DataLength    = le32_to_cpu(RNDISPacketHeader.DataLength);
+
+	if ((le32_to_cpu(RNDISPacketHeader.MessageType) != REMOTE_NDIS_PACKET_MSG) ||
+	    (DataLength > ETHERNET_FRAME_SIZE_MAX) || (DataStart < sizeof(RNDIS_Packet_Message_t)) ||
+	    (MessageLength < (DataStart + DataLength)) || ((MessageLength - DataLength) > 0xFFFF))
 	{
 		Endpoint_StallTransaction();
 
 		return RNDIS_ERROR_LOGICAL_CMD_FAILED;
 	}
 
-	*PacketLength = (uint16_t)le32_to_cpu(RNDISPacketHeader.DataLength);
+	if (DataStart > sizeof(RNDIS_Packet_Message_t))
+	  Endpoint_Discard_Stream(DataStart - sizeof(RNDIS_Packet_Message_t), NULL);
+
+	RNDISInterfaceInfo->State.RxBankOffset    += DataStart;
+	RNDISInterfaceInfo->State.RxPendingLength  = DataLength;
+	RNDISInterfaceInfo->State.RxPendingTrailer = (MessageLength - DataStart - DataLength);
+	RNDISInterfaceInfo->State.RxFramePending   = true;
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+static void RNDIS_Device_FinishPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint16_t BankSize = RNDISInterfaceInfo->Config.DataOUTEndpoint.Size;
+
+	if (RNDISInterfaceInfo->State.RxPendingTrailer)
+	  Endpoint_Discard_Stream(RNDISInterfaceInfo->State.RxPendingTrailer, NULL);
+
+	RNDISInterfaceInfo->State.RxBankOffset   = ((RNDISInterfaceInfo->State.RxBankOffset + RNDISInterfaceInfo->State.RxPendingLength +
+	                                             RNDISInterfaceInfo->State.RxPendingTrailer) & (BankSize - 1));
+	RNDISInterfaceInfo->State.RxFramePending = false;
+
+	RNDIS_Device_DiscardPadding(RNDISInterfaceInfo);
+}
+
+static void RNDIS_Device_FillFrameQueue(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t* QueueBuffer = (uint8_t*)RNDISInterfaceInfo->Config.FrameQueueBuffer;
+	uint16_t QueueSize   = RNDISInterfaceInfo->Config.FrameQueueSize;
+
+	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	for (;;)
+	{
+		if (!(RNDISInterfaceInfo->State.RxFramePending))
+		{
+			if (RNDIS_Device_ReadPacketHeader(RNDISInterfaceInfo) != ENDPOINT_RWSTREAM_NoError)
+			  return;
+
+			if (!(RNDISInterfaceInfo->State.RxFramePending))
+			  return;
+		}
+
+		uint16_t FrameLength = RNDISInterfaceInfo->State.RxPendingLength;
+
+		/* Frames that do not fit are left in the endpoint, to be read straight into the application's buffer */
+		if ((QueueSize - RNDISInterfaceInfo->State.QueueCount) < (sizeof(uint16_t) + FrameLength))
+		  return;
+
+		uint16_t Tail = (RNDISInterfaceInfo->State.QueueHead + RNDISInterfaceInfo->State.QueueCount);
+
+		if (Tail >= QueueSize)
+		  Tail -= QueueSize;
+
+		QueueBuffer[Tail] = (FrameLength & 0xFF);
+
+		if (++Tail == QueueSize)
+		  Tail = 0;
+
+		QueueBuffer[Tail] = (FrameLength >> 8);
+
+		if (++Tail == QueueSize)
+		  Tail = 0;
+
+		/* Frame data wraps around to the start of the queue buffer if it does not fit before the end */
+		uint16_t ChunkLength = MIN(FrameLength, (uint16_t)(QueueSize - Tail));
+
+		if (ChunkLength)
+		  Endpoint_Read_Stream_LE(&QueueBuffer[Tail], ChunkLength, NULL);
+
+		if (FrameLength - ChunkLength)
+		  Endpoint_Read_Stream_LE(QueueBuffer, (FrameLength - ChunkLength), NULL);
+
+		RNDISInterfaceInfo->State.QueueCount += (sizeof(uint16_t) + FrameLength);
+
+		RNDIS_Device_FinishPacket(RNDISInterfaceInfo);
+	}
+}
+
+static void RNDIS_Device_CopyFromQueue(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                       void* Buffer,
+                                       const uint16_t Length)
+{
+	uint8_t* QueueBuffer = (uint8_t*)RNDISInterfaceInfo->Config.FrameQueueBuffer;
+	uint16_t QueueSize   = RNDISInterfaceInfo->Config.FrameQueueSize;
+	uint16_t Head        = RNDISInterfaceInfo->State.QueueHead;
+	uint16_t ChunkLength = MIN(Length, (uint16_t)(QueueSize - Head));
+
+	memcpy(Buffer, &QueueBuffer[Head], ChunkLength);
+	memcpy((uint8_t*)Buffer + ChunkLength, QueueBuffer, (Length - ChunkLength));
+
+	Head += Length;
+
+	if (Head >= QueueSize)
+	  Head -= QueueSize;
+
+	RNDISInterfaceInfo->State.QueueHead   = Head;
+	RNDISInterfaceInfo->State.QueueCount -= Length;
+}
+
+uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                uint16_t* const PacketLength)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+	    (RNDISInterfaceInfo->State.CurrRNDISState != RNDIS_Data_Initialized))
+	{
+		return ENDPOINT_RWSTREAM_DeviceDisconnected;
+	}
+
+	*PacketLength = 0;
+
+	/* Frames already taken from the endpoint into the frame queue were received first */
+	if (RNDISInterfaceInfo->State.QueueCount)
+	{
+		uint8_t FrameLength[2];
+
+		RNDIS_Device_CopyFromQueue(RNDISInterfaceInfo, FrameLength, sizeof(FrameLength));
+		*PacketLength = ((FrameLength[1] << 8) | FrameLength[0]);
+
+		RNDIS_Device_CopyFromQueue(RNDISInterfaceInfo, Buffer, *PacketLength);
+		return ENDPOINT_RWSTREAM_NoError;
+	}
+
+	if (!(RNDISInterfaceInfo->State.RxFramePending))
+	{
+		uint8_t ErrorCode;
+
+		if ((ErrorCode = RNDIS_Device_ReadPacketHeader(RNDISInterfaceInfo)) != ENDPOINT_RWSTREAM_NoError)
+		  return ErrorCode;
+
+		if (!(RNDISInterfaceInfo->State.RxFramePending))
+		  return ENDPOINT_RWSTREAM_NoError;
+	}
+
+	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	*PacketLength = RNDISInterfaceInfo->State.RxPendingLength;
 
 	Endpoint_Read_Stream_LE(Buffer, *PacketLength, NULL);
-	Endpoint_ClearOUT();
+	RNDIS_Device_FinishPacket(RNDISInterfaceInfo);
 
 	return ENDPOINT_RWSTREAM_NoError;
 }
 
+uint8_t RNDIS_Device_Flush(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t ErrorCode;
+
+	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+	    (RNDISInterfaceInfo->State.CurrRNDISState != RNDIS_Data_Initialized))
+	{
+		return ENDPOINT_RWSTREAM_DeviceDisconnected;
+	}
+
+	if (!(RNDISInterfaceInfo->State.TxPackets))
+	  return ENDPOINT_READYWAIT_NoError;
+
+	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
+	  return ErrorCode;
+
+	Endpoint_ClearIN();
+
+	RNDISInterfaceInfo->State.TxPackets = 0;
+	RNDISInterfaceInfo->State.TxLength  = 0;
+
+	return ENDPOINT_READYWAIT_NoError;
+}
+
 uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
                                 void* Buffer,
                                 const uint16_t PacketLength)
@@ -477,6 +689,17 @@ uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 		return ENDPOINT_RWSTREAM_DeviceDisconnected;
 	}
 
+	uint16_t MessageLength = (sizeof(RNDIS_Packet_Message_t) + PacketLength);
+
+	/* Packet messages are appended to the current IN transfer while it stays within both the device and host limits */
+	if (RNDISInterfaceInfo->State.TxPackets &&
+	    ((RNDISInterfaceInfo->State.TxPackets >= RNDISInterfaceInfo->Config.MaxPacketsPerTransfer) ||
+	     ((RNDISInterfaceInfo->State.TxLength + MessageLength) > RNDISInterfaceInfo->State.HostMaxTransferSize)))
+	{
+		if ((ErrorCode = RNDIS_Device_Flush(RNDISInterfaceInfo)) != ENDPOINT_READYWAIT_NoError)
+		  return ErrorCode;
+	}
+
 	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpoint.Address);
 
 	if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
@@ -487,13 +710,22 @@ uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 	memset(&RNDISPacketHeader, 0, sizeof(RNDIS_Packet_Message_t));
 
 	RNDISPacketHeader.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
-	RNDISPacketHeader.MessageLength = cpu_to_le32(sizeof(RNDIS_Packet_Message_t) + PacketLength);
+	RNDISPacketHeader.MessageLength = cpu_to_le32(MessageLength);
 	RNDISPacketHeader.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
 	RNDISPacketHeader.DataLength    = cpu_to_le32(PacketLength);
 
 	Endpoint_Write_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
 	Endpoint_Write_Stream_LE(Buffer, PacketLength, NULL);
-	Endpoint_ClearIN();
+
+	if (RNDISInterfaceInfo->Config.MaxPacketsPerTransfer > 1)
+	{
+		RNDISInterfaceInfo->State.TxPackets++;
+		RNDISInterfaceInfo->State.TxLength += MessageLength;
+	}
+	else
+	{
+		Endpoint_ClearIN();
+	}
 
 	return ENDPOINT_RWSTREAM_NoError;
 }
@@ -87,6 +87,21 @@
 
 					char*         AdapterVendorDescription; /**< String description of the adapter vendor. */
 					MAC_Address_t AdapterMACAddress; /**< MAC address of the adapter. */
+
+					uint8_t       MaxPacketsPerTransfer; /**< Maximum number of RNDIS packet messages carried in a single bulk
+					                                      *   transfer in each direction. This is advertised to the host, which
+					                                      *   may then send several packets back to back, and packets sent with
+					                                      *   \ref RNDIS_Device_SendPacket() are appended to the current IN transfer
+					                                      *   until it is ended by \ref RNDIS_Device_USBTask() or fills. Set to zero
+					                                      *   (the default) or one for a single packet per transfer.
+					                                      */
+					void*         FrameQueueBuffer; /**< Optional buffer used to queue received Ethernet frames, so that
+					                                 *   \ref RNDIS_Device_USBTask() can keep draining the OUT endpoint while
+					                                 *   the application is busy. Frames are stored with a two byte length
+					                                 *   prefix, and frames which do not fit are left in the endpoint. Set to
+					                                 *   \c NULL (the default) to read frames straight from the endpoint.
+					                                 */
+					uint16_t      FrameQueueSize; /**< Size in bytes of the \c FrameQueueBuffer buffer. */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -98,6 +113,20 @@
 					bool     ResponseReady; /**< Internal flag indicating if a RNDIS message is waiting to be returned to the host. */
 					uint8_t  CurrRNDISState; /**< Current RNDIS state of the adapter, a value from the \ref RNDIS_States_t enum. */
 					uint32_t CurrPacketFilter; /**< Current packet filter mode, used internally by the class driver. */
+					uint32_t HostMaxTransferSize; /**< Largest bulk transfer the host accepts, from its initialize message. */
+
+					uint16_t RxBankOffset; /**< Number of bytes already read from the current OUT endpoint bank. */
+					uint16_t RxPendingLength; /**< Length of a received frame whose packet message header has been read,
+					                           *   but whose data is still waiting in the OUT endpoint.
+					                           */
+					uint16_t RxPendingTrailer; /**< Number of bytes following the pending frame in its packet message. */
+					bool     RxFramePending; /**< Indicates that \c RxPendingLength holds a frame waiting in the OUT endpoint. */
+
+					uint16_t QueueHead; /**< Index of the next byte to read from \c Config.FrameQueueBuffer. */
+					uint16_t QueueCount; /**< Number of bytes stored in \c Config.FrameQueueBuffer. */
+
+					uint8_t  TxPackets; /**< Number of packet messages written to the unfinished IN transfer. */
+					uint32_t TxLength; /**< Number of bytes written to the unfinished IN transfer. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -128,6 +157,19 @@
 			 */
 			void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** Ends the current IN transfer, sending any packet messages held back by \c Config.MaxPacketsPerTransfer to the
+			 *  host straight away. This is done automatically by \ref RNDIS_Device_USBTask(), so it only needs to be called when
+			 *  the application will not return to its main loop for some time.
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *
+			 *  \return A value from the \ref Endpoint_WaitUntilReady_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Device_Flush(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** Determines if a packet is currently waiting for the device to read in and process.
 			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or the
@@ -188,6 +230,13 @@
 			                                        const void* SetData,
                                                     const uint16_t SetSize) ATTR_NON_NULL_PTR_ARG(1)
 			                                        ATTR_NON_NULL_PTR_ARG(3);
+			static void RNDIS_Device_DiscardPadding(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+			static uint8_t RNDIS_Device_ReadPacketHeader(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+			static void RNDIS_Device_FinishPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+			static void RNDIS_Device_FillFrameQueue(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+			static void RNDIS_Device_CopyFromQueue(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+			                                       void* Buffer,
+			                                       const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
 		#endif
 
 	#endif
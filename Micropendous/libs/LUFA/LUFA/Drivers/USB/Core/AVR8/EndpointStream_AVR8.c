@@ -126,6 +126,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_BE
@@ -134,6 +135,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_LE
@@ -142,6 +144,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#define  TEMPLATE_BANK_BYTES()                     Endpoint_BytesInEndpoint()
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_BE
@@ -150,6 +153,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#define  TEMPLATE_BANK_BYTES()                     Endpoint_BytesInEndpoint()
 #include "Template/Template_Endpoint_RW.c"
 
 #if defined(ARCH_HAS_FLASH_ADDRESS_SPACE)
@@ -159,6 +163,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
+	#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 	#include "Template/Template_Endpoint_RW.c"
 
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_BE
@@ -167,6 +172,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
+	#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 	#include "Template/Template_Endpoint_RW.c"
 #endif
 
@@ -177,6 +183,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
+	#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 	#include "Template/Template_Endpoint_RW.c"
 
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_BE
@@ -185,6 +192,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
+	#define  TEMPLATE_BANK_BYTES()                     (Endpoint_GetBankSize() - Endpoint_BytesInEndpoint())
 	#include "Template/Template_Endpoint_RW.c"
 
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_LE
@@ -193,6 +201,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
+	#define  TEMPLATE_BANK_BYTES()                     Endpoint_BytesInEndpoint()
 	#include "Template/Template_Endpoint_RW.c"
 
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_BE
@@ -201,6 +210,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
+	#define  TEMPLATE_BANK_BYTES()                     Endpoint_BytesInEndpoint()
 	#include "Template/Template_Endpoint_RW.c"
 #endif
 
@@ -68,10 +68,41 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 		}
 		else
 		{
+			#if !defined(NO_STREAM_BLOCK_TRANSFERS)
+			uint16_t BytesInBank = TEMPLATE_BANK_BYTES();
+
+			if (BytesInBank > Length)
+			  BytesInBank = Length;
+
+			Length          -= BytesInBank;
+			BytesInTransfer += BytesInBank;
+
+			/* Transfer the whole run that fits in the current bank without re-checking the bank state per byte */
+			while (BytesInBank >= 8)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream); TEMPLATE_BUFFER_MOVE(DataStream, 1);
+
+				BytesInBank -= 8;
+			}
+
+			while (BytesInBank--)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+			}
+			#else
 			TEMPLATE_TRANSFER_BYTE(DataStream);
 			TEMPLATE_BUFFER_MOVE(DataStream, 1);
 			Length--;
 			BytesInTransfer++;
+			#endif
 		}
 	}
 
@@ -84,6 +115,7 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 #undef TEMPLATE_CLEAR_ENDPOINT
 #undef TEMPLATE_BUFFER_OFFSET
 #undef TEMPLATE_BUFFER_MOVE
+#undef TEMPLATE_BANK_BYTES
 
 #endif
 
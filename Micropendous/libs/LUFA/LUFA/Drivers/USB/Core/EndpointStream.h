@@ -111,6 +111,8 @@
 			#include "UC3/EndpointStream_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/EndpointStream_XMEGA.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/EndpointStream_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
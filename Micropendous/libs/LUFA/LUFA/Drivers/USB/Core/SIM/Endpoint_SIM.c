@@ -0,0 +1,210 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+
+#include "../Endpoint.h"
+
+#if !defined(FIXED_CONTROL_ENDPOINT_SIZE)
+uint8_t USB_Device_ControlEndpointSize = ENDPOINT_CONTROLEP_DEFAULT_SIZE;
+#endif
+
+Endpoint_FIFOPair_t USB_Endpoint_FIFOs[ENDPOINT_TOTAL_ENDPOINTS];
+
+uint8_t             USB_Endpoint_SelectedEndpoint;
+Endpoint_FIFO_t*    USB_Endpoint_SelectedFIFO = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT;
+
+bool Endpoint_ConfigureEndpointTable(const USB_Endpoint_Table_t* const Table,
+                                     const uint8_t Entries)
+{
+	for (uint8_t i = 0; i < Entries; i++)
+	{
+		if (!(Table[i].Address))
+		  continue;
+
+		if (!(Endpoint_ConfigureEndpoint(Table[i].Address, Table[i].Type, Table[i].Size, Table[i].Banks)))
+		  return false;
+	}
+
+	return true;
+}
+
+bool Endpoint_ConfigureEndpoint_Prv(const uint8_t Address,
+                                    const uint8_t Type,
+                                    const uint16_t Size,
+                                    const uint8_t Banks)
+{
+	Endpoint_SelectEndpoint(Address);
+
+	if ((Size > ENDPOINT_MAX_BANK_SIZE) || !(Banks) || (Banks > ENDPOINT_MAX_BANKS))
+	{
+		USB_Endpoint_SelectedFIFO->Configured = false;
+		return false;
+	}
+
+	USB_Endpoint_SelectedFIFO->Size             = Size;
+	USB_Endpoint_SelectedFIFO->Banks            = Banks;
+	USB_Endpoint_SelectedFIFO->Type             = Type;
+	USB_Endpoint_SelectedFIFO->Stalled          = false;
+	USB_Endpoint_SelectedFIFO->Enabled          = true;
+	USB_Endpoint_SelectedFIFO->InterruptEnabled = false;
+
+	Endpoint_ResetEndpoint(Address);
+
+	USB_Endpoint_SelectedFIFO->Configured = true;
+
+	return true;
+}
+
+void Endpoint_ClearEndpoints(void)
+{
+	for (uint8_t EPNum = 0; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		USB_Endpoint_FIFOs[EPNum].IN.Configured        = false;
+		USB_Endpoint_FIFOs[EPNum].OUT.Configured       = false;
+		USB_Endpoint_FIFOs[EPNum].IN.InterruptEnabled  = false;
+		USB_Endpoint_FIFOs[EPNum].OUT.InterruptEnabled = false;
+
+		Endpoint_ResetEndpoint(EPNum | ENDPOINT_DIR_IN);
+		Endpoint_ResetEndpoint(EPNum | ENDPOINT_DIR_OUT);
+	}
+}
+
+uint8_t Endpoint_GetEndpointInterrupts(void)
+{
+	uint8_t EndpointInterrupts = 0;
+
+	for (uint8_t EPNum = 0; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		Endpoint_FIFO_t* OUTFIFO = &USB_Endpoint_FIFOs[EPNum].OUT;
+		Endpoint_FIFO_t* INFIFO  = &USB_Endpoint_FIFOs[EPNum].IN;
+		bool             OUTReady;
+
+		/* The control endpoint interrupts on a SETUP packet rather than on its OUT data packets */
+		if (EPNum == ENDPOINT_CONTROLEP)
+		  OUTReady = USB_INT_HasOccurred(USB_INT_RXSTPI);
+		else
+		  OUTReady = (__atomic_load_n(&OUTFIFO->BusyBanks, __ATOMIC_ACQUIRE) != 0);
+
+		if ((OUTFIFO->InterruptEnabled && OUTReady) ||
+		    (INFIFO->InterruptEnabled && (__atomic_load_n(&INFIFO->BusyBanks, __ATOMIC_ACQUIRE) < INFIFO->Banks)))
+		{
+			EndpointInterrupts |= (1 << EPNum);
+		}
+	}
+
+	return EndpointInterrupts;
+}
+
+void Endpoint_RaiseEndpointInterrupts(void)
+{
+	if (Endpoint_GetEndpointInterrupts())
+	  SIM_INTC_RaiseInterrupt(SIM_INTC_VECTOR_USB_COM);
+}
+
+void Endpoint_ClearStatusStage(void)
+{
+	if (USB_ControlRequest.bmRequestType & REQDIR_DEVICETOHOST)
+	{
+		while (!(Endpoint_IsOUTReceived()))
+		{
+			if (USB_DeviceState == DEVICE_STATE_Unattached)
+			  return;
+		}
+
+		Endpoint_ClearOUT();
+	}
+	else
+	{
+		while (!(Endpoint_IsINReady()))
+		{
+			if (USB_DeviceState == DEVICE_STATE_Unattached)
+			  return;
+		}
+
+		Endpoint_ClearIN();
+	}
+}
+
+#if !defined(CONTROL_ONLY_DEVICE)
+uint8_t Endpoint_WaitUntilReady(void)
+{
+	#if (USB_STREAM_TIMEOUT_MS < 0xFF)
+	uint8_t  TimeoutMSRem = USB_STREAM_TIMEOUT_MS;
+	#else
+	uint16_t TimeoutMSRem = USB_STREAM_TIMEOUT_MS;
+	#endif
+
+	uint16_t PreviousFrameNumber = USB_Device_GetFrameNumber();
+
+	for (;;)
+	{
+		if (Endpoint_GetEndpointDirection() == ENDPOINT_DIR_IN)
+		{
+			if (Endpoint_IsINReady())
+			  return ENDPOINT_READYWAIT_NoError;
+		}
+		else
+		{
+			if (Endpoint_IsOUTReceived())
+			  return ENDPOINT_READYWAIT_NoError;
+		}
+
+		uint8_t USB_DeviceState_LCL = USB_DeviceState;
+
+		if (USB_DeviceState_LCL == DEVICE_STATE_Unattached)
+		  return ENDPOINT_READYWAIT_DeviceDisconnected;
+		else if (USB_DeviceState_LCL == DEVICE_STATE_Suspended)
+		  return ENDPOINT_READYWAIT_BusSuspended;
+		else if (Endpoint_IsStalled())
+		  return ENDPOINT_READYWAIT_EndpointStalled;
+
+		uint16_t CurrentFrameNumber = USB_Device_GetFrameNumber();
+
+		if (CurrentFrameNumber != PreviousFrameNumber)
+		{
+			PreviousFrameNumber = CurrentFrameNumber;
+
+			if (!(TimeoutMSRem--))
+			  return ENDPOINT_READYWAIT_Timeout;
+		}
+	}
+}
+#endif
+
+#endif
+
+#endif
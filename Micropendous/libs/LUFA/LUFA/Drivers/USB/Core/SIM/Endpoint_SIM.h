@@ -0,0 +1,923 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB Endpoint definitions for the simulated USB controller.
+ *  \copydetails Group_EndpointManagement_SIM
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_EndpointRW
+ *  \defgroup Group_EndpointRW_SIM Endpoint Data Reading and Writing (SIM)
+ *  \brief Endpoint data read/write definitions for the host-side simulated USB controller architecture.
+ *
+ *  Functions, macros, variables, enums and types related to data reading and writing from and to endpoints.
+ */
+
+/** \ingroup Group_EndpointPrimitiveRW
+ *  \defgroup Group_EndpointPrimitiveRW_SIM Read/Write of Primitive Data Types (SIM)
+ *  \brief Endpoint primitive read/write definitions for the host-side simulated USB controller architecture.
+ *
+ *  Functions, macros, variables, enums and types related to data reading and writing of primitive data types
+ *  from and to endpoints.
+ */
+
+/** \ingroup Group_EndpointPacketManagement
+ *  \defgroup Group_EndpointPacketManagement_SIM Endpoint Packet Management (SIM)
+ *  \brief Endpoint packet management definitions for the host-side simulated USB controller architecture.
+ *
+ *  Functions, macros, variables, enums and types related to packet management of endpoints.
+ */
+
+/** \ingroup Group_EndpointManagement
+ *  \defgroup Group_EndpointManagement_SIM Endpoint Management (SIM)
+ *  \brief Endpoint management definitions for the host-side simulated USB controller architecture.
+ *
+ *  Functions, macros and enums related to endpoint management when in USB Device mode. This
+ *  module contains the endpoint management macros, as well as endpoint interrupt and data
+ *  send/receive functions for various data types.
+ *
+ *  @{
+ */
+
+#ifndef __ENDPOINT_SIM_H__
+#define __ENDPOINT_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "../USBTask.h"
+		#include "../USBInterrupt.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Maximum size in bytes of a single endpoint bank in the simulated USB controller. */
+			#define ENDPOINT_MAX_BANK_SIZE                  256
+
+			/** Maximum number of banks which may be allocated to a single endpoint in the simulated USB controller. */
+			#define ENDPOINT_MAX_BANKS                      2
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Type Defines: */
+			typedef struct
+			{
+				uint8_t          Data[ENDPOINT_MAX_BANKS][ENDPOINT_MAX_BANK_SIZE];
+				uint16_t         Length[ENDPOINT_MAX_BANKS];
+				uint16_t         Position;
+				uint16_t         Size;
+				uint8_t          Banks;
+				uint8_t          Type;
+				uint8_t          CPUBank;
+				uint8_t          SIEBank;
+				volatile uint8_t BusyBanks;
+				volatile bool    Stalled;
+				volatile bool    Enabled;
+				volatile bool    Configured;
+				volatile bool    InterruptEnabled;
+			} Endpoint_FIFO_t;
+
+			typedef struct
+			{
+				Endpoint_FIFO_t OUT;
+				Endpoint_FIFO_t IN;
+			} Endpoint_FIFOPair_t;
+
+		/* External Variables: */
+			extern Endpoint_FIFOPair_t USB_Endpoint_FIFOs[];
+			extern uint8_t             USB_Endpoint_SelectedEndpoint;
+			extern Endpoint_FIFO_t*    USB_Endpoint_SelectedFIFO;
+
+		/* Inline Functions: */
+			static inline uint8_t Endpoint_NextBank(const Endpoint_FIFO_t* const FIFO,
+			                                        const uint8_t Bank) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint8_t Endpoint_NextBank(const Endpoint_FIFO_t* const FIFO,
+			                                        const uint8_t Bank)
+			{
+				return ((Bank + 1) < FIFO->Banks) ? (Bank + 1) : 0;
+			}
+
+			static inline uint16_t Endpoint_GetBankSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetBankSize(void)
+			{
+				return USB_Endpoint_SelectedFIFO->Size;
+			}
+
+		/* Function Prototypes: */
+			void Endpoint_ClearEndpoints(void);
+			void Endpoint_RaiseEndpointInterrupts(void);
+			bool Endpoint_ConfigureEndpoint_Prv(const uint8_t Address,
+			                                    const uint8_t Type,
+			                                    const uint16_t Size,
+			                                    const uint8_t Banks);
+
+	#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if (!defined(FIXED_CONTROL_ENDPOINT_SIZE) || defined(__DOXYGEN__))
+				/** Default size of the default control endpoint's bank, until altered by the control endpoint bank size
+				 *  value in the device descriptor. Not available if the \c FIXED_CONTROL_ENDPOINT_SIZE token is defined.
+				 */
+				#define ENDPOINT_CONTROLEP_DEFAULT_SIZE     8
+			#endif
+
+			#if !defined(CONTROL_ONLY_DEVICE) || defined(__DOXYGEN__)
+				/** Total number of endpoints (including the default control endpoint at address 0) which may
+				 *  be used in the device. The simulated controller mirrors the endpoint count of the largest
+				 *  USB AVR8 models.
+				 */
+				#define ENDPOINT_TOTAL_ENDPOINTS            7
+			#else
+				#define ENDPOINT_TOTAL_ENDPOINTS            1
+			#endif
+
+		/* Enums: */
+			/** Enum for the possible error return codes of the \ref Endpoint_WaitUntilReady() function.
+			 *
+			 *  \ingroup Group_EndpointRW_SIM
+			 */
+			enum Endpoint_WaitUntilReady_ErrorCodes_t
+			{
+				ENDPOINT_READYWAIT_NoError                 = 0, /**< Endpoint is ready for next packet, no error. */
+				ENDPOINT_READYWAIT_EndpointStalled         = 1, /**< The endpoint was stalled during the stream
+				                                                 *   transfer by the host or device.
+				                                                 */
+				ENDPOINT_READYWAIT_DeviceDisconnected      = 2,	/**< Device was disconnected from the host while
+				                                                 *   waiting for the endpoint to become ready.
+				                                                 */
+				ENDPOINT_READYWAIT_BusSuspended            = 3, /**< The USB bus has been suspended by the host and
+				                                                 *   no USB endpoint traffic can occur until the bus
+				                                                 *   has resumed.
+				                                                 */
+				ENDPOINT_READYWAIT_Timeout                 = 4, /**< The host failed to accept or send the next packet
+				                                                 *   within the software timeout period set by the
+				                                                 *   \ref USB_STREAM_TIMEOUT_MS macro.
+				                                                 */
+			};
+
+		/* Inline Functions: */
+			/** Configures the specified endpoint address with the given endpoint type, bank size and number of hardware
+			 *  banks. Once configured, the endpoint may be read from or written to, depending on its direction.
+			 *
+			 *  \param[in] Address    Endpoint address to configure.
+			 *
+			 *  \param[in] Type       Type of endpoint to configure, a \c EP_TYPE_* mask. Not all endpoint types
+			 *                        are available on Low Speed USB devices - refer to the USB 2.0 specification.
+			 *
+			 *  \param[in] Size       Size of the endpoint's bank, where packets are stored before they are transmitted
+			 *                        to the USB host, or after they have been received from the USB host (depending on
+			 *                        the endpoint's data direction). The bank size must indicate the maximum packet size
+			 *                        that the endpoint can handle.
+			 *
+			 *  \param[in] Banks      Number of banks to use for the endpoint being configured.
+			 *
+			 *  \attention When the \c ORDERED_EP_CONFIG compile time option is used, Endpoints <b>must</b> be configured in
+			 *             ascending order, or bank corruption will occur.
+			 *
+			 *  \note Different endpoints may have different maximum packet sizes based on the endpoint's index - please
+			 *        refer to the chosen microcontroller model's datasheet to determine the maximum bank size for each endpoint.
+			 *        \n\n
+			 *
+			 *  \note The default control endpoint should not be manually configured by the user application, as
+			 *        it is automatically configured by the library internally.
+			 *        \n\n
+			 *
+			 *  \note This routine will automatically select the specified endpoint upon success. Upon failure, the endpoint
+			 *        which failed to reconfigure correctly will be selected.
+			 *
+			 *  \return Boolean \c true if the configuration succeeded, \c false otherwise.
+			 */
+			static inline bool Endpoint_ConfigureEndpoint(const uint8_t Address,
+			                                              const uint8_t Type,
+			                                              const uint16_t Size,
+			                                              const uint8_t Banks) ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_ConfigureEndpoint(const uint8_t Address,
+			                                              const uint8_t Type,
+			                                              const uint16_t Size,
+			                                              const uint8_t Banks)
+			{
+				if ((Address & ENDPOINT_EPNUM_MASK) >= ENDPOINT_TOTAL_ENDPOINTS)
+				  return false;
+
+				if (Type == EP_TYPE_CONTROL)
+				  Endpoint_ConfigureEndpoint_Prv(Address ^ ENDPOINT_DIR_IN, Type, Size, Banks);
+
+				return Endpoint_ConfigureEndpoint_Prv(Address, Type, Size, Banks);
+			}
+
+			/** Indicates the number of bytes currently stored in the current endpoint's selected bank.
+			 *
+			 *  \ingroup Group_EndpointRW_SIM
+			 *
+			 *  \return Total number of bytes in the currently selected Endpoint's FIFO buffer.
+			 */
+			static inline uint16_t Endpoint_BytesInEndpoint(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_BytesInEndpoint(void)
+			{
+				if (USB_Endpoint_SelectedEndpoint & ENDPOINT_DIR_IN)
+				  return USB_Endpoint_SelectedFIFO->Position;
+				else
+				  return (USB_Endpoint_SelectedFIFO->Length[USB_Endpoint_SelectedFIFO->CPUBank] - USB_Endpoint_SelectedFIFO->Position);
+			}
+
+			/** Determines the currently selected endpoint's direction.
+			 *
+			 *  \return The currently selected endpoint's direction, as a \c ENDPOINT_DIR_* mask.
+			 */
+			static inline uint8_t Endpoint_GetEndpointDirection(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint8_t Endpoint_GetEndpointDirection(void)
+			{
+				return (USB_Endpoint_SelectedEndpoint & ENDPOINT_DIR_IN);
+			}
+
+			/** Get the endpoint address of the currently selected endpoint. This is typically used to save
+			 *  the currently selected endpoint so that it can be restored after another endpoint has been
+			 *  manipulated.
+			 *
+			 *  \return Index of the currently selected endpoint.
+			 */
+			static inline uint8_t Endpoint_GetCurrentEndpoint(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint8_t Endpoint_GetCurrentEndpoint(void)
+			{
+				return USB_Endpoint_SelectedEndpoint;
+			}
+
+			/** Selects the given endpoint address.
+			 *
+			 *  Any endpoint operations which do not require the endpoint address to be indicated will operate on
+			 *  the currently selected endpoint.
+			 *
+			 *  \param[in] Address Endpoint address to select.
+			 */
+			static inline void Endpoint_SelectEndpoint(const uint8_t Address) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_SelectEndpoint(const uint8_t Address)
+			{
+				uint8_t EndpointNumber = (Address & ENDPOINT_EPNUM_MASK);
+
+				USB_Endpoint_SelectedEndpoint = Address;
+
+				if (Address & ENDPOINT_DIR_IN)
+				  USB_Endpoint_SelectedFIFO = &USB_Endpoint_FIFOs[EndpointNumber].IN;
+				else
+				  USB_Endpoint_SelectedFIFO = &USB_Endpoint_FIFOs[EndpointNumber].OUT;
+			}
+
+			/** Resets the endpoint bank FIFO. This clears all the endpoint banks and resets the USB controller's
+			 *  data In and Out pointers to the bank's contents.
+			 *
+			 *  \param[in] Address  Endpoint address whose FIFO buffers are to be reset.
+			 */
+			static inline void Endpoint_ResetEndpoint(const uint8_t Address) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ResetEndpoint(const uint8_t Address)
+			{
+				Endpoint_FIFO_t* FIFO;
+
+				if (Address & ENDPOINT_DIR_IN)
+				  FIFO = &USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].IN;
+				else
+				  FIFO = &USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].OUT;
+
+				FIFO->Position = 0;
+				FIFO->CPUBank  = 0;
+				FIFO->SIEBank  = 0;
+				__atomic_store_n(&FIFO->BusyBanks, 0, __ATOMIC_RELEASE);
+			}
+
+			/** Enables the currently selected endpoint so that data can be sent and received through it to
+			 *  and from a host.
+			 *
+			 *  \note Endpoints must first be configured properly via \ref Endpoint_ConfigureEndpoint().
+			 */
+			static inline void Endpoint_EnableEndpoint(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_EnableEndpoint(void)
+			{
+				USB_Endpoint_SelectedFIFO->Enabled = true;
+			}
+
+			/** Disables the currently selected endpoint so that data cannot be sent and received through it
+			 *  to and from a host.
+			 */
+			static inline void Endpoint_DisableEndpoint(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_DisableEndpoint(void)
+			{
+				USB_Endpoint_SelectedFIFO->Enabled = false;
+			}
+
+			/** Determines if the currently selected endpoint is enabled, but not necessarily configured.
+			 *
+			 * \return Boolean \c true if the currently selected endpoint is enabled, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsEnabled(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsEnabled(void)
+			{
+				return USB_Endpoint_SelectedFIFO->Enabled;
+			}
+
+			/** Retrieves the number of busy banks in the currently selected endpoint, which have been queued for
+			 *  transmission via the \ref Endpoint_ClearIN() command, or are awaiting acknowledgement via the
+			 *  \ref Endpoint_ClearOUT() command.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Total number of busy banks in the selected endpoint.
+			 */
+			static inline uint8_t Endpoint_GetBusyBanks(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline uint8_t Endpoint_GetBusyBanks(void)
+			{
+				return __atomic_load_n(&USB_Endpoint_SelectedFIFO->BusyBanks, __ATOMIC_ACQUIRE);
+			}
+
+			/** Aborts all pending IN transactions on the currently selected endpoint, once the bank
+			 *  has been queued for transmission to the host via \ref Endpoint_ClearIN(). This function
+			 *  will terminate all queued transactions, resetting the endpoint banks ready for a new
+			 *  packet.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 */
+			static inline void Endpoint_AbortPendingIN(void)
+			{
+				USB_Endpoint_SelectedFIFO->SIEBank = USB_Endpoint_SelectedFIFO->CPUBank;
+				__atomic_store_n(&USB_Endpoint_SelectedFIFO->BusyBanks, 0, __ATOMIC_RELEASE);
+			}
+
+			/** Determines if the currently selected endpoint may be read from (if data is waiting in the endpoint
+			 *  bank and the endpoint is an OUT direction, or if the bank is not yet full if the endpoint is an IN
+			 *  direction). This function will return false if an error has occurred in the endpoint, if the endpoint
+			 *  is an OUT direction and no packet (or an empty packet) has been received, or if the endpoint is an IN
+			 *  direction and the endpoint bank is full.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Boolean \c true if the currently selected endpoint may be read from or written to, depending
+			 *          on its direction.
+			 */
+			static inline bool Endpoint_IsReadWriteAllowed(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsReadWriteAllowed(void)
+			{
+				Endpoint_FIFO_t* FIFO      = USB_Endpoint_SelectedFIFO;
+				uint8_t          BusyBanks = __atomic_load_n(&FIFO->BusyBanks, __ATOMIC_ACQUIRE);
+
+				if (USB_Endpoint_SelectedEndpoint & ENDPOINT_DIR_IN)
+				  return ((BusyBanks < FIFO->Banks) && (FIFO->Position < FIFO->Size));
+				else
+				  return (BusyBanks && (FIFO->Position < FIFO->Length[FIFO->CPUBank]));
+			}
+
+			/** Determines if the currently selected endpoint is configured.
+			 *
+			 *  \return Boolean \c true if the currently selected endpoint has been configured, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsConfigured(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsConfigured(void)
+			{
+				return USB_Endpoint_SelectedFIFO->Configured;
+			}
+
+			/** Returns a mask indicating which endpoints have interrupted - i.e. an endpoint whose interrupt
+			 *  was enabled with \ref Endpoint_EnableEndpointInterrupt() is ready to be serviced. Which endpoints
+			 *  have interrupted can be determined by masking the return value against
+			 *  <tt>(1 << <i>{Endpoint Number}</i>)</tt>.
+			 *
+			 *  \return Mask whose bits indicate which endpoints have interrupted.
+			 */
+			uint8_t Endpoint_GetEndpointInterrupts(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Enables the endpoint interrupt of the currently selected endpoint, raising the USB endpoint
+			 *  interrupt vector when the endpoint is ready to be serviced: on the reception of a SETUP packet
+			 *  for the control endpoint, on the reception of a packet for an OUT endpoint, or when a bank is
+			 *  free for a new packet for an IN endpoint. Like those of the real controller, the interrupt is
+			 *  level triggered, and fires straight away if the endpoint is already ready.
+			 */
+			static inline void Endpoint_EnableEndpointInterrupt(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_EnableEndpointInterrupt(void)
+			{
+				USB_Endpoint_SelectedFIFO->InterruptEnabled = true;
+				Endpoint_RaiseEndpointInterrupts();
+			}
+
+			/** Disables the endpoint interrupts of both directions of the currently selected endpoint number,
+			 *  as the per-endpoint interrupt enable register of the real controller does.
+			 */
+			static inline void Endpoint_DisableEndpointInterrupt(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_DisableEndpointInterrupt(void)
+			{
+				USB_Endpoint_FIFOs[USB_Endpoint_SelectedEndpoint & ENDPOINT_EPNUM_MASK].OUT.InterruptEnabled = false;
+				USB_Endpoint_FIFOs[USB_Endpoint_SelectedEndpoint & ENDPOINT_EPNUM_MASK].IN.InterruptEnabled  = false;
+			}
+
+			/** Determines if the specified endpoint number has interrupted (valid only for INTERRUPT type
+			 *  endpoints).
+			 *
+			 *  \param[in] Address  Address of the endpoint whose interrupt flag should be tested.
+			 *
+			 *  \return Boolean \c true if the specified endpoint has interrupted, \c false otherwise.
+			 */
+			static inline bool Endpoint_HasEndpointInterrupted(const uint8_t Address) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_HasEndpointInterrupted(const uint8_t Address)
+			{
+				return ((Endpoint_GetEndpointInterrupts() & (1 << (Address & ENDPOINT_EPNUM_MASK))) ? true : false);
+			}
+
+			/** Determines if the selected IN endpoint is ready for a new packet to be sent to the host.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Boolean \c true if the current endpoint is ready for an IN packet, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsINReady(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsINReady(void)
+			{
+				Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint | ENDPOINT_DIR_IN);
+
+				if (__atomic_load_n(&USB_Endpoint_SelectedFIFO->BusyBanks, __ATOMIC_ACQUIRE) < USB_Endpoint_SelectedFIFO->Banks)
+				  return true;
+
+				SIM_YieldToBus();
+				return false;
+			}
+
+			/** Determines if the selected OUT endpoint has received new packet from the host.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Boolean \c true if current endpoint is has received an OUT packet, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsOUTReceived(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsOUTReceived(void)
+			{
+				Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint & ~ENDPOINT_DIR_IN);
+
+				if (!(USB_INT_HasOccurred(USB_INT_RXSTPI) && !(USB_Endpoint_SelectedEndpoint & ENDPOINT_EPNUM_MASK)) &&
+				    __atomic_load_n(&USB_Endpoint_SelectedFIFO->BusyBanks, __ATOMIC_ACQUIRE))
+				{
+					return true;
+				}
+
+				SIM_YieldToBus();
+				return false;
+			}
+
+			/** Determines if the current CONTROL type endpoint has received a SETUP packet.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Boolean \c true if the selected endpoint has received a SETUP packet, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsSETUPReceived(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsSETUPReceived(void)
+			{
+				Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint & ~ENDPOINT_DIR_IN);
+
+				return USB_INT_HasOccurred(USB_INT_RXSTPI);
+			}
+
+			/** Clears a received SETUP packet on the currently selected CONTROL type endpoint, freeing up the
+			 *  endpoint for the next packet.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \note This is not applicable for non CONTROL type endpoints.
+			 */
+			static inline void Endpoint_ClearSETUP(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ClearSETUP(void)
+			{
+				Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint & ~ENDPOINT_DIR_IN);
+				USB_Endpoint_SelectedFIFO->Position = 0;
+				__atomic_store_n(&USB_Endpoint_SelectedFIFO->BusyBanks, 0, __ATOMIC_RELEASE);
+				USB_INT_Clear(USB_INT_RXSTPI);
+
+				Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint | ENDPOINT_DIR_IN);
+				USB_Endpoint_SelectedFIFO->Position = 0;
+			}
+
+			/** Sends an IN packet to the host on the currently selected endpoint, freeing up the endpoint for the
+			 *  next packet and switching to the alternative endpoint bank if double banked.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 */
+			static inline void Endpoint_ClearIN(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ClearIN(void)
+			{
+				Endpoint_FIFO_t* FIFO = USB_Endpoint_SelectedFIFO;
+
+				/* Like the FIFOCON bit of the real controller, clearing a bank has no effect until one is free */
+				if (__atomic_load_n(&FIFO->BusyBanks, __ATOMIC_ACQUIRE) >= FIFO->Banks)
+				  return;
+
+				FIFO->Length[FIFO->CPUBank] = FIFO->Position;
+				FIFO->Position = 0;
+				FIFO->CPUBank  = Endpoint_NextBank(FIFO, FIFO->CPUBank);
+				__atomic_add_fetch(&FIFO->BusyBanks, 1, __ATOMIC_RELEASE);
+			}
+
+			/** Acknowledges an OUT packet to the host on the currently selected endpoint, freeing up the endpoint
+			 *  for the next packet and switching to the alternative endpoint bank if double banked.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 */
+			static inline void Endpoint_ClearOUT(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ClearOUT(void)
+			{
+				Endpoint_FIFO_t* FIFO = USB_Endpoint_SelectedFIFO;
+
+				if (!(__atomic_load_n(&FIFO->BusyBanks, __ATOMIC_ACQUIRE)))
+				  return;
+
+				FIFO->Position = 0;
+				FIFO->CPUBank  = Endpoint_NextBank(FIFO, FIFO->CPUBank);
+				__atomic_sub_fetch(&FIFO->BusyBanks, 1, __ATOMIC_RELEASE);
+			}
+
+			/** Stalls the current endpoint, indicating to the host that a logical problem occurred with the
+			 *  indicated endpoint and that the current transfer sequence should be aborted. This provides a
+			 *  way for devices to indicate invalid commands to the host so that the current transfer can be
+			 *  aborted and the host can begin its own recovery sequence.
+			 *
+			 *  The currently selected endpoint remains stalled until either the \ref Endpoint_ClearStall() macro
+			 *  is called, or the host issues a CLEAR FEATURE request to the device for the currently selected
+			 *  endpoint.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 */
+			static inline void Endpoint_StallTransaction(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_StallTransaction(void)
+			{
+				USB_Endpoint_SelectedFIFO->Stalled = true;
+
+				if (USB_Endpoint_SelectedFIFO->Type == EP_TYPE_CONTROL)
+				{
+					Endpoint_SelectEndpoint(USB_Endpoint_SelectedEndpoint ^ ENDPOINT_DIR_IN);
+					USB_Endpoint_SelectedFIFO->Stalled = true;
+				}
+			}
+
+			/** Clears the STALL condition on the currently selected endpoint.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 */
+			static inline void Endpoint_ClearStall(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ClearStall(void)
+			{
+				USB_Endpoint_SelectedFIFO->Stalled = false;
+			}
+
+			/** Determines if the currently selected endpoint is stalled, \c false otherwise.
+			 *
+			 *  \ingroup Group_EndpointPacketManagement_SIM
+			 *
+			 *  \return Boolean \c true if the currently selected endpoint is stalled, \c false otherwise.
+			 */
+			static inline bool Endpoint_IsStalled(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline bool Endpoint_IsStalled(void)
+			{
+				return USB_Endpoint_SelectedFIFO->Stalled;
+			}
+
+			/** Resets the data toggle of the currently selected endpoint. */
+			static inline void Endpoint_ResetDataToggle(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_ResetDataToggle(void)
+			{
+				/* No implementation for the SIM architecture, as data toggles are not modelled */
+			}
+
+			/** Sets the direction of the currently selected endpoint.
+			 *
+			 *  \param[in] DirectionMask  New endpoint direction, as a \c ENDPOINT_DIR_* mask.
+			 */
+			static inline void Endpoint_SetEndpointDirection(const uint8_t DirectionMask) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_SetEndpointDirection(const uint8_t DirectionMask)
+			{
+				Endpoint_SelectEndpoint((USB_Endpoint_SelectedEndpoint & ~ENDPOINT_DIR_IN) | DirectionMask);
+			}
+
+			/** Reads one byte from the currently selected endpoint's bank, for OUT direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \return Next byte in the currently selected endpoint's FIFO buffer.
+			 */
+			static inline uint8_t Endpoint_Read_8(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint8_t Endpoint_Read_8(void)
+			{
+				Endpoint_FIFO_t* FIFO = USB_Endpoint_SelectedFIFO;
+
+				return FIFO->Data[FIFO->CPUBank][FIFO->Position++];
+			}
+
+			/** Writes one byte to the currently selected endpoint's bank, for IN direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \param[in] Data  Data to write into the the currently selected endpoint's FIFO buffer.
+			 */
+			static inline void Endpoint_Write_8(const uint8_t Data) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Write_8(const uint8_t Data)
+			{
+				Endpoint_FIFO_t* FIFO = USB_Endpoint_SelectedFIFO;
+
+				if (FIFO->Position < FIFO->Size)
+				  FIFO->Data[FIFO->CPUBank][FIFO->Position++] = Data;
+			}
+
+			/** Discards one byte from the currently selected endpoint's bank, for OUT direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 */
+			static inline void Endpoint_Discard_8(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Discard_8(void)
+			{
+				uint8_t Dummy;
+
+				Dummy = Endpoint_Read_8();
+
+				(void)Dummy;
+			}
+
+			/** Reads two bytes from the currently selected endpoint's bank in little endian format, for OUT
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \return Next two bytes in the currently selected endpoint's FIFO buffer.
+			 */
+			static inline uint16_t Endpoint_Read_16_LE(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_Read_16_LE(void)
+			{
+				union
+				{
+					uint16_t Value;
+					uint8_t  Bytes[2];
+				} Data;
+
+				Data.Bytes[0] = Endpoint_Read_8();
+				Data.Bytes[1] = Endpoint_Read_8();
+
+				return Data.Value;
+			}
+
+			/** Reads two bytes from the currently selected endpoint's bank in big endian format, for OUT
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \return Next two bytes in the currently selected endpoint's FIFO buffer.
+			 */
+			static inline uint16_t Endpoint_Read_16_BE(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_Read_16_BE(void)
+			{
+				union
+				{
+					uint16_t Value;
+					uint8_t  Bytes[2];
+				} Data;
+
+				Data.Bytes[1] = Endpoint_Read_8();
+				Data.Bytes[0] = Endpoint_Read_8();
+
+				return Data.Value;
+			}
+
+			/** Writes two bytes to the currently selected endpoint's bank in little endian format, for IN
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \param[in] Data  Data to write to the currently selected endpoint's FIFO buffer.
+			 */
+			static inline void Endpoint_Write_16_LE(const uint16_t Data) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Write_16_LE(const uint16_t Data)
+			{
+				Endpoint_Write_8(Data & 0xFF);
+				Endpoint_Write_8(Data >> 8);
+			}
+
+			/** Writes two bytes to the currently selected endpoint's bank in big endian format, for IN
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \param[in] Data  Data to write to the currently selected endpoint's FIFO buffer.
+			 */
+			static inline void Endpoint_Write_16_BE(const uint16_t Data) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Write_16_BE(const uint16_t Data)
+			{
+				Endpoint_Write_8(Data >> 8);
+				Endpoint_Write_8(Data & 0xFF);
+			}
+
+			/** Discards two bytes from the currently selected endpoint's bank, for OUT direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 */
+			static inline void Endpoint_Discard_16(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Discard_16(void)
+			{
+				uint8_t Dummy;
+
+				Dummy = Endpoint_Read_8();
+				Dummy = Endpoint_Read_8();
+
+				(void)Dummy;
+			}
+
+			/** Reads four bytes from the currently selected endpoint's bank in little endian format, for OUT
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \return Next four bytes in the currently selected endpoint's FIFO buffer.
+			 */
+			static inline uint32_t Endpoint_Read_32_LE(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint32_t Endpoint_Read_32_LE(void)
+			{
+				union
+				{
+					uint32_t Value;
+					uint8_t  Bytes[4];
+				} Data;
+
+				Data.Bytes[0] = Endpoint_Read_8();
+				Data.Bytes[1] = Endpoint_Read_8();
+				Data.Bytes[2] = Endpoint_Read_8();
+				Data.Bytes[3] = Endpoint_Read_8();
+
+				return Data.Value;
+			}
+
+			/** Reads four bytes from the currently selected endpoint's bank in big endian format, for OUT
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \return Next four bytes in the currently selected endpoint's FIFO buffer.
+			 */
+			static inline uint32_t Endpoint_Read_32_BE(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint32_t Endpoint_Read_32_BE(void)
+			{
+				union
+				{
+					uint32_t Value;
+					uint8_t  Bytes[4];
+				} Data;
+
+				Data.Bytes[3] = Endpoint_Read_8();
+				Data.Bytes[2] = Endpoint_Read_8();
+				Data.Bytes[1] = Endpoint_Read_8();
+				Data.Bytes[0] = Endpoint_Read_8();
+
+				return Data.Value;
+			}
+
+			/** Writes four bytes to the currently selected endpoint's bank in little endian format, for IN
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \param[in] Data  Data to write to the currently selected endpoint's FIFO buffer.
+			 */
+			static inline void Endpoint_Write_32_LE(const uint32_t Data) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Write_32_LE(const uint32_t Data)
+			{
+				Endpoint_Write_8(Data &  0xFF);
+				Endpoint_Write_8(Data >> 8);
+				Endpoint_Write_8(Data >> 16);
+				Endpoint_Write_8(Data >> 24);
+			}
+
+			/** Writes four bytes to the currently selected endpoint's bank in big endian format, for IN
+			 *  direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 *
+			 *  \param[in] Data  Data to write to the currently selected endpoint's FIFO buffer.
+			 */
+			static inline void Endpoint_Write_32_BE(const uint32_t Data) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Write_32_BE(const uint32_t Data)
+			{
+				Endpoint_Write_8(Data >> 24);
+				Endpoint_Write_8(Data >> 16);
+				Endpoint_Write_8(Data >> 8);
+				Endpoint_Write_8(Data &  0xFF);
+			}
+
+			/** Discards four bytes from the currently selected endpoint's bank, for OUT direction endpoints.
+			 *
+			 *  \ingroup Group_EndpointPrimitiveRW_SIM
+			 */
+			static inline void Endpoint_Discard_32(void) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_Discard_32(void)
+			{
+				uint8_t Dummy;
+
+				Dummy = Endpoint_Read_8();
+				Dummy = Endpoint_Read_8();
+				Dummy = Endpoint_Read_8();
+				Dummy = Endpoint_Read_8();
+
+				(void)Dummy;
+			}
+
+		/* External Variables: */
+			/** Global indicating the maximum packet size of the default control endpoint located at address
+			 *  0 in the device. This value is set to the value indicated in the device descriptor in the user
+			 *  project once the USB interface is initialized into device mode.
+			 *
+			 *  If space is an issue, it is possible to fix this to a static value by defining the control
+			 *  endpoint size in the \c FIXED_CONTROL_ENDPOINT_SIZE token passed to the compiler in the makefile
+			 *  via the -D switch. When a fixed control endpoint size is used, the size is no longer dynamically
+			 *  read from the descriptors at runtime and instead fixed to the given value. When used, it is
+			 *  important that the descriptor control endpoint size value matches the size given as the
+			 *  \c FIXED_CONTROL_ENDPOINT_SIZE token - it is recommended that the \c FIXED_CONTROL_ENDPOINT_SIZE token
+			 *  be used in the device descriptors to ensure this.
+			 *
+			 *  \attention This variable should be treated as read-only in the user application, and never manually
+			 *             changed in value.
+			 */
+			#if (!defined(FIXED_CONTROL_ENDPOINT_SIZE) || defined(__DOXYGEN__))
+				extern uint8_t USB_Device_ControlEndpointSize;
+			#else
+				#define USB_Device_ControlEndpointSize FIXED_CONTROL_ENDPOINT_SIZE
+			#endif
+
+		/* Function Prototypes: */
+			/** Configures a table of endpoint descriptions, in sequence. This function can be used to configure multiple
+			 *  endpoints at the same time.
+			 *
+			 *  \note Endpoints with a zero address will be ignored, thus this function cannot be used to configure the
+			 *        control endpoint.
+			 *
+			 *  \param[in] Table    Pointer to a table of endpoint descriptions.
+			 *  \param[in] Entries  Number of entries in the endpoint table to configure.
+			 *
+			 *  \return Boolean \c true if all endpoints configured successfully, \c false otherwise.
+			 */
+			bool Endpoint_ConfigureEndpointTable(const USB_Endpoint_Table_t* const Table,
+			                                     const uint8_t Entries);
+
+			/** Completes the status stage of a control transfer on a CONTROL type endpoint automatically,
+			 *  with respect to the data direction. This is a convenience function which can be used to
+			 *  simplify user control request handling.
+			 *
+			 *  \note This routine should not be called on non CONTROL type endpoints.
+			 */
+			void Endpoint_ClearStatusStage(void);
+
+			/** Spin-loops until the currently selected non-control endpoint is ready for the next packet of data
+			 *  to be read or written to it.
+			 *
+			 *  \note This routine should not be called on CONTROL type endpoints.
+			 *
+			 *  \ingroup Group_EndpointRW_SIM
+			 *
+			 *  \return A value from the \ref Endpoint_WaitUntilReady_ErrorCodes_t enum.
+			 */
+			uint8_t Endpoint_WaitUntilReady(void);
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
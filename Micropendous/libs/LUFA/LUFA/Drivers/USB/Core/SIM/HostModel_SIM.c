@@ -0,0 +1,434 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBController.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+
+USB_SimHost_Statistics_t USB_SimHost_Statistics;
+
+/** Wall clock time at which the last Start of Frame event was issued by the host thread, in milliseconds */
+static uint32_t USB_SimHost_LastFrameTime;
+
+static uint32_t USB_SimHost_GetTimeMS(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return ((uint32_t)Now.tv_sec * 1000UL) + (uint32_t)(Now.tv_nsec / 1000000L);
+}
+
+/** Yields to the device thread while the host is waiting on it, issuing Start of Frame events as wall clock time
+ *  passes so that frame based timeouts in the device continue to advance.
+ *
+ *  \param[in] StartTime  Wall clock time in milliseconds at which the wait began.
+ *
+ *  \return Boolean \c true if the wait may continue, \c false if it has exceeded \ref USB_SIMHOST_TIMEOUT_MS.
+ */
+static bool USB_SimHost_Poll(const uint32_t StartTime)
+{
+	uint32_t CurrentTime = USB_SimHost_GetTimeMS();
+
+	if (CurrentTime != USB_SimHost_LastFrameTime)
+	{
+		USB_SimHost_LastFrameTime = CurrentTime;
+		USB_SimHost_StartOfFrame();
+	}
+
+	sched_yield();
+
+	return ((CurrentTime - StartTime) < USB_SIMHOST_TIMEOUT_MS);
+}
+
+static Endpoint_FIFO_t* USB_SimHost_GetFIFO(const uint8_t Address)
+{
+	Endpoint_FIFOPair_t* FIFOPair = &USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK];
+
+	return (Address & ENDPOINT_DIR_IN) ? &FIFOPair->IN : &FIFOPair->OUT;
+}
+
+static uint8_t USB_SimHost_SendPacket(Endpoint_FIFO_t* const FIFO,
+                                      const void* const Buffer,
+                                      const uint16_t Length)
+{
+	uint32_t StartTime = USB_SimHost_GetTimeMS();
+
+	if (Length > FIFO->Size)
+	  return USB_SIMHOST_BadLength;
+
+	while (__atomic_load_n(&FIFO->BusyBanks, __ATOMIC_ACQUIRE) >= FIFO->Banks)
+	{
+		if (USB_DeviceState == DEVICE_STATE_Unattached)
+		  return USB_SIMHOST_DeviceDisconnected;
+		else if (FIFO->Stalled)
+		  return USB_SIMHOST_EndpointStalled;
+		else if (!(USB_SimHost_Poll(StartTime)))
+		  return USB_SIMHOST_Timeout;
+	}
+
+	if (FIFO->Stalled)
+	  return USB_SIMHOST_EndpointStalled;
+
+	if (Length)
+	  memcpy(FIFO->Data[FIFO->SIEBank], Buffer, Length);
+
+	FIFO->Length[FIFO->SIEBank] = Length;
+	FIFO->SIEBank = Endpoint_NextBank(FIFO, FIFO->SIEBank);
+	__atomic_add_fetch(&FIFO->BusyBanks, 1, __ATOMIC_RELEASE);
+	Endpoint_RaiseEndpointInterrupts();
+
+	return USB_SIMHOST_Successful;
+}
+
+static uint8_t USB_SimHost_ReceivePacket(Endpoint_FIFO_t* const FIFO,
+                                         void* const Buffer,
+                                         uint16_t* const Length)
+{
+	uint32_t StartTime = USB_SimHost_GetTimeMS();
+
+	while (!(__atomic_load_n(&FIFO->BusyBanks, __ATOMIC_ACQUIRE)))
+	{
+		if (USB_DeviceState == DEVICE_STATE_Unattached)
+		  return USB_SIMHOST_DeviceDisconnected;
+		else if (FIFO->Stalled)
+		  return USB_SIMHOST_EndpointStalled;
+		else if (!(USB_SimHost_Poll(StartTime)))
+		  return USB_SIMHOST_Timeout;
+	}
+
+	*Length = FIFO->Length[FIFO->SIEBank];
+	memcpy(Buffer, FIFO->Data[FIFO->SIEBank], *Length);
+	FIFO->SIEBank = Endpoint_NextBank(FIFO, FIFO->SIEBank);
+	__atomic_sub_fetch(&FIFO->BusyBanks, 1, __ATOMIC_RELEASE);
+	Endpoint_RaiseEndpointInterrupts();
+
+	return USB_SIMHOST_Successful;
+}
+
+static uint8_t USB_SimHost_WaitForDeviceState(const uint8_t State)
+{
+	uint32_t StartTime = USB_SimHost_GetTimeMS();
+
+	while (USB_DeviceState != State)
+	{
+		if (!(USB_SimHost_Poll(StartTime)))
+		  return USB_SIMHOST_Timeout;
+	}
+
+	return USB_SIMHOST_Successful;
+}
+
+static void* USB_SimHost_Thread(void* Parameter)
+{
+	(void)Parameter;
+
+	CALLBACK_USB_SimHost_Task();
+
+	return NULL;
+}
+
+void USB_SimHost_Start(void)
+{
+	static bool IsStarted;
+
+	pthread_t HostThread;
+	sigset_t  InterruptSignals;
+	sigset_t  PreviousSignals;
+
+	if (IsStarted)
+	  return;
+
+	IsStarted = true;
+
+	/* Interrupts must only ever be delivered to the application thread, so start the host with them masked */
+	sigemptyset(&InterruptSignals);
+	sigaddset(&InterruptSignals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &InterruptSignals, &PreviousSignals);
+
+	if (pthread_create(&HostThread, NULL, USB_SimHost_Thread, NULL) == 0)
+	  pthread_detach(HostThread);
+
+	pthread_sigmask(SIG_SETMASK, &PreviousSignals, NULL);
+}
+
+void CALLBACK_USB_SimHost_Task(void) ATTR_WEAK;
+void CALLBACK_USB_SimHost_Task(void)
+{
+	USB_SimHost_Enumerate(1);
+
+	for (;;)
+	{
+		SIM_Delay_MS(1);
+		USB_SimHost_StartOfFrame();
+	}
+}
+
+uint8_t USB_SimHost_Attach(void)
+{
+	uint32_t StartTime = USB_SimHost_GetTimeMS();
+
+	USB_VBUS_Present = true;
+	USB_INT_Set(USB_INT_VBUSTI);
+
+	while (!(USB_Controller_Attached) || (USB_DeviceState == DEVICE_STATE_Unattached))
+	{
+		if (!(USB_SimHost_Poll(StartTime)))
+		  return USB_SIMHOST_Timeout;
+	}
+
+	USB_INT_Set(USB_INT_EORSTI);
+
+	return USB_SimHost_WaitForDeviceState(DEVICE_STATE_Default);
+}
+
+void USB_SimHost_Detach(void)
+{
+	USB_VBUS_Present = false;
+	USB_INT_Set(USB_INT_VBUSTI);
+}
+
+void USB_SimHost_Suspend(void)
+{
+	USB_INT_Set(USB_INT_SUSPI);
+}
+
+void USB_SimHost_Resume(void)
+{
+	USB_INT_Set(USB_INT_WAKEUPI);
+}
+
+void USB_SimHost_StartOfFrame(void)
+{
+	USB_Device_FrameNumber = ((USB_Device_FrameNumber + 1) & 0x07FF);
+	USB_SimHost_Statistics.Frames++;
+
+	USB_INT_Set(USB_INT_SOFI);
+}
+
+uint8_t USB_SimHost_ControlTransfer(const USB_Request_Header_t* const Request,
+                                    void* const Buffer,
+                                    uint16_t* const BytesTransferred)
+{
+	Endpoint_FIFO_t* OUTFIFO   = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT;
+	Endpoint_FIFO_t* INFIFO    = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].IN;
+	uint8_t*         DataPtr   = (uint8_t*)Buffer;
+	uint16_t         Remaining = Request->wLength;
+	uint16_t         PacketLength;
+	uint8_t          ErrorCode;
+	uint32_t         StartTime = USB_SimHost_GetTimeMS();
+
+	if (BytesTransferred != NULL)
+	  *BytesTransferred = 0;
+
+	/* SETUP stage - a SETUP token always clears any stall and flushes the control endpoint banks */
+	OUTFIFO->Stalled = false;
+	INFIFO->Stalled  = false;
+	Endpoint_ResetEndpoint(ENDPOINT_CONTROLEP | ENDPOINT_DIR_OUT);
+	Endpoint_ResetEndpoint(ENDPOINT_CONTROLEP | ENDPOINT_DIR_IN);
+
+	memcpy(OUTFIFO->Data[0], Request, sizeof(USB_Request_Header_t));
+	OUTFIFO->Length[0] = sizeof(USB_Request_Header_t);
+	__atomic_store_n(&OUTFIFO->BusyBanks, 1, __ATOMIC_RELEASE);
+	USB_INT_Set(USB_INT_RXSTPI);
+	Endpoint_RaiseEndpointInterrupts();
+
+	while (USB_INT_HasOccurred(USB_INT_RXSTPI))
+	{
+		if (USB_DeviceState == DEVICE_STATE_Unattached)
+		  return USB_SIMHOST_DeviceDisconnected;
+		else if (!(USB_SimHost_Poll(StartTime)))
+		  return USB_SIMHOST_Timeout;
+	}
+
+	/* Data stage */
+	if (Request->bmRequestType & REQDIR_DEVICETOHOST)
+	{
+		while (Remaining)
+		{
+			uint8_t PacketBuffer[ENDPOINT_MAX_BANK_SIZE];
+
+			if ((ErrorCode = USB_SimHost_ReceivePacket(INFIFO, PacketBuffer, &PacketLength)) != USB_SIMHOST_Successful)
+			  return ErrorCode;
+
+			if (PacketLength > Remaining)
+			  PacketLength = Remaining;
+
+			memcpy(DataPtr, PacketBuffer, PacketLength);
+			DataPtr   += PacketLength;
+			Remaining -= PacketLength;
+
+			if (PacketLength < INFIFO->Size)
+			  break;
+		}
+	}
+	else
+	{
+		while (Remaining)
+		{
+			PacketLength = MIN(Remaining, OUTFIFO->Size);
+
+			if ((ErrorCode = USB_SimHost_SendPacket(OUTFIFO, DataPtr, PacketLength)) != USB_SIMHOST_Successful)
+			  return ErrorCode;
+
+			DataPtr   += PacketLength;
+			Remaining -= PacketLength;
+		}
+	}
+
+	if (BytesTransferred != NULL)
+	  *BytesTransferred = (Request->wLength - Remaining);
+
+	/* Status stage - a Zero Length Packet in the opposite direction to the data stage */
+	if (Request->bmRequestType & REQDIR_DEVICETOHOST)
+	{
+		if ((ErrorCode = USB_SimHost_SendPacket(OUTFIFO, NULL, 0)) != USB_SIMHOST_Successful)
+		  return ErrorCode;
+
+		StartTime = USB_SimHost_GetTimeMS();
+
+		while (__atomic_load_n(&OUTFIFO->BusyBanks, __ATOMIC_ACQUIRE))
+		{
+			if (USB_DeviceState == DEVICE_STATE_Unattached)
+			  return USB_SIMHOST_DeviceDisconnected;
+			else if (!(USB_SimHost_Poll(StartTime)))
+			  return USB_SIMHOST_Timeout;
+		}
+	}
+	else
+	{
+		uint8_t PacketBuffer[ENDPOINT_MAX_BANK_SIZE];
+
+		if ((ErrorCode = USB_SimHost_ReceivePacket(INFIFO, PacketBuffer, &PacketLength)) != USB_SIMHOST_Successful)
+		  return ErrorCode;
+	}
+
+	return USB_SIMHOST_Successful;
+}
+
+uint8_t USB_SimHost_Enumerate(const uint8_t ConfigNumber)
+{
+	USB_Descriptor_Device_t DeviceDescriptor;
+	uint8_t                 ErrorCode;
+
+	if ((ErrorCode = USB_SimHost_Attach()) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_Request_Header_t GetDeviceDescriptor =
+		{
+			.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_GetDescriptor,
+			.wValue        = (DTYPE_Device << 8),
+			.wIndex        = 0,
+			.wLength       = 8,
+		};
+
+	if ((ErrorCode = USB_SimHost_ControlTransfer(&GetDeviceDescriptor, &DeviceDescriptor, NULL)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_Request_Header_t SetAddress =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_SetAddress,
+			.wValue        = USB_SIMHOST_DEVICE_ADDRESS,
+			.wIndex        = 0,
+			.wLength       = 0,
+		};
+
+	if ((ErrorCode = USB_SimHost_ControlTransfer(&SetAddress, NULL, NULL)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	if ((ErrorCode = USB_SimHost_WaitForDeviceState(DEVICE_STATE_Addressed)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	GetDeviceDescriptor.wLength = sizeof(USB_Descriptor_Device_t);
+
+	if ((ErrorCode = USB_SimHost_ControlTransfer(&GetDeviceDescriptor, &DeviceDescriptor, NULL)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_Request_Header_t SetConfiguration =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_SetConfiguration,
+			.wValue        = ConfigNumber,
+			.wIndex        = 0,
+			.wLength       = 0,
+		};
+
+	if ((ErrorCode = USB_SimHost_ControlTransfer(&SetConfiguration, NULL, NULL)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	return USB_SimHost_WaitForDeviceState(DEVICE_STATE_Configured);
+}
+
+uint8_t USB_SimHost_WriteOUT(const uint8_t Address,
+                             const void* const Buffer,
+                             const uint16_t Length)
+{
+	Endpoint_FIFO_t* FIFO = USB_SimHost_GetFIFO(Address & ~ENDPOINT_DIR_IN);
+	uint8_t          ErrorCode;
+
+	if (!(FIFO->Configured))
+	  return USB_SIMHOST_EndpointNotReady;
+
+	if ((ErrorCode = USB_SimHost_SendPacket(FIFO, Buffer, Length)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_SimHost_Statistics.PacketsOUT++;
+	USB_SimHost_Statistics.BytesOUT += Length;
+
+	return USB_SIMHOST_Successful;
+}
+
+uint8_t USB_SimHost_ReadIN(const uint8_t Address,
+                           void* const Buffer,
+                           uint16_t* const Length)
+{
+	Endpoint_FIFO_t* FIFO = USB_SimHost_GetFIFO(Address | ENDPOINT_DIR_IN);
+	uint8_t          ErrorCode;
+
+	if (!(FIFO->Configured))
+	  return USB_SIMHOST_EndpointNotReady;
+
+	if ((ErrorCode = USB_SimHost_ReceivePacket(FIFO, Buffer, Length)) != USB_SIMHOST_Successful)
+	  return ErrorCode;
+
+	USB_SimHost_Statistics.PacketsIN++;
+	USB_SimHost_Statistics.BytesIN += *Length;
+
+	return USB_SIMHOST_Successful;
+}
+
+#endif
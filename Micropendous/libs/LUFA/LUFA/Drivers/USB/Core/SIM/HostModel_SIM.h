@@ -0,0 +1,212 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Simulated USB host bus model for the simulated USB controller.
+ *  \copydetails Group_USBManagement_SIMHost
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USBManagement
+ *  \defgroup Group_USBManagement_SIMHost Simulated USB Host (SIM)
+ *  \brief Simulated USB host bus model for the simulated USB controller.
+ *
+ *  The simulated USB controller architecture runs the unmodified LUFA device stack and application code as a
+ *  normal host process. A second thread acts as the USB host, driving the device through bus events (VBUS,
+ *  bus reset, suspend, resume and Start of Frame) and moving packets into and out of the simulated endpoint
+ *  banks exactly as the USB SIE of a real controller would.
+ *
+ *  The host thread executes \ref CALLBACK_USB_SimHost_Task(), which may be overridden by the application to
+ *  script a test or benchmark session against the device. The default implementation attaches the device,
+ *  enumerates it into its first configuration and then issues Start of Frame events once every millisecond.
+ *
+ *  All functions in this module must only be called from the simulated host thread. While any of them are
+ *  waiting on the device, Start of Frame events are generated automatically once every millisecond of wall
+ *  clock time so that the device's frame based timeouts continue to advance.
+ *
+ *  @{
+ */
+
+#ifndef __USBHOSTMODEL_SIM_H__
+#define __USBHOSTMODEL_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "../StdRequestType.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(USB_SIMHOST_TIMEOUT_MS) || defined(__DOXYGEN__)
+				/** Maximum wall clock time in milliseconds that the simulated host will wait for the device to
+				 *  respond to a bus event or transaction before aborting it with \ref USB_SIMHOST_Timeout.
+				 *
+				 *  This value may be overridden in the user project makefile as the value of the
+				 *  \ref USB_SIMHOST_TIMEOUT_MS token, and passed to the compiler using the -D switch.
+				 */
+				#define USB_SIMHOST_TIMEOUT_MS      1000
+			#endif
+
+			/** Address the simulated host assigns to the device during \ref USB_SimHost_Enumerate(). */
+			#define USB_SIMHOST_DEVICE_ADDRESS      1
+
+		/* Enums: */
+			/** Enum for the possible error return codes of the simulated host transaction functions. */
+			enum USB_SimHost_ErrorCodes_t
+			{
+				USB_SIMHOST_Successful          = 0, /**< Transaction completed successfully. */
+				USB_SIMHOST_Timeout             = 1, /**< Device did not respond within \ref USB_SIMHOST_TIMEOUT_MS. */
+				USB_SIMHOST_EndpointStalled     = 2, /**< Device stalled the addressed endpoint. */
+				USB_SIMHOST_DeviceDisconnected  = 3, /**< Device detached from the bus during the transaction. */
+				USB_SIMHOST_EndpointNotReady    = 4, /**< Addressed endpoint is not configured in the device. */
+				USB_SIMHOST_BadLength           = 5, /**< Packet length exceeds the addressed endpoint's bank size. */
+			};
+
+		/* Type Defines: */
+			/** Type define for the running transfer statistics of the simulated host, used to benchmark the
+			 *  device's data path.
+			 */
+			typedef struct
+			{
+				uint32_t PacketsOUT; /**< Number of non-SETUP packets sent to the device. */
+				uint32_t PacketsIN; /**< Number of packets received from the device. */
+				uint32_t BytesOUT; /**< Number of data bytes sent to the device in non-SETUP packets. */
+				uint32_t BytesIN; /**< Number of data bytes received from the device. */
+				uint32_t Frames; /**< Number of Start of Frame events issued to the device. */
+			} USB_SimHost_Statistics_t;
+
+		/* Global Variables: */
+			/** Running transfer statistics of the simulated host. This may be reset to zero at any time by the
+			 *  host thread to start a new measurement interval.
+			 */
+			extern USB_SimHost_Statistics_t USB_SimHost_Statistics;
+
+		/* Function Prototypes: */
+			/** Callback executed in the simulated host thread once the device has been initialized via \ref USB_Init().
+			 *  This is the entry point of the simulated host; when it returns the host thread terminates and the
+			 *  device is left in its last bus state.
+			 *
+			 *  \note This callback is weakly defined; the default implementation attaches and enumerates the device and
+			 *        then generates Start of Frame events forever. Applications may override it to script a session.
+			 */
+			void CALLBACK_USB_SimHost_Task(void);
+
+			/** Applies VBUS power to the device and issues a bus reset once the device has attached to the bus.
+			 *
+			 *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+			 */
+			uint8_t USB_SimHost_Attach(void);
+
+			/** Removes VBUS power from the device. */
+			void USB_SimHost_Detach(void);
+
+			/** Signals a bus suspend condition to the device. */
+			void USB_SimHost_Suspend(void);
+
+			/** Signals a bus resume condition to the device after a prior call to \ref USB_SimHost_Suspend(). */
+			void USB_SimHost_Resume(void);
+
+			/** Issues a single Start of Frame event to the device, advancing its frame number. */
+			void USB_SimHost_StartOfFrame(void);
+
+			/** Performs a complete control transfer on the device's default control endpoint, including the SETUP,
+			 *  optional data and status stages.
+			 *
+			 *  \param[in]     Request           Pointer to the request header to send in the SETUP stage.
+			 *  \param[in,out] Buffer            Buffer for the data stage, at least \c wLength bytes in size, or \c NULL
+			 *                                   if the request has no data stage.
+			 *  \param[out]    BytesTransferred  Location where the number of data stage bytes transferred is to be stored,
+			 *                                   or \c NULL if not required.
+			 *
+			 *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+			 */
+			uint8_t USB_SimHost_ControlTransfer(const USB_Request_Header_t* const Request,
+			                                    void* const Buffer,
+			                                    uint16_t* const BytesTransferred);
+
+			/** Attaches the device and enumerates it into the given configuration, assigning it the address
+			 *  \ref USB_SIMHOST_DEVICE_ADDRESS.
+			 *
+			 *  \param[in] ConfigNumber  Configuration number to select via a SET CONFIGURATION request.
+			 *
+			 *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+			 */
+			uint8_t USB_SimHost_Enumerate(const uint8_t ConfigNumber);
+
+			/** Sends a single OUT packet to the given device endpoint, waiting for a free bank if required.
+			 *
+			 *  \param[in] Address  Address of the OUT endpoint to send to.
+			 *  \param[in] Buffer   Pointer to the packet data.
+			 *  \param[in] Length   Length of the packet in bytes, zero for a Zero Length Packet.
+			 *
+			 *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+			 */
+			uint8_t USB_SimHost_WriteOUT(const uint8_t Address,
+			                             const void* const Buffer,
+			                             const uint16_t Length);
+
+			/** Receives a single IN packet from the given device endpoint, waiting for the device to commit one.
+			 *
+			 *  \param[in]  Address  Address of the IN endpoint to read from.
+			 *  \param[out] Buffer   Buffer for the packet data, at least \ref ENDPOINT_MAX_BANK_SIZE bytes in size.
+			 *  \param[out] Length   Location where the received packet's length is to be stored.
+			 *
+			 *  \return A value from the \ref USB_SimHost_ErrorCodes_t enum.
+			 */
+			uint8_t USB_SimHost_ReadIN(const uint8_t Address,
+			                           void* const Buffer,
+			                           uint16_t* const Length);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			void USB_SimHost_Start(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -0,0 +1,143 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB Controller Interrupt definitions for the simulated USB controller.
+ *
+ *  This file contains definitions required for the correct handling of low level USB service routine interrupts
+ *  from the simulated USB controller.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+#ifndef __USBINTERRUPT_SIM_H__
+#define __USBINTERRUPT_SIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Enums: */
+			enum USB_Interrupts_t
+			{
+				USB_INT_VBUSTI  = 0,
+				USB_INT_WAKEUPI = 2,
+				USB_INT_SUSPI   = 3,
+				USB_INT_EORSTI  = 4,
+				USB_INT_SOFI    = 5,
+				USB_INT_RXSTPI  = 6,
+			};
+
+		/* External Variables: */
+			extern volatile uint8_t USB_INT_Flags;
+			extern volatile uint8_t USB_INT_Enables;
+
+		/* Inline Functions: */
+			static inline uint8_t USB_INT_GetVector(const uint8_t Interrupt) ATTR_ALWAYS_INLINE ATTR_CONST;
+			static inline uint8_t USB_INT_GetVector(const uint8_t Interrupt)
+			{
+				return (Interrupt == USB_INT_RXSTPI) ? SIM_INTC_VECTOR_USB_COM : SIM_INTC_VECTOR_USB_GEN;
+			}
+
+			static inline bool USB_INT_IsEnabled(const uint8_t Interrupt) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline bool USB_INT_IsEnabled(const uint8_t Interrupt)
+			{
+				return ((USB_INT_Enables & (1 << Interrupt)) ? true : false);
+			}
+
+			static inline bool USB_INT_HasOccurred(const uint8_t Interrupt) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline bool USB_INT_HasOccurred(const uint8_t Interrupt)
+			{
+				return ((__atomic_load_n(&USB_INT_Flags, __ATOMIC_ACQUIRE) & (1 << Interrupt)) ? true : false);
+			}
+
+			static inline void USB_INT_Enable(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Enable(const uint8_t Interrupt)
+			{
+				USB_INT_Enables |= (1 << Interrupt);
+
+				/* Interrupts are level triggered; enabling an interrupt whose flag is already set fires it */
+				if (USB_INT_HasOccurred(Interrupt))
+				  SIM_INTC_RaiseInterrupt(USB_INT_GetVector(Interrupt));
+			}
+
+			static inline void USB_INT_Disable(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Disable(const uint8_t Interrupt)
+			{
+				USB_INT_Enables &= ~(1 << Interrupt);
+			}
+
+			static inline void USB_INT_Clear(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Clear(const uint8_t Interrupt)
+			{
+				__atomic_and_fetch(&USB_INT_Flags, (uint8_t)~(1 << Interrupt), __ATOMIC_RELEASE);
+			}
+
+			static inline void USB_INT_Set(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Set(const uint8_t Interrupt)
+			{
+				__atomic_or_fetch(&USB_INT_Flags, (1 << Interrupt), __ATOMIC_RELEASE);
+
+				if (USB_INT_IsEnabled(Interrupt))
+				  SIM_INTC_RaiseInterrupt(USB_INT_GetVector(Interrupt));
+			}
+
+		/* Includes: */
+			#include "../USBMode.h"
+			#include "../Events.h"
+			#include "../USBController.h"
+
+		/* Function Prototypes: */
+			void USB_INT_ClearAllInterrupts(void);
+			void USB_INT_DisableAllInterrupts(void);
+
+			void USB_GEN_vect(void);
+			void USB_COM_vect(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
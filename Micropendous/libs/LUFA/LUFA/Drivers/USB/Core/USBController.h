@@ -138,6 +138,8 @@
 			#include "UC3/USBController_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/USBController_XMEGA.h"
+		#elif (ARCH == ARCH_SIM)
+			#include "SIM/USBController_SIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
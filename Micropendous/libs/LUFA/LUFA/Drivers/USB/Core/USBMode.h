@@ -245,6 +245,8 @@
 			#elif (defined(__AVR_ATxmega16C4__) || defined(__AVR_ATxmega32C4__))
 				#define USB_SERIES_C4_XMEGA
 				#define USB_CAN_BE_DEVICE
+			#elif (ARCH == ARCH_SIM)
+				#define USB_CAN_BE_DEVICE
 			#endif
 
 			#if (defined(USB_HOST_ONLY) && defined(USB_DEVICE_ONLY))
@@ -0,0 +1,144 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../Common/Common.h"
+#if (ARCH == ARCH_SIM)
+
+#include "HostEmulation.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+
+volatile uint8_t  SIM_GlobalInterruptFlag;
+volatile uint32_t SIM_PendingInterrupts;
+
+/** Interrupt vector table, containing the ISR to call for each emulated interrupt vector */
+static SIM_InterruptHandlerPtr_t SIM_InterruptHandlers[SIM_INTC_TOTAL_VECTORS];
+
+/** Host thread running the simulated processor's application code, to which all interrupts are delivered */
+static pthread_t SIM_ApplicationThread;
+
+/** Indicates if the emulated interrupt controller has been bound to the application thread */
+static volatile bool SIM_INTC_IsInitialized;
+
+static void SIM_INTC_SignalHandler(int Signal)
+{
+	int PreviousErrno = errno;
+
+	(void)Signal;
+	SIM_INTC_DispatchPending();
+
+	errno = PreviousErrno;
+}
+
+void SIM_INTC_RegisterHandler(const uint8_t Vector,
+                              const SIM_InterruptHandlerPtr_t Handler)
+{
+	if (!(SIM_INTC_IsInitialized))
+	{
+		struct sigaction InterruptAction;
+
+		memset(&InterruptAction, 0, sizeof(InterruptAction));
+		InterruptAction.sa_handler = SIM_INTC_SignalHandler;
+		InterruptAction.sa_flags   = SA_RESTART;
+		sigemptyset(&InterruptAction.sa_mask);
+		sigaction(SIGUSR1, &InterruptAction, NULL);
+
+		SIM_ApplicationThread  = pthread_self();
+		SIM_INTC_IsInitialized = true;
+	}
+
+	SIM_InterruptHandlers[Vector] = Handler;
+}
+
+void SIM_INTC_RaiseInterrupt(const uint8_t Vector)
+{
+	__atomic_or_fetch(&SIM_PendingInterrupts, (1UL << Vector), __ATOMIC_RELEASE);
+
+	if (!(SIM_INTC_IsInitialized))
+	  return;
+
+	/* Signal the application thread even when raised from it, so that the interrupt is held off while the
+	 * thread blocks signals for an RTOS critical section; otherwise it is taken before pthread_kill() returns */
+	pthread_kill(SIM_ApplicationThread, SIGUSR1);
+}
+
+void SIM_INTC_DispatchPending(void)
+{
+	sigset_t AllSignals;
+	sigset_t PreviousSignals;
+
+	if (!(SIM_GlobalInterruptFlag && SIM_PendingInterrupts))
+	  return;
+
+	/* Hold off any other signal driven code on the application thread - such as an RTOS tick - while
+	 * the handlers run, as the processor would not take another interrupt until the ISR completes */
+	sigfillset(&AllSignals);
+	pthread_sigmask(SIG_BLOCK, &AllSignals, &PreviousSignals);
+
+	while (SIM_GlobalInterruptFlag && SIM_PendingInterrupts)
+	{
+		/* Emulate the processor clearing the global interrupt flag on entry to an ISR */
+		SIM_GlobalInterruptFlag = 0;
+
+		uint32_t Pending = __atomic_exchange_n(&SIM_PendingInterrupts, 0, __ATOMIC_ACQUIRE);
+
+		for (uint8_t Vector = 0; Pending; Vector++, Pending >>= 1)
+		{
+			if ((Pending & 0x01) && SIM_InterruptHandlers[Vector])
+			  SIM_InterruptHandlers[Vector]();
+		}
+
+		/* Emulate the RETI instruction re-enabling global interrupts */
+		SIM_GlobalInterruptFlag = 1;
+	}
+
+	pthread_sigmask(SIG_SETMASK, &PreviousSignals, NULL);
+}
+
+void SIM_Delay_MS(const uint16_t Milliseconds)
+{
+	struct timespec Delay =
+		{
+			.tv_sec  = (Milliseconds / 1000),
+			.tv_nsec = ((long)(Milliseconds % 1000) * 1000000L),
+		};
+
+	while (nanosleep(&Delay, &Delay) && (errno == EINTR));
+}
+
+void SIM_YieldToBus(void)
+{
+	sched_yield();
+}
+
+#endif
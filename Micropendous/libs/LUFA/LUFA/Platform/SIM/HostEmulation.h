@@ -0,0 +1,236 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2013.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2013  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Host Emulation Layer for the simulated USB controller architecture.
+ *
+ *  Host emulation layer for the \c ARCH_SIM architecture, providing the minimal set of AVR-LIBC style services
+ *  (program and EEPROM memory access, interrupt handling and timing) required to build the library and its
+ *  applications natively on a POSIX host.
+ */
+
+/** \ingroup Group_PlatformDrivers_SIM
+ *  \defgroup Group_PlatformDrivers_SIMHostEmulation Host Emulation Layer - LUFA/Platform/SIM/HostEmulation.h
+ *  \brief Host Emulation Layer for the simulated USB controller architecture.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Platform/SIM/HostEmulation.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
+ *
+ *  \section Sec_ModDescription Module Description
+ *  Host emulation layer for the \c ARCH_SIM architecture. On the simulated target there is only a single flat
+ *  address space, so the FLASH and EEPROM access macros resolve to plain memory accesses, and a simple emulated
+ *  interrupt controller is provided to deliver peripheral interrupts (raised from other host threads, such as the
+ *  simulated USB host) to the application thread with the same preemption and masking semantics as the AVR8 core.
+ *
+ *  Interrupts are delivered to the application thread via the \c SIGUSR1 POSIX signal, and are deferred while the
+ *  emulated global interrupt flag is cleared. Interrupt handlers therefore run on the application thread's stack,
+ *  preempting the main program at arbitrary points exactly as they would on the real hardware.
+ *
+ *  Usage Example:
+ *  \code
+ *		#include <LUFA/Common/Common.h>
+ *
+ *		ISR(Timer_Handler)
+ *		{
+ *			// Timer handler code here
+ *		}
+ *
+ *		void main(void)
+ *		{
+ *			SIM_INTC_RegisterHandler(SIM_INTC_VECTOR_USER, Timer_Handler);
+ *			GlobalInterruptEnable();
+ *		}
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef _SIM_HOST_EMULATION_H_
+#define _SIM_HOST_EMULATION_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdbool.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <string.h>
+		#include <math.h>
+		#include <time.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** \name Program Memory Emulation */
+			//@{
+			#define PROGMEM
+			#define PSTR(String)                  (String)
+			#define pgm_read_byte(Address)        (*(const uint8_t*)(Address))
+			#define pgm_read_word(Address)        (*(const uint16_t*)(Address))
+			#define pgm_read_dword(Address)       (*(const uint32_t*)(Address))
+			#define pgm_read_ptr(Address)         (*(void* const*)(Address))
+			#define memcpy_P(...)                 memcpy(__VA_ARGS__)
+			#define memcmp_P(...)                 memcmp(__VA_ARGS__)
+			#define strlen_P(...)                 strlen(__VA_ARGS__)
+			#define strcpy_P(...)                 strcpy(__VA_ARGS__)
+			#define strncpy_P(...)                strncpy(__VA_ARGS__)
+			#define strcmp_P(...)                 strcmp(__VA_ARGS__)
+			#define strncmp_P(...)                strncmp(__VA_ARGS__)
+			#define printf_P(...)                 printf(__VA_ARGS__)
+			#define fprintf_P(...)                fprintf(__VA_ARGS__)
+			#define sprintf_P(...)                sprintf(__VA_ARGS__)
+			#define snprintf_P(...)               snprintf(__VA_ARGS__)
+			#define fputs_P(...)                  fputs(__VA_ARGS__)
+			#define puts_P(...)                   puts(__VA_ARGS__)
+			//@}
+
+			/** \name EEPROM Memory Emulation */
+			//@{
+			#define EEMEM
+			#define eeprom_read_byte(Address)            (*(const uint8_t*)(Address))
+			#define eeprom_read_word(Address)            (*(const uint16_t*)(Address))
+			#define eeprom_read_dword(Address)           (*(const uint32_t*)(Address))
+			#define eeprom_read_block(Dest, Source, Len) memcpy((Dest), (Source), (Len))
+			#define eeprom_write_byte(Address, Value)    (*(uint8_t*)(Address)  = (Value))
+			#define eeprom_write_word(Address, Value)    (*(uint16_t*)(Address) = (Value))
+			#define eeprom_write_dword(Address, Value)   (*(uint32_t*)(Address) = (Value))
+			#define eeprom_write_block(Source, Dest, Len) memcpy((Dest), (Source), (Len))
+			#define eeprom_update_byte(Address, Value)   eeprom_write_byte(Address, Value)
+			#define eeprom_update_word(Address, Value)   eeprom_write_word(Address, Value)
+			#define eeprom_update_dword(Address, Value)  eeprom_write_dword(Address, Value)
+			#define eeprom_update_block(Source, Dest, Len) eeprom_write_block(Source, Dest, Len)
+			//@}
+
+			/** Total number of interrupt vectors supported by the emulated interrupt controller. */
+			#define SIM_INTC_TOTAL_VECTORS        8
+
+			/** \name Emulated Interrupt Vectors */
+			//@{
+			/** Vector number of the simulated USB controller's general (bus event) interrupt. */
+			#define SIM_INTC_VECTOR_USB_GEN       0
+
+			/** Vector number of the simulated USB controller's endpoint (communication) interrupt. */
+			#define SIM_INTC_VECTOR_USB_COM       1
+
+			/** First vector number free for use by the user application. */
+			#define SIM_INTC_VECTOR_USER          4
+			//@}
+
+			/** Macro for the definition of interrupt service routines on the simulated architecture. As interrupts are
+			 *  dispatched by the emulated interrupt controller, ISRs are ordinary functions which must be registered via
+			 *  \ref SIM_INTC_RegisterHandler() before they will be called; any AVR-GCC ISR attributes are discarded.
+			 *
+			 *  \param[in] Name  Unique name of the interrupt service routine.
+			 */
+			#define ISR(Name, ...)                void Name (void)
+
+		/* Type Defines: */
+			/** Type define for an emulated interrupt handler function pointer. */
+			typedef void (*SIM_InterruptHandlerPtr_t)(void);
+
+		/* External Variables: */
+			/** Emulated global interrupt enable flag of the simulated processor. This should be manipulated through the
+			 *  standard \ref GlobalInterruptEnable() and related functions rather than directly.
+			 */
+			extern volatile uint8_t  SIM_GlobalInterruptFlag;
+
+			/** Mask of emulated interrupt vectors currently awaiting dispatch, one bit per vector. */
+			extern volatile uint32_t SIM_PendingInterrupts;
+
+		/* Function Prototypes: */
+			/** Registers a handler for the given emulated interrupt vector. The first thread to register a handler
+			 *  becomes the simulated processor's application thread, to which all interrupts are subsequently delivered.
+			 *
+			 *  \param[in] Vector   Interrupt vector number to register, a \c SIM_INTC_VECTOR_* value.
+			 *  \param[in] Handler  Address of the ISR handler for the vector.
+			 */
+			void SIM_INTC_RegisterHandler(const uint8_t Vector,
+			                              const SIM_InterruptHandlerPtr_t Handler);
+
+			/** Raises the given emulated interrupt vector. This may be called from any host thread; if called from a
+			 *  thread other than the application thread the application is preempted via a signal, otherwise the
+			 *  interrupt is dispatched immediately if the global interrupt flag is set.
+			 *
+			 *  \param[in] Vector  Interrupt vector number to raise, a \c SIM_INTC_VECTOR_* value.
+			 */
+			void SIM_INTC_RaiseInterrupt(const uint8_t Vector);
+
+			/** Dispatches all pending interrupts to their registered handlers, if global interrupts are enabled. This
+			 *  is called automatically when the global interrupt flag is set.
+			 */
+			void SIM_INTC_DispatchPending(void);
+
+			/** Blocks the calling thread for at least the specified number of milliseconds, resuming after any
+			 *  interrupt handlers which fire in the meantime.
+			 *
+			 *  \param[in] Milliseconds  Number of milliseconds to delay.
+			 */
+			void SIM_Delay_MS(const uint16_t Milliseconds);
+
+			/** Relinquishes the host processor to the simulated USB host, so that it may progress bus transactions
+			 *  while the application busy-waits on a controller status flag. On a real target the USB controller
+			 *  runs concurrently with the processor; on a host with few processor cores the simulated bus would
+			 *  otherwise only advance once the application's time slice expired.
+			 */
+			void SIM_YieldToBus(void);
+
+		/* Inline Functions: */
+			/** Retrieves the current value of the host processor's free-running cycle counter, for the
+			 *  measurement of code execution costs on the simulated target. Where no cycle counter is available,
+			 *  a nanosecond resolution monotonic clock is used instead.
+			 *
+			 *  \return Current host cycle count.
+			 */
+			static inline uint64_t SIM_GetCycleCount(void) __attribute__ ((always_inline));
+			static inline uint64_t SIM_GetCycleCount(void)
+			{
+				#if defined(__x86_64__) || defined(__i386__)
+				return __builtin_ia32_rdtsc();
+				#else
+				struct timespec Now;
+
+				clock_gettime(CLOCK_MONOTONIC, &Now);
+				return (((uint64_t)Now.tv_sec * 1000000000ULL) + Now.tv_nsec);
+				#endif
+			}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -36,11 +36,17 @@
 
 #include "Benito.h"
 
+/** Circular buffer to hold data from the host before it is sent to the target via the serial port. */
+static RingBufferSPSC_t USBtoUSART_Buffer;
+
+/** Underlying data buffer for \ref USBtoUSART_Buffer, where the stored bytes are located. */
+static uint8_t          USBtoUSART_Buffer_Data[128];
+
 /** Circular buffer to hold data from the serial port before it is sent to the host. */
-static RingBuffer_t USARTtoUSB_Buffer;
+static RingBufferSPSC_t USARTtoUSB_Buffer;
 
 /** Underlying data buffer for \ref USARTtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t      USARTtoUSB_Buffer_Data[128];
+static uint8_t          USARTtoUSB_Buffer_Data[128];
 
 /** Pulse generation counters to keep track of the number of milliseconds remaining for each pulse type */
 volatile struct
@@ -51,9 +57,6 @@ volatile struct
 	uint8_t PingPongLEDPulse; /**< Milliseconds remaining for enumeration Tx/Rx ping-pong LED pulse */
 } PulseMSRemaining;
 
-/** Milliseconds remaining until the receive buffer is flushed to the USB host */
-uint8_t FlushPeriodRemaining = RECEIVE_BUFFER_FLUSH_MS;
-
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -81,6 +84,7 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 						.Size             = CDC_NOTIFICATION_EPSIZE,
 						.Banks            = 1,
 					},
+				.CoalesceFrames           = RECEIVE_BUFFER_FLUSH_MS,
 			},
 	};
 
@@ -91,21 +95,30 @@ int main(void)
 {
 	SetupHardware();
 
-	RingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
+	RingBufferSPSC_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
+	RingBufferSPSC_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
 
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
-		/* Echo bytes from the host to the target via the hardware USART */
-		if ((UCSR1A & (1 << UDRE1)) && CDC_Device_BytesReceived(&VirtualSerial_CDC_Interface))
+		/* Echo bytes from the host to the target via the hardware USART, drained by the data register empty ISR */
+		if (CDC_Device_ReceiveToRingBuffer(&VirtualSerial_CDC_Interface, &USBtoUSART_Buffer))
 		{
-			UDR1 = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
+			UCSR1B |= (1 << UDRIE1);
 
 			LEDs_TurnOnLEDs(LEDMASK_TX);
 			PulseMSRemaining.TxLEDPulse = TX_RX_LED_PULSE_MS;
 		}
 
+		/* Echo bytes from the target to the host via the virtual serial port - the CDC class driver sends each
+		 * packet once full, or once RECEIVE_BUFFER_FLUSH_MS USB frames have elapsed */
+		if (CDC_Device_SendFromRingBuffer(&VirtualSerial_CDC_Interface, &USARTtoUSB_Buffer))
+		{
+			LEDs_TurnOnLEDs(LEDMASK_RX);
+			PulseMSRemaining.RxLEDPulse = TX_RX_LED_PULSE_MS;
+		}
+
 		/* Check if the millisecond timer has elapsed */
 		if (TIFR0 & (1 << OCF0A))
 		{
@@ -133,34 +146,6 @@ int main(void)
 			/* Turn off RX LED(s) once the RX pulse period has elapsed */
 			if (PulseMSRemaining.RxLEDPulse && !(--PulseMSRemaining.RxLEDPulse))
 			  LEDs_TurnOffLEDs(LEDMASK_RX);
-
-			/* Check if the receive buffer flush period has expired */
-			uint16_t BufferCount = RingBuffer_GetCount(&USARTtoUSB_Buffer);
-			if (!(--FlushPeriodRemaining) || (BufferCount > 200))
-			{
-				FlushPeriodRemaining = RECEIVE_BUFFER_FLUSH_MS;
-
-				/* Start RX LED indicator pulse */
-				if (BufferCount)
-				{
-					LEDs_TurnOnLEDs(LEDMASK_RX);
-					PulseMSRemaining.RxLEDPulse = TX_RX_LED_PULSE_MS;
-				}
-
-				/* Echo bytes from the target to the host via the virtual serial port */
-				while (BufferCount--)
-				{
-					/* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-					if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-											RingBuffer_Peek(&USARTtoUSB_Buffer)) != ENDPOINT_READYWAIT_NoError)
-					{
-						break;
-					}
-
-					/* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-					RingBuffer_Remove(&USARTtoUSB_Buffer);
-				}
-			}
 		}
 
 		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
@@ -269,7 +254,7 @@ void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCI
 	/* Reconfigure the USART in double speed mode for a wider baud rate range at the expense of accuracy */
 	UCSR1C = ConfigMask;
 	UCSR1A = (1 << U2X1);
-	UCSR1B = ((1 << RXCIE1) | (1 << TXEN1) | (1 << RXEN1));
+	UCSR1B = ((1 << RXCIE1) | (1 << UDRIE1) | (1 << TXEN1) | (1 << RXEN1));
 }
 
 /** ISR to manage the reception of data from the serial port, placing received bytes into a circular buffer
@@ -279,8 +264,19 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 {
 	uint8_t ReceivedByte = UDR1;
 
-	if (USB_DeviceState == DEVICE_STATE_Configured)
-	  RingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+	if ((USB_DeviceState == DEVICE_STATE_Configured) && !(RingBufferSPSC_IsFull(&USARTtoUSB_Buffer)))
+	  RingBufferSPSC_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+}
+
+/** ISR to manage the transmission of data to the serial port, loading the next byte from the circular buffer
+ *  of data received from the host each time the USART data register becomes empty.
+ */
+ISR(USART1_UDRE_vect, ISR_BLOCK)
+{
+	if (RingBufferSPSC_IsEmpty(&USBtoUSART_Buffer))
+	  UCSR1B &= ~(1 << UDRIE1);
+	else
+	  UDR1 = RingBufferSPSC_Remove(&USBtoUSART_Buffer);
 }
 
 /** Event handler for the CDC Class driver Host-to-Device Line Encoding Changed event.
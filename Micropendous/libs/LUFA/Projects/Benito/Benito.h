@@ -46,7 +46,7 @@
 
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Peripheral/Serial.h>
-		#include <LUFA/Drivers/Misc/RingBuffer.h>
+		#include <LUFA/Drivers/Misc/RingBufferSPSC.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
@@ -44,5 +44,7 @@
 #define _APP_CONFIG_H_
 
 //	#define DUMMY_RTC
+	#define DISK_CACHE_SECTORS            4
+	#define DISK_READAHEAD_SECTORS        0
 
 #endif
\ No newline at end of file
@@ -66,6 +66,9 @@
 		 */
 		#define VIRTUAL_MEMORY_BLOCKS               (VIRTUAL_MEMORY_BYTES / VIRTUAL_MEMORY_BLOCK_SIZE)
 
+		/** Value of the buffered Dataflash page index when no page image is held in a Dataflash buffer. */
+		#define DATAFLASH_NO_BUFFERED_PAGE          0xFFFF
+
 	/* Function Prototypes: */
 		void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
 		                                  const uint32_t BlockAddress,
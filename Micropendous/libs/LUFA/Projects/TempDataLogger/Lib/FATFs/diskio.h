@@ -10,10 +10,21 @@ extern "C" {
 #endif
 
 #include "integer.h"
+#include "ff.h"
 
+#include "Config/AppConfig.h"
 #include "../DataflashManager.h"
 
 
+/* Sector cache configuration, see the project's Config/AppConfig.h */
+#ifndef DISK_CACHE_SECTORS
+#define DISK_CACHE_SECTORS		2	/* Number of sectors held in the sector cache */
+#endif
+#ifndef DISK_READAHEAD_SECTORS
+#define DISK_READAHEAD_SECTORS	0	/* Number of sectors prefetched after a sequential read */
+#endif
+
+
 /* Status of Disk Functions */
 typedef BYTE	DSTATUS;
 
@@ -47,6 +58,7 @@ DRESULT disk_ioctl (BYTE, BYTE, void*);
 
 /* Generic command */
 #define CTRL_SYNC			0	/* Mandatory for write functions */
+#define CTRL_INVALIDATE		50	/* Discard cached sectors after the media was changed through Mass Storage */
 
 #ifdef __cplusplus
 }
@@ -308,11 +308,21 @@ static bool SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* const MSInterfa
 		return false;
 	}
 
+	/* Write back sectors held by the FAT file system's sector cache, so that the host sees the current media contents */
+	disk_ioctl(0, CTRL_SYNC, NULL);
+
 	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	{
+		DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	}
 	else
-	  DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	{
+		DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+
+		/* Sectors cached by the FAT file system may have been overwritten by the host, and must be read again */
+		disk_ioctl(0, CTRL_INVALIDATE, NULL);
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
 	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
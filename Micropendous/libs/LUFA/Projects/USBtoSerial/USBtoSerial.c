@@ -37,16 +37,16 @@
 #include "USBtoSerial.h"
 
 /** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
-static RingBuffer_t USBtoUSART_Buffer;
+static RingBufferSPSC_t USBtoUSART_Buffer;
 
 /** Underlying data buffer for \ref USBtoUSART_Buffer, where the stored bytes are located. */
-static uint8_t      USBtoUSART_Buffer_Data[128];
+static uint8_t          USBtoUSART_Buffer_Data[128];
 
 /** Circular buffer to hold data from the serial port before it is sent to the host. */
-static RingBuffer_t USARTtoUSB_Buffer;
+static RingBufferSPSC_t USARTtoUSB_Buffer;
 
 /** Underlying data buffer for \ref USARTtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t      USARTtoUSB_Buffer_Data[128];
+static uint8_t          USARTtoUSB_Buffer_Data[128];
 
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
@@ -75,6 +75,7 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 						.Size                   = CDC_NOTIFICATION_EPSIZE,
 						.Banks                  = 1,
 					},
+				.CoalesceFrames                 = USART_FLUSH_FRAMES,
 			},
 	};
 
@@ -86,57 +87,23 @@ int main(void)
 {
 	SetupHardware();
 
-	RingBuffer_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
-	RingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
+	RingBufferSPSC_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
+	RingBufferSPSC_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
 
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
-		/* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-		if (!(RingBuffer_IsFull(&USBtoUSART_Buffer)))
-		{
-			int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
-
-			/* Read bytes from the USB OUT endpoint into the USART transmit buffer */
-			if (!(ReceivedByte < 0))
-			  RingBuffer_Insert(&USBtoUSART_Buffer, ReceivedByte);
-		}
-
-		/* Check if the UART receive buffer flush timer has expired or the buffer is nearly full */
-		uint16_t BufferCount = RingBuffer_GetCount(&USARTtoUSB_Buffer);
-		if (BufferCount)
-		{
-			Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
-
-			/* Check if a packet is already enqueued to the host - if so, we shouldn't try to send more data
-			 * until it completes as there is a chance nothing is listening and a lengthy timeout could occur */
-			if (Endpoint_IsINReady())
-			{
-				/* Never send more than one bank size less one byte to the host at a time, so that we don't block
-				 * while a Zero Length Packet (ZLP) to terminate the transfer is sent if the host isn't listening */
-				uint8_t BytesToSend = MIN(BufferCount, (CDC_TXRX_EPSIZE - 1));
-
-				/* Read bytes from the USART receive buffer into the USB IN endpoint */
-				while (BytesToSend--)
-				{
-					/* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-					if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-											RingBuffer_Peek(&USARTtoUSB_Buffer)) != ENDPOINT_READYWAIT_NoError)
-					{
-						break;
-					}
+		/* Move received data from the USB OUT endpoint bank into the USART transmit buffer as a block, and
+		 * start the USART data register empty ISR to drain it to the serial port */
+		if (CDC_Device_ReceiveToRingBuffer(&VirtualSerial_CDC_Interface, &USBtoUSART_Buffer))
+		  UCSR1B |= (1 << UDRIE1);
 
-					/* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-					RingBuffer_Remove(&USARTtoUSB_Buffer);
-				}
-			}
-		}
-
-		/* Load the next byte from the USART transmit buffer into the USART */
-		if (!(RingBuffer_IsEmpty(&USBtoUSART_Buffer)))
-		  Serial_SendByte(RingBuffer_Remove(&USBtoUSART_Buffer));
+		/* Move data from the USART receive buffer into the USB IN endpoint bank as a block - the CDC class driver
+		 * sends the bank once it is full, or once USART_FLUSH_FRAMES USB frames have elapsed, without blocking if
+		 * the host isn't listening */
+		CDC_Device_SendFromRingBuffer(&VirtualSerial_CDC_Interface, &USARTtoUSB_Buffer);
 
 		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
 		USB_USBTask();
@@ -193,8 +160,19 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 {
 	uint8_t ReceivedByte = UDR1;
 
-	if (USB_DeviceState == DEVICE_STATE_Configured)
-	  RingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+	if ((USB_DeviceState == DEVICE_STATE_Configured) && !(RingBufferSPSC_IsFull(&USARTtoUSB_Buffer)))
+	  RingBufferSPSC_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+}
+
+/** ISR to manage the transmission of data to the serial port, loading the next byte from the circular buffer
+ *  of data received from the host each time the USART data register becomes empty.
+ */
+ISR(USART1_UDRE_vect, ISR_BLOCK)
+{
+	if (RingBufferSPSC_IsEmpty(&USBtoUSART_Buffer))
+	  UCSR1B &= ~(1 << UDRIE1);
+	else
+	  UDR1 = RingBufferSPSC_Remove(&USBtoUSART_Buffer);
 }
 
 /** Event handler for the CDC Class driver Line Encoding Changed event.
@@ -242,6 +220,6 @@ void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCI
 	/* Reconfigure the USART in double speed mode for a wider baud rate range at the expense of accuracy */
 	UCSR1C = ConfigMask;
 	UCSR1A = (1 << U2X1);
-	UCSR1B = ((1 << RXCIE1) | (1 << TXEN1) | (1 << RXEN1));
+	UCSR1B = ((1 << RXCIE1) | (1 << UDRIE1) | (1 << TXEN1) | (1 << RXEN1));
 }
 
@@ -46,7 +46,7 @@
 
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Peripheral/Serial.h>
-		#include <LUFA/Drivers/Misc/RingBuffer.h>
+		#include <LUFA/Drivers/Misc/RingBufferSPSC.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
@@ -62,6 +62,11 @@
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
 
+		/** Maximum number of USB frames that data received from the USART is held back for, so that it can be
+		 *  coalesced into full packets to the host.
+		 */
+		#define USART_FLUSH_FRAMES       2
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
 
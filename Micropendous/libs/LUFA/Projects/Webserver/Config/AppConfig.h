@@ -47,6 +47,10 @@
 	#define ENABLE_DHCP_SERVER
 	#define ENABLE_TELNET_SERVER
 	#define MAX_URI_LENGTH                50
+	#define DISK_CACHE_SECTORS            3
+	#define DISK_READAHEAD_SECTORS        0
+	#define RNDIS_PACKETS_PER_TRANSFER    4
+	#define RNDIS_FRAME_QUEUE_SIZE        128
 
 	#define DEVICE_IP_ADDRESS             (uint8_t[]){ 10,   0,   0,   2}
 	#define DEVICE_NETMASK                (uint8_t[]){255, 255, 255,   0}
@@ -60,13 +64,14 @@
 	#define UIP_CONF_MAX_CONNECTIONS      3
 	#define UIP_CONF_MAX_LISTENPORTS      5
 	#define UIP_CONF_BUFFER_SIZE          1514
+	#define UIP_CONF_TCP_SEND_SEGMENTS    4
 	#define UIP_CONF_LL_802154            0
 	#define UIP_CONF_LL_80211             0
 	#define UIP_CONF_ROUTER               0
 	#define UIP_CONF_ICMP6                0
 	#define UIP_CONF_ICMP_DEST_UNREACH    1
 	#define UIP_URGDATA                   0
-	#define UIP_ARCH_CHKSUM               0
+	#define UIP_ARCH_CHKSUM               1
 	#define UIP_ARCH_ADD32                0
 	#define UIP_NEIGHBOR_CONF_ADDRTYPE    0
 
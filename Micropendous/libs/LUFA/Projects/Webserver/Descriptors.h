@@ -37,11 +37,13 @@
 #define _DESCRIPTORS_H_
 
 	/* Includes: */
-		#include <avr/pgmspace.h>
-
 		#include <LUFA/Drivers/USB/USB.h>
 
 		#include "Config/AppConfig.h"
+
+		#if (ARCH == ARCH_AVR8)
+			#include <avr/pgmspace.h>
+		#endif
 		
 	/* Macros: */
 		/** Endpoint address of the Mass Storage device-to-host data IN endpoint. */
@@ -37,14 +37,16 @@
 #define _DATAFLASH_MANAGER_H_
 
 	/* Includes: */
-		#include <avr/io.h>
-
 		#include "../Descriptors.h"
 
 		#include <LUFA/Common/Common.h>
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/Board/Dataflash.h>
 
+		#if (ARCH == ARCH_AVR8)
+			#include <avr/io.h>
+		#endif
+
 	/* Preprocessor Checks: */
 		#if (DATAFLASH_PAGE_SIZE % 16)
 			#error Dataflash page size must be a multiple of 16 bytes.
@@ -64,6 +66,9 @@
 		 */
 		#define VIRTUAL_MEMORY_BLOCKS               (VIRTUAL_MEMORY_BYTES / VIRTUAL_MEMORY_BLOCK_SIZE)
 
+		/** Value of the buffered Dataflash page index when no page image is held in a Dataflash buffer. */
+		#define DATAFLASH_NO_BUFFERED_PAGE          0xFFFF
+
 		/** Indicates if the disk is write protected or not. */
 		#define DISK_READ_ONLY                      false
 
@@ -5,8 +5,204 @@
 /* disk I/O modules and attach it to FatFs module with common interface. */
 /*-----------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "diskio.h"
 
+/*-----------------------------------------------------------------------*/
+/* Sector Cache                                                          */
+/*-----------------------------------------------------------------------*/
+/* Single sector accesses are served from a small write-back cache of    */
+/* DISK_CACHE_SECTORS sectors, evicted in least recently used order.     */
+/* Sectors of the FAT of the last mounted volume are pinned, and only    */
+/* evicted when every slot holds a FAT sector, so that cluster chain     */
+/* walks do not go back to the Dataflash. Written sectors are held until */
+/* evicted or until FatFs issues CTRL_SYNC, and sequential reads fetch   */
+/* the following DISK_READAHEAD_SECTORS sectors into any free slots.     */
+
+#if (DISK_CACHE_SECTORS < 1)
+	#error DISK_CACHE_SECTORS must be at least 1.
+#endif
+
+#define CACHE_NO_SECTOR		0xFFFFFFFF	/* Sector address of an unused slot */
+#define CACHE_NO_SLOT		0xFF		/* Slot index returned when a sector is not cached */
+
+static BYTE  CacheData[DISK_CACHE_SECTORS][_MAX_SS];	/* Cached sector contents */
+static DWORD CacheSector[DISK_CACHE_SECTORS];			/* Sector held in each slot, set up by disk_initialize() */
+static WORD  CacheLastUsed[DISK_CACHE_SECTORS];		/* Access tick each slot was last used on */
+static BYTE  CacheDirty[DISK_CACHE_SECTORS];			/* Non-zero for slots not yet written to the media */
+static WORD  CacheTicks;								/* Access counter for LRU ordering */
+static DWORD CacheFATStart;							/* First sector of the FAT region of the mounted volume */
+static DWORD CacheFATEnd;								/* Sector following the FAT region of the mounted volume */
+static DWORD CacheNextSector = CACHE_NO_SECTOR;		/* Sector that continues the last single sector read */
+
+static BYTE Cache_Find (
+	DWORD sector
+)
+{
+	for (BYTE Slot = 0; Slot < DISK_CACHE_SECTORS; Slot++)
+	{
+		if (CacheSector[Slot] == sector)
+		  return Slot;
+	}
+
+	return CACHE_NO_SLOT;
+}
+
+static BYTE Cache_IsPinned (
+	BYTE slot
+)
+{
+	return ((CacheSector[slot] >= CacheFATStart) && (CacheSector[slot] < CacheFATEnd));
+}
+
+static void Cache_Touch (
+	BYTE slot
+)
+{
+	CacheLastUsed[slot] = ++CacheTicks;
+}
+
+static void Cache_WriteBack (
+	BYTE slot
+)
+{
+	if (!(CacheDirty[slot]))
+	  return;
+
+	DataflashManager_WriteBlocks_RAM(CacheSector[slot], 1, CacheData[slot]);
+	CacheDirty[slot] = 0;
+}
+
+static void Cache_Flush (void)
+{
+	/* Write back in ascending sector order, so that both halves of a Dataflash page are written back to back */
+	for (;;)
+	{
+		BYTE Oldest = CACHE_NO_SLOT;
+
+		for (BYTE Slot = 0; Slot < DISK_CACHE_SECTORS; Slot++)
+		{
+			if (CacheDirty[Slot] && ((Oldest == CACHE_NO_SLOT) || (CacheSector[Slot] < CacheSector[Oldest])))
+			  Oldest = Slot;
+		}
+
+		if (Oldest == CACHE_NO_SLOT)
+		  break;
+
+		Cache_WriteBack(Oldest);
+	}
+}
+
+static void Cache_Invalidate (void)
+{
+	for (BYTE Slot = 0; Slot < DISK_CACHE_SECTORS; Slot++)
+	{
+		CacheSector[Slot] = CACHE_NO_SECTOR;
+		CacheDirty[Slot]  = 0;
+	}
+
+	CacheNextSector = CACHE_NO_SECTOR;
+}
+
+static BYTE Cache_SelectVictim (void)
+{
+	BYTE Victim       = CACHE_NO_SLOT;
+	BYTE VictimPinned = 1;
+	WORD VictimAge    = 0;
+
+	/* Prefer an unused slot, then the least recently used unpinned slot, then the least recently used slot */
+	for (BYTE Slot = 0; Slot < DISK_CACHE_SECTORS; Slot++)
+	{
+		if (CacheSector[Slot] == CACHE_NO_SECTOR)
+		  return Slot;
+
+		BYTE Pinned = Cache_IsPinned(Slot);
+		WORD Age    = (CacheTicks - CacheLastUsed[Slot]);
+
+		if ((Victim == CACHE_NO_SLOT) || (Pinned < VictimPinned) || ((Pinned == VictimPinned) && (Age > VictimAge)))
+		{
+			Victim       = Slot;
+			VictimPinned = Pinned;
+			VictimAge    = Age;
+		}
+	}
+
+	return Victim;
+}
+
+static BYTE Cache_Allocate (
+	DWORD sector
+)
+{
+	BYTE Slot = Cache_SelectVictim();
+
+	Cache_WriteBack(Slot);
+	CacheSector[Slot] = sector;
+	Cache_Touch(Slot);
+
+	return Slot;
+}
+
+static void Cache_CheckBootRecord (
+	DWORD sector,
+	const BYTE *data
+)
+{
+	/* Pin the FAT region of any FAT volume boot record read from the media, as detected by FatFs */
+	if (LD_WORD(&data[510]) != 0xAA55)
+	  return;
+
+	if (((LD_DWORD(&data[54]) & 0xFFFFFF) != 0x544146) && ((LD_DWORD(&data[82]) & 0xFFFFFF) != 0x544146))
+	  return;
+
+	DWORD FATSize = LD_WORD(&data[22]);
+
+	if (!(FATSize))
+	  FATSize = LD_DWORD(&data[36]);
+
+	CacheFATStart = (sector + LD_WORD(&data[14]));
+	CacheFATEnd   = (CacheFATStart + (FATSize * data[16]));
+}
+
+static BYTE Cache_Load (
+	DWORD sector
+)
+{
+	BYTE Slot = Cache_Allocate(sector);
+
+	DataflashManager_ReadBlocks_RAM(sector, 1, CacheData[Slot]);
+	Cache_CheckBootRecord(sector, CacheData[Slot]);
+
+	return Slot;
+}
+
+static void Cache_ReadAhead (
+	DWORD sector
+)
+{
+	WORD ReadTicks = 0;	/* Ticks elapsed since the sector being read was used */
+
+	for (BYTE Count = 0; Count < DISK_READAHEAD_SECTORS; Count++, sector++)
+	{
+		if ((sector >= VIRTUAL_MEMORY_BLOCKS) || (Cache_Find(sector) != CACHE_NO_SLOT))
+		  continue;
+
+		/* Only prefetch into slots which can be given up without a Dataflash write or losing a FAT sector, and
+		   never into the slots holding the sector being read or sectors prefetched alongside it */
+		BYTE Slot = Cache_SelectVictim();
+
+		if ((CacheSector[Slot] != CACHE_NO_SECTOR) && (CacheDirty[Slot] || Cache_IsPinned(Slot) ||
+		                                               ((WORD)(CacheTicks - CacheLastUsed[Slot]) <= ReadTicks)))
+		{
+			break;
+		}
+
+		Cache_Load(sector);
+		ReadTicks++;
+	}
+}
+
 /*-----------------------------------------------------------------------*/
 /* Initialize a Drive                                                    */
 
@@ -14,6 +210,11 @@ DSTATUS disk_initialize (
 	BYTE drv				/* Physical drive number (0..) */
 )
 {
+	/* Start from the media contents, the volume boot record is read again as the volume is mounted */
+	Cache_Flush();
+	Cache_Invalidate();
+	CacheFATStart = CacheFATEnd = 0;
+
 	return FR_OK;
 }
 
@@ -41,7 +242,51 @@ DRESULT disk_read (
 	BYTE count		/* Number of sectors to read (1..128) */
 )
 {
-	DataflashManager_ReadBlocks_RAM(sector, count, buff);
+	if (count == 1)
+	{
+		BYTE Slot = Cache_Find(sector);
+
+		if (Slot == CACHE_NO_SLOT)
+		{
+			Slot = Cache_Load(sector);
+
+			if (sector == CacheNextSector)
+			  Cache_ReadAhead(sector + 1);
+		}
+		else
+		{
+			Cache_Touch(Slot);
+		}
+
+		CacheNextSector = (sector + 1);
+
+		memcpy(buff, CacheData[Slot], _MAX_SS);
+		return RES_OK;
+	}
+
+	/* Multiple sector reads come from the Dataflash directly, except for any sectors already cached */
+	while (count)
+	{
+		BYTE Slot   = Cache_Find(sector);
+		BYTE Blocks = 1;
+
+		if (Slot != CACHE_NO_SLOT)
+		{
+			memcpy(buff, CacheData[Slot], _MAX_SS);
+		}
+		else
+		{
+			while ((Blocks < count) && (Cache_Find(sector + Blocks) == CACHE_NO_SLOT))
+			  Blocks++;
+
+			DataflashManager_ReadBlocks_RAM(sector, Blocks, buff);
+		}
+
+		buff   += ((WORD)Blocks * _MAX_SS);
+		sector += Blocks;
+		count  -= Blocks;
+	}
+
 	return RES_OK;
 }
 
@@ -58,8 +303,68 @@ DRESULT disk_write (
 	BYTE count			/* Number of sectors to write (1..128) */
 )
 {
-	DataflashManager_WriteBlocks_RAM(sector, count, buff);
+	while (count)
+	{
+		BYTE Slot   = Cache_Find(sector);
+		BYTE Blocks = 1;
+
+		if (Slot != CACHE_NO_SLOT)
+		{
+			/* Rewriting a sector with its current contents does not need a Dataflash page program */
+			if (memcmp(CacheData[Slot], buff, _MAX_SS))
+			{
+				memcpy(CacheData[Slot], buff, _MAX_SS);
+				CacheDirty[Slot] = 1;
+			}
+
+			Cache_Touch(Slot);
+		}
+		else if (count == 1)
+		{
+			/* Single sector writes are held in the cache, multiple sector writes only update sectors already cached */
+			Slot = Cache_Allocate(sector);
+
+			memcpy(CacheData[Slot], buff, _MAX_SS);
+			CacheDirty[Slot] = 1;
+		}
+		else
+		{
+			while ((Blocks < count) && (Cache_Find(sector + Blocks) == CACHE_NO_SLOT))
+			  Blocks++;
+
+			DataflashManager_WriteBlocks_RAM(sector, Blocks, buff);
+		}
+
+		buff   += ((WORD)Blocks * _MAX_SS);
+		sector += Blocks;
+		count  -= Blocks;
+	}
+
 	return RES_OK;
 }
 #endif /* _READONLY */
 
+
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+
+DRESULT disk_ioctl (
+	BYTE drv,		/* Physical drive number (0..) */
+	BYTE ctrl,		/* Control code */
+	void *buff		/* Buffer to send/receive control data */
+)
+{
+	switch (ctrl)
+	{
+		case CTRL_SYNC:
+			Cache_Flush();
+			return RES_OK;
+		case CTRL_INVALIDATE:
+			Cache_Invalidate();
+			return RES_OK;
+		default:
+			return RES_PARERR;
+	}
+}
+
@@ -42,10 +42,15 @@
  */
 const char PROGMEM HTTP200Header[] = "HTTP/1.1 200 OK\r\n"
                                      "Server: LUFA " LUFA_VERSION_STRING "\r\n"
-                                     "Connection: close\r\n"
                                      "MIME-version: 1.0\r\n"
                                      "Content-Type: ";
 
+/** HTTP server response header, for transmission when the client's cached copy of the requested page is still current. This
+ *  indicates to the host that the page contents are not being sent again.
+ */
+const char PROGMEM HTTP304Header[] = "HTTP/1.1 304 Not Modified\r\n"
+                                     "Server: LUFA " LUFA_VERSION_STRING "\r\n";
+
 /** HTTP server response header, for transmission before a resource not found error. This indicates to the host that the given
  *  URL is invalid, and gives extra error information.
  */
@@ -112,22 +117,21 @@ void HTTPServerApp_Callback(void)
 		AppState->HTTPServer.NextState     = WEBSERVER_STATE_OpenRequestedFile;
 		AppState->HTTPServer.FileOpen      = false;
 		AppState->HTTPServer.ACKedFilePos  = 0;
-		AppState->HTTPServer.SentChunkSize = 0;
+
+		/* Close the connection if the client does not send a request in time */
+		timer_set(&AppState->HTTPServer.IdleTimer, HTTP_KEEP_ALIVE_TIMEOUT);
+		uIPManagement_SetConnectionReadyAfter(uip_conn, HTTP_KEEP_ALIVE_TIMEOUT);
 	}
 
 	if (uip_acked())
 	{
 		/* Add the amount of ACKed file data to the total sent file bytes counter */
-		AppState->HTTPServer.ACKedFilePos += AppState->HTTPServer.SentChunkSize;
-
-		/* Progress to the next state once the current state's data has been ACKed */
-		AppState->HTTPServer.CurrentState = AppState->HTTPServer.NextState;
-	}
+		if (AppState->HTTPServer.CurrentState == WEBSERVER_STATE_SendData)
+		  AppState->HTTPServer.ACKedFilePos += uip_ackedlen();
 
-	if (uip_rexmit())
-	{
-		/* Return file pointer to the last ACKed position */
-		f_lseek(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.ACKedFilePos);
+		/* Progress to the next state once all of the current state's data has been ACKed */
+		if (!(uip_outstanding(uip_conn)))
+		  AppState->HTTPServer.CurrentState = AppState->HTTPServer.NextState;
 	}
 
 	if (uip_rexmit() || uip_acked() || uip_newdata() || uip_connected() || uip_poll())
@@ -156,30 +160,92 @@ void HTTPServerApp_Callback(void)
 				break;
 		}
 	}
+
+	/* Have the connection polled again while the current state has more to send without waiting for the client */
+	if ((AppState->HTTPServer.CurrentState == WEBSERVER_STATE_SendResponseHeader) ||
+	    (AppState->HTTPServer.CurrentState == WEBSERVER_STATE_Closing) ||
+	    ((AppState->HTTPServer.CurrentState == WEBSERVER_STATE_SendData) &&
+	     (AppState->HTTPServer.NextState    == WEBSERVER_STATE_SendData)))
+	{
+		uIPManagement_SetConnectionReady(uip_conn);
+	}
 }
 
 /** HTTP Server State handler for the Request Process state. This state manages the processing of incoming HTTP
- *  GET requests to the server from the receiving HTTP client.
+ *  GET requests to the server from the receiving HTTP client. Connections are kept open between requests when
+ *  the client allows it, until no new request has been received for \ref HTTP_KEEP_ALIVE_TIMEOUT.
  */
 static void HTTPServerApp_OpenRequestedFile(void)
 {
 	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 	char*               const AppData     = (char*)uip_appdata;
 
-	/* No HTTP header received from the client, abort processing */
+	/* Close the file sent in response to the previous request on this connection */
+	if (AppState->HTTPServer.FileOpen)
+	{
+		f_close(&AppState->HTTPServer.FileHandle);
+		AppState->HTTPServer.FileOpen = false;
+	}
+
+	/* No HTTP header received from the client, close the connection if it has been idle for too long */
 	if (!(uip_newdata()))
-	  return;
+	{
+		if (timer_expired(&AppState->HTTPServer.IdleTimer))
+		{
+			AppState->HTTPServer.CurrentState = WEBSERVER_STATE_Closing;
+			AppState->HTTPServer.NextState    = WEBSERVER_STATE_Closing;
+		}
+
+		return;
+	}
+
+	/* Terminate the request so that its lines can be processed as strings */
+	AppData[uip_datalen()] = '\0';
 
+	char* RequestHeaders    = strchr(AppData, '\n');
 	char* RequestToken      = strtok(AppData, " ");
-	char* RequestedFileName = strtok(NULL, " ");
+	char* RequestedFileName = strtok(NULL, " \r\n");
+	char* RequestVersion    = strtok(NULL, "\r\n");
 
 	/* Must be a GET request, abort otherwise */
-	if (strcmp_P(RequestToken, PSTR("GET")) != 0)
+	if ((strcmp_P(RequestToken, PSTR("GET")) != 0) || (RequestedFileName == NULL))
 	{
 		uip_abort();
 		return;
 	}
 
+	/* HTTP/1.1 connections persist unless the client asks otherwise, older HTTP versions must ask for it */
+	bool AcceptsGZip = false;
+	char* ETagList   = NULL;
+
+	AppState->HTTPServer.KeepAlive = ((RequestVersion != NULL) && (strcmp_P(RequestVersion, PSTR("HTTP/1.1")) == 0));
+
+	/* Look through the request header lines for the fields that change the response */
+	while (RequestHeaders != NULL)
+	{
+		char* HeaderLine = ++RequestHeaders;
+
+		/* Terminate the current line and move to the next */
+		RequestHeaders = strchr(HeaderLine, '\n');
+		HeaderLine[strcspn(HeaderLine, "\r\n")] = '\0';
+
+		if (strncasecmp_P(HeaderLine, PSTR("Accept-Encoding:"), 16) == 0)
+		{
+			AcceptsGZip = (strstr_P(HeaderLine, PSTR("gzip")) != NULL);
+		}
+		else if (strncasecmp_P(HeaderLine, PSTR("If-None-Match:"), 14) == 0)
+		{
+			ETagList = &HeaderLine[14];
+		}
+		else if (strncasecmp_P(HeaderLine, PSTR("Connection:"), 11) == 0)
+		{
+			if (strcasestr_P(HeaderLine, PSTR("close")) != NULL)
+			  AppState->HTTPServer.KeepAlive = false;
+			else if (strcasestr_P(HeaderLine, PSTR("keep-alive")) != NULL)
+			  AppState->HTTPServer.KeepAlive = true;
+		}
+	}
+
 	/* Copy over the requested filename */
 	strlcpy(AppState->HTTPServer.FileName, &RequestedFileName[1], sizeof(AppState->HTTPServer.FileName));
 
@@ -191,12 +257,62 @@ static void HTTPServerApp_OpenRequestedFile(void)
 	{
 		strlcpy_P(&AppState->HTTPServer.FileName[FileNameLen], DefaultDirFileName,
 		          (sizeof(AppState->HTTPServer.FileName) - FileNameLen));
+
+		FileNameLen = strlen(AppState->HTTPServer.FileName);
+	}
+
+	FILINFO FileInfo;
+	char    GZipFileName[sizeof(AppState->HTTPServer.FileName)];
+
+	/* Prefer a gzip compressed copy of the requested file if the client can decode it - as filenames are limited to
+	 * 8.3 format, the compressed copy has the same name as the requested file, but with a .gz extension */
+	AppState->HTTPServer.GZipEncoded = false;
+
+	if (AcceptsGZip)
+	{
+		char* Extension = strrchr(AppState->HTTPServer.FileName, '.');
+
+		if ((Extension == NULL) || (strchr(Extension, '/') != NULL))
+		  Extension = &AppState->HTTPServer.FileName[FileNameLen];
+
+		uint8_t BaseNameLen = (Extension - AppState->HTTPServer.FileName);
+
+		if ((strcasecmp_P(Extension, PSTR(".gz")) != 0) && (BaseNameLen < (sizeof(GZipFileName) - 3)))
+		{
+			memcpy(GZipFileName, AppState->HTTPServer.FileName, BaseNameLen);
+			strcpy_P(&GZipFileName[BaseNameLen], PSTR(".gz"));
+
+			AppState->HTTPServer.GZipEncoded = (f_stat(GZipFileName, &FileInfo) == FR_OK);
+		}
 	}
 
+	/* Try the file as requested, if no compressed copy was found */
+	bool FileFound = (AppState->HTTPServer.GZipEncoded ||
+	                  (f_stat(AppState->HTTPServer.FileName, &FileInfo) == FR_OK));
+
 	/* Try to open the file from the Dataflash disk */
-	AppState->HTTPServer.FileOpen     = (f_open(&AppState->HTTPServer.FileHandle, AppState->HTTPServer.FileName,
+	AppState->HTTPServer.FileOpen     = FileFound &&
+	                                    (f_open(&AppState->HTTPServer.FileHandle,
+	                                            (AppState->HTTPServer.GZipEncoded ? GZipFileName : AppState->HTTPServer.FileName),
 	                                            (FA_OPEN_EXISTING | FA_READ)) == FR_OK);
 
+	/* Check if the client's cached copy of the file is still current */
+	AppState->HTTPServer.FileDate     = FileInfo.fdate;
+	AppState->HTTPServer.FileTime     = FileInfo.ftime;
+	AppState->HTTPServer.NotModified  = false;
+
+	if (AppState->HTTPServer.FileOpen && (ETagList != NULL))
+	{
+		char ETag[HTTP_ETAG_LENGTH];
+		HTTPServerApp_GetETag(ETag);
+
+		AppState->HTTPServer.NotModified = (strstr(ETagList, ETag) != NULL);
+	}
+
+	/* The next response uses a fresh send window, starting at the beginning of the file */
+	uip_close_window();
+	AppState->HTTPServer.ACKedFilePos = 0;
+
 	/* Lock to the SendResponseHeader state until connection terminated */
 	AppState->HTTPServer.CurrentState = WEBSERVER_STATE_SendResponseHeader;
 	AppState->HTTPServer.NextState    = WEBSERVER_STATE_SendResponseHeader;
@@ -225,60 +341,151 @@ static void HTTPServerApp_SendResponseHeader(void)
 		return;
 	}
 
-	/* Copy over the HTTP 200 response header and send it to the receiving client */
-	strcpy_P(AppData, HTTP200Header);
-
-	/* Check to see if a MIME type for the requested file's extension was found */
-	if (Extension != NULL)
+	/* If the client's cached copy is current, send back a 304 response without the file contents */
+	if (AppState->HTTPServer.NotModified)
 	{
-		/* Look through the MIME type list, copy over the required MIME type if found */
-		for (uint8_t i = 0; i < (sizeof(MIMETypes) / sizeof(MIMETypes[0])); i++)
+		strcpy_P(AppData, HTTP304Header);
+	}
+	else
+	{
+		/* Copy over the HTTP 200 response header and send it to the receiving client */
+		strcpy_P(AppData, HTTP200Header);
+
+		/* Check to see if a MIME type for the requested file's extension was found */
+		if (Extension != NULL)
 		{
-			if (strcmp(&Extension[1], MIMETypes[i].Extension) == 0)
+			/* Look through the MIME type list, copy over the required MIME type if found */
+			for (uint8_t i = 0; i < (sizeof(MIMETypes) / sizeof(MIMETypes[0])); i++)
 			{
-				strcat(AppData, MIMETypes[i].MIMEType);
-				FoundMIMEType = true;
-				break;
+				if (strcmp(&Extension[1], MIMETypes[i].Extension) == 0)
+				{
+					strcat(AppData, MIMETypes[i].MIMEType);
+					FoundMIMEType = true;
+					break;
+				}
 			}
 		}
-	}
 
-	/* Check if a MIME type was found and copied to the output buffer */
-	if (!(FoundMIMEType))
-	{
-		/* MIME type not found - copy over the default MIME type */
-		strcat_P(AppData, DefaultMIMEType);
+		/* Check if a MIME type was found and copied to the output buffer */
+		if (!(FoundMIMEType))
+		{
+			/* MIME type not found - copy over the default MIME type */
+			strcat_P(AppData, DefaultMIMEType);
+		}
+
+		/* Add the end-of-line terminator after the MIME type */
+		strcat_P(AppData, PSTR("\r\n"));
+
+		/* Indicate when the compressed copy of the file is being sent */
+		if (AppState->HTTPServer.GZipEncoded)
+		  strcat_P(AppData, PSTR("Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n"));
+
+		/* Give the length of the file contents, so that the client can find the end of the response on a persistent connection */
+		sprintf_P(&AppData[strlen(AppData)], PSTR("Content-Length: %lu\r\n"), f_size(&AppState->HTTPServer.FileHandle));
 	}
 
-	/* Add the end-of-line terminator and end-of-headers terminator after the MIME type */
-	strcat_P(AppData, PSTR("\r\n\r\n"));
+	/* Add the file's entity tag, so that the client can check if its cached copy is current on the next request */
+	strcat_P(AppData, PSTR("ETag: "));
+	HTTPServerApp_GetETag(&AppData[strlen(AppData)]);
+
+	/* Tell the client if the connection will be kept open for further requests, then add the end-of-headers terminator */
+	if (AppState->HTTPServer.KeepAlive)
+	  strcat_P(AppData, PSTR("\r\nConnection: keep-alive\r\n\r\n"));
+	else
+	  strcat_P(AppData, PSTR("\r\nConnection: close\r\n\r\n"));
 
 	/* Send the MIME header to the receiving client */
 	uip_send(AppData, strlen(AppData));
 
-	/* When the MIME header is ACKed, progress to the data send stage */
-	AppState->HTTPServer.NextState = WEBSERVER_STATE_SendData;
+	/* When the MIME header is ACKed, progress to the data send stage, or finish the request if there is no data to send */
+	if (!(AppState->HTTPServer.NotModified))
+	  AppState->HTTPServer.NextState = WEBSERVER_STATE_SendData;
+	else
+	  HTTPServerApp_FinishRequest();
 }
 
 /** HTTP Server State handler for the Data Send state. This state manages the transmission of file chunks
- *  to the receiving HTTP client.
+ *  to the receiving HTTP client. Several chunks may be in flight at once; each new chunk is read from the
+ *  file position following the data already in flight, while a retransmission restarts from the last
+ *  ACKed file position.
  */
 static void HTTPServerApp_SendData(void)
 {
 	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 	char*               const AppData     = (char*)uip_appdata;
 
+	/* Allow further file chunks to be sent before the previous chunks have been ACKed */
+	uip_open_window();
+
+	/* Abort if the end of the file has already been sent, or the send window has no room for another chunk */
+	if (!(uip_rexmit()) && ((AppState->HTTPServer.NextState != WEBSERVER_STATE_SendData) || !(uip_sendable())))
+	  return;
+
 	/* Get the maximum segment size for the current packet */
 	uint16_t MaxChunkSize = uip_mss();
+	uint16_t ChunkSize;
+
+	/* Determine the file position of the next chunk, after any chunks still in flight */
+	uint32_t ChunkFilePos = AppState->HTTPServer.ACKedFilePos;
+
+	if (!(uip_rexmit()))
+	  ChunkFilePos += uip_outstanding(uip_conn);
+
+	/* Move the file pointer if the previous chunk was not sent in full */
+	if (f_tell(&AppState->HTTPServer.FileHandle) != ChunkFilePos)
+	  f_lseek(&AppState->HTTPServer.FileHandle, ChunkFilePos);
 
 	/* Read the next chunk of data from the open file */
-	f_read(&AppState->HTTPServer.FileHandle, AppData, MaxChunkSize, &AppState->HTTPServer.SentChunkSize);
+	f_read(&AppState->HTTPServer.FileHandle, AppData, MaxChunkSize, &ChunkSize);
 
 	/* Send the next file chunk to the receiving client */
-	uip_send(AppData, AppState->HTTPServer.SentChunkSize);
+	uip_send(AppData, ChunkSize);
+
+	/* Check if we are at the last chunk of the file, if so the final ACK should finish the request */
+	if (MaxChunkSize != ChunkSize)
+	{
+		HTTPServerApp_FinishRequest();
+
+		/* If the file ended on a chunk boundary, all file data may already have been ACKed */
+		if (!(ChunkSize) && !(uip_outstanding(uip_conn)))
+		  AppState->HTTPServer.CurrentState = AppState->HTTPServer.NextState;
+	}
+	else
+	{
+		AppState->HTTPServer.NextState = WEBSERVER_STATE_SendData;
+	}
+}
+
+/** Sets the state to enter once the response to the current request has been ACKed. This waits for the next request
+ *  if the connection is being kept open, or closes the connection otherwise.
+ */
+static void HTTPServerApp_FinishRequest(void)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
+
+	if (AppState->HTTPServer.KeepAlive)
+	{
+		AppState->HTTPServer.NextState = WEBSERVER_STATE_OpenRequestedFile;
+
+		/* Close the connection if the client does not send another request in time */
+		timer_set(&AppState->HTTPServer.IdleTimer, HTTP_KEEP_ALIVE_TIMEOUT);
+		uIPManagement_SetConnectionReadyAfter(uip_conn, HTTP_KEEP_ALIVE_TIMEOUT);
+	}
+	else
+	{
+		AppState->HTTPServer.NextState = WEBSERVER_STATE_Closing;
+	}
+}
+
+/** Writes the entity tag of the open file, derived from its modification date, time and size, as a quoted string.
+ *
+ *  \param[out] ETag  Buffer of at least \ref HTTP_ETAG_LENGTH characters where the entity tag is to be stored
+ */
+static void HTTPServerApp_GetETag(char* ETag)
+{
+	uip_tcp_appstate_t* const AppState    = &uip_conn->appstate;
 
-	/* Check if we are at the last chunk of the file, if so next ACK should close the connection */
-	if (MaxChunkSize != AppState->HTTPServer.SentChunkSize)
-	  AppState->HTTPServer.NextState = WEBSERVER_STATE_Closing;
+	sprintf_P(ETag, PSTR("\"%04x%04x-%lx\""), AppState->HTTPServer.FileDate, AppState->HTTPServer.FileTime,
+	          f_size(&AppState->HTTPServer.FileHandle));
 }
 
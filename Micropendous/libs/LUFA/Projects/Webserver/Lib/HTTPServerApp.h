@@ -39,6 +39,7 @@
 	/* Includes: */
 		#include <avr/pgmspace.h>
 		#include <string.h>
+		#include <stdio.h>
 
 		#include <LUFA/Version.h>
 		
@@ -47,6 +48,8 @@
 		#include <uip.h>
 		#include <ff.h>
 
+		#include "uIPManagement.h"
+
 	/* Enums: */
 		/** States for each HTTP connection to the webserver. */
 		enum Webserver_States_t
@@ -68,7 +71,13 @@
 
 	/* Macros: */
 		/** TCP listen port for incoming HTTP traffic. */
-		#define HTTP_SERVER_PORT  80
+		#define HTTP_SERVER_PORT         80
+
+		/** Time a connection is kept open while waiting for the next HTTP request from the client. */
+		#define HTTP_KEEP_ALIVE_TIMEOUT  (5 * CLOCK_SECOND)
+
+		/** Maximum length of a file entity tag, including the enclosing quotes and null terminator. */
+		#define HTTP_ETAG_LENGTH         20
 
 	/* Function Prototypes: */
 		void HTTPServerApp_Init(void);
@@ -78,6 +87,8 @@
 			static void HTTPServerApp_OpenRequestedFile(void);
 			static void HTTPServerApp_SendResponseHeader(void);
 			static void HTTPServerApp_SendData(void);
+			static void HTTPServerApp_FinishRequest(void);
+			static void HTTPServerApp_GetETag(char* ETag);
 		#endif
 
 #endif
@@ -107,6 +107,9 @@ void TELNETServerApp_Callback(void)
 				AppState->TELNETServer.IssuedCommand = AppData[0];
 
 				AppState->TELNETServer.CurrentState  = TELNET_STATE_SendResponse;
+
+				/* Have the connection polled to send the command's response */
+				uIPManagement_SetConnectionReady(uip_conn);
 				break;
 			case TELNET_STATE_SendResponse:
 				/* Determine which command was issued, perform command processing */
@@ -44,6 +44,7 @@
 		#include <uip.h>
 
 		#include "Config/AppConfig.h"
+		#include "uIPManagement.h"
 
 	/* Macros: */
 		/** TCP listen port for incoming TELNET traffic. */
@@ -43,6 +43,20 @@ static struct timer ConnectionTimer;
 /** ARP timer, to retain the time elapsed since the ARP cache was last updated. */
 static struct timer ARPTimer;
 
+/** Bit mask of the TCP connections whose applications have output pending, which are polled on the next pass
+ *  through the connection manager.
+ */
+static uint8_t ReadyConnections[(UIP_CONNS + 7) / 8];
+
+/** Connection timer wheel, holding the index of the first connection in each slot. The connections in a slot are
+ *  sorted by the time at which they are due, so that only the head of the current slot needs to be examined on
+ *  each connection timer period.
+ */
+static uint8_t TimerWheel[CONNECTION_TIMER_SLOTS];
+
+/** Timer wheel state of each TCP connection, indexed in the same way as the uIP connection list. */
+static ConnectionTimer_t ConnectionTimers[UIP_CONNS];
+
 /** MAC address of the RNDIS device, when enumerated. */
 struct uip_eth_addr MACAddress;
 
@@ -52,9 +66,14 @@ void uIPManagement_Init(void)
 {
 	/* uIP Timing Initialization */
 	clock_init();
-	timer_set(&ConnectionTimer, CLOCK_SECOND / 2);
+	timer_set(&ConnectionTimer, CONNECTION_TIMER_PERIOD);
 	timer_set(&ARPTimer, CLOCK_SECOND * 10);
 
+	/* Connection Scheduler Initialization */
+	memset(ReadyConnections, 0, sizeof(ReadyConnections));
+	memset(TimerWheel, NO_CONNECTION, sizeof(TimerWheel));
+	memset(ConnectionTimers, 0, sizeof(ConnectionTimers));
+
 	/* uIP Stack Initialization */
 	uip_init();
 	uip_arp_init();
@@ -113,8 +132,19 @@ void uIPManagement_Init(void)
  */
 void uIPManagement_ManageNetwork(void)
 {
-	if (((USB_CurrentMode == USB_MODE_Host)   && (USB_HostState   == HOST_STATE_Configured)) ||
-	    ((USB_CurrentMode == USB_MODE_Device) && (USB_DeviceState == DEVICE_STATE_Configured)))
+	bool NetworkReady = false;
+
+	#if defined(USB_CAN_BE_HOST)
+	if (USB_CurrentMode == USB_MODE_Host)
+	  NetworkReady = (USB_HostState == HOST_STATE_Configured);
+	#endif
+
+	#if defined(USB_CAN_BE_DEVICE)
+	if (USB_CurrentMode == USB_MODE_Device)
+	  NetworkReady = (USB_DeviceState == DEVICE_STATE_Configured);
+	#endif
+
+	if (NetworkReady)
 	{
 		uIPManagement_ProcessIncomingPacket();
 		uIPManagement_ManageConnections();
@@ -161,10 +191,43 @@ void uIPManagement_UDPCallback(void)
 	}
 }
 
+/** Marks a TCP connection as having output pending from its application, so that the connection is polled for the
+ *  data on the next pass through the connection manager. Connections are otherwise only processed when a packet is
+ *  received for them or their retransmission timer expires.
+ *
+ *  \param[in] Connection  Pointer to the uIP connection to poll
+ */
+void uIPManagement_SetConnectionReady(struct uip_conn* const Connection)
+{
+	uint8_t ConnectionIndex = (Connection - uip_conns);
+
+	ReadyConnections[ConnectionIndex >> 3] |= (1 << (ConnectionIndex & 0x07));
+}
+
+/** Marks a TCP connection as ready once the given delay has elapsed, so that its application is polled at that time
+ *  (for example, to time out an idle connection). Only the most recent delay requested for each connection is kept.
+ *
+ *  \param[in] Connection  Pointer to the uIP connection to poll
+ *  \param[in] Delay       Delay in clock ticks before the connection is polled, less than 64 connection timer periods
+ */
+void uIPManagement_SetConnectionReadyAfter(struct uip_conn* const Connection,
+                                           const clock_time_t Delay)
+{
+	uint8_t            ConnectionIndex = (Connection - uip_conns);
+	ConnectionTimer_t* Timer           = &ConnectionTimers[ConnectionIndex];
+
+	/* Round up to whole timer periods, plus one for the part of the current period that has already elapsed */
+	Timer->WakeTick    = uip_ticks + ((Delay + CONNECTION_TIMER_PERIOD - 1) / CONNECTION_TIMER_PERIOD) + 1;
+	Timer->WakePending = true;
+
+	uIPManagement_ScheduleConnection(ConnectionIndex);
+}
+
 /** Processes Incoming packets to the server from the connected RNDIS device, creating responses as needed. */
 static void uIPManagement_ProcessIncomingPacket(void)
 {
 	/* Determine which USB mode the system is currently initialized in */
+	#if defined(USB_CAN_BE_DEVICE)
 	if (USB_CurrentMode == USB_MODE_Device)
 	{
 		/* If no packet received, exit processing routine */
@@ -176,7 +239,10 @@ static void uIPManagement_ProcessIncomingPacket(void)
 		/* Read the Incoming packet straight into the UIP packet buffer */
 		RNDIS_Device_ReadPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, &uip_len);
 	}
-	else
+	#endif
+
+	#if defined(USB_CAN_BE_HOST)
+	if (USB_CurrentMode == USB_MODE_Host)
 	{
 		/* If no packet received, exit processing routine */
 		if (!(RNDIS_Host_IsPacketReceived(&Ethernet_RNDIS_Interface_Host)))
@@ -187,6 +253,7 @@ static void uIPManagement_ProcessIncomingPacket(void)
 		/* Read the Incoming packet straight into the UIP packet buffer */
 		RNDIS_Host_ReadPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, &uip_len);
 	}
+	#endif
 
 	/* If the packet contains an Ethernet frame, process it */
 	if (uip_len > 0)
@@ -209,6 +276,10 @@ static void uIPManagement_ProcessIncomingPacket(void)
 					uip_split_output();
 				}
 
+				/* Update the timer of the TCP connection the packet was processed for, if any */
+				if (uip_conn != NULL)
+				  uIPManagement_ScheduleConnection(uip_conn - uip_conns);
+
 				break;
 			case HTONS(UIP_ETHTYPE_ARP):
 				/* Process ARP packet */
@@ -228,19 +299,31 @@ static void uIPManagement_ProcessIncomingPacket(void)
 /** Manages the currently open network connections, including TCP and (if enabled) UDP. */
 static void uIPManagement_ManageConnections(void)
 {
-	/* Poll TCP connections for more data to send back to the host */
-	for (uint8_t i = 0; i < UIP_CONNS; i++)
+	/* Poll the TCP connections whose applications have more data to send back to the host */
+	for (uint8_t i = 0; i < sizeof(ReadyConnections); i++)
 	{
-		uip_poll_conn(&uip_conns[i]);
+		/* Take the current group of eight ready connections, so that any marked again when polled wait for the next pass */
+		uint8_t ReadyMask = ReadyConnections[i];
+		ReadyConnections[i] = 0;
 
-		/* If a response was generated, send it */
-		if (uip_len > 0)
+		for (uint8_t ConnectionIndex = (i << 3); ReadyMask; ConnectionIndex++, ReadyMask >>= 1)
 		{
-			/* Add destination MAC to outgoing packet */
-			uip_arp_out();
+			if (!(ReadyMask & 0x01))
+			  continue;
+
+			uip_poll_conn(&uip_conns[ConnectionIndex]);
+
+			/* If a response was generated, send it */
+			if (uip_len > 0)
+			{
+				/* Add destination MAC to outgoing packet */
+				uip_arp_out();
 
-			/* Split and send the outgoing packet */
-			uip_split_output();
+				/* Split and send the outgoing packet */
+				uip_split_output();
+			}
+
+			uIPManagement_ScheduleConnection(ConnectionIndex);
 		}
 	}
 
@@ -251,20 +334,43 @@ static void uIPManagement_ManageConnections(void)
 
 		LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
 
-		for (uint8_t i = 0; i < UIP_CONNS; i++)
+		uip_tick();
+
+		/* Process the TCP connections at the head of the current timer wheel slot which are due in this period */
+		uint8_t* const CurrentSlot = &TimerWheel[uip_ticks & (CONNECTION_TIMER_SLOTS - 1)];
+
+		while ((*CurrentSlot != NO_CONNECTION) && (ConnectionTimers[*CurrentSlot].DueTick == uip_ticks))
 		{
-			/* Run periodic connection management for each TCP connection */
-			uip_periodic(i);
+			uint8_t            ConnectionIndex = *CurrentSlot;
+			ConnectionTimer_t* Timer           = &ConnectionTimers[ConnectionIndex];
 
-			/* If a response was generated, send it */
-			if (uip_len > 0)
+			*CurrentSlot     = Timer->NextConnection;
+			Timer->Scheduled = false;
+
+			/* Poll the connection's application if it asked to be woken up in this period */
+			if (Timer->WakePending && ((int8_t)(Timer->WakeTick - uip_ticks) <= 0))
 			{
-				/* Add destination MAC to outgoing packet */
-				uip_arp_out();
+				Timer->WakePending = false;
+				uIPManagement_SetConnectionReady(&uip_conns[ConnectionIndex]);
+			}
 
-				/* Split and send the outgoing packet */
-				uip_split_output();
+			/* Run periodic connection management for the TCP connection if its timer has expired */
+			if (uip_timer_running(&uip_conns[ConnectionIndex]))
+			{
+				uip_periodic(ConnectionIndex);
+
+				/* If a response was generated, send it */
+				if (uip_len > 0)
+				{
+					/* Add destination MAC to outgoing packet */
+					uip_arp_out();
+
+					/* Split and send the outgoing packet */
+					uip_split_output();
+				}
 			}
+
+			uIPManagement_ScheduleConnection(ConnectionIndex);
 		}
 
 		#if defined(ENABLE_DHCP_CLIENT)
@@ -296,3 +402,67 @@ static void uIPManagement_ManageConnections(void)
 	}
 }
 
+/** Places a TCP connection into the connection timer wheel slot for the time at which it is next due to be processed,
+ *  which is the earlier of the expiry of its uIP retransmission or TIME_WAIT timer and the time its application asked
+ *  to be polled at. Connections with neither are removed from the timer wheel. This must be called each time the
+ *  connection has been processed by uIP, as that may change its timer.
+ *
+ *  \param[in] ConnectionIndex  Index of the connection in the uIP connection list
+ */
+static void uIPManagement_ScheduleConnection(const uint8_t ConnectionIndex)
+{
+	struct uip_conn*   Connection = &uip_conns[ConnectionIndex];
+	ConnectionTimer_t* Timer      = &ConnectionTimers[ConnectionIndex];
+	bool               IsDue      = false;
+	uint8_t            DueTick    = 0;
+
+	if (uip_timer_running(Connection))
+	{
+		DueTick = uip_timer_expiry(Connection);
+		IsDue   = true;
+	}
+
+	if (Timer->WakePending && (!(IsDue) || ((uint8_t)(Timer->WakeTick - uip_ticks) < (uint8_t)(DueTick - uip_ticks))))
+	{
+		DueTick = Timer->WakeTick;
+		IsDue   = true;
+	}
+
+	/* Timers which have already expired are processed in the next period */
+	if (IsDue && ((int8_t)(DueTick - uip_ticks) <= 0))
+	  DueTick = uip_ticks + 1;
+
+	if (Timer->Scheduled)
+	{
+		/* Leave the connection in place if it is already in the correct position */
+		if (IsDue && (DueTick == Timer->DueTick))
+		  return;
+
+		/* Unlink the connection from its current timer wheel slot */
+		uint8_t* NextLink = &TimerWheel[Timer->DueTick & (CONNECTION_TIMER_SLOTS - 1)];
+
+		while (*NextLink != ConnectionIndex)
+		  NextLink = &ConnectionTimers[*NextLink].NextConnection;
+
+		*NextLink        = Timer->NextConnection;
+		Timer->Scheduled = false;
+	}
+
+	if (!(IsDue))
+	  return;
+
+	/* Insert the connection into its new slot, after the connections which are due before it */
+	uint8_t* NextLink = &TimerWheel[DueTick & (CONNECTION_TIMER_SLOTS - 1)];
+
+	while ((*NextLink != NO_CONNECTION) &&
+	       ((uint8_t)(ConnectionTimers[*NextLink].DueTick - uip_ticks) <= (uint8_t)(DueTick - uip_ticks)))
+	{
+		NextLink = &ConnectionTimers[*NextLink].NextConnection;
+	}
+
+	Timer->NextConnection = *NextLink;
+	Timer->DueTick        = DueTick;
+	Timer->Scheduled      = true;
+	*NextLink             = ConnectionIndex;
+}
+
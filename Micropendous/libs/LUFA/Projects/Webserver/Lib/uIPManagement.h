@@ -37,6 +37,8 @@
 #define _UIP_MANAGEMENT_H_
 
 	/* Includes: */
+		#include <string.h>
+
 		#include <LUFA/Drivers/USB/USB.h>
 
 		#include <uip.h>
@@ -51,6 +53,30 @@
 		#include "HTTPServerApp.h"
 		#include "TELNETServerApp.h"
 
+	/* Macros: */
+		/** Period of the uIP TCP connection timers, in clock ticks. */
+		#define CONNECTION_TIMER_PERIOD     (CLOCK_SECOND / 2)
+
+		/** Number of slots in the connection timer wheel. Connections whose timers expire more than this many
+		 *  connection timer periods ahead share their slot with sooner ones, so larger wheels shorten the slot
+		 *  lists when many connections are open. Must be a power of two.
+		 */
+		#define CONNECTION_TIMER_SLOTS      16
+
+		/** Value used to terminate the connection lists in the connection timer wheel. */
+		#define NO_CONNECTION               0xFF
+
+	/* Type Defines: */
+		/** Type define for the connection timer wheel state of each TCP connection. */
+		typedef struct
+		{
+			uint8_t NextConnection; /**< Index of the next connection in the same timer wheel slot, or \ref NO_CONNECTION */
+			uint8_t DueTick; /**< Value of \c uip_ticks at which the connection is next due to be processed */
+			uint8_t WakeTick; /**< Value of \c uip_ticks at which the connection's application should be polled */
+			bool    Scheduled; /**< Indicates if the connection is in the timer wheel */
+			bool    WakePending; /**< Indicates if the connection's application has asked to be polled at \c WakeTick */
+		} ConnectionTimer_t;
+
 	/* External Variables: */
 		extern struct uip_eth_addr MACAddress;
 
@@ -59,10 +85,14 @@
 		void uIPManagement_ManageNetwork(void);
 		void uIPManagement_TCPCallback(void);
 		void uIPManagement_UDPCallback(void);
+		void uIPManagement_SetConnectionReady(struct uip_conn* const Connection);
+		void uIPManagement_SetConnectionReadyAfter(struct uip_conn* const Connection,
+		                                           const clock_time_t Delay);
 
 		#if defined(INCLUDE_FROM_UIPMANAGEMENT_C)
 			static void uIPManagement_ProcessIncomingPacket(void);
 			static void uIPManagement_ManageConnections(void);
+			static void uIPManagement_ScheduleConnection(const uint8_t ConnectionIndex);
 		#endif
 
 #endif
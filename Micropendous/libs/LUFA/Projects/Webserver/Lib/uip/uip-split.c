@@ -38,15 +38,65 @@
 
 #define BUF ((struct uip_tcpip_hdr *)&uip_buf[UIP_LLH_LEN])
 
+#if !UIP_CONF_IPV6
+/*-----------------------------------------------------------------------------*/
+/* Sends the packet in uip_buf over the RNDIS interface of the current USB
+   mode. */
+static void
+uip_split_send(void)
+{
+#if defined(USB_CAN_BE_DEVICE)
+  if(USB_CurrentMode == USB_MODE_Device) {
+    RNDIS_Device_SendPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, uip_len);
+  }
+#endif
+#if defined(USB_CAN_BE_HOST)
+  if(USB_CurrentMode == USB_MODE_Host) {
+    RNDIS_Host_SendPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, uip_len);
+  }
+#endif
+}
+
+/*-----------------------------------------------------------------------------*/
+/* Patches the checksums of the segment in uip_buf for a change of its
+   payload from oldsum to newsum (one's complement sums of the payload in
+   host byte order) and of its TCP length from oldlen to newlen, as described
+   in RFC 1624. */
+static void
+uip_split_adjust(u16_t oldsum, u16_t newsum, u16_t oldlen, u16_t newlen)
+{
+  u16_t chksum;
+
+  chksum = ntohs(BUF->tcpchksum);
+  chksum = InetChecksum_Adjust(chksum, oldsum, newsum);
+  chksum = InetChecksum_Adjust(chksum, oldlen + UIP_TCPH_LEN, newlen + UIP_TCPH_LEN);
+  BUF->tcpchksum = htons(chksum);
+
+  chksum = ntohs(BUF->ipchksum);
+  chksum = InetChecksum_Adjust(chksum, oldlen + UIP_TCPIP_HLEN, newlen + UIP_TCPIP_HLEN);
+  BUF->ipchksum = htons(chksum);
+}
+#endif /* !UIP_CONF_IPV6 */
+
 /*-----------------------------------------------------------------------------*/
 void
 uip_split_output(void)
 {
 #if UIP_TCP
   u16_t tcplen, len1, len2;
-
-  /* We only try to split maximum sized TCP segments. */
-  if(BUF->proto == UIP_PROTO_TCP  && uip_len == UIP_BUFSIZE) {
+#if !UIP_CONF_IPV6
+  u16_t sum1, sum2, seqhi, seqlo;
+#endif /* !UIP_CONF_IPV6 */
+
+  /* We only try to split maximum sized TCP segments. Connections with
+     an open send window keep enough segments in flight to draw ACKs
+     from the remote host without help, so their segments are sent
+     whole. */
+  if(BUF->proto == UIP_PROTO_TCP  && uip_len == UIP_BUFSIZE
+#if UIP_TCP_SEND_SEGMENTS > 1
+     && !(uip_conn != NULL && uip_conn->sndwnd)
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+     ) {
 
     tcplen = uip_len - UIP_TCPIP_HLEN - UIP_LLH_LEN;
     /* Split the segment in two. If the original packet length was
@@ -56,6 +106,22 @@ uip_split_output(void)
       ++len2;
     }
 
+#if !UIP_CONF_IPV6
+    /* Rather than summing both packets in full, the checksums of the
+       original segment are patched for each of them. This needs the sums
+       of the two halves of the payload, which are found by summing just
+       the first half, and the headers to recover the sum of the whole. */
+    sum1 = ntohs(uip_chksum((u16_t *)&BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t)));
+    sum1 = InetChecksum_AddWord(sum1, ntohs(uip_chksum((u16_t *)&BUF->srcport, UIP_TCPH_LEN)));
+    sum1 = InetChecksum_AddWord(sum1, tcplen + UIP_TCPH_LEN + UIP_PROTO_TCP);
+
+    /* The whole segment sums to 0xffff, so the payload is the complement
+       of the header sum. */
+    sum2 = ~sum1;
+    sum1 = ntohs(uip_chksum((u16_t *)uip_appdata, len1));
+    sum2 = InetChecksum_AddWord(sum2, ~sum1);
+#endif /* !UIP_CONF_IPV6 */
+
     /* Create the first packet. This is done by altering the length
        field of the IP header and updating the checksums. */
     uip_len = len1 + UIP_TCPIP_HLEN + UIP_LLH_LEN;
@@ -69,24 +135,20 @@ uip_split_output(void)
     BUF->len[1] = (uip_len - UIP_LLH_LEN) & 0xff;
 #endif /* UIP_CONF_IPV6 */
 
+#if UIP_CONF_IPV6
     /* Recalculate the TCP checksum. */
     BUF->tcpchksum = 0;
     BUF->tcpchksum = ~(uip_tcpchksum());
-
-#if !UIP_CONF_IPV6
-    /* Recalculate the IP checksum. */
-    BUF->ipchksum = 0;
-    BUF->ipchksum = ~(uip_ipchksum());
+#else /* UIP_CONF_IPV6 */
+    /* Remove the second half of the payload from the checksums. */
+    uip_split_adjust(sum2, 0, tcplen, len1);
 #endif /* UIP_CONF_IPV6 */
 
     /* Transmit the first packet. */
 #if UIP_CONF_IPV6
     tcpip_ipv6_output();
 #else
-	if (USB_CurrentMode == USB_MODE_Device)
-	  RNDIS_Device_SendPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, uip_len);
-	else
-	  RNDIS_Host_SendPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, uip_len);
+	uip_split_send();
 #endif /* UIP_CONF_IPV6 */
 
     /* Now, create the second packet. To do this, it is not enough to
@@ -107,30 +169,42 @@ uip_split_output(void)
 
     memcpy(uip_appdata, (u8_t *)uip_appdata + len1, len2);
 
+#if !UIP_CONF_IPV6
+    seqhi = ((u16_t)BUF->seqno[0] << 8) | BUF->seqno[1];
+    seqlo = ((u16_t)BUF->seqno[2] << 8) | BUF->seqno[3];
+#endif /* !UIP_CONF_IPV6 */
+
     uip_add32(BUF->seqno, len1);
     BUF->seqno[0] = uip_acc32[0];
     BUF->seqno[1] = uip_acc32[1];
     BUF->seqno[2] = uip_acc32[2];
     BUF->seqno[3] = uip_acc32[3];
 
+#if UIP_CONF_IPV6
     /* Recalculate the TCP checksum. */
     BUF->tcpchksum = 0;
     BUF->tcpchksum = ~(uip_tcpchksum());
+#else /* UIP_CONF_IPV6 */
+    /* Swap the first half of the payload for the second, which is now at
+       the start of the payload; if it has moved by an odd number of bytes,
+       the bytes of its sum have swapped places. */
+    if(len1 & 1) {
+      sum2 = (sum2 << 8) | (sum2 >> 8);
+    }
+    uip_split_adjust(sum1, sum2, len1, len2);
 
-#if !UIP_CONF_IPV6
-    /* Recalculate the IP checksum. */
-    BUF->ipchksum = 0;
-    BUF->ipchksum = ~(uip_ipchksum());
+    /* Patch in the new sequence number. */
+    BUF->tcpchksum = htons(InetChecksum_Adjust(ntohs(BUF->tcpchksum), seqhi,
+                                               ((u16_t)BUF->seqno[0] << 8) | BUF->seqno[1]));
+    BUF->tcpchksum = htons(InetChecksum_Adjust(ntohs(BUF->tcpchksum), seqlo,
+                                               ((u16_t)BUF->seqno[2] << 8) | BUF->seqno[3]));
 #endif /* UIP_CONF_IPV6 */
 
     /* Transmit the second packet. */
 #if UIP_CONF_IPV6
     tcpip_ipv6_output();
 #else
-	if (USB_CurrentMode == USB_MODE_Device)
-	  RNDIS_Device_SendPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, uip_len);
-	else
-	  RNDIS_Host_SendPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, uip_len);
+	uip_split_send();
 #endif /* UIP_CONF_IPV6 */
     return;
   }
@@ -140,10 +214,7 @@ uip_split_output(void)
 #if UIP_CONF_IPV6
 	tcpip_ipv6_output();
 #else
-	if (USB_CurrentMode == USB_MODE_Device)
-	  RNDIS_Device_SendPacket(&Ethernet_RNDIS_Interface_Device, uip_buf, uip_len);
-	else
-	  RNDIS_Host_SendPacket(&Ethernet_RNDIS_Interface_Host, uip_buf, uip_len);
+	uip_split_send();
 #endif /* UIP_CONF_IPV6 */
 }
 
@@ -78,6 +78,7 @@
 #include "../../USBHostMode.h"
 
 #include <LUFA/Drivers/USB/USB.h>
+#include <LUFA/Drivers/Misc/InternetChecksum.h>
 
 /**
  * Handle outgoing packets.
@@ -142,6 +142,13 @@ void *uip_urgdata;               /* The uip_urgdata pointer points to
 u16_t uip_urglen, uip_surglen;
 #endif /* UIP_URGDATA > 0 */
 
+u16_t uip_acklen;                /* The uip_acklen variable holds the
+				    number of bytes acknowledged by the
+				    last incoming segment. */
+
+u8_t uip_ticks;                  /* The uip_ticks variable counts the
+				    periods of the TCP timers. */
+
 u16_t uip_len, uip_slen;
                              /* The uip_len is either 8 or 16 bits,
 				depending on the maximum packet
@@ -182,8 +189,20 @@ static u16_t lastport;       /* Keeps track of the last port used for
 u8_t uip_acc32[4];
 static u8_t c, opt;
 static u16_t tmp16;
+#if UIP_TCP_SEND_SEGMENTS > 1
+static u16_t sndoff;         /* Offset of the segment being sent from
+				the oldest unacknowledged byte. */
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
 
 /* Structures and definitions. */
+/* The TCP timer of a connection holds the value of uip_ticks at
+   which it expires, so that connections only need periodic
+   processing when their timer is due. A timer set to t expires on
+   the (t + 1)th call to uip_tick(). */
+#define UIP_TIMER_SET(conn, t)  ((conn)->timer = uip_ticks + (t) + 1)
+#define UIP_TIMER_LEFT(conn)    ((u8_t)((conn)->timer - uip_ticks - 1))
+#define UIP_TIMER_EXPIRED(conn) ((signed char)(uip_ticks - (conn)->timer) >= 0)
+
 #define TCP_FIN 0x01
 #define TCP_SYN 0x02
 #define TCP_RST 0x04
@@ -428,7 +447,7 @@ uip_connect(uip_ipaddr_t *ripaddr, u16_t rport)
     }
     if(cconn->tcpstateflags == UIP_TIME_WAIT) {
       if(conn == 0 ||
-	 cconn->timer > conn->timer) {
+	 UIP_TIMER_LEFT(cconn) < UIP_TIMER_LEFT(conn)) {
 	conn = cconn;
       }
     }
@@ -449,7 +468,10 @@ uip_connect(uip_ipaddr_t *ripaddr, u16_t rport)
 
   conn->len = 1;   /* TCP length of the SYN is one. */
   conn->nrtx = 0;
-  conn->timer = 1; /* Send the SYN next time around. */
+#if UIP_TCP_SEND_SEGMENTS > 1
+  conn->wnd = conn->sndwnd = 0;
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+  UIP_TIMER_SET(conn, 1); /* Send the SYN next time around. */
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
@@ -507,6 +529,23 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport)
 }
 #endif /* UIP_UDP */
 /*---------------------------------------------------------------------------*/
+#if UIP_TCP
+void
+uip_tick(void)
+{
+  ++uip_ticks;
+
+  /* Increase the initial sequence number. */
+  if(++iss[3] == 0) {
+    if(++iss[2] == 0) {
+      if(++iss[1] == 0) {
+	++iss[0];
+      }
+    }
+  }
+}
+#endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
 void
 uip_unlisten(u16_t port)
 {
@@ -688,7 +727,7 @@ uip_process(u8_t flag)
      particular connection. */
   if(flag == UIP_POLL_REQUEST) {
     if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
-       !uip_outstanding(uip_connr)) {
+       uip_tcp_sendable(uip_connr)) {
 	uip_len = uip_slen = 0;
 	uip_flags = UIP_POLL;
 	UIP_APPCALL();
@@ -703,35 +742,25 @@ uip_process(u8_t flag)
       --uip_reasstmr;
     }
 #endif /* UIP_REASSEMBLY */
-    /* Increase the initial sequence number. */
-    if(++iss[3] == 0) {
-      if(++iss[2] == 0) {
-	if(++iss[1] == 0) {
-	  ++iss[0];
-	}
-      }
-    }
 
     /* Reset the length variables. */
     uip_len = 0;
     uip_slen = 0;
 
     /* Check if the connection is in a state in which we simply wait
-       for the connection to time out. If so, we increase the
-       connection's timer and remove the connection if it times
-       out. */
+       for the connection to time out. If so, we remove the
+       connection once its timer has expired. */
     if(uip_connr->tcpstateflags == UIP_TIME_WAIT ||
        uip_connr->tcpstateflags == UIP_FIN_WAIT_2) {
-      ++(uip_connr->timer);
-      if(uip_connr->timer == UIP_TIME_WAIT_TIMEOUT) {
+      if(UIP_TIMER_EXPIRED(uip_connr)) {
 	uip_connr->tcpstateflags = UIP_CLOSED;
       }
     } else if(uip_connr->tcpstateflags != UIP_CLOSED) {
-      /* If the connection has outstanding data, we increase the
-	 connection's timer and see if it has reached the RTO value
-	 in which case we retransmit. */
+      /* If the connection has outstanding data, we check if the
+	 connection's timer has expired in which case we
+	 retransmit. */
       if(uip_outstanding(uip_connr)) {
-	if(uip_connr->timer-- == 0) {
+	if(UIP_TIMER_EXPIRED(uip_connr)) {
 	  if(uip_connr->nrtx == UIP_MAXRTX ||
 	     ((uip_connr->tcpstateflags == UIP_SYN_SENT ||
 	       uip_connr->tcpstateflags == UIP_SYN_RCVD) &&
@@ -750,9 +779,9 @@ uip_process(u8_t flag)
 	  }
 
 	  /* Exponential back-off. */
-	  uip_connr->timer = UIP_RTO << (uip_connr->nrtx > 4?
-					 4:
-					 uip_connr->nrtx);
+	  UIP_TIMER_SET(uip_connr, UIP_RTO << (uip_connr->nrtx > 4?
+					       4:
+					       uip_connr->nrtx));
 	  ++(uip_connr->nrtx);
 
 	  /* Ok, so we need to retransmit. We do this differently
@@ -781,7 +810,24 @@ uip_process(u8_t flag)
                the code for sending out the packet (the apprexmit
                label). */
 	    uip_flags = UIP_REXMIT;
+#if UIP_TCP_SEND_SEGMENTS > 1
+	    /* With an open send window we go back to the oldest
+	       unacknowledged byte, and resend a single segment from
+	       there. The rest of the data in flight is sent again as
+	       new data once this segment has been acknowledged. */
+	    if(uip_connr->sndwnd && uip_connr->len > uip_connr->mss) {
+	      uip_connr->len = uip_connr->mss;
+	    }
+	    UIP_APPCALL();
+	    if(uip_slen > 0) {
+	      if(uip_connr->sndwnd && uip_slen < uip_connr->len) {
+		uip_connr->len = uip_slen;
+	      }
+	      uip_slen = uip_connr->len;
+	    }
+#else /* UIP_TCP_SEND_SEGMENTS > 1 */
 	    UIP_APPCALL();
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
 	    goto apprexmit;
 
 	  case UIP_FIN_WAIT_1:
@@ -1313,7 +1359,7 @@ uip_process(u8_t flag)
     }
     if(uip_conns[c].tcpstateflags == UIP_TIME_WAIT) {
       if(uip_connr == 0 ||
-	 uip_conns[c].timer > uip_connr->timer) {
+	 UIP_TIMER_LEFT(&uip_conns[c]) < UIP_TIMER_LEFT(uip_connr)) {
 	uip_connr = &uip_conns[c];
       }
     }
@@ -1330,7 +1376,8 @@ uip_process(u8_t flag)
   uip_conn = uip_connr;
 
   /* Fill in the necessary fields for the new connection. */
-  uip_connr->rto = uip_connr->timer = UIP_RTO;
+  uip_connr->rto = UIP_RTO;
+  UIP_TIMER_SET(uip_connr, UIP_RTO);
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
@@ -1344,6 +1391,9 @@ uip_process(u8_t flag)
   uip_connr->snd_nxt[2] = iss[2];
   uip_connr->snd_nxt[3] = iss[3];
   uip_connr->len = 1;
+#if UIP_TCP_SEND_SEGMENTS > 1
+  uip_connr->wnd = uip_connr->sndwnd = 0;
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
 
   /* rcv_nxt should be the seqno from the incoming packet + 1. */
   uip_connr->rcv_nxt[3] = BUF->seqno[3];
@@ -1449,6 +1499,32 @@ uip_process(u8_t flag)
      the outstanding data, calculate RTT estimations, and reset the
      retransmission timer. */
   if((BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
+#if UIP_TCP_SEND_SEGMENTS > 1
+    /* With an open send window, the segment may acknowledge only the
+       first part of the data in flight. If so, we move the sequence
+       number past the acknowledged data and restart the
+       retransmission timer. */
+    if(uip_connr->sndwnd &&
+       (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+      uip_acklen = (((u16_t)BUF->ackno[2] << 8) | BUF->ackno[3]) -
+	(((u16_t)uip_connr->snd_nxt[2] << 8) | uip_connr->snd_nxt[3]);
+      if(uip_acklen > 0 && uip_acklen < uip_connr->len) {
+	uip_add32(uip_connr->snd_nxt, uip_acklen);
+
+	if(BUF->ackno[0] == uip_acc32[0] &&
+	   BUF->ackno[1] == uip_acc32[1]) {
+	  uip_connr->snd_nxt[0] = uip_acc32[0];
+	  uip_connr->snd_nxt[1] = uip_acc32[1];
+	  uip_connr->snd_nxt[2] = uip_acc32[2];
+	  uip_connr->snd_nxt[3] = uip_acc32[3];
+
+	  uip_flags = UIP_ACKDATA;
+	  UIP_TIMER_SET(uip_connr, uip_connr->rto);
+	  uip_connr->len -= uip_acklen;
+	}
+      }
+    }
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
     uip_add32(uip_connr->snd_nxt, uip_connr->len);
 
     if(BUF->ackno[0] == uip_acc32[0] &&
@@ -1464,7 +1540,7 @@ uip_process(u8_t flag)
       /* Do RTT estimation, unless we have done retransmissions. */
       if(uip_connr->nrtx == 0) {
 	signed char m;
-	m = uip_connr->rto - uip_connr->timer;
+	m = uip_connr->rto - UIP_TIMER_LEFT(uip_connr);
 	/* This is taken directly from VJs original code in his paper */
 	m = m - (uip_connr->sa >> 3);
 	uip_connr->sa += m;
@@ -1479,7 +1555,9 @@ uip_process(u8_t flag)
       /* Set the acknowledged flag. */
       uip_flags = UIP_ACKDATA;
       /* Reset the retransmission timer. */
-      uip_connr->timer = uip_connr->rto;
+      UIP_TIMER_SET(uip_connr, uip_connr->rto);
+
+      uip_acklen = uip_connr->len;
 
       /* Reset length of outstanding data. */
       uip_connr->len = 0;
@@ -1598,6 +1676,7 @@ uip_process(u8_t flag)
       uip_connr->len = 1;
       uip_connr->tcpstateflags = UIP_LAST_ACK;
       uip_connr->nrtx = 0;
+      UIP_TIMER_SET(uip_connr, uip_connr->rto);
     tcp_send_finack:
       BUF->flags = TCP_FIN | TCP_ACK;
       goto tcp_send_nodata;
@@ -1647,6 +1726,9 @@ uip_process(u8_t flag)
        "persistent timer" and uses the retransmission mechanism.
     */
     tmp16 = ((u16_t)BUF->wnd[0] << 8) + (u16_t)BUF->wnd[1];
+#if UIP_TCP_SEND_SEGMENTS > 1
+    uip_connr->wnd = tmp16;
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
     if(tmp16 > uip_connr->initialmss ||
        tmp16 == 0) {
       tmp16 = uip_connr->initialmss;
@@ -1687,6 +1769,7 @@ uip_process(u8_t flag)
 	uip_connr->len = 1;
 	uip_connr->tcpstateflags = UIP_FIN_WAIT_1;
 	uip_connr->nrtx = 0;
+	UIP_TIMER_SET(uip_connr, uip_connr->rto);
 	BUF->flags = TCP_FIN | TCP_ACK;
 	goto tcp_send_nodata;
       }
@@ -1696,7 +1779,11 @@ uip_process(u8_t flag)
 
 	/* If the connection has acknowledged data, the contents of
 	   the ->len variable should be discarded. */
-	if((uip_flags & UIP_ACKDATA) != 0) {
+	if((uip_flags & UIP_ACKDATA) != 0
+#if UIP_TCP_SEND_SEGMENTS > 1
+	   && !uip_connr->sndwnd
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+	   ) {
 	  uip_connr->len = 0;
 	}
 
@@ -1713,8 +1800,25 @@ uip_process(u8_t flag)
 	  }
 
 	  /* Remember how much data we send out now so that we know
-	     when everything has been acknowledged. */
+	     when everything has been acknowledged, and start the
+	     retransmission timer. */
 	  uip_connr->len = uip_slen;
+	  UIP_TIMER_SET(uip_connr, uip_connr->rto);
+#if UIP_TCP_SEND_SEGMENTS > 1
+	} else if(uip_connr->sndwnd) {
+
+	  /* With an open send window, the new data follows the data
+	     already in flight if there is room for it. */
+	  if(uip_tcp_sendable(uip_connr)) {
+	    if(uip_slen > uip_connr->mss) {
+	      uip_slen = uip_connr->mss;
+	    }
+	    sndoff = uip_connr->len;
+	    uip_connr->len += uip_slen;
+	  } else {
+	    uip_slen = 0;
+	  }
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
 	} else {
 
 	  /* If the application already had unacknowledged data, we
@@ -1731,7 +1835,11 @@ uip_process(u8_t flag)
          packet had new data in it, we must send out a packet. */
       if(uip_slen > 0 && uip_connr->len > 0) {
 	/* Add the length of the IP and TCP headers. */
+#if UIP_TCP_SEND_SEGMENTS > 1
+	uip_len = uip_slen + UIP_TCPIP_HLEN;
+#else /* UIP_TCP_SEND_SEGMENTS > 1 */
 	uip_len = uip_connr->len + UIP_TCPIP_HLEN;
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
 	/* We always set the ACK flag in response packets. */
 	BUF->flags = TCP_ACK | TCP_PSH;
 	/* Send the packet. */
@@ -1766,7 +1874,7 @@ uip_process(u8_t flag)
     if(BUF->flags & TCP_FIN) {
       if(uip_flags & UIP_ACKDATA) {
 	uip_connr->tcpstateflags = UIP_TIME_WAIT;
-	uip_connr->timer = 0;
+	UIP_TIMER_SET(uip_connr, UIP_TIME_WAIT_TIMEOUT - 1);
 	uip_connr->len = 0;
       } else {
 	uip_connr->tcpstateflags = UIP_CLOSING;
@@ -1777,6 +1885,7 @@ uip_process(u8_t flag)
       goto tcp_send_ack;
     } else if(uip_flags & UIP_ACKDATA) {
       uip_connr->tcpstateflags = UIP_FIN_WAIT_2;
+      UIP_TIMER_SET(uip_connr, UIP_TIME_WAIT_TIMEOUT - 1);
       uip_connr->len = 0;
       goto drop;
     }
@@ -1791,7 +1900,7 @@ uip_process(u8_t flag)
     }
     if(BUF->flags & TCP_FIN) {
       uip_connr->tcpstateflags = UIP_TIME_WAIT;
-      uip_connr->timer = 0;
+      UIP_TIMER_SET(uip_connr, UIP_TIME_WAIT_TIMEOUT - 1);
       uip_add_rcv_nxt(1);
       uip_flags = UIP_CLOSE;
       UIP_APPCALL();
@@ -1808,7 +1917,7 @@ uip_process(u8_t flag)
   case UIP_CLOSING:
     if(uip_flags & UIP_ACKDATA) {
       uip_connr->tcpstateflags = UIP_TIME_WAIT;
-      uip_connr->timer = 0;
+      UIP_TIMER_SET(uip_connr, UIP_TIME_WAIT_TIMEOUT - 1);
     }
   }
   goto drop;
@@ -1834,10 +1943,24 @@ uip_process(u8_t flag)
   BUF->ackno[2] = uip_connr->rcv_nxt[2];
   BUF->ackno[3] = uip_connr->rcv_nxt[3];
 
-  BUF->seqno[0] = uip_connr->snd_nxt[0];
-  BUF->seqno[1] = uip_connr->snd_nxt[1];
-  BUF->seqno[2] = uip_connr->snd_nxt[2];
-  BUF->seqno[3] = uip_connr->snd_nxt[3];
+#if UIP_TCP_SEND_SEGMENTS > 1
+  if(sndoff > 0) {
+    /* The segment follows other data that is still in flight. */
+    uip_add32(uip_connr->snd_nxt, sndoff);
+    sndoff = 0;
+
+    BUF->seqno[0] = uip_acc32[0];
+    BUF->seqno[1] = uip_acc32[1];
+    BUF->seqno[2] = uip_acc32[2];
+    BUF->seqno[3] = uip_acc32[3];
+  } else
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+  {
+    BUF->seqno[0] = uip_connr->snd_nxt[0];
+    BUF->seqno[1] = uip_connr->snd_nxt[1];
+    BUF->seqno[2] = uip_connr->snd_nxt[2];
+    BUF->seqno[3] = uip_connr->snd_nxt[3];
+  }
 
   BUF->proto = UIP_PROTO_TCP;
 
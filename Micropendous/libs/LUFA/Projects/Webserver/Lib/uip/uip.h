@@ -306,6 +306,42 @@ void uip_setipid(u16_t id);
  */
 #define uip_input()        uip_process(UIP_DATA)
 
+/**
+ * Advance the TCP timers by one period.
+ *
+ * This function should be called each time the periodic uIP timer
+ * goes off, before the connections are processed with
+ * uip_periodic().
+ */
+void uip_tick(void);
+
+/**
+ * Check if the TCP timer of a connection is running.
+ *
+ * The timer runs while the connection has unacknowledged data, or
+ * is waiting to time out in the TIME_WAIT or FIN_WAIT_2 state. Only
+ * these connections need periodic processing, once uip_ticks has
+ * reached the value given by uip_timer_expiry().
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ *
+ * \hideinitializer
+ */
+#define uip_timer_running(conn) ((conn)->tcpstateflags == UIP_TIME_WAIT || \
+                                 (conn)->tcpstateflags == UIP_FIN_WAIT_2 || \
+                                 ((conn)->tcpstateflags != UIP_CLOSED &&   \
+                                  uip_outstanding(conn)))
+
+/**
+ * The value of uip_ticks at which the TCP timer of a connection
+ * expires.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ *
+ * \hideinitializer
+ */
+#define uip_timer_expiry(conn) ((conn)->timer)
+
 
 /**
  * Periodic processing for a connection identified by its number.
@@ -313,7 +349,10 @@ void uip_setipid(u16_t id);
  * This function does the necessary periodic processing (timers,
  * polling) for a uIP TCP connection, and should be called when the
  * periodic uIP timer goes off. It should be called for every
- * connection, regardless of whether they are open of closed.
+ * connection, regardless of whether they are open of closed, or
+ * only for the connections whose timer is running and due (see
+ * uip_timer_running()) if the application is not polled for new
+ * data in the periodic processing.
  *
  * When the function returns, it may have an outbound packet waiting
  * for service in the uIP packet buffer, and if so the uip_len
@@ -323,6 +362,7 @@ void uip_setipid(u16_t id);
  * The usual way of calling the function is through a for() loop like
  * this:
  \code
+ uip_tick();
  for(i = 0; i < UIP_CONNS; ++i) {
  uip_periodic(i);
  if(uip_len > 0) {
@@ -336,6 +376,7 @@ void uip_setipid(u16_t id);
  * Ethernet, you will need to call the uip_arp_out() function before
  * calling the device driver:
  \code
+ uip_tick();
  for(i = 0; i < UIP_CONNS; ++i) {
  uip_periodic(i);
  if(uip_len > 0) {
@@ -566,6 +607,23 @@ struct uip_conn *uip_connect(uip_ipaddr_t *ripaddr, u16_t port);
  */
 #define uip_outstanding(conn) ((conn)->len)
 
+/**
+ * \internal
+ *
+ * Check if a connection may send another segment of new data.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ *
+ * \hideinitializer
+ */
+#if UIP_TCP_SEND_SEGMENTS > 1
+#define uip_tcp_sendable(conn) (!(conn)->len ||                         \
+                                ((conn)->len + (conn)->mss <= (conn)->sndwnd && \
+                                 (conn)->len + (conn)->mss <= (conn)->wnd))
+#else /* UIP_TCP_SEND_SEGMENTS > 1 */
+#define uip_tcp_sendable(conn) (!(conn)->len)
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+
 /**
  * Send data on the current connection.
  *
@@ -703,6 +761,18 @@ void uip_send(const void *data, int len);
  */
 #define uip_acked()   (uip_flags & UIP_ACKDATA)
 
+/**
+ * Get the number of bytes acknowledged by the remote host.
+ *
+ * Only valid when uip_acked() is true. On a connection with an open
+ * send window (see uip_open_window()) this may be less than the
+ * amount of data in flight, in which case uip_outstanding() is still
+ * non-zero.
+ *
+ * \hideinitializer
+ */
+#define uip_ackedlen()   (uip_acklen)
+
 /**
  * Has the connection just been connected?
  *
@@ -792,6 +862,58 @@ void uip_send(const void *data, int len);
  */
 #define uip_mss()             (uip_conn->mss)
 
+/**
+ * Allow the current connection to keep several segments in flight.
+ *
+ * Once the send window is opened, the application is polled and may
+ * send new data while earlier data is still unacknowledged, up to
+ * UIP_TCP_SEND_SEGMENTS segments or the window advertised by the
+ * remote host. Each call to uip_send() then appends a segment to the
+ * data in flight, which starts uip_outstanding() bytes after the
+ * last byte acknowledged by the remote host.
+ *
+ * On a uip_rexmit() event uIP goes back to the oldest unacknowledged
+ * byte: the application must resend its data from that point, of
+ * which at most uip_mss() bytes are sent. The rest of the data that
+ * was in flight is discarded and must be sent again as new data.
+ *
+ * The application must not call uip_close() before all its data has
+ * been acknowledged.
+ *
+ * This function does nothing if UIP_TCP_SEND_SEGMENTS is 1.
+ *
+ * \hideinitializer
+ */
+#if UIP_TCP_SEND_SEGMENTS > 1
+#define uip_open_window()     (uip_conn->sndwnd = UIP_TCP_SEND_SEGMENTS * uip_conn->initialmss)
+#else /* UIP_TCP_SEND_SEGMENTS > 1 */
+#define uip_open_window()
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+
+/**
+ * Return the current connection to sending one segment at a time.
+ *
+ * This undoes uip_open_window(), and must only be called when the
+ * connection has no outstanding data.
+ *
+ * \hideinitializer
+ */
+#if UIP_TCP_SEND_SEGMENTS > 1
+#define uip_close_window()    (uip_conn->sndwnd = 0)
+#else /* UIP_TCP_SEND_SEGMENTS > 1 */
+#define uip_close_window()
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+
+/**
+ * Check whether a new segment can be sent on the current connection.
+ *
+ * Reduces to non-zero if the connection has no outstanding data, or
+ * if its send window has room for another maximum sized segment.
+ *
+ * \hideinitializer
+ */
+#define uip_sendable()        (uip_tcp_sendable(uip_conn))
+
 /**
  * Set up a new UDP connection.
  *
@@ -1268,6 +1390,18 @@ extern u8_t uip_ext_len;
 extern u16_t uip_urglen, uip_surglen;
 #endif /* UIP_URGDATA > 0 */
 
+/**
+ * The number of bytes acknowledged by the last incoming segment.
+ *
+ * \sa uip_ackedlen()
+ */
+extern u16_t uip_acklen;
+
+/**
+ * The number of periods of the TCP timers, advanced by uip_tick().
+ */
+extern u8_t uip_ticks;
+
 
 /**
  * Representation of a uIP TCP connection.
@@ -1301,9 +1435,18 @@ struct uip_conn {
 			 variable. */
   u8_t rto;           /**< Retransmission time-out. */
   u8_t tcpstateflags; /**< TCP state and flags. */
-  u8_t timer;         /**< The retransmission timer. */
+  u8_t timer;         /**< The value of uip_ticks at which the
+			 retransmission timer expires. */
   u8_t nrtx;          /**< The number of retransmissions for the last
 			 segment sent. */
+#if UIP_TCP_SEND_SEGMENTS > 1
+  u16_t wnd;          /**< The receive window advertised by the remote
+			 host. */
+  u16_t sndwnd;       /**< The amount of data that may be in flight, or
+			 zero for one segment at a time. */
+#endif /* UIP_TCP_SEND_SEGMENTS > 1 */
+  u8_t arpidx;        /**< The ARP table entry last used for the
+			 connection's next hop. */
 
   /** The application state. */
   uip_tcp_appstate_t appstate;
@@ -1342,6 +1485,8 @@ struct uip_udp_conn {
   u16_t lport;        /**< The local port number in network byte order. */
   u16_t rport;        /**< The remote port number in network byte order. */
   u8_t  ttl;          /**< Default time-to-live. */
+  u8_t  arpidx;       /**< The ARP table entry last used for the
+			 connection's next hop. */
 
   /** The application state. */
   uip_udp_appstate_t appstate;
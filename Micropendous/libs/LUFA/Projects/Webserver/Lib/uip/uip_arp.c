@@ -99,13 +99,22 @@ struct arp_entry {
   uip_ipaddr_t ipaddr;
   struct uip_eth_addr ethaddr;
   u8_t time;
+  u8_t next;   /* Next entry in the same hash bucket, or in the free list. */
 };
 
+#define ARP_NO_ENTRY 0xff
+
+/* The hash bucket of an IP address, from its two low-order bytes,
+   which differ the most between hosts on the local network. */
+#define ARP_HASH(addr) (((addr)->u8[2] ^ (addr)->u8[3]) & (UIP_ARP_BUCKETS - 1))
+
 static const struct uip_eth_addr broadcast_ethaddr =
   {{0xff,0xff,0xff,0xff,0xff,0xff}};
-static const u16_t broadcast_ipaddr[2] = {0xffff,0xffff};
 
 static struct arp_entry arp_table[UIP_ARPTAB_SIZE];
+static u8_t arp_buckets[UIP_ARP_BUCKETS];
+static u8_t arp_free;
+static u8_t arp_sweep;
 static uip_ipaddr_t ipaddr;
 static u8_t i, c;
 
@@ -132,9 +141,40 @@ static u8_t tmpage;
 void
 uip_arp_init(void)
 {
+  /* All entries start out in the free list, and all buckets empty. */
   for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
     memset(&arp_table[i].ipaddr, 0, 4);
+    arp_table[i].next = i + 1;
   }
+  arp_table[UIP_ARPTAB_SIZE - 1].next = ARP_NO_ENTRY;
+  arp_free = 0;
+
+  memset(arp_buckets, ARP_NO_ENTRY, sizeof(arp_buckets));
+  arp_sweep = 0;
+}
+/*-----------------------------------------------------------------------------------*/
+/* Return the index of the ARP table entry for an IP address, or
+   ARP_NO_ENTRY if there is none. */
+static u8_t
+uip_arp_lookup(uip_ipaddr_t *addr)
+{
+  for(c = arp_buckets[ARP_HASH(addr)]; c != ARP_NO_ENTRY; c = arp_table[c].next) {
+    if(uip_ipaddr_cmp(addr, &arp_table[c].ipaddr)) {
+      break;
+    }
+  }
+  return c;
+}
+/*-----------------------------------------------------------------------------------*/
+/* Unlink an entry from its hash bucket. */
+static void
+uip_arp_unlink(u8_t entry)
+{
+  u8_t *link;
+
+  for(link = &arp_buckets[ARP_HASH(&arp_table[entry].ipaddr)];
+      *link != entry; link = &arp_table[*link].next);
+  *link = arp_table[entry].next;
 }
 /*-----------------------------------------------------------------------------------*/
 /**
@@ -144,64 +184,60 @@ uip_arp_init(void)
  * and should be called at regular intervals. The recommended interval
  * is 10 seconds between the calls.
  *
+ * Each call ages the entries of one hash bucket.
+ *
  */
 /*-----------------------------------------------------------------------------------*/
 void
 uip_arp_timer(void)
 {
-  struct arp_entry *tabptr = NULL;
+  u8_t *link;
+  struct arp_entry *tabptr;
 
   ++arptime;
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-    tabptr = &arp_table[i];
-    if(uip_ipaddr_cmp(&tabptr->ipaddr, &uip_all_zeroes_addr) &&
-       arptime - tabptr->time >= UIP_ARP_MAXAGE) {
+  link = &arp_buckets[arp_sweep];
+  while(*link != ARP_NO_ENTRY) {
+    tabptr = &arp_table[*link];
+    if((u8_t)(arptime - tabptr->time) >= UIP_ARP_MAXAGE) {
+      /* Move the expired entry to the free list. */
+      c = *link;
+      *link = tabptr->next;
       memset(&tabptr->ipaddr, 0, 4);
+      tabptr->next = arp_free;
+      arp_free = c;
+    } else {
+      link = &tabptr->next;
     }
   }
-
+  arp_sweep = (arp_sweep + 1) & (UIP_ARP_BUCKETS - 1);
 }
 /*-----------------------------------------------------------------------------------*/
 static void
 uip_arp_update(uip_ipaddr_t *ipaddr, struct uip_eth_addr *ethaddr)
 {
   register struct arp_entry *tabptr = NULL;
-  /* Walk through the ARP mapping table and try to find an entry to
-     update. If none is found, the IP -> MAC address mapping is
-     inserted in the ARP table. */
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-
+  /* Look for an entry to update in the IP address's hash bucket. If
+     none is found, the IP -> MAC address mapping is inserted in the
+     ARP table. */
+  i = uip_arp_lookup(ipaddr);
+  if(i != ARP_NO_ENTRY) {
+    /* An old entry found, update this and return. */
     tabptr = &arp_table[i];
-    /* Only check those entries that are actually in use. */
-    if(!uip_ipaddr_cmp(&tabptr->ipaddr, &uip_all_zeroes_addr)) {
-
-      /* Check if the source IP address of the incoming packet matches
-         the IP address in this ARP table entry. */
-      if(uip_ipaddr_cmp(ipaddr, &tabptr->ipaddr)) {
-
-	/* An old entry found, update this and return. */
-	memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
-	tabptr->time = arptime;
-
-	return;
-      }
-    }
+    memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
+    tabptr->time = arptime;
+    return;
   }
 
   /* If we get here, no existing ARP table entry was found, so we
      create one. */
 
-  /* First, we try to find an unused entry in the ARP table. */
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-    tabptr = &arp_table[i];
-    if(uip_ipaddr_cmp(&tabptr->ipaddr, &uip_all_zeroes_addr)) {
-      break;
-    }
-  }
-
-  /* If no unused entry is found, we try to find the oldest entry and
-     throw it away. */
-  if(i == UIP_ARPTAB_SIZE) {
+  /* First, we try to take an unused entry from the free list. */
+  if(arp_free != ARP_NO_ENTRY) {
+    i = arp_free;
+    arp_free = arp_table[i].next;
+  } else {
+    /* If no unused entry is found, we try to find the oldest entry and
+       throw it away. */
     tmpage = 0;
     c = 0;
     for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
@@ -212,14 +248,18 @@ uip_arp_update(uip_ipaddr_t *ipaddr, struct uip_eth_addr *ethaddr)
       }
     }
     i = c;
-    tabptr = &arp_table[i];
+    uip_arp_unlink(i);
   }
 
   /* Now, i is the ARP table entry which we will fill with the new
-     information. */
+     information, and link into its hash bucket. */
+  tabptr = &arp_table[i];
   uip_ipaddr_copy(&tabptr->ipaddr, ipaddr);
   memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
   tabptr->time = arptime;
+  c = ARP_HASH(ipaddr);
+  tabptr->next = arp_buckets[c];
+  arp_buckets[c] = i;
 }
 /*-----------------------------------------------------------------------------------*/
 /**
@@ -353,6 +393,10 @@ uip_arp_arpin(void)
  * If the destination IP address is not on the local network, the IP
  * address of the default router is used instead.
  *
+ * The ARP table entry used is remembered in the TCP or UDP connection
+ * the packet belongs to, so that later packets on the connection skip
+ * the table lookup while the entry still holds their next hop.
+ *
  * When the function returns, a packet is present in the uip_buf[]
  * buffer, and the length of the packet is in the global variable
  * uip_len.
@@ -362,6 +406,7 @@ void
 uip_arp_out(void)
 {
   struct arp_entry *tabptr = NULL;
+  u8_t *arpidx = NULL;
 
   /* Find the destination IP address in the ARP table and construct
      the Ethernet header. If the destination IP address isn't on the
@@ -385,14 +430,27 @@ uip_arp_out(void)
       uip_ipaddr_copy(&ipaddr, &IPBUF->destipaddr);
     }
 
-    for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-      tabptr = &arp_table[i];
-      if(uip_ipaddr_cmp(&ipaddr, &tabptr->ipaddr)) {
-	break;
+    /* Find the connection the packet belongs to, and try the ARP table
+       entry it last used first. */
+    if(IPBUF->proto == UIP_PROTO_TCP && uip_conn != NULL) {
+      arpidx = &uip_conn->arpidx;
+#if UIP_UDP
+    } else if(IPBUF->proto == UIP_PROTO_UDP && uip_udp_conn != NULL) {
+      arpidx = &uip_udp_conn->arpidx;
+#endif /* UIP_UDP */
+    }
+
+    if(arpidx != NULL && *arpidx < UIP_ARPTAB_SIZE &&
+       uip_ipaddr_cmp(&ipaddr, &arp_table[*arpidx].ipaddr)) {
+      i = *arpidx;
+    } else {
+      i = uip_arp_lookup(&ipaddr);
+      if(arpidx != NULL) {
+	*arpidx = i;
       }
     }
 
-    if(i == UIP_ARPTAB_SIZE) {
+    if(i == ARP_NO_ENTRY) {
       /* The destination address was not in our ARP table, so we
 	 overwrite the IP packet with an ARP request. */
 
@@ -417,6 +475,7 @@ uip_arp_out(void)
     }
 
     /* Build an ethernet header. */
+    tabptr = &arp_table[i];
     memcpy(IPBUF->ethhdr.dest.addr, tabptr->ethaddr.addr, 6);
   }
   memcpy(IPBUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
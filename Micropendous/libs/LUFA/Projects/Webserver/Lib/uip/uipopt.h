@@ -409,6 +409,23 @@
 #define UIP_RECEIVE_WINDOW UIP_CONF_RECEIVE_WINDOW
 #endif
 
+/**
+ * The number of maximum sized segments a connection may have in
+ * flight at once.
+ *
+ * With the default of 1, uIP waits for each segment to be
+ * acknowledged before the next may be sent. Larger values allow
+ * connections that call uip_open_window() to keep several segments
+ * outstanding, limited by the window advertised by the remote host.
+ *
+ * \hideinitializer
+ */
+#ifndef UIP_CONF_TCP_SEND_SEGMENTS
+#define UIP_TCP_SEND_SEGMENTS 1
+#else
+#define UIP_TCP_SEND_SEGMENTS UIP_CONF_TCP_SEND_SEGMENTS
+#endif
+
 /**
  * How long a connection should stay in the TIME_WAIT state.
  *
@@ -447,6 +464,22 @@
  */
 #define UIP_ARP_MAXAGE 120
 
+/**
+ * The number of hash buckets the ARP table is divided into.
+ *
+ * Must be a power of two. Lookups only search the entries in one
+ * bucket, and each call to uip_arp_timer() ages one bucket, so
+ * entries expire between UIP_ARP_MAXAGE and UIP_ARP_MAXAGE +
+ * UIP_ARP_BUCKETS - 1 timer periods after they were last refreshed.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_ARP_BUCKETS
+#define UIP_ARP_BUCKETS UIP_CONF_ARP_BUCKETS
+#else
+#define UIP_ARP_BUCKETS 8
+#endif
+
 
 /** @} */
 
@@ -696,8 +729,13 @@ typedef union
 		char     FileName[MAX_URI_LENGTH];
 		FIL      FileHandle;
 		bool     FileOpen;
+		bool     GZipEncoded;
+		bool     NotModified;
+		bool     KeepAlive;
+		uint16_t FileDate;
+		uint16_t FileTime;
 		uint32_t ACKedFilePos;
-		uint16_t SentChunkSize;
+		struct timer IdleTimer;
 	} HTTPServer;
 
 	struct
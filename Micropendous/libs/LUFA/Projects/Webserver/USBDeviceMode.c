@@ -36,6 +36,9 @@
 
 #include "USBDeviceMode.h"
 
+/** Receive queue for small Ethernet frames taken from combined RNDIS transfers by the RNDIS Class driver. */
+static uint8_t RNDISFrameQueue[RNDIS_FRAME_QUEUE_SIZE];
+
 /** LUFA RNDIS Class driver interface configuration and state information. This structure is
  *  passed to all RNDIS Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -65,6 +68,9 @@ USB_ClassInfo_RNDIS_Device_t Ethernet_RNDIS_Interface_Device =
 					},
 				.AdapterVendorDescription       = "LUFA RNDIS Adapter",
 				.AdapterMACAddress              = {{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}},
+				.MaxPacketsPerTransfer          = RNDIS_PACKETS_PER_TRANSFER,
+				.FrameQueueBuffer               = RNDISFrameQueue,
+				.FrameQueueSize                 = sizeof(RNDISFrameQueue),
 			},
 	};
 
@@ -43,6 +43,7 @@
 		#include "Lib/uIPManagement.h"
 		#include "Config/AppConfig.h"
 
+	#if defined(USB_CAN_BE_HOST)
 	/* External Variables: */
 		extern USB_ClassInfo_RNDIS_Host_t Ethernet_RNDIS_Interface_Host;
 
@@ -55,6 +56,7 @@
 		void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
 		                                            const uint8_t SubErrorCode);
 		void EVENT_USB_Host_DeviceEnumerationComplete(void);
+	#endif
 
 #endif
 
@@ -45,7 +45,9 @@
 
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Dataflash.h>
-		#include <LUFA/Drivers/Peripheral/SPI.h>
+		#if (ARCH == ARCH_AVR8)
+			#include <LUFA/Drivers/Peripheral/SPI.h>
+		#endif
 		#include <LUFA/Drivers/USB/USB.h>
 
 		#include "USBDeviceMode.h"
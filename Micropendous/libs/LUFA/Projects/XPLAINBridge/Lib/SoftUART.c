@@ -121,9 +121,9 @@ ISR(TIMER1_COMPA_vect, ISR_BLOCK)
 		EIFR   = (1 << INTF0);
 		EIMSK  = (1 << INT0);
 
-		/* Reception complete, store the received byte if stop bit valid */
-		if (SRX_Cached)
-		  RingBuffer_Insert(&UARTtoUSB_Buffer, RX_Data);
+		/* Reception complete, store the received byte if stop bit valid and there is room for it */
+		if (SRX_Cached && !(RingBufferSPSC_IsFull(&UARTtoUSB_Buffer)))
+		  RingBufferSPSC_Insert(&UARTtoUSB_Buffer, RX_Data);
 	}
 }
 
@@ -143,13 +143,13 @@ ISR(TIMER3_COMPA_vect, ISR_BLOCK)
 		TX_Data >>= 1;
 		TX_BitsRemaining--;
 	}
-	else if (!(RX_BitsRemaining) && !(RingBuffer_IsEmpty(&USBtoUART_Buffer)))
+	else if (!(RX_BitsRemaining) && !(RingBufferSPSC_IsEmpty(&USBtoUART_Buffer)))
 	{
 		/* Start bit - TX line low */
 		STXPORT &= ~(1 << STX);
 
 		/* Transmission complete, get the next byte to send (if available) */
-		TX_Data          = ~RingBuffer_Remove(&USBtoUART_Buffer);
+		TX_Data          = ~RingBufferSPSC_Remove(&USBtoUART_Buffer);
 		TX_BitsRemaining = 9;
 	}
 }
@@ -66,20 +66,21 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 						.Size                   = CDC_NOTIFICATION_EPSIZE,
 						.Banks                  = 1,
 					},
+				.CoalesceFrames                 = UART_FLUSH_FRAMES,
 			},
 	};
 
 /** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
-RingBuffer_t   USBtoUART_Buffer;
+RingBufferSPSC_t USBtoUART_Buffer;
 
 /** Underlying data buffer for \ref USBtoUART_Buffer, where the stored bytes are located. */
-static uint8_t USBtoUART_Buffer_Data[128];
+static uint8_t   USBtoUART_Buffer_Data[128];
 
 /** Circular buffer to hold data from the serial port before it is sent to the host. */
-RingBuffer_t   UARTtoUSB_Buffer;
+RingBufferSPSC_t UARTtoUSB_Buffer;
 
 /** Underlying data buffer for \ref UARTtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t UARTtoUSB_Buffer_Data[128];
+static uint8_t   UARTtoUSB_Buffer_Data[128];
 
 
 /** Main program entry point. This routine contains the overall program flow, including initial
@@ -131,37 +132,13 @@ void UARTBridge_Task(void)
 	if (USB_DeviceState != DEVICE_STATE_Configured)
 	  return;
 
-	/* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-	if (!(RingBuffer_IsFull(&USBtoUART_Buffer)))
-	{
-		int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
-
-		/* Read bytes from the USB OUT endpoint into the UART transmit buffer */
-		if (!(ReceivedByte < 0))
-		  RingBuffer_Insert(&USBtoUART_Buffer, ReceivedByte);
-	}
-
-	/* Check if the UART receive buffer flush timer has expired or buffer is nearly full */
-	uint16_t BufferCount = RingBuffer_GetCount(&UARTtoUSB_Buffer);
-	if ((TIFR0 & (1 << TOV0)) || (BufferCount > 200))
-	{
-		/* Clear flush timer expiry flag */
-		TIFR0 |= (1 << TOV0);
-
-		/* Read bytes from the USART receive buffer into the USB IN endpoint */
-		while (BufferCount--)
-		{
-			/* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-			if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-									RingBuffer_Peek(&UARTtoUSB_Buffer)) != ENDPOINT_READYWAIT_NoError)
-			{
-				break;
-			}
+	/* Move received data from the USB OUT endpoint bank into the UART transmit buffer as a block, where it is
+	 * drained by the software UART's transmission ISR */
+	CDC_Device_ReceiveToRingBuffer(&VirtualSerial_CDC_Interface, &USBtoUART_Buffer);
 
-			/* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-			RingBuffer_Remove(&UARTtoUSB_Buffer);
-		}
-	}
+	/* Move data from the UART receive buffer into the USB IN endpoint bank as a block - the CDC class driver
+	 * sends the bank once it is full, or once UART_FLUSH_FRAMES USB frames have elapsed */
+	CDC_Device_SendFromRingBuffer(&VirtualSerial_CDC_Interface, &UARTtoUSB_Buffer);
 
 	CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
 }
@@ -212,12 +189,9 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 	{
 		ConfigSuccess &= CDC_Device_ConfigureEndpoints(&VirtualSerial_CDC_Interface);
 
-		/* Configure the UART flush timer - run at Fcpu/1024 for maximum interval before overflow */
-		TCCR0B = ((1 << CS02) | (1 << CS00));
-
 		/* Initialize ring buffers used to hold serial data between USB and software UART interfaces */
-		RingBuffer_InitBuffer(&USBtoUART_Buffer, USBtoUART_Buffer_Data, sizeof(USBtoUART_Buffer_Data));
-		RingBuffer_InitBuffer(&UARTtoUSB_Buffer, UARTtoUSB_Buffer_Data, sizeof(UARTtoUSB_Buffer_Data));
+		RingBufferSPSC_InitBuffer(&USBtoUART_Buffer, USBtoUART_Buffer_Data, sizeof(USBtoUART_Buffer_Data));
+		RingBufferSPSC_InitBuffer(&UARTtoUSB_Buffer, UARTtoUSB_Buffer_Data, sizeof(UARTtoUSB_Buffer_Data));
 
 		/* Start the software USART */
 		SoftUART_Init();
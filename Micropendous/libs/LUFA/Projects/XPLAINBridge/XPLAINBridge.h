@@ -51,7 +51,7 @@
 		#include "Config/AppConfig.h"
 
 		#include <LUFA/Drivers/Board/LEDs.h>
-		#include <LUFA/Drivers/Misc/RingBuffer.h>
+		#include <LUFA/Drivers/Misc/RingBufferSPSC.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
@@ -76,10 +76,15 @@
 		/** Firmware mode define for the AVRISP Programmer mode. */
 		#define MODE_PDI_PROGRAMMER      true
 
+		/** Maximum number of USB frames that data received from the software UART is held back for, so that it can be
+		 *  coalesced into full packets to the host.
+		 */
+		#define UART_FLUSH_FRAMES        10
+
 	/* External Variables: */
 		extern bool         CurrentFirmwareMode;
-		extern RingBuffer_t UARTtoUSB_Buffer;
-		extern RingBuffer_t USBtoUART_Buffer;
+		extern RingBufferSPSC_t UARTtoUSB_Buffer;
+		extern RingBufferSPSC_t USBtoUART_Buffer;
 
 	/* Function Prototypes: */
 		void SetupHardware(void);
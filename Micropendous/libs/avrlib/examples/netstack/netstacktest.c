@@ -41,6 +41,7 @@
 #define LOOPBACK_PORT		7		// UDP packets sent to this port will be returned to sender
 #define CONTROL_PORT		4950	// UDP packets sent to this port will be used for control
 #define SERIAL_PORT			4951	// UDP packets sent to this port will be printed via serial
+#define ECHO_PORT			7		// TCP requests sent to this port will be returned to sender
 
 // timer defines
 #define TIMER_PRESCALE		1024
@@ -50,6 +51,10 @@
 static volatile unsigned long UptimeMs;
 
 // functions
+void loopbackHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data);
+void controlHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data);
+void serialHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data);
+u16 echoHandler(uint32_t srcIp, uint16_t len, u08* data, u16 maxlen);
 void processCommand(u16 len, u08* data);
 void serviceLocal(void);
 void systickHandler(void);
@@ -75,6 +80,10 @@ int main(void)
 	// init network stack
 	rprintf("Initializing Network Stack\r\n");
 	netstackInit(IPADDRESS, NETMASK, GATEWAY);
+	netstackUDPAttach(LOOPBACK_PORT, loopbackHandler);
+	netstackUDPAttach(CONTROL_PORT, controlHandler);
+	netstackUDPAttach(SERIAL_PORT, serialHandler);
+	netstackTCPAttach(ECHO_PORT, echoHandler);
 
 	nicGetMacAddress(&myEthAddress.addr[0]);
 	rprintfProgStrM("Eth Addr is: "); netPrintEthAddr(&myEthAddress);		rprintfCRLF();
@@ -95,43 +104,32 @@ int main(void)
 }
 
 
-void netstackUDPIPProcess(unsigned int len, udpip_hdr* packet)
+void loopbackHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data)
 {
-	u16 payloadlen=0;
-	u08* payloaddata=0;
-	u16 i;
-
-	// get UDP payload length
-	payloadlen = htons(packet->udp.udplen);
-	payloadlen -= 8; // subtract header
-	// get UDP payload data
-	payloaddata = &((unsigned char*)packet)[IP_HEADER_LEN+UDP_HEADER_LEN];
-	
-	rprintf("UDP packet, len: %d\r\n", len);
-//	debugPrintHexTable(len, (unsigned char*)packet);
+	// return packet to sender, straight from the receive buffer
+	udpSendFrom(srcIp, LOOPBACK_PORT, srcPort, len, data);
+}
 
-	if(packet->udp.destport == HTONS(CONTROL_PORT))
-	{
-		// command packet
-		processCommand(payloadlen, payloaddata);
-	}
-	else if(packet->udp.destport == HTONS(SERIAL_PORT))
-	{
-		// serial output
-		for(i=0; i<payloadlen; i++)
-			uartSendByte(payloaddata[i]);
-	}
-	else if(packet->udp.destport == HTONS(LOOPBACK_PORT))
-	{
-		// loopback - return packet to sender
-		udpSend(htonl(packet->ip.srcipaddr), LOOPBACK_PORT, payloadlen, payloaddata);
-	}
+void controlHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data)
+{
+	// command packet
+	processCommand(len, data);
 }
 
+void serialHandler(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data)
+{
+	u16 i;
+
+	// serial output
+	for(i=0; i<len; i++)
+		uartSendByte(data[i]);
+}
 
-void netstackTCPIPProcess(unsigned int len, tcpip_hdr* packet)
+u16 echoHandler(uint32_t srcIp, uint16_t len, u08* data, u16 maxlen)
 {
-	rprintf("Received TCP/IP Packet: len=%d\r\n", len);
+	rprintf("Received TCP/IP request: len=%d\r\n", len);
+	// the request is already in place as the reply
+	return len;
 }
 
 
@@ -21,27 +21,48 @@
 
 // global variables
 
+#define ARP_NO_ENTRY	0xFF	///< end of an ArpTable entry list
+
+/// Hash bucket of an IP address (host byte order), from its low-order bytes
+#define arpHash(ipaddr)	((uint8_t)((ipaddr) ^ ((ipaddr)>>8)) & (ARP_HASH_BUCKETS-1))
+
 /// Single ARP table entry/record
 struct ArpEntry
 {
 	uint32_t ipaddr;			///< remote-note IP address
 	struct netEthAddr ethaddr;	///< remote-node ethernet (hardware/mac) address
-	uint8_t time;				///< time to live (in ARP table); this is decremented by arpTimer()
+	uint8_t time;				///< value of ArpClock when the entry was last refreshed
+	uint8_t next;				///< next entry in the same hash bucket (or in the free list)
 };
 
 struct ArpEntry ArpMyAddr;		///< my local interface information (IP and MAC address)
 struct ArpEntry ArpTable[ARP_TABLE_SIZE];	///< ARP table of matched IP<->MAC associations
+static uint8_t ArpBuckets[ARP_HASH_BUCKETS];	///< first entry in each hash bucket
+static uint8_t ArpFree;			///< first unused entry
+static uint8_t ArpClock;		///< incremented by every call to arpTimer()
+static uint8_t ArpSweep;		///< hash bucket to be aged by the next call to arpTimer()
+static uint8_t ArpLastIndex;	///< entry used by the last call to arpIpOut()
 
 
 void arpInit(void)
 {
 	u08 i;
-	// initialize all ArpTable elements to unused
+	// initialize all ArpTable elements to unused, and chain them into the free list
 	for(i=0; i<ARP_TABLE_SIZE; i++)
 	{
 		ArpTable[i].ipaddr = 0;
 		ArpTable[i].time = 0;
+		ArpTable[i].next = i+1;
 	}
+	ArpTable[ARP_TABLE_SIZE-1].next = ARP_NO_ENTRY;
+	ArpFree = 0;
+
+	// empty all hash buckets
+	for(i=0; i<ARP_HASH_BUCKETS; i++)
+		ArpBuckets[i] = ARP_NO_ENTRY;
+
+	ArpSweep = 0;
+	ArpLastIndex = ARP_NO_ENTRY;
 }
 
 void arpSetAddress(struct netEthAddr* myeth, uint32_t myip)
@@ -89,34 +110,39 @@ void arpArpIn(unsigned int len, struct netEthArpHeader* packet)
 
 void arpIpIn(struct netEthIpHeader* packet)
 {
-	int8_t index;
+	uint32_t ipaddr = HTONL(packet->ip.srcipaddr);
+	int index;
+	uint8_t bucket;
 
 	// check if sender is already present in arp table
-	index = arpMatchIp(HTONL(packet->ip.srcipaddr));
+	index = arpMatchIp(ipaddr);
 	if(index != -1)
 	{
-		// sender's IP address found, update ARP entry
+		// sender's IP address found, update and refresh ARP entry
 		ArpTable[index].ethaddr = packet->eth.src;
+		ArpTable[index].time = ArpClock;
 		// and we're done
 		return;
 	}
 
 	// sender was not present in table,
 	// must add in empty/expired slot
-	for(index=0; index<ARP_TABLE_SIZE; index++)
+	if(ArpFree == ARP_NO_ENTRY)
 	{
-		if(!ArpTable[index].time)
-		{
-			// write entry
-			ArpTable[index].ethaddr = packet->eth.src;
-			ArpTable[index].ipaddr = HTONL(packet->ip.srcipaddr);
-			ArpTable[index].time = ARP_CACHE_TIME_TO_LIVE;
-			// and we're done
-			return;
-		}
+		// no space in table, we give up
+		return;
 	}
+	index = ArpFree;
+	ArpFree = ArpTable[index].next;
 
-	// no space in table, we give up
+	// write entry
+	ArpTable[index].ethaddr = packet->eth.src;
+	ArpTable[index].ipaddr = ipaddr;
+	ArpTable[index].time = ArpClock;
+	// and link it into its hash bucket
+	bucket = arpHash(ipaddr);
+	ArpTable[index].next = ArpBuckets[bucket];
+	ArpBuckets[bucket] = index;
 }
 
 void arpIpOut(struct netEthIpHeader* packet, uint32_t phyDstIp)
@@ -124,10 +150,17 @@ void arpIpOut(struct netEthIpHeader* packet, uint32_t phyDstIp)
 	int index;
 	// check if destination is already present in arp table
 	// use the physical dstIp if it's provided, otherwise the dstIp in packet
-	if(phyDstIp)
-		index = arpMatchIp(phyDstIp);
+	if(!phyDstIp)
+		phyDstIp = HTONL(packet->ip.destipaddr);
+	// try the entry used for the previous packet first
+	if( (ArpLastIndex != ARP_NO_ENTRY) && (ArpTable[ArpLastIndex].ipaddr == phyDstIp) )
+		index = ArpLastIndex;
 	else
-		index = arpMatchIp(HTONL(packet->ip.destipaddr));
+	{
+		index = arpMatchIp(phyDstIp);
+		if(index != -1)
+			ArpLastIndex = index;
+	}
 	// fill in ethernet info
 	if(index != -1)
 	{
@@ -153,23 +186,37 @@ void arpIpOut(struct netEthIpHeader* packet, uint32_t phyDstIp)
 
 void arpTimer(void)
 {
-	int index;
+	uint8_t* link;
+	uint8_t index;
 	// this function meant to be called on a regular time interval
 
-	// decrement time-to-live for all entries
-	for(index=0; index<ARP_TABLE_SIZE; index++)
+	ArpClock++;
+
+	// expire old entries from one hash bucket, returning them to the free list
+	link = &ArpBuckets[ArpSweep];
+	while( (index = *link) != ARP_NO_ENTRY )
 	{
-		if(ArpTable[index].time)
-			ArpTable[index].time--;
+		if( (uint8_t)(ArpClock - ArpTable[index].time) >= ARP_CACHE_TIME_TO_LIVE )
+		{
+			*link = ArpTable[index].next;
+			ArpTable[index].ipaddr = 0;
+			ArpTable[index].next = ArpFree;
+			ArpFree = index;
+			if(ArpLastIndex == index)
+				ArpLastIndex = ARP_NO_ENTRY;
+		}
+		else
+			link = &ArpTable[index].next;
 	}
+	ArpSweep = (ArpSweep+1) & (ARP_HASH_BUCKETS-1);
 }
 
 int arpMatchIp(uint32_t ipaddr)
 {
 	uint8_t i;
 
-	// check if IP address is present in arp table
-	for(i=0; i<ARP_TABLE_SIZE; i++)
+	// check if IP address is present in its hash bucket
+	for(i=ArpBuckets[arpHash(ipaddr)]; i!=ARP_NO_ENTRY; i=ArpTable[i].next)
 	{
 		if(ArpTable[i].ipaddr == ipaddr)
 		{
@@ -210,13 +257,19 @@ void arpPrintHeader(struct netArpHeader* packet)
 void arpPrintTable(void)
 {
 	uint8_t i;
+	uint8_t age;
 
 	// print ARP table
 	rprintfProgStrM("Time    Eth Address    IP Address\r\n");
 	rprintfProgStrM("---------------------------------------\r\n");
 	for(i=0; i<ARP_TABLE_SIZE; i++)
 	{
-		rprintfu08(ArpTable[i].time);
+		// remaining time to live
+		age = ArpClock - ArpTable[i].time;
+		if(ArpTable[i].ipaddr && (age < ARP_CACHE_TIME_TO_LIVE))
+			rprintfu08(ARP_CACHE_TIME_TO_LIVE - age);
+		else
+			rprintfu08(0);
 		rprintfProgStrM("   ");
 		netPrintEthAddr(&ArpTable[i].ethaddr);
 		rprintfProgStrM("  ");
@@ -51,6 +51,14 @@
 #define ARP_CACHE_TIME_TO_LIVE	100
 #endif
 
+/// Number of hash buckets the ARP table is divided into (must be a power of
+/// two).  Lookups only search the entries in one bucket, and arpTimer() ages
+/// one bucket per call, so entries live for between ARP_CACHE_TIME_TO_LIVE and
+/// ARP_CACHE_TIME_TO_LIVE+ARP_HASH_BUCKETS-1 calls after last being refreshed.
+#ifndef ARP_HASH_BUCKETS
+#define ARP_HASH_BUCKETS	8
+#endif
+
 //#define ARP_DEBUG_PRINT
 
 
@@ -100,6 +108,9 @@ void arpIpIn(struct netEthIpHeader* packet);
 	embedded systems, such a holdup is unacceptable.  This function instead
 	sends the packet as an ethernet broadcast if a mapping cannot be found.
 
+	The table entry used is remembered, so that consecutive packets to the
+	same next hop (e.g. a stream of UDP packets to one host) skip the lookup.
+
 	\todo Send the packet broadcast AND send an ARP request, if a mapping
 	is not found.
 */
@@ -107,7 +118,7 @@ void arpIpOut(struct netEthIpHeader* packet, uint32_t phyDstIp);
 
 /*! Periodic ARP cache maintenance.
 	This function is to be called once per second and will slowly 
-	expire old ARP cache entries. */
+	expire old ARP cache entries, one hash bucket at a time. */
 void arpTimer(void);
 
 
@@ -33,6 +33,14 @@
 #define ENC28J60_CONTROL_DDR	DDRB
 #define ENC28J60_CONTROL_CS		4
 
+// Interrupt-driven reception
+// Define ENC28J60_RX_INTERRUPT and attach enc28j60InterruptHandler() to the
+// external interrupt wired to the controller's INT pin (low level or falling
+// edge).  Frames refused by nicFilterFrame() are then dropped as they arrive,
+// and nicPoll() only touches the controller once a wanted frame is waiting.
+// Leave undefined to check the controller for frames in nicPoll().
+//#define ENC28J60_RX_INTERRUPT
+
 // MAC address for this interface
 #ifdef ETHADDR0
 #define ENC28J60_MAC0 ETHADDR0
@@ -43,8 +43,52 @@
 // include configuration
 #include "enc28j60conf.h"
 
+#ifdef ENC28J60_RX_INTERRUPT
+// reasons the controller's interrupt output is held disabled
+#define ENC28J60_LOCK_MAIN		0x01	// main context is using the SPI bus
+#define ENC28J60_LOCK_PENDING	0x02	// a wanted frame is waiting for nicPoll
+#endif
+
+// SPI chip select
+#define enc28j60Select()		(ENC28J60_CONTROL_PORT &= ~(1<<ENC28J60_CONTROL_CS))
+#define enc28j60Deselect()		(ENC28J60_CONTROL_PORT |= (1<<ENC28J60_CONTROL_CS))
+#define enc28j60SpiWait()		while(!(SPSR & (1<<SPIF)))
+
 u08 Enc28j60Bank;
 u16 NextPacketPtr;
+static u08 Enc28j60TxSlot;
+// start and length of the frame last accepted by enc28j60PacketPeek()
+static u16 Enc28j60RxFramePtr;
+static u16 Enc28j60RxFrameLen;
+
+#ifdef ENC28J60_RX_INTERRUPT
+static volatile u08 Enc28j60IntLocks;
+
+// hold the controller's interrupt output disabled for the given reason
+static void enc28j60IntLock(u08 reason)
+{
+	u08 sreg = SREG;
+	cli();
+	Enc28j60IntLocks |= reason;
+	enc28j60WriteOp(ENC28J60_BIT_FIELD_CLR, EIE, EIE_INTIE);
+	SREG = sreg;
+}
+
+// release a reason for holding the controller's interrupt output disabled,
+// enabling it again once there are none left
+static void enc28j60IntUnlock(u08 reason)
+{
+	u08 sreg = SREG;
+	cli();
+	Enc28j60IntLocks &= ~reason;
+	if(!Enc28j60IntLocks)
+		enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, EIE, EIE_INTIE);
+	SREG = sreg;
+}
+#else
+#define enc28j60IntLock(reason)
+#define enc28j60IntUnlock(reason)
+#endif
 
 void nicInit(void)
 {
@@ -53,7 +97,9 @@ void nicInit(void)
 
 void nicSend(unsigned int len, unsigned char* packet)
 {
+	enc28j60IntLock(ENC28J60_LOCK_MAIN);
 	enc28j60PacketSend(len, packet);
+	enc28j60IntUnlock(ENC28J60_LOCK_MAIN);
 }
 
 unsigned int nicPoll(unsigned int maxlen, unsigned char* packet)
@@ -63,6 +109,7 @@ unsigned int nicPoll(unsigned int maxlen, unsigned char* packet)
 
 void nicGetMacAddress(u08* macaddr)
 {
+	enc28j60IntLock(ENC28J60_LOCK_MAIN);
 	// read MAC address registers
 	// NOTE: MAC address in ENC28J60 is byte-backward
 	*macaddr++ = enc28j60Read(MAADR5);
@@ -71,10 +118,12 @@ void nicGetMacAddress(u08* macaddr)
 	*macaddr++ = enc28j60Read(MAADR2);
 	*macaddr++ = enc28j60Read(MAADR1);
 	*macaddr++ = enc28j60Read(MAADR0);
+	enc28j60IntUnlock(ENC28J60_LOCK_MAIN);
 }
 
 void nicSetMacAddress(u08* macaddr)
 {
+	enc28j60IntLock(ENC28J60_LOCK_MAIN);
 	// write MAC address
 	// NOTE: MAC address in ENC28J60 is byte-backward
 	enc28j60Write(MAADR5, *macaddr++);
@@ -83,11 +132,14 @@ void nicSetMacAddress(u08* macaddr)
 	enc28j60Write(MAADR2, *macaddr++);
 	enc28j60Write(MAADR1, *macaddr++);
 	enc28j60Write(MAADR0, *macaddr++);
+	enc28j60IntUnlock(ENC28J60_LOCK_MAIN);
 }
 
 void nicRegDump(void)
 {
+	enc28j60IntLock(ENC28J60_LOCK_MAIN);
 	enc28j60RegDump();
+	enc28j60IntUnlock(ENC28J60_LOCK_MAIN);
 }
 
 /*
@@ -125,24 +177,24 @@ u08 enc28j60ReadOp(u08 op, u08 address)
 	u08 data;
    
 	// assert CS
-	ENC28J60_CONTROL_PORT &= ~(1<<ENC28J60_CONTROL_CS);
+	enc28j60Select();
 	
 	// issue read command
 	SPDR = op | (address & ADDR_MASK);
-	while(!(SPSR & (1<<SPIF)));
+	enc28j60SpiWait();
 	// read data
 	SPDR = 0x00;
-	while(!(SPSR & (1<<SPIF)));
+	enc28j60SpiWait();
 	// do dummy read if needed
 	if(address & 0x80)
 	{
 		SPDR = 0x00;
-		while(!(inb(SPSR) & (1<<SPIF)));
+		enc28j60SpiWait();
 	}
 	data = SPDR;
 	
 	// release CS
-	ENC28J60_CONTROL_PORT |= (1<<ENC28J60_CONTROL_CS);
+	enc28j60Deselect();
 
 	return data;
 }
@@ -150,54 +202,87 @@ u08 enc28j60ReadOp(u08 op, u08 address)
 void enc28j60WriteOp(u08 op, u08 address, u08 data)
 {
 	// assert CS
-	ENC28J60_CONTROL_PORT &= ~(1<<ENC28J60_CONTROL_CS);
+	enc28j60Select();
 
 	// issue write command
 	SPDR = op | (address & ADDR_MASK);
-	while(!(SPSR & (1<<SPIF)));
+	enc28j60SpiWait();
 	// write data
 	SPDR = data;
-	while(!(SPSR & (1<<SPIF)));
+	enc28j60SpiWait();
 
 	// release CS
-	ENC28J60_CONTROL_PORT |= (1<<ENC28J60_CONTROL_CS);
+	enc28j60Deselect();
+}
+
+// Clock a block of bytes in from the controller, within a transaction
+// already started by the caller. Each byte is stored while the next one is
+// being shifted in, so that the bus is kept busy for the whole block.
+static void enc28j60SpiReadBlock(u16 len, u08* data)
+{
+	u08 byte;
+
+	if(!len)
+		return;
+
+	SPDR = 0x00;
+	while(--len)
+	{
+		enc28j60SpiWait();
+		byte = SPDR;
+		SPDR = 0x00;
+		*data++ = byte;
+	}
+	enc28j60SpiWait();
+	*data = SPDR;
+}
+
+// Clock a block of bytes out to the controller, within a transaction
+// already started by the caller. Each byte is fetched while the previous
+// one is being shifted out.
+static void enc28j60SpiWriteBlock(u16 len, u08* data)
+{
+	u08 byte;
+
+	if(!len)
+		return;
+
+	SPDR = *data++;
+	while(--len)
+	{
+		byte = *data++;
+		enc28j60SpiWait();
+		SPDR = byte;
+	}
+	enc28j60SpiWait();
 }
 
 void enc28j60ReadBuffer(u16 len, u08* data)
 {
 	// assert CS
-	ENC28J60_CONTROL_PORT &= ~(1<<ENC28J60_CONTROL_CS);
+	enc28j60Select();
 	
 	// issue read command
 	SPDR = ENC28J60_READ_BUF_MEM;
-	while(!(SPSR & (1<<SPIF)));
-	while(len--)
-	{
-		// read data
-		SPDR = 0x00;
-		while(!(SPSR & (1<<SPIF)));
-		*data++ = SPDR;
-	}	
+	enc28j60SpiWait();
+	enc28j60SpiReadBlock(len, data);
+
 	// release CS
-	ENC28J60_CONTROL_PORT |= (1<<ENC28J60_CONTROL_CS);
+	enc28j60Deselect();
 }
 
 void enc28j60WriteBuffer(u16 len, u08* data)
 {
 	// assert CS
-	ENC28J60_CONTROL_PORT &= ~(1<<ENC28J60_CONTROL_CS);
+	enc28j60Select();
 	
 	// issue write command
 	SPDR = ENC28J60_WRITE_BUF_MEM;
-	while(!(SPSR & (1<<SPIF)));
-	while(len--)
-	{
-		// write data
-		SPDR = *data++;
-		while(!(SPSR & (1<<SPIF)));
-	}	
+	enc28j60SpiWait();
+	enc28j60SpiWriteBlock(len, data);
+
 	// release CS
-	ENC28J60_CONTROL_PORT |= (1<<ENC28J60_CONTROL_CS);
+	enc28j60Deselect();
 }
 
 void enc28j60SetBank(u08 address)
@@ -312,6 +397,7 @@ void enc28j60Init(void)
 	// ETXST defaults to 0x0000 (beginnging of ram)
 	enc28j60Write(ETXSTL, TXSTART_INIT&0xFF);
 	enc28j60Write(ETXSTH, TXSTART_INIT>>8);
+	Enc28j60TxSlot = 0;
 
 	// do bank 2 stuff
 	// enable MAC receive
@@ -346,6 +432,9 @@ void enc28j60Init(void)
 	// switch to bank 0
 	enc28j60SetBank(ECON1);
 	// enable interrutps
+#ifdef ENC28J60_RX_INTERRUPT
+	Enc28j60IntLocks = 0;
+#endif
 	enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, EIE, EIE_INTIE|EIE_PKTIE);
 	// enable packet reception
 	enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_RXEN);
@@ -384,67 +473,195 @@ void enc28j60Init(void)
 
 void enc28j60PacketSend(unsigned int len, unsigned char* packet)
 {
-	// Set the write pointer to start of transmit buffer area
-	enc28j60Write(EWRPTL, TXSTART_INIT);
-	enc28j60Write(EWRPTH, TXSTART_INIT>>8);
-	// Set the TXND pointer to correspond to the packet size given
-	enc28j60Write(ETXNDL, (TXSTART_INIT+len));
-	enc28j60Write(ETXNDH, (TXSTART_INIT+len)>>8);
-
-	// write per-packet control byte
-	enc28j60WriteOp(ENC28J60_WRITE_BUF_MEM, 0, 0x00);
-
-	// copy the packet into the transmit buffer
-	enc28j60WriteBuffer(len, packet);
-	
+	u16 start = TXSTART_INIT + (Enc28j60TxSlot ? TXSLOT_SIZE : 0);
+	u08 control = 0x00;
+
+	// Copy the frame into the transmit slot not used by the previous frame,
+	// which may still be going out on the wire
+	enc28j60Write(EWRPTL, start);
+	enc28j60Write(EWRPTH, start>>8);
+
+	// write per-packet control byte and the packet in one transaction
+	enc28j60Select();
+	SPDR = ENC28J60_WRITE_BUF_MEM;
+	enc28j60SpiWait();
+	enc28j60SpiWriteBlock(1, &control);
+	enc28j60SpiWriteBlock(len, packet);
+	enc28j60Deselect();
+
+	// wait for the previous frame to leave the controller
+	// (errata: reset the transmit logic if it stalled on an error)
+	while(enc28j60Read(ECON1) & ECON1_TXRTS)
+	{
+		if(enc28j60Read(EIR) & EIR_TXERIF)
+		{
+			enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRST);
+			enc28j60WriteOp(ENC28J60_BIT_FIELD_CLR, ECON1, ECON1_TXRST);
+		}
+	}
+
+	// point the transmitter at the new frame
+	enc28j60Write(ETXSTL, start);
+	enc28j60Write(ETXSTH, start>>8);
+	enc28j60Write(ETXNDL, (start+len));
+	enc28j60Write(ETXNDH, (start+len)>>8);
+	enc28j60WriteOp(ENC28J60_BIT_FIELD_CLR, EIR, EIR_TXIF|EIR_TXERIF);
+
 	// send the contents of the transmit buffer onto the network
 	enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRTS);
+	Enc28j60TxSlot ^= 1;
 }
 
-unsigned int enc28j60PacketReceive(unsigned int maxlen, unsigned char* packet)
+// Free the frame at the head of the receive buffer, which must already have
+// had its header read so that NextPacketPtr points past it
+static void enc28j60PacketFree(void)
 {
+	// Move the RX read pointer to the start of the next received packet
+	// This frees the memory we just read out
+	// (errata: ERXRDPT must be odd, so free up to the byte before it)
+	if(NextPacketPtr == RXSTART_INIT)
+	{
+		enc28j60Write(ERXRDPTL, RXSTOP_INIT&0xFF);
+		enc28j60Write(ERXRDPTH, RXSTOP_INIT>>8);
+	}
+	else
+	{
+		enc28j60Write(ERXRDPTL, (NextPacketPtr-1));
+		enc28j60Write(ERXRDPTH, (NextPacketPtr-1)>>8);
+	}
+
+	// decrement the packet counter indicate we are done with this packet
+	enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, ECON2, ECON2_PKTDEC);
+}
+
+// Find the next received frame the network stack has a use for, dropping
+// frames with receive errors or refused by nicFilterFrame() on the way.
+// The frame's first MIN(length, maxlen, NIC_FILTER_HEADER_LEN) bytes are
+// read into packet, and the buffer read is left open after them.
+// Returns the frame length, or zero if no wanted frame is waiting.
+static u16 enc28j60PacketPeek(u16 maxlen, u08* packet)
+{
+	u08 header[6];
 	u16 rxstat;
 	u16 len;
 
 	// check if a packet has been received and buffered
-//	if( !(enc28j60Read(EIR) & EIR_PKTIF) )
-	if( !enc28j60Read(EPKTCNT) )
+	while( enc28j60Read(EPKTCNT) )
+	{
+		Enc28j60RxFramePtr = NextPacketPtr;
+
+		// Set the read pointer to the start of the received packet
+		enc28j60Write(ERDPTL, (NextPacketPtr));
+		enc28j60Write(ERDPTH, (NextPacketPtr)>>8);
+
+		// the whole frame is fetched in a single buffer read transaction
+		enc28j60Select();
+		SPDR = ENC28J60_READ_BUF_MEM;
+		enc28j60SpiWait();
+
+		// read the next packet pointer, packet length and receive status
+		enc28j60SpiReadBlock(sizeof(header), header);
+		NextPacketPtr = header[0] | (header[1]<<8);
+		len = header[2] | (header[3]<<8);
+		rxstat = header[4] | (header[5]<<8);
+
+		// drop frames received with errors
+		// (we reduce the MAC-reported length by 4 to remove the CRC)
+		if( !(rxstat & 0x80) || len < 4 )
+		{
+			enc28j60Deselect();
+			enc28j60PacketFree();
+			continue;
+		}
+		Enc28j60RxFrameLen = len - 4;
+
+		// look at the protocol headers first, and leave frames the network
+		// stack has no use for in the controller
+		len = MIN(MIN(Enc28j60RxFrameLen, maxlen), NIC_FILTER_HEADER_LEN);
+		enc28j60SpiReadBlock(len, packet);
+		if( !nicFilterFrame(Enc28j60RxFrameLen, packet) )
+		{
+			enc28j60Deselect();
+			enc28j60PacketFree();
+			continue;
+		}
+
+		return Enc28j60RxFrameLen;
+	}
+
+	return 0;
+}
+
+unsigned int enc28j60PacketReceive(unsigned int maxlen, unsigned char* packet)
+{
+#ifdef ENC28J60_RX_INTERRUPT
+	u08 header[6];
+	u16 len;
+
+	if(!(Enc28j60IntLocks & ENC28J60_LOCK_PENDING))
 		return 0;
-	
-	// Make absolutely certain that any previous packet was discarded	
-	//if( WasDiscarded == FALSE)
-	//	MACDiscardRx();
-
-	// Set the read pointer to the start of the received packet
-	enc28j60Write(ERDPTL, (NextPacketPtr));
-	enc28j60Write(ERDPTH, (NextPacketPtr)>>8);
-	// read the next packet pointer
-	NextPacketPtr  = enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0);
-	NextPacketPtr |= enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0)<<8;
-	// read the packet length
-	len  = enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0);
-	len |= enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0)<<8;
-	// read the receive status
-	rxstat  = enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0);
-	rxstat |= enc28j60ReadOp(ENC28J60_READ_BUF_MEM, 0)<<8;
 
-	// limit retrieve length
-	// (we reduce the MAC-reported length by 4 to remove the CRC)
-	len = MIN(len, maxlen);
+	// read the frame accepted by the interrupt handler, skipping its
+	// receive header, straight into the caller's buffer
+	enc28j60Write(ERDPTL, Enc28j60RxFramePtr);
+	enc28j60Write(ERDPTH, Enc28j60RxFramePtr>>8);
+	len = MIN(Enc28j60RxFrameLen, maxlen);
 
-	// copy the packet from the receive buffer
-	enc28j60ReadBuffer(len, packet);
+	enc28j60Select();
+	SPDR = ENC28J60_READ_BUF_MEM;
+	enc28j60SpiWait();
+	enc28j60SpiReadBlock(sizeof(header), header);
+	enc28j60SpiReadBlock(len, packet);
+	enc28j60Deselect();
+	enc28j60PacketFree();
+
+	// let the interrupt handler look at the next frame
+	enc28j60IntUnlock(ENC28J60_LOCK_PENDING);
+	return len;
+#else
+	u16 len;
+	u16 peek;
 
-	// Move the RX read pointer to the start of the next received packet
-	// This frees the memory we just read out
-	enc28j60Write(ERXRDPTL, (NextPacketPtr));
-	enc28j60Write(ERXRDPTH, (NextPacketPtr)>>8);
+	if( !enc28j60PacketPeek(maxlen, packet) )
+		return 0;
 
-	// decrement the packet counter indicate we are done with this packet
-	enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, ECON2, ECON2_PKTDEC);
+	// limit retrieve length
+	len = MIN(Enc28j60RxFrameLen, maxlen);
+	peek = MIN(len, NIC_FILTER_HEADER_LEN);
+
+	// copy the rest of the packet from the receive buffer
+	enc28j60SpiReadBlock(len-peek, packet+peek);
+	enc28j60Deselect();
+	enc28j60PacketFree();
 
 	return len;
+#endif
+}
+
+#ifdef ENC28J60_RX_INTERRUPT
+void enc28j60InterruptHandler(void)
+{
+	u08 header[NIC_FILTER_HEADER_LEN];
+
+	// leave the interrupt pending while the main context owns the bus,
+	// or while nicPoll has yet to read the last accepted frame
+	if(Enc28j60IntLocks)
+		return;
+
+	// disable the interrupt output so that it can be re-armed on exit
+	enc28j60WriteOp(ENC28J60_BIT_FIELD_CLR, EIE, EIE_INTIE);
+
+	// drop unwanted frames, stopping at the first one the stack wants,
+	// which stays in the controller until nicPoll reads it out
+	if(enc28j60PacketPeek(sizeof(header), header))
+	{
+		enc28j60Deselect();
+		Enc28j60IntLocks |= ENC28J60_LOCK_PENDING;
+	}
+	else
+		enc28j60WriteOp(ENC28J60_BIT_FIELD_SET, EIE, EIE_INTIE);
 }
+#endif
 
 void enc28j60ReceiveOverflowRecover(void)
 {
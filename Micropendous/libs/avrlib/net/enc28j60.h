@@ -244,7 +244,8 @@
 // buffer boundaries applied to internal 8K ram
 //	entire available packet buffer space is allocated
 #define TXSTART_INIT   	0x0000	// start TX buffer at 0
-#define RXSTART_INIT   	0x0600	// give TX buffer space for one full ethernet frame (~1500 bytes)
+#define TXSLOT_SIZE    	0x0600	// two TX slots of one full ethernet frame (~1500 bytes) each
+#define RXSTART_INIT   	0x0C00	// give TX buffer space for two full ethernet frames
 #define RXSTOP_INIT    	0x1FFF	// receive buffer gets the rest
 
 #define	MAX_FRAMELEN	1518	// maximum ethernet frame length
@@ -295,6 +296,15 @@ void enc28j60PacketSend(unsigned int len, unsigned char* packet);
 /// \return Packet length in bytes if a packet was retrieved, zero otherwise.
 unsigned int enc28j60PacketReceive(unsigned int maxlen, unsigned char* packet);
 
+//! Interrupt handler for the ENC28J60 INT line.
+/// Only present when ENC28J60_RX_INTERRUPT is defined (see enc28j60conf.h).
+/// Drops received frames refused by nicFilterFrame(), and marks the first
+/// wanted frame as pending for enc28j60PacketReceive(), which then reads it
+/// straight into the caller's buffer without checking the controller again.
+/// Attach to the external interrupt wired to INT, e.g.
+/// \code extintAttach(EXTINT2, enc28j60InterruptHandler); \endcode
+void enc28j60InterruptHandler(void);
+
 //! execute procedure for recovering from a receive overflow
 /// this should be done when the receive memory fills up with packets
 void enc28j60ReceiveOverflowRecover(void);
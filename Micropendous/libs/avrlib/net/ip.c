@@ -106,7 +106,30 @@ void ipSend(uint32_t dstIp, uint8_t protocol, uint16_t len, uint8_t* data)
 	nicSend(len, data);
 }
 
+uint16_t ipChecksumPseudo(uint32_t dstIp, uint8_t protocol, uint16_t len)
+{
+	uint32_t addr;
+	uint16_t word;
+	uint16_t sum;
+
+	// source and destination addresses, in network order as on the wire
+	addr = htonl(IpMyConfig.ip);
+	sum = netChecksumAdd(0, &addr, 4);
+	addr = htonl(dstIp);
+	sum = netChecksumAdd(sum, &addr, 4);
+	// zero-padded protocol and upper-layer length
+	word = htons(protocol);
+	sum = netChecksumAdd(sum, &word, 2);
+	word = htons(len);
+	return netChecksumAdd(sum, &word, 2);
+}
+
 void udpSend(uint32_t dstIp, uint16_t dstPort, uint16_t len, uint8_t* data)
+{
+	udpSendFrom(dstIp, dstPort, dstPort, len, data);
+}
+
+void udpSendFrom(uint32_t dstIp, uint16_t srcPort, uint16_t dstPort, uint16_t len, uint8_t* data)
 {
 	// make pointer to UDP header
 	struct netUdpHeader* udpHeader;
@@ -116,8 +139,10 @@ void udpSend(uint32_t dstIp, uint16_t dstPort, uint16_t len, uint8_t* data)
 	// adjust length to add UDP header
 	len += UDP_HEADER_LEN;
 	// fill UDP header
-	udpHeader->destport = HTONS(dstPort);
-	udpHeader->srcport  = HTONS(dstPort);
+	// (the checksum is optional for UDP over IPv4, and is left out so that
+	// the payload is never read back)
+	udpHeader->destport = htons(dstPort);
+	udpHeader->srcport  = htons(srcPort);
 	udpHeader->udplen = htons(len);
 	udpHeader->udpchksum = 0;
 
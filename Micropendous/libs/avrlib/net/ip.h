@@ -62,9 +62,24 @@ void ipPrintConfig(struct ipConfig* config);
 //! Send an IP packet.
 void ipSend(uint32_t dstIp, uint8_t protocol, uint16_t len, uint8_t* data);
 
+//! Compute the one's complement sum of the TCP/UDP pseudo-header.
+/// Covers our address, dstIp, protocol and the upper-layer length (header
+/// plus payload).  Continue the sum over the upper-layer header and payload
+/// with netChecksumAdd(), and complement the result to get the checksum.
+uint16_t ipChecksumPseudo(uint32_t dstIp, uint8_t protocol, uint16_t len);
+
 //! Send a UDP/IP packet.
+/// Same as udpSendFrom() with the source port set to dstPort.
 void udpSend(uint32_t dstIp, uint16_t dstPort, uint16_t len, uint8_t* data);
 
+//! Send a UDP/IP packet from the given local port.
+/// The UDP, IP and ethernet headers are built in place in front of the
+/// payload, so \c data must be preceded by at least
+/// ETH_HEADER_LEN+IP_HEADER_LEN+UDP_HEADER_LEN bytes of free buffer space.
+/// A payload received through netstackUDPAttach() satisfies this, and may be
+/// sent back without copying.
+void udpSendFrom(uint32_t dstIp, uint16_t srcPort, uint16_t dstPort, uint16_t len, uint8_t* data);
+
 #endif
 //@}
 
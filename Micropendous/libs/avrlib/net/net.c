@@ -29,25 +29,81 @@ uint32_t htonl(uint32_t val)
 }
 
 
+static uint16_t netChecksumAddWord(uint16_t sum, uint16_t word)
+{
+	sum += word;
+	if(sum < word)
+		sum++;
+	return sum;
+}
+
+uint16_t netChecksumAdd(uint16_t sum, void *data, uint16_t len)
+{
+	uint8_t *ptr = (uint8_t *)data;
+	uint16_t blocks = len >> 2;
+
+	if(blocks)
+	{
+#ifdef __AVR__
+		// the inner count runs first (zero meaning 256 passes), then the outer count repeats it
+		uint8_t inner = blocks & 0xFF;
+		uint8_t outer = (blocks >> 8) + (inner ? 1 : 0);
+
+		// only LD, DEC and BRNE sit between the additions, none of which touch
+		// the carry flag, so each word's carry ripples into the next one and the
+		// end-around carry is only folded in once at the end
+		asm (
+			"clc"						"\n\t"
+			"1:"						"\n\t"
+			"ld   __tmp_reg__, %a1+"	"\n\t"
+			"adc  %A0, __tmp_reg__"		"\n\t"
+			"ld   __tmp_reg__, %a1+"	"\n\t"
+			"adc  %B0, __tmp_reg__"		"\n\t"
+			"ld   __tmp_reg__, %a1+"	"\n\t"
+			"adc  %A0, __tmp_reg__"		"\n\t"
+			"ld   __tmp_reg__, %a1+"	"\n\t"
+			"adc  %B0, __tmp_reg__"		"\n\t"
+			"dec  %2"					"\n\t"
+			"brne 1b"					"\n\t"
+			"dec  %3"					"\n\t"
+			"brne 1b"					"\n\t"
+			"adc  %A0, __zero_reg__"	"\n\t"
+			"adc  %B0, __zero_reg__"	"\n\t"
+			"adc  %A0, __zero_reg__"	"\n\t"
+			: "+r" (sum), "+e" (ptr), "+r" (inner), "+r" (outer)
+			:
+			: "memory"
+		);
+#else
+		// add two words per pass into a wide accumulator, folding its carries back in at the end
+		uint32_t wide = sum;
+
+		while(blocks--)
+		{
+			wide += (uint16_t)(ptr[0] | (ptr[1]<<8));
+			wide += (uint16_t)(ptr[2] | (ptr[3]<<8));
+			ptr += 4;
+		}
+		wide = (wide & 0xFFFF) + (wide >> 16);
+		sum = netChecksumAddWord((uint16_t)wide, (uint16_t)(wide >> 16));
+#endif
+	}
+
+	// up to three trailing bytes, the last of which is padded with a zero if the length is odd
+	if(len & 2)
+	{
+		sum = netChecksumAddWord(sum, ptr[0] | (ptr[1]<<8));
+		ptr += 2;
+	}
+	if(len & 1)
+		sum = netChecksumAddWord(sum, ptr[0]);
+
+	return sum;
+}
+
 uint16_t netChecksum(void *data, uint16_t len)
 {
-    register uint32_t sum = 0;
-
-    for (;;) {
-        if (len < 2)
-            break;
-		//sum += *((uint16_t *)data)++;
-		sum += *((uint16_t *)data);
-		data+=2;
-        len -= 2;
-    }
-    if (len)
-        sum += *(uint8_t *) data;
-
-    while ((len = (uint16_t) (sum >> 16)) != 0)
-        sum = (uint16_t) sum + len;
-
-    return (uint16_t) sum ^ 0xFFFF;
+	return netChecksumAdd(0, data, len) ^ 0xFFFF;
 }
 
 void netPrintEthAddr(struct netEthAddr* ethaddr)
@@ -178,7 +178,7 @@ typedef struct {
 #define IPDOT(a,b,c,d)	((a<<24)|(b<<16)|(c<<8)|(d))
 
 //! Host-to-Network SHORT (16-bit) byte-order swap (macro).
-#define HTONS(s)		((s<<8) | (s>>8))
+#define HTONS(s)		((((s)<<8)&0xFF00) | (((s)>>8)&0x00FF))
 //! Host-to-Network LONG (32-bit) byte-order swap (macro).
 #define HTONL(l)		((l<<24) | ((l&0x00FF0000l)>>8) | ((l&0x0000FF00l)<<8) | (l>>24))
 
@@ -189,6 +189,8 @@ uint32_t htonl(uint32_t val);
 
 //! Calculate IP-style checksum from data.
 uint16_t netChecksum(void *data, uint16_t len);
+//! Add data to a running one's complement sum (complement the result to get a checksum).
+uint16_t netChecksumAdd(uint16_t sum, void *data, uint16_t len);
 
 //! Print Ethernet address in XX:XX:XX:XX:XX:XX format.
 void netPrintEthAddr(struct netEthAddr* ethaddr);
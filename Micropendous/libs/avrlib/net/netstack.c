@@ -12,13 +12,35 @@
 //
 //*****************************************************************************
 
+#include <string.h>
+
 #include "rprintf.h"
 #include "debug.h"
 
 #include "netstack.h"
 
+// largest TCP payload which fits the network buffer, announced as both our
+// maximum segment size and our receive window
+#define NETSTACK_TCP_MSS	(NETSTACK_BUFFERSIZE-ETH_HEADER_LEN-IP_HEADER_LEN-TCP_HEADER_LEN)
+
 unsigned char NetBuffer[NETSTACK_BUFFERSIZE];
 
+// local ports with attached handlers (port zero marks a free entry)
+static struct
+{
+	uint16_t port;
+	netstackUDPHandler handler;
+} NetstackUDPPorts[NETSTACK_UDP_PORTS];
+
+static struct
+{
+	uint16_t port;
+	netstackTCPHandler handler;
+} NetstackTCPPorts[NETSTACK_TCP_PORTS];
+
+// initial sequence number of the last accepted TCP connection
+static uint32_t NetstackTCPSeqNo;
+
 void netstackInit(uint32_t ipaddress, uint32_t netmask, uint32_t gatewayip)
 {
 	// init network device driver
@@ -88,6 +110,41 @@ int netstackService(void)
 	return len;
 }
 
+u08 nicFilterFrame(unsigned int len, unsigned char* header)
+{
+	struct netEthHeader* ethPacket = (struct netEthHeader*)header;
+	struct netEthArpHeader* arpPacket;
+	struct netEthIpHeader* ipPacket;
+
+	if(len < ETH_HEADER_LEN)
+		return FALSE;
+
+	if(ethPacket->type == htons(ETHTYPE_ARP))
+	{
+		// only requests for our address are answered
+		arpPacket = (struct netEthArpHeader*)header;
+		if(len < sizeof(struct netEthArpHeader))
+			return FALSE;
+		return (arpPacket->arp.dipaddr == HTONL(ipGetConfig()->ip));
+	}
+	else if(ethPacket->type == htons(ETHTYPE_IP))
+	{
+		// same addressing and protocol checks as netstackIPProcess()
+		ipPacket = (struct netEthIpHeader*)header;
+		if(len < ETH_HEADER_LEN+IP_HEADER_LEN)
+			return FALSE;
+		if( (htonl(ipPacket->ip.destipaddr) != ipGetConfig()->ip) &&
+			(htonl(ipPacket->ip.destipaddr) != (ipGetConfig()->ip|ipGetConfig()->netmask)) &&
+			(htonl(ipPacket->ip.destipaddr) != 0xFFFFFFFF) ) 
+			return FALSE;
+		return ( (ipPacket->ip.proto == IP_PROTO_ICMP) ||
+				 (ipPacket->ip.proto == IP_PROTO_UDP) ||
+				 (ipPacket->ip.proto == IP_PROTO_TCP) );
+	}
+
+	return FALSE;
+}
+
 void netstackIPProcess(unsigned int len, ip_hdr* packet)
 {
 	// check IP addressing, stop processing if not for me and not a broadcast
@@ -128,16 +185,199 @@ void netstackIPProcess(unsigned int len, ip_hdr* packet)
 	}
 }
 
+u08 netstackUDPAttach(uint16_t port, netstackUDPHandler handler)
+{
+	u08 i;
+	u08 slot = NETSTACK_UDP_PORTS;
+
+	// reuse the port's entry, or else the first free one
+	for(i=0; i<NETSTACK_UDP_PORTS; i++)
+	{
+		if(NetstackUDPPorts[i].port == port)
+			break;
+		if(!NetstackUDPPorts[i].port && (slot == NETSTACK_UDP_PORTS))
+			slot = i;
+	}
+	if(i == NETSTACK_UDP_PORTS)
+		i = slot;
+	if(i == NETSTACK_UDP_PORTS)
+		return FALSE;
+
+	NetstackUDPPorts[i].port = port;
+	NetstackUDPPorts[i].handler = handler;
+	return TRUE;
+}
+
+void netstackUDPDetach(uint16_t port)
+{
+	u08 i;
+
+	for(i=0; i<NETSTACK_UDP_PORTS; i++)
+	{
+		if(NetstackUDPPorts[i].port == port)
+			NetstackUDPPorts[i].port = 0;
+	}
+}
+
+u08 netstackTCPAttach(uint16_t port, netstackTCPHandler handler)
+{
+	u08 i;
+	u08 slot = NETSTACK_TCP_PORTS;
+
+	// reuse the port's entry, or else the first free one
+	for(i=0; i<NETSTACK_TCP_PORTS; i++)
+	{
+		if(NetstackTCPPorts[i].port == port)
+			break;
+		if(!NetstackTCPPorts[i].port && (slot == NETSTACK_TCP_PORTS))
+			slot = i;
+	}
+	if(i == NETSTACK_TCP_PORTS)
+		i = slot;
+	if(i == NETSTACK_TCP_PORTS)
+		return FALSE;
+
+	NetstackTCPPorts[i].port = port;
+	NetstackTCPPorts[i].handler = handler;
+	return TRUE;
+}
+
+void netstackTCPDetach(uint16_t port)
+{
+	u08 i;
+
+	for(i=0; i<NETSTACK_TCP_PORTS; i++)
+	{
+		if(NetstackTCPPorts[i].port == port)
+			NetstackTCPPorts[i].port = 0;
+	}
+}
+
 void netstackUDPIPProcess(unsigned int len, udpip_hdr* packet)
 {
+	uint16_t port = htons(packet->udp.destport);
+	uint16_t udplen = htons(packet->udp.udplen);
+	u08 i;
+
+	// headers are taken to be fixed-size, so skip packets with IP options
+	if( (packet->ip.vhl != 0x45) || (udplen < UDP_HEADER_LEN) || (udplen > len-IP_HEADER_LEN) )
+		return;
+
+	for(i=0; i<NETSTACK_UDP_PORTS; i++)
+	{
+		if(NetstackUDPPorts[i].port == port)
+		{
+			// hand over the payload where it lies in the network buffer
+			NetstackUDPPorts[i].handler(htonl(packet->ip.srcipaddr), htons(packet->udp.srcport),
+				udplen-UDP_HEADER_LEN, ((u08*)packet)+IP_HEADER_LEN+UDP_HEADER_LEN);
+			return;
+		}
+	}
+
 	#ifdef NETSTACK_DEBUG
-	rprintf("NetStack UDP/IP Rx Dummy Handler\r\n");
+	rprintf("NetStack UDP/IP Rx on unattached port %d\r\n", port);
 	#endif
 }
 
+// Turn a received TCP segment around into a reply segment, in place, and
+// send it.  The reply's payload (len bytes) must already be in place after a
+// TCP header without options.
+static void netstackTCPReply(tcpip_hdr* packet, u08 flags, uint32_t seqno, uint32_t ackno, u16 len)
+{
+	uint32_t dstIp = htonl(packet->ip.srcipaddr);
+	uint16_t port;
+	u08 hdrlen = TCP_HEADER_LEN;
+	u08* option;
+
+	// reply from the port the segment was sent to
+	port = packet->tcp.srcport;
+	packet->tcp.srcport = packet->tcp.destport;
+	packet->tcp.destport = port;
+	packet->tcp.seqno = htonl(seqno);
+	packet->tcp.ackno = htonl(ackno);
+	packet->tcp.flags = flags;
+	packet->tcp.wnd = htons(NETSTACK_TCP_MSS);
+	packet->tcp.urgp = 0;
+
+	if(flags & TCP_FLAGS_SYN)
+	{
+		// announce the largest segment we can receive
+		option = ((u08*)&packet->tcp)+TCP_HEADER_LEN;
+		option[0] = 2;
+		option[1] = 4;
+		option[2] = NETSTACK_TCP_MSS>>8;
+		option[3] = NETSTACK_TCP_MSS&0xFF;
+		hdrlen += 4;
+	}
+	packet->tcp.tcpoffset = hdrlen<<2;
+	len += hdrlen;
+
+	// calculate and apply TCP checksum over pseudo-header, header and payload
+	packet->tcp.tcpchksum = 0;
+	packet->tcp.tcpchksum = netChecksumAdd(ipChecksumPseudo(dstIp, IP_PROTO_TCP, len), &packet->tcp, len) ^ 0xFFFF;
+
+	ipSend(dstIp, IP_PROTO_TCP, len, (u08*)&packet->tcp);
+}
+
 void netstackTCPIPProcess(unsigned int len, tcpip_hdr* packet)
 {
-	#ifdef NETSTACK_DEBUG
-	rprintf("NetStack TCP/IP Rx Dummy Handler\r\n");
-	#endif
+	netstackTCPHandler handler = 0;
+	uint16_t port = htons(packet->tcp.destport);
+	uint32_t seqno = htonl(packet->tcp.seqno);
+	uint32_t ackno = htonl(packet->tcp.ackno);
+	u08 flags = packet->tcp.flags;
+	u08 hdrlen = (packet->tcp.tcpoffset>>4)<<2;
+	u16 datalen = htons(packet->ip.len);
+	u08* data;
+	u08 i;
+
+	// never answer a reset, and skip packets with IP options or bad lengths
+	if( (flags & TCP_FLAGS_RST) || (packet->ip.vhl != 0x45) || (hdrlen < TCP_HEADER_LEN) ||
+		(datalen > len) || (datalen < IP_HEADER_LEN+hdrlen) )
+		return;
+	datalen -= IP_HEADER_LEN+hdrlen;
+
+	for(i=0; i<NETSTACK_TCP_PORTS; i++)
+	{
+		if(NetstackTCPPorts[i].port == port)
+			handler = NetstackTCPPorts[i].handler;
+	}
+
+	if(!handler)
+	{
+		// refuse the connection
+		#ifdef NETSTACK_DEBUG
+		rprintf("NetStack TCP/IP Rx on unattached port %d\r\n", port);
+		#endif
+		if(flags & TCP_FLAGS_ACK)
+			netstackTCPReply(packet, TCP_FLAGS_RST, ackno, 0, 0);
+		else
+			netstackTCPReply(packet, TCP_FLAGS_RST|TCP_FLAGS_ACK, 0,
+				seqno+datalen+((flags & TCP_FLAGS_SYN)?1:0)+((flags & TCP_FLAGS_FIN)?1:0), 0);
+	}
+	else if(flags & TCP_FLAGS_SYN)
+	{
+		// accept the connection
+		NetstackTCPSeqNo += 0x00010000;
+		netstackTCPReply(packet, TCP_FLAGS_SYN|TCP_FLAGS_ACK, NetstackTCPSeqNo, seqno+1, 0);
+	}
+	else if(datalen)
+	{
+		// move the request to where the reply's payload goes, if the
+		// segment carried TCP options
+		data = ((u08*)&packet->tcp)+TCP_HEADER_LEN;
+		if(hdrlen != TCP_HEADER_LEN)
+			memmove(data, ((u08*)&packet->tcp)+hdrlen, datalen);
+
+		// acknowledge the request and answer it, closing our side
+		seqno += datalen + ((flags & TCP_FLAGS_FIN)?1:0);
+		datalen = handler(htonl(packet->ip.srcipaddr), datalen, data, NETSTACK_TCP_MSS);
+		datalen = MIN(datalen, NETSTACK_TCP_MSS);
+		netstackTCPReply(packet, TCP_FLAGS_ACK|TCP_FLAGS_FIN|(datalen?TCP_FLAGS_PSH:0), ackno, seqno, datalen);
+	}
+	else if(flags & TCP_FLAGS_FIN)
+	{
+		// acknowledge the peer closing its side
+		netstackTCPReply(packet, TCP_FLAGS_ACK, ackno, seqno+1, 0);
+	}
 }
@@ -16,7 +16,9 @@
 ///	\par Description
 ///		This library co-ordinates the various pieces of a typical IP network
 ///		stack into one unit.  Included are handling for ARP, ICMP, and IP
-///		packets.  UDP and TCP packets are processed and passed to the user.
+///		packets.  UDP and TCP packets are processed and passed to the user,
+///		either through handlers attached to individual ports, or by
+///		overriding the default UDP and TCP handlers.
 ///
 ///		This is an example of how to use the various network libraries, and
 ///		is meant to be useful out-of-the-box for most users.  However, some
@@ -53,6 +55,30 @@
 #define NETSTACK_BUFFERSIZE		(576+ETH_HEADER_LEN)
 #endif
 
+/// NETSTACK_UDP_PORTS and NETSTACK_TCP_PORTS set the number of local ports which
+/// may have handlers attached at once.
+/// - You may override the defaults by defining alternate values in global.h.
+#ifndef NETSTACK_UDP_PORTS
+#define NETSTACK_UDP_PORTS		4
+#endif
+#ifndef NETSTACK_TCP_PORTS
+#define NETSTACK_TCP_PORTS		2
+#endif
+
+/// UDP port handler, called with the sender's address and port and the
+/// received payload.  \c data points into the common network buffer and is
+/// only valid until the handler returns.  It is preceded by the received
+/// headers, so a reply may be built over it and sent with udpSendFrom()
+/// without copying.
+typedef void (*netstackUDPHandler)(uint32_t srcIp, uint16_t srcPort, uint16_t len, u08* data);
+
+/// TCP port handler, called with the sender's address and the payload of a
+/// received segment, in the same buffer rules as netstackUDPHandler.  The
+/// handler may write a reply of up to \c maxlen bytes over \c data, and
+/// returns its length.  The reply is sent in a single segment which also
+/// closes the connection.
+typedef u16 (*netstackTCPHandler)(uint32_t srcIp, uint16_t len, u08* data, u16 maxlen);
+
 /// netstackInit prepares the network interface for use and should be called
 /// once at the beginning of the user program.
 /// \note Use ipSetAddress() to change network parameters in mid-run.
@@ -67,17 +93,44 @@ u08* netstackGetBuffer(void);
 /// packet was processed.
 int netstackService(void);
 
+/// nicFilterFrame tells NIC drivers which received frames are worth copying
+/// out of the controller: ARP requests for our address, and ICMP, UDP and
+/// TCP packets addressed to us or broadcast.  See nic.h.
+u08 nicFilterFrame(unsigned int len, unsigned char* header);
+
+/// netstackUDPAttach delivers UDP packets received on the given local port to
+/// handler, replacing any handler already attached to the port.  Returns
+/// FALSE if all NETSTACK_UDP_PORTS ports are already in use.
+u08 netstackUDPAttach(uint16_t port, netstackUDPHandler handler);
+
+/// netstackUDPDetach stops delivery of UDP packets received on the given port.
+void netstackUDPDetach(uint16_t port);
+
+/// netstackTCPAttach answers TCP connections to the given local port with
+/// handler, replacing any handler already attached to the port.  Returns
+/// FALSE if all NETSTACK_TCP_PORTS ports are already in use.
+/// \note Connections are not tracked: each one is expected to carry a single
+///	request segment, which is answered with a single reply segment.
+u08 netstackTCPAttach(uint16_t port, netstackTCPHandler handler);
+
+/// netstackTCPDetach stops answering TCP connections to the given port.
+/// Further connection attempts are refused.
+void netstackTCPDetach(uint16_t port);
+
 /// netstackIPProcess handles distribution of IP received packets.
 ///
 void netstackIPProcess(unsigned int len, ip_hdr* packet);
 
 /// This weakly-defined function is the default handler for incoming UDP/IP packets.
-/// Users should define this same function in user code (same name and arguments) to
+/// It passes packets on to the handlers attached with netstackUDPAttach().
+/// Users may define this same function in user code (same name and arguments) to
 /// override this default handler and get access to the received packets.
 void netstackUDPIPProcess(unsigned int len, udpip_hdr* packet) __attribute__ ((weak));
 
 /// This weakly-defined function is the default handler for incoming TCP/IP packets.
-/// Users should define this same function in user code (same name and arguments) to
+/// It answers connections to ports attached with netstackTCPAttach(), and
+/// refuses all others.
+/// Users may define this same function in user code (same name and arguments) to
 /// override this default handler and get access to the received packets.
 void netstackTCPIPProcess(unsigned int len, tcpip_hdr* packet) __attribute__ ((weak));
 
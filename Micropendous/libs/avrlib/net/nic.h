@@ -65,7 +65,19 @@ void nicSetMacAddress(uint8_t* macaddr);
 //! Print network interface hardware registers.
 /// Prints a formatted list of names and values of NIC registers for debugging
 /// purposes.
-inline void nicRegDump(void);
+void nicRegDump(void);
+
+//! Number of bytes at the start of a received frame passed to \c nicFilterFrame().
+/// Covers the ethernet, IP and UDP/ICMP headers, or a complete ARP packet.
+#define NIC_FILTER_HEADER_LEN	42
+
+//! Decide whether a received frame is wanted by the network stack.
+/// Implemented by the upper network layers, not by the NIC driver.  Drivers
+/// which can read a frame in pieces may call this with the first
+/// \c NIC_FILTER_HEADER_LEN bytes (or fewer, for shorter frames) before
+/// copying the remainder, and discard the frame without copying it further
+/// when zero is returned.  \c len is the full length of the frame.
+uint8_t nicFilterFrame(unsigned int len, unsigned char* header);
 
 #endif
 //@}